@@ -0,0 +1,187 @@
+import hashlib
+import os
+import pickle
+import struct
+import sys
+import zlib
+
+import numpy as np
+
+# Flatten the RandomForestClassifier saved by mdel.py or train_window.py into
+# the node tables read by src/forest.h, and check the flattened form against
+# predict_proba().
+# The same tables are also written as a binary image (src/model_image.h) that
+# a running board takes without reflashing:
+#
+#   python export_forest.py [model.pkl] [out.h] [out.bin]
+#   curl --data-binary @railway_fault_forest.bin http://192.168.1.1/model
+#
+# The names in the header come from the last word of out.h: railway_fault_forest.h
+# declares RAILWAY_FOREST_* and railwayForest, railway_fault_window.h
+# RAILWAY_WINDOW_* and railwayWindow.
+
+PROBA_ONE = 65535
+LEAF = 0x8000
+
+model_path = sys.argv[1] if len(sys.argv) > 1 else "railway_fault_AI_with_confidence.pkl"
+out_path = sys.argv[2] if len(sys.argv) > 2 else "railway_fault_forest.h"
+bin_path = sys.argv[3] if len(sys.argv) > 3 else "railway_fault_forest.bin"
+
+with open(model_path, "rb") as f:
+    model = pickle.load(f)
+
+kind = os.path.splitext(os.path.basename(out_path))[0].split("_")[-1]
+PREFIX = "RAILWAY_" + kind.upper()
+var = "railway" + kind.capitalize()
+
+n_features = model.n_features_in_
+n_classes = len(model.classes_)
+
+roots, feature, threshold, children = [], [], [], []
+leaf_rows = {}  # quantized probabilities -> leaf id
+
+
+def leaf_id(value):
+    row = value / value.sum()
+    q = tuple(int(round(p * PROBA_ONE)) for p in row)
+    if q not in leaf_rows:
+        leaf_rows[q] = len(leaf_rows)
+    return LEAF | leaf_rows[q]
+
+
+def signature(tree, node=0):
+    if tree.children_left[node] == -1:
+        return leaf_id(tree.value[node][0])
+    return (int(tree.feature[node]), float(tree.threshold[node]),
+            signature(tree, tree.children_left[node]), signature(tree, tree.children_right[node]))
+
+
+# Bootstrapped trees over a few binary features are often identical; keep
+# one copy of each with a weight (how many of the forest's trees it stands for)
+unique = {}
+for estimator in model.estimators_:
+    key = signature(estimator.tree_)
+    if key not in unique:
+        unique[key] = [estimator.tree_, 0]
+    unique[key][1] += 1
+
+weights = []
+for tree, weight in unique.values():
+    weights.append(weight)
+    # Breadth-first, split nodes only; leaves become references to leaf rows
+    order = [0]
+    for node in order:
+        for child in (tree.children_left[node], tree.children_right[node]):
+            if tree.children_left[child] != -1:
+                order.append(child)
+    base = len(feature)
+    index = {node: base + i for i, node in enumerate(order) if tree.children_left[node] != -1}
+
+    def ref(node):
+        return index[node] if node in index else leaf_id(tree.value[node][0])
+
+    roots.append(ref(0))
+    for node in order:
+        if tree.children_left[node] == -1:
+            continue
+        feature.append(int(tree.feature[node]))
+        threshold.append(float(tree.threshold[node]))
+        children.append(ref(tree.children_left[node]))
+        children.append(ref(tree.children_right[node]))
+
+assert len(feature) < LEAF and len(leaf_rows) < LEAF, "forest too large for 15-bit node references"
+proba = [p for row in sorted(leaf_rows, key=leaf_rows.get) for p in row]
+threshold32 = np.array(threshold, dtype=np.float32)
+
+
+def flat_proba(x):
+    total = np.zeros(n_classes)
+    for root, weight in zip(roots, weights):
+        node = root
+        while not node & LEAF:
+            node = children[2 * node + int(np.float32(x[feature[node]]) > threshold32[node])]
+        row = (node & ~LEAF) * n_classes
+        total += np.array(proba[row:row + n_classes]) * weight
+    return total / (len(model.estimators_) * PROBA_ONE)
+
+
+# Every binary sensor combination when there are few enough features, else
+# the samples the trainer kept (train_window.py)
+check_inputs = []
+if n_features <= 8:
+    check_inputs = [[(i >> f) & 1 for f in range(n_features)] for i in range(1 << n_features)]
+elif hasattr(model, "check_inputs_"):
+    check_inputs = [list(map(float, x)) for x in model.check_inputs_]
+if check_inputs:
+    expected = model.predict_proba(np.array(check_inputs, dtype=np.float32))
+    error = max(abs(flat_proba(x) - e).max() for x, e in zip(check_inputs, expected))
+    assert error < 1e-4, "flattened forest differs from predict_proba by %g" % error
+    print("✅ Flattened forest matches predict_proba (max error %.2g)" % error)
+
+
+def c_float(v):
+    text = "%.9g" % v
+    return text + ("f" if "." in text or "e" in text else ".0f")
+
+
+def c_array(ctype, name, values, fmt="%d"):
+    lines = []
+    for i in range(0, len(values), 12):
+        lines.append("    " + ", ".join(fmt(v) if callable(fmt) else fmt % v for v in values[i:i + 12]) + ",")
+    return "static const %s %s[] PROGMEM = {\n%s\n};\n" % (ctype, name, "\n".join(lines))
+
+
+with open(out_path, "w") as f:
+    f.write("#pragma once\n")
+    f.write("// Generated by export_forest.py from %s.\n" % model_path)
+    f.write('#include "src/forest.h"\n\n')
+    f.write("#define %s_FEATURES %d\n" % (PREFIX, n_features))
+    f.write("#define %s_CLASSES %d\n" % (PREFIX, n_classes))
+    f.write("#define %s_TREES %d\n" % (PREFIX, len(model.estimators_)))
+    f.write("#define %s_UNIQUE_TREES %d\n" % (PREFIX, len(roots)))
+    f.write("#define %s_NODES %d\n" % (PREFIX, len(feature)))
+    f.write("#define %s_LEAF_ROWS %d\n\n" % (PREFIX, len(leaf_rows)))
+    f.write(c_array("uint16_t", PREFIX + "_ROOTS", roots, "0x%04x"))
+    f.write(c_array("uint16_t", PREFIX + "_WEIGHTS", weights))
+    f.write(c_array("uint8_t", PREFIX + "_FEATURE", feature))
+    f.write(c_array("float", PREFIX + "_THRESHOLD", threshold, c_float))
+    f.write(c_array("uint16_t", PREFIX + "_CHILDREN", children, "0x%04x"))
+    f.write(c_array("uint16_t", PREFIX + "_PROBA", proba))
+    if check_inputs and n_features <= 8:
+        f.write("\n// predict_proba() of every binary input, bit i = feature i, for host checks\n")
+        f.write(c_array("float", PREFIX + "_CHECK", [p for row in expected for p in row], c_float))
+    elif check_inputs:
+        f.write("\n// predict_proba() of the inputs at sample CHECK_SAMPLES of %s, for host checks\n"
+                % model.check_trace_)
+        f.write('#define %s_CHECK_TRACE "%s"\n' % (PREFIX, model.check_trace_))
+        f.write("#define %s_CHECK_COUNT %d\n" % (PREFIX, len(check_inputs)))
+        f.write(c_array("uint32_t", PREFIX + "_CHECK_SAMPLES", [int(k) for k in model.check_samples_]))
+        f.write(c_array("float", PREFIX + "_CHECK_INPUTS", [v for x in check_inputs for v in x], c_float))
+        f.write(c_array("float", PREFIX + "_CHECK", [p for row in expected for p in row], c_float))
+    f.write("\nstatic const Forest<{0}_FEATURES, {0}_CLASSES> {1}(\n"
+            "    {0}_UNIQUE_TREES, {0}_TREES, {0}_ROOTS, {0}_WEIGHTS,\n"
+            "    {0}_FEATURE, {0}_THRESHOLD, {0}_CHILDREN, {0}_PROBA);\n".format(PREFIX, var))
+
+# Binary image: header, then the sections widest first so each is aligned
+MODEL_MAGIC = 0x444D4652  # "RFMD"
+MODEL_VERSION = 1
+HEADER = "<IHHBBHHHHHIII"
+
+assert len(model.estimators_) < 1 << 16 and n_features < 256 and n_classes < 256
+body = (np.array(threshold, dtype="<f4").tobytes() + np.array(roots + weights + children + proba, dtype="<u2").tobytes()
+        + np.array(feature, dtype="u1").tobytes())
+body += bytes(-len(body) % 4)
+header_size = struct.calcsize(HEADER)
+with open(model_path, "rb") as f:
+    model_id = int.from_bytes(hashlib.sha1(f.read()).digest()[:4], "little")
+header = struct.pack(HEADER[:-1], MODEL_MAGIC, MODEL_VERSION, header_size, n_features, n_classes, len(roots),
+                     len(model.estimators_), len(feature), len(leaf_rows), 0, header_size + len(body), model_id)
+# The CRC covers every byte but its own
+image = header + struct.pack("<I", zlib.crc32(body, zlib.crc32(header))) + body
+with open(bin_path, "wb") as f:
+    f.write(image)
+
+flash = len(roots) * 4 + len(feature) * (1 + 4 + 2 + 2) + len(proba) * 2
+print("✅ %d trees (%d distinct), %d split nodes, %d leaf rows, %d bytes of tables -> %s" % (
+    len(model.estimators_), len(roots), len(feature), len(leaf_rows), flash, out_path))
+print("✅ %d-byte model image %08x -> %s" % (len(image), model_id, bin_path))
@@ -0,0 +1,101 @@
+import numpy as np
+
+# The windowed sensor features of src/features.h, computed the same way
+# (same counts, same float32 arithmetic) so a model trained on them sees
+# exactly what the firmware feeds it.
+#
+# A trace is a CSV of "t_ms,left,right[,status]" rows, the track script
+# format of host/tracks; each row holds from its time on. It is sampled
+# every SAMPLE_US from its first row, and a sample takes the row before its
+# instant, as the firmware does with its timestamped edges.
+
+SAMPLE_US = 1000
+WINDOW = 256
+RUN_CAP = 60000
+NAMES = ["left", "right", "left_duty", "right_duty", "left_edges", "right_edges",
+         "left_run_ms", "right_run_ms", "since_edge_ms", "correlation"]
+STATUS = {"Normal": 0, "Crack_Left": 1, "Crack_Right": 2, "Break": 3}
+
+f32 = np.float32
+
+
+class SensorWindow:
+    def __init__(self):
+        self.ring = [0] * WINDOW
+        self.head = self.count = 0
+        self.ones = [0, 0]
+        self.edges = [0, 0]
+        self.both = 0
+        self.run = [0, 0]
+        self.last = 0
+
+    def push(self, pair):
+        if self.count == WINDOW:
+            old, nxt = self.ring[self.head], self.ring[(self.head + 1) % WINDOW]
+            for s in (0, 1):
+                self.ones[s] -= (old >> s) & 1
+                self.edges[s] -= ((old ^ nxt) >> s) & 1
+            self.both -= old == 3
+            self.count -= 1
+        changed = pair ^ self.last if self.count else 0
+        for s in (0, 1):
+            self.ones[s] += (pair >> s) & 1
+            self.edges[s] += (changed >> s) & 1
+            self.run[s] = 1 if not self.count or (changed >> s) & 1 else min(self.run[s] + 1, RUN_CAP)
+        self.both += pair == 3
+        self.ring[self.head] = pair
+        self.head = (self.head + 1) % WINDOW
+        self.count += 1
+        self.last = pair
+
+    def extract(self):
+        n = self.count or 1
+        out = [f32(self.last & 1), f32(self.last >> 1)]
+        out += [f32(self.ones[s]) / f32(n) for s in (0, 1)]
+        out += [f32(self.edges[s] * (1000000 // SAMPLE_US)) / f32(n) for s in (0, 1)]
+        out += [f32(self.run[s] * SAMPLE_US // 1000) for s in (0, 1)]
+        out.append(f32(min(self.run) * SAMPLE_US // 1000))
+        var = [self.ones[s] * (n - self.ones[s]) for s in (0, 1)]
+        if not self.count or not var[0] or not var[1]:
+            out.append(f32(0))
+        else:
+            out.append(f32(n * self.both - self.ones[0] * self.ones[1]) / np.sqrt(f32(var[0]) * f32(var[1])))
+        return out
+
+
+def read_trace(path):
+    """Rows of (t_ms, pair, status); status is -1 when the trace has none."""
+    rows = []
+    with open(path) as f:
+        for line in f:
+            parts = line.strip().split(",")
+            try:
+                t, left, right = float(parts[0]), int(parts[1]), int(parts[2])
+            except (ValueError, IndexError):
+                continue  # header or comment
+            status = STATUS.get(parts[3], -1) if len(parts) > 3 else -1
+            rows.append((t, (1 if left else 0) | (2 if right else 0), status))
+    return rows
+
+
+def trace_features(path, every=1):
+    """Feature rows and labels of every `every`-th sample of a trace, and their sample indices."""
+    rows = read_trace(path)
+    times = [t for t, _, _ in rows]
+    t0 = times[0]
+    n_samples = int((times[-1] - t0) * 1000 // SAMPLE_US) + 1
+    window = SensorWindow()
+    X, y, index = [], [], []
+    row = 0
+    for k in range(n_samples):
+        instant = t0 + k * SAMPLE_US / 1000.0
+        # The last row before the instant; the first row holds at the start
+        while row + 1 < len(rows) and times[row + 1] < instant:
+            row += 1
+        _, pair, status = rows[row]
+        window.push(pair)
+        if k % every == 0:
+            X.append(window.extract())
+            y.append(status)
+            index.append(k)
+    return np.array(X, dtype=np.float32), np.array(y), np.array(index)
@@ -0,0 +1,31 @@
+import gzip
+import hashlib
+
+# Compress the dashboard page into a PROGMEM array the firmware streams as-is.
+# Run again after editing dashboard.html; the output is checked in because the
+# Arduino build has no pre-build step.
+SOURCE = "dashboard.html"
+OUTPUT = "src/dashboard_gz.h"
+
+with open(SOURCE, "rb") as f:
+    html = f.read()
+
+# mtime=0 keeps the output (and so the ETag) stable across rebuilds
+gz = gzip.compress(html, compresslevel=9, mtime=0)
+etag = '"' + hashlib.sha256(gz).hexdigest()[:16] + '"'
+
+lines = []
+for i in range(0, len(gz), 16):
+    lines.append("    " + ", ".join(f"0x{b:02x}" for b in gz[i:i + 16]) + ",")
+
+with open(OUTPUT, "w") as f:
+    f.write("#pragma once\n")
+    f.write(f"// Generated by gen_dashboard.py from {SOURCE} ({len(html)} bytes) -- do not edit.\n")
+    f.write('#include "hal.h"\n\n')
+    f.write(f"#define DASHBOARD_ETAG \"{etag.replace(chr(34), chr(92) + chr(34))}\"\n")
+    f.write(f"const size_t DASHBOARD_GZ_LEN = {len(gz)};\n")
+    f.write("const uint8_t DASHBOARD_GZ[] PROGMEM = {\n")
+    f.write("\n".join(lines))
+    f.write("\n};\n")
+
+print(f"✅ {SOURCE}: {len(html)} -> {len(gz)} bytes gzip, ETag {etag}")
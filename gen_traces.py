@@ -0,0 +1,80 @@
+import random
+import sys
+
+# Labeled synthetic sensor traces for train_window.py: the track script
+# format of host/tracks with a status column saying what the track really
+# is at each point.
+#
+#   python gen_traces.py [out.csv] [minutes=20] [seed=1]
+#
+# Clear track is sprinkled with glitches, 1-3 ms misreads of one or both
+# sensors, which are still Normal. A fault holds one sensor (a crack) or
+# both (a break, the two sensors skewed by up to 5 ms) for 50 ms to 2 s;
+# its edges bounce for a few ms, and the sensor drops out now and then
+# while it lasts.
+
+out_path = sys.argv[1] if len(sys.argv) > 1 else "railway_fault_traces.csv"
+minutes = float(sys.argv[2]) if len(sys.argv) > 2 else 20
+seed = int(sys.argv[3]) if len(sys.argv) > 3 else 1
+
+rng = random.Random(seed)
+FAULTS = {"Crack_Left": (1, 0), "Crack_Right": (0, 1), "Break": (1, 1)}
+MEAN_CLEAR_MS = 3000
+MEAN_GLITCH_GAP_MS = 400
+
+rows = [(0.0, 0, 0, "Normal")]
+
+
+def at(t, pair, status):
+    rows.append((round(t, 1), pair[0], pair[1], status))
+
+
+def bounce(t, settled, away, status):
+    """A few quick flips away from the settled pair and back; returns when it settles."""
+    for _ in range(rng.randint(0, 3)):
+        t += rng.uniform(0.3, 2)
+        at(t, away, status)
+        t += rng.uniform(0.3, 2)
+        at(t, settled, status)
+    return t
+
+
+t = 0.0
+end = minutes * 60000
+while t < end:
+    clear_until = t + rng.expovariate(1 / MEAN_CLEAR_MS) + 200
+    while True:
+        t += rng.expovariate(1 / MEAN_GLITCH_GAP_MS) + 5
+        if t >= clear_until:
+            break
+        at(t, rng.choice(list(FAULTS.values())), "Normal")
+        t += rng.uniform(1, 3)
+        at(t, (0, 0), "Normal")
+    t = clear_until
+
+    status = rng.choice(list(FAULTS))
+    pair = FAULTS[status]
+    fault_end = t + rng.uniform(50, 2000)
+    if status == "Break":
+        first = rng.choice([(1, 0), (0, 1)])
+        at(t, first, status)
+        t += rng.uniform(0, 5)
+    at(t, pair, status)
+    t = bounce(t, pair, (0, 0), status)
+    while True:
+        t += rng.expovariate(1 / 300) + 10
+        if t >= fault_end - 5:
+            break
+        at(t, (0, 0), status)
+        t += rng.uniform(1, 2)
+        at(t, pair, status)
+    t = fault_end
+    at(t, (0, 0), "Normal")
+    t = bounce(t, (0, 0), pair, "Normal")
+
+with open(out_path, "w") as f:
+    f.write("t_ms,left,right,status\n")
+    for r in rows:
+        f.write("%g,%d,%d,%s\n" % r)
+
+print("✅ %.0f minutes, %d rows -> %s" % (minutes, len(rows), out_path))
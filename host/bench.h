@@ -0,0 +1,49 @@
+#pragma once
+// Small timing helpers shared by the host runner and benchmarks.
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+inline uint64_t bench_now_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+class LatencySamples
+{
+public:
+    void reserve(size_t n) { values.reserve(n); }
+    void add(uint64_t v) { values.push_back(v); sorted = false; }
+    size_t count() const { return values.size(); }
+    void merge(const LatencySamples &other)
+    {
+        values.insert(values.end(), other.values.begin(), other.values.end());
+        sorted = false;
+    }
+
+    uint64_t percentile(double p)
+    {
+        if (values.empty())
+            return 0;
+        if (!sorted)
+        {
+            std::sort(values.begin(), values.end());
+            sorted = true;
+        }
+        size_t index = size_t(p / 100.0 * (values.size() - 1) + 0.5);
+        return values[std::min(index, values.size() - 1)];
+    }
+
+    void report(const char *label, const char *unit, double scale = 1.0)
+    {
+        printf("  %-22s p50 %.1f  p90 %.1f  p99 %.1f  p99.9 %.1f  max %.1f %s (n=%zu)\n", label,
+               percentile(50) / scale, percentile(90) / scale, percentile(99) / scale, percentile(99.9) / scale,
+               percentile(100) / scale, unit, values.size());
+    }
+
+private:
+    std::vector<uint64_t> values;
+    bool sorted = true;
+};
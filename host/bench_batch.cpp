@@ -0,0 +1,128 @@
+// Offline replay throughput: classifying a long columnar sensor log.
+//
+//   bench_batch [samples] [dataset.csv]
+//
+// Builds a synthetic log by resampling railway_fault_dataset.csv, with a
+// share of analog noise, exact threshold values and NaNs mixed in. The log
+// is classified sample by sample with DecisionTree::predict (the reference),
+// TreeTable::predict and TreeTable::predictBatch; all three must agree on
+// every sample. Exits 1 otherwise.
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "../railway_fault_model.h"
+#include "../railway_fault_tree.h"
+#include "bench.h"
+
+static bool loadDataset(const char *path, std::vector<float> &left, std::vector<float> &right)
+{
+    FILE *f = fopen(path, "r");
+    if (!f)
+        return false;
+    char line[256];
+    if (!fgets(line, sizeof(line), f)) // header
+    {
+        fclose(f);
+        return false;
+    }
+    float l, r;
+    while (fgets(line, sizeof(line), f))
+    {
+        if (sscanf(line, "%f,%f", &l, &r) == 2)
+        {
+            left.push_back(l);
+            right.push_back(r);
+        }
+    }
+    fclose(f);
+    return !left.empty();
+}
+
+static float noisy(std::mt19937 &rng, float value)
+{
+    switch (rng() % 64)
+    {
+    case 0:
+        return std::uniform_real_distribution<float>(-0.5f, 1.5f)(rng);
+    case 1:
+        return 0.5f;
+    case 2:
+        return NAN;
+    default:
+        return value;
+    }
+}
+
+static void report(const char *label, size_t samples, uint64_t ns, double baseline)
+{
+    double rate = samples / (ns / 1e9);
+    printf("  %-22s %8.1f M samples/s  %6.2f ns/sample", label, rate / 1e6, double(ns) / samples);
+    if (baseline > 0)
+        printf("  (%.1fx)", rate / baseline);
+    printf("\n");
+}
+
+int main(int argc, char **argv)
+{
+    size_t samples = argc > 1 ? strtoull(argv[1], nullptr, 10) : 20000000;
+    const char *path = argc > 2 ? argv[2] : "railway_fault_dataset.csv";
+
+    std::vector<float> rowsLeft, rowsRight;
+    if (!loadDataset(path, rowsLeft, rowsRight))
+    {
+        perror(path);
+        return 1;
+    }
+
+    std::mt19937 rng(1);
+    std::vector<float> left(samples), right(samples);
+    for (size_t i = 0; i < samples; i++)
+    {
+        size_t row = rng() % rowsLeft.size();
+        left[i] = noisy(rng, rowsLeft[row]);
+        right[i] = noisy(rng, rowsRight[row]);
+    }
+
+    static constexpr TreeTable<RAILWAY_FAULT_FEATURES, RAILWAY_FAULT_CLASSES> table(RAILWAY_FAULT_TREE);
+    static_assert(table.binarizable(), "railway tree splits each sensor at one threshold");
+    Eloquent::ML::Port::DecisionTree tree;
+    std::vector<uint8_t> reference(samples), scalar(samples), batch(samples);
+
+    uint64_t t0 = bench_now_ns();
+    for (size_t i = 0; i < samples; i++)
+    {
+        float x[2] = {left[i], right[i]};
+        reference[i] = tree.predict(x);
+    }
+    uint64_t t1 = bench_now_ns();
+    for (size_t i = 0; i < samples; i++)
+    {
+        float x[2] = {left[i], right[i]};
+        scalar[i] = table.predict(x);
+    }
+    uint64_t t2 = bench_now_ns();
+    const float *columns[2] = {left.data(), right.data()};
+    table.predictBatch(columns, samples, batch.data());
+    uint64_t t3 = bench_now_ns();
+
+    bool ok = true;
+    for (size_t i = 0; i < samples && ok; i++)
+    {
+        if (scalar[i] != reference[i] || batch[i] != reference[i])
+        {
+            printf("MISMATCH at sample %zu (%g, %g): predict %d, table %d, batch %d\n", i, left[i], right[i],
+                   reference[i], scalar[i], batch[i]);
+            ok = false;
+        }
+    }
+
+    printf("bench_batch: %zu samples resampled from %zu rows, %s\n", samples, rowsLeft.size(),
+           ok ? "all paths agree" : "MISMATCHED");
+    double baseline = samples / ((t1 - t0) / 1e9);
+    report("DecisionTree::predict", samples, t1 - t0, 0);
+    report("TreeTable::predict", samples, t2 - t1, baseline);
+    report("TreeTable::predictBatch", samples, t3 - t2, baseline);
+    return ok ? 0 : 1;
+}
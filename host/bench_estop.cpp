@@ -0,0 +1,156 @@
+// Emergency stop latency under web load. A separate thread plays the sensor
+// hardware: it drives the motor forward, then breaks the track and raises the
+// pin interrupts itself, the way an edge preempts whatever loop() is doing on
+// the ESP8266. Meanwhile the main thread runs loop() while fast clients hammer
+// /data.json and / and slow clients trickle their request headers (which
+// parked loop() inside handleClient() before the server stopped blocking).
+//
+//   bench_estop [faults] [port] [bound_us]
+//
+// Latency is measured from the first input change to the motor pin going low
+// (the stop) and to the buzzer going high (loop()'s alert). Exits 1 if any
+// stop is missing or slower than bound_us.
+#include <atomic>
+#include <mutex>
+#include <random>
+#include <thread>
+
+#include "../src/hal.h"
+#include "../src/sensors.h"
+#include "bench.h"
+#include "hal_host.h"
+#include "http_client.h"
+
+void setup();
+void loop();
+
+#define FAST_CLIENTS 6
+#define SLOW_CLIENTS 2
+#define SLOW_CLIENT_STALL_MS 150
+
+static std::atomic<bool> done(false);
+static std::atomic<uint64_t> faultAt(0);
+static std::atomic<bool> stopped(false), alerted(false);
+static std::atomic<uint32_t> requests(0);
+static std::atomic<int> clientsRunning(0);
+static std::mutex mutex;
+static LatencySamples stopNs, alertNs;
+
+static void onPinWrite(uint8_t pin, int level, uint64_t)
+{
+    uint64_t since = faultAt.load();
+    if (!since)
+        return;
+    uint64_t now = bench_now_ns();
+    if (pin == MLP_PIN && level == LOW && !stopped.exchange(true))
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopNs.add(now - since);
+    }
+    else if (pin == BUZZER_PIN && level == HIGH && !alerted.exchange(true))
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        alertNs.add(now - since);
+    }
+}
+
+static void fastClient(uint16_t port, int index)
+{
+    std::string body;
+    for (uint32_t i = index; !done; i++)
+        if (http_get(port, i % 4 ? "/data.json" : "/", body) > 0)
+            requests++;
+    clientsRunning--;
+}
+
+// Sends the request line, stalls, then finishes the headers.
+static void slowClient(uint16_t port)
+{
+    while (!done)
+    {
+        int fd = http_connect(port);
+        if (fd < 0)
+            continue;
+        static const char head[] = "GET /data.json HTTP/1.1\r\n";
+        static const char tail[] = "Host: 127.0.0.1\r\nConnection: close\r\n\r\n";
+        send(fd, head, sizeof(head) - 1, MSG_NOSIGNAL);
+        std::this_thread::sleep_for(std::chrono::milliseconds(SLOW_CLIENT_STALL_MS));
+        send(fd, tail, sizeof(tail) - 1, MSG_NOSIGNAL);
+        char buf[1024];
+        while (recv(fd, buf, sizeof(buf), 0) > 0)
+            ;
+        close(fd);
+        requests++;
+    }
+    clientsRunning--;
+}
+
+static void sensorHardware(int faults)
+{
+    std::mt19937 rng(7);
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    for (int i = 0; i < faults; i++)
+    {
+        digitalWrite(MLP_PIN, HIGH); // operator pressed FORWARD
+        std::this_thread::sleep_for(std::chrono::microseconds(20000 + rng() % 40000));
+
+        stopped = false;
+        alerted = false;
+        faultAt = bench_now_ns();
+        hal_host::set_input(IRL_PIN, HIGH);
+        hal_host::set_input(IRR_PIN, HIGH);
+
+        // Give loop() time to raise the alert before the track clears.
+        for (int waited = 0; !alerted && waited < 1000; waited++)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        faultAt = 0;
+        hal_host::set_input(IRL_PIN, LOW);
+        hal_host::set_input(IRR_PIN, LOW);
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    done = true;
+}
+
+int main(int argc, char **argv)
+{
+    int faults = argc > 1 ? atoi(argv[1]) : 100;
+    uint16_t port = argc > 2 ? atoi(argv[2]) : 18181;
+    double boundUs = argc > 3 ? atof(argv[3]) : 1000;
+
+    hal_host::set_realtime(true);
+    hal_host::set_http_port(port);
+    hal_host::on_pin_write(onPinWrite);
+    setup();
+
+    std::thread clients[FAST_CLIENTS + SLOW_CLIENTS];
+    clientsRunning = FAST_CLIENTS + SLOW_CLIENTS;
+    for (int i = 0; i < FAST_CLIENTS; i++)
+        clients[i] = std::thread(fastClient, port, i);
+    for (int i = FAST_CLIENTS; i < FAST_CLIENTS + SLOW_CLIENTS; i++)
+        clients[i] = std::thread(slowClient, port);
+    std::thread hardware(sensorHardware, faults);
+
+    // Keeps serving until every client has seen its last response.
+    while (!done || clientsRunning > 0)
+    {
+        loop();
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+    hardware.join();
+    for (int i = 0; i < FAST_CLIENTS + SLOW_CLIENTS; i++)
+        clients[i].join();
+
+    printf("bench_estop: %d faults, %u requests served meanwhile, %u interrupt stops\n", faults, requests.load(),
+           safetyStops.load());
+    stopNs.report("motor stop (ISR)", "us", 1e3);
+    alertNs.report("buzzer (loop)", "ms", 1e6);
+
+    uint64_t worst = stopNs.percentile(100);
+    if (stopNs.count() != size_t(faults) || worst > boundUs * 1e3)
+    {
+        printf("  FAIL: %zu/%d stops, worst %.1f us, bound %.0f us\n", stopNs.count(), faults, worst / 1e3, boundUs);
+        return 1;
+    }
+    printf("  PASS: every stop within %.0f us\n", boundUs);
+    return 0;
+}
@@ -0,0 +1,347 @@
+// Windowed sensor features: the firmware's extractor against the training
+// scripts', its cost per sample, and what it changes on a glitchy track.
+//
+//   bench_features [trace=RAILWAY_WINDOW_CHECK_TRACE]
+//
+// The trace the exporter took its check inputs from is replayed twice:
+// edge by edge, as serviceSensors() feeds the window (long quiet gaps go
+// through advanceTo() in bulk), and one push() per sample. Both must give
+// features.py's values exactly at every check sample, and the compiled
+// forest must give predict_proba() on them.
+//
+// Then the firmware runs on the virtual clock with the trace as its track
+// and the train driven forward. Every fault must be called and keep the
+// train stopped until it ends. The glitches between faults stop it from
+// the interrupt as before and must keep it stopped, unless the build has
+// SENSOR_GLITCH_RESUME (src/sensors.h): then they should have it moving
+// again within FEATURE_CONFIRM_MS. Exits 1 on a mismatch, a missed fault
+// or a glitch that moved the train on its own without that flag.
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include "../railway_fault_window.h"
+#include "../src/features.h"
+#include "../src/hal.h"
+#include "../src/sensors.h"
+#include "bench.h"
+#include "hal_host.h"
+#include "track_sim.h"
+
+void setup();
+void loop();
+
+#define FEATURES RAILWAY_WINDOW_FEATURES
+#define CLASSES RAILWAY_WINDOW_CLASSES
+
+static_assert(FEATURES == FEATURE_COUNT, "railway_fault_window.h is out of date");
+
+typedef SensorWindow<FEATURE_WINDOW> Window;
+
+struct Row
+{
+    uint64_t t_us;
+    uint8_t pair;
+    bool fault; // the status column is not Normal
+};
+
+static std::vector<Row> readTrace(const char *path)
+{
+    std::vector<Row> rows;
+    FILE *f = fopen(path, "r");
+    if (!f)
+        return rows;
+    char line[128], status[32];
+    while (fgets(line, sizeof(line), f))
+    {
+        double t_ms;
+        unsigned left, right;
+        int n = sscanf(line, "%lf,%u,%u,%31s", &t_ms, &left, &right, status);
+        if (n < 3)
+            continue; // header or comment
+        rows.push_back({uint64_t(llround(t_ms * 1000.0)), uint8_t((left ? 1 : 0) | (right ? 2 : 0)),
+                        n == 4 && strcmp(status, "Normal") != 0});
+    }
+    fclose(f);
+    return rows;
+}
+
+// The pair at every sample instant: the last row before it.
+static std::vector<uint8_t> resample(const std::vector<Row> &rows)
+{
+    std::vector<uint8_t> pairs;
+    uint64_t t0 = rows[0].t_us;
+    size_t row = 0;
+    for (uint64_t t = t0; t <= rows.back().t_us; t += FEATURE_SAMPLE_US)
+    {
+        while (row + 1 < rows.size() && rows[row + 1].t_us < t)
+            row++;
+        pairs.push_back(rows[row].pair);
+    }
+    return pairs;
+}
+
+static bool matchesCheck(const float *x, uint32_t check, const char *how)
+{
+    const float *want = RAILWAY_WINDOW_CHECK_INPUTS + check * FEATURES;
+    for (int f = 0; f < FEATURES; f++)
+        if (x[f] != want[f])
+        {
+            printf("  %s: sample %u %s = %.9g, features.py says %.9g\n", how, RAILWAY_WINDOW_CHECK_SAMPLES[check],
+                   featureName(f), x[f], want[f]);
+            return false;
+        }
+    return true;
+}
+
+// Edge by edge, as the firmware does it; sample instants are relative to
+// the first row, which starts the grid.
+static bool replayEdges(const std::vector<Row> &rows)
+{
+    Window w;
+    uint32_t t0 = uint32_t(rows[0].t_us);
+    w.begin(t0, rows[0].pair & 1, rows[0].pair >> 1);
+    uint32_t check = 0;
+    bool ok = true;
+    for (size_t i = 1; i <= rows.size() && check < RAILWAY_WINDOW_CHECK_COUNT; i++)
+    {
+        uint64_t until = i < rows.size() ? rows[i].t_us : rows.back().t_us + FEATURE_SAMPLE_US;
+        // Check samples before this edge; the one at its instant still
+        // takes the old level.
+        while (check < RAILWAY_WINDOW_CHECK_COUNT &&
+               t0 + uint64_t(RAILWAY_WINDOW_CHECK_SAMPLES[check]) * FEATURE_SAMPLE_US <= until)
+        {
+            w.advanceTo(t0 + RAILWAY_WINDOW_CHECK_SAMPLES[check] * FEATURE_SAMPLE_US);
+            float x[FEATURES];
+            w.extract(x);
+            ok = matchesCheck(x, check++, "edges") && ok;
+        }
+        if (i < rows.size())
+        {
+            w.advanceTo(uint32_t(rows[i].t_us));
+            w.set(rows[i].pair & 1, rows[i].pair >> 1);
+        }
+    }
+    return ok && check == RAILWAY_WINDOW_CHECK_COUNT;
+}
+
+static bool replaySamples(const std::vector<uint8_t> &pairs)
+{
+    Window w;
+    uint32_t check = 0;
+    bool ok = true;
+    for (uint32_t k = 0; k < pairs.size(); k++)
+    {
+        w.push(pairs[k]);
+        if (check < RAILWAY_WINDOW_CHECK_COUNT && RAILWAY_WINDOW_CHECK_SAMPLES[check] == k)
+        {
+            float x[FEATURES];
+            w.extract(x);
+            ok = matchesCheck(x, check++, "samples") && ok;
+        }
+    }
+    return ok && check == RAILWAY_WINDOW_CHECK_COUNT;
+}
+
+static bool forestMatches()
+{
+    for (uint32_t i = 0; i < RAILWAY_WINDOW_CHECK_COUNT; i++)
+    {
+        float proba[CLASSES];
+        railwayWindow.predictProba(RAILWAY_WINDOW_CHECK_INPUTS + i * FEATURES, proba);
+        for (int c = 0; c < CLASSES; c++)
+            if (std::fabs(proba[c] - RAILWAY_WINDOW_CHECK[i * CLASSES + c]) > 1e-4f)
+            {
+                printf("  check %u class %d: %.6f, predict_proba says %.6f\n", i, c, proba[c],
+                       RAILWAY_WINDOW_CHECK[i * CLASSES + c]);
+                return false;
+            }
+    }
+    return true;
+}
+
+static volatile float sink;
+
+static void timeSamples(const std::vector<uint8_t> &pairs)
+{
+    LatencySamples pushNs, extractNs, predictNs;
+    float sum = 0;
+    for (int round = 0; round < 20; round++)
+    {
+        Window w;
+        uint64_t t0 = bench_now_ns();
+        for (uint8_t pair : pairs)
+            w.push(pair);
+        uint64_t t1 = bench_now_ns();
+        for (uint8_t pair : pairs)
+        {
+            float x[FEATURES];
+            w.push(pair);
+            w.extract(x);
+            sum += x[FEAT_CORRELATION];
+        }
+        uint64_t t2 = bench_now_ns();
+        for (uint8_t pair : pairs)
+        {
+            float x[FEATURES], proba[CLASSES];
+            w.push(pair);
+            w.extract(x);
+            sum += railwayWindow.predict(x, proba);
+        }
+        uint64_t t3 = bench_now_ns();
+        pushNs.add((t1 - t0) * 1000 / pairs.size());
+        extractNs.add((t2 - t1) * 1000 / pairs.size());
+        predictNs.add((t3 - t2) * 1000 / pairs.size());
+    }
+    sink = sum;
+    pushNs.report("push()", "ns/sample", 1e3);
+    extractNs.report("push() + extract()", "ns/sample", 1e3);
+    predictNs.report("... + forest", "ns/sample", 1e3);
+
+    // A quiet track: one edge a second, the rest filled in bulk.
+    Window w;
+    w.begin(0, 0, 0);
+    uint64_t t0 = bench_now_ns();
+    for (uint32_t s = 1; s <= 100000; s++)
+    {
+        w.advanceTo(s * 1000000u);
+        w.set(s & 1, 0);
+    }
+    double perSecond = double(bench_now_ns() - t0) / 100000;
+    printf("  %-22s %.0f ns per second of track, %u samples\n", "advanceTo(), 1 edge/s", perSecond, w.samples());
+}
+
+// The firmware on the trace, the train driven forward throughout.
+struct Segment
+{
+    uint64_t startUs, endUs;
+    bool fault;
+};
+
+static uint64_t buzzerUs = 0, driveUs = 0;
+
+static void onPinWrite(uint8_t pin, int level, uint64_t t_us)
+{
+    if (pin == BUZZER_PIN && level == HIGH && !buzzerUs)
+        buzzerUs = t_us;
+    if (pin == MLP_PIN && level == HIGH)
+        driveUs = t_us;
+}
+
+// Faults by their labels; glitches are Normal misreads on a quiet track,
+// not the bounce at the end of a fault.
+static std::vector<Segment> segments(const std::vector<Row> &rows)
+{
+    std::vector<Segment> out;
+    uint64_t faultEndUs = 0;
+    for (size_t i = 1; i < rows.size(); i++)
+    {
+        if (rows[i].fault && !rows[i - 1].fault)
+            out.push_back({rows[i].t_us, rows[i].t_us, true});
+        else if (!rows[i].fault && rows[i - 1].fault)
+            out.back().endUs = faultEndUs = rows[i].t_us;
+        else if (!rows[i].fault && rows[i].pair && !rows[i - 1].pair && rows[i].t_us - faultEndUs > 300000 &&
+                 i + 1 < rows.size())
+            out.push_back({rows[i].t_us, rows[i + 1].t_us, false});
+    }
+    return out;
+}
+
+static void runUntil(uint64_t tUs)
+{
+    while (hal_host::now_us() < tUs)
+    {
+        loop();
+        hal_host::advance_us(100);
+    }
+}
+
+static bool runFirmware(const char *path, const std::vector<Row> &rows)
+{
+    static TrackSim track;
+    std::vector<Segment> segs = segments(rows);
+    hal_host::on_pin_write(onPinWrite);
+    setup();
+    uint64_t warmUs = hal_host::now_us() + 300000;
+    track.load(path);
+    hal_host::attach_track(&track, IRL_PIN, IRR_PIN);
+    digitalWrite(MLP_PIN, HIGH);
+
+    uint32_t faults = 0, called = 0, held = 0, glitches = 0, stopped = 0, resumed = 0, calledFault = 0;
+    LatencySamples detectUs, resumeUs;
+    for (size_t s = 0; s < segs.size(); s++)
+    {
+        const Segment &seg = segs[s];
+        // Judged just before the next segment starts, or once this one has
+        // long been over.
+        uint64_t judgeUs = seg.endUs + 100000;
+        if (s + 1 < segs.size() && segs[s + 1].startUs < judgeUs)
+            judgeUs = segs[s + 1].startUs;
+        judgeUs -= 100;
+        runUntil(seg.startUs);
+        buzzerUs = 0;
+        runUntil(judgeUs);
+        if (seg.startUs < warmUs)
+            continue;
+
+        bool moving = hal_host::pin_level(MLP_PIN) == HIGH;
+        if (seg.fault)
+        {
+            faults++;
+            if (buzzerUs >= seg.startUs && buzzerUs <= seg.endUs)
+            {
+                called++;
+                detectUs.add(buzzerUs - seg.startUs);
+            }
+            held += driveUs < seg.startUs && !moving;
+        }
+        else
+        {
+            glitches++;
+            bool stop = driveUs >= seg.startUs;
+            stopped += stop || !moving;
+            calledFault += buzzerUs >= seg.startUs;
+            if (stop && moving)
+            {
+                resumed++;
+                resumeUs.add(driveUs - seg.startUs);
+            }
+        }
+        // The operator sends the train on again.
+        if (!moving)
+            digitalWrite(MLP_PIN, HIGH);
+    }
+
+    printf("  %-22s %u faults: %u called, %u kept the train stopped to the end\n", "firmware on the trace", faults,
+           called, held);
+    detectUs.report("fault -> buzzer", "ms", 1e3);
+    printf("  %-22s %u glitches: %u stopped the train, %u resumed by themselves (%s), %u called a fault\n", "",
+           glitches, stopped, resumed, SENSOR_GLITCH_RESUME ? "SENSOR_GLITCH_RESUME" : "latched: 0", calledFault);
+    if (SENSOR_GLITCH_RESUME)
+        resumeUs.report("glitch -> moving again", "ms", 1e3);
+    return faults && called == faults && held == faults && (SENSOR_GLITCH_RESUME || resumed == 0);
+}
+
+int main(int argc, char **argv)
+{
+    const char *path = argc > 1 ? argv[1] : RAILWAY_WINDOW_CHECK_TRACE;
+    std::vector<Row> rows = readTrace(path);
+    if (rows.empty())
+    {
+        printf("bench_features: cannot read %s\n", path);
+        return 1;
+    }
+    std::vector<uint8_t> pairs = resample(rows);
+    printf("bench_features: %s, %zu rows, %zu samples of %d us, window %d\n", path, rows.size(), pairs.size(),
+           FEATURE_SAMPLE_US, FEATURE_WINDOW);
+
+    bool edges = replayEdges(rows), samples = replaySamples(pairs), forest = forestMatches();
+    printf("  %-22s edge by edge %s, sample by sample %s, forest %s (%d check samples)\n", "against features.py",
+           edges ? "exact" : "MISMATCH", samples ? "exact" : "MISMATCH", forest ? "matches" : "MISMATCH",
+           RAILWAY_WINDOW_CHECK_COUNT);
+    printf("  %-22s %zu B\n", "window state", sizeof(Window));
+    timeSamples(pairs);
+
+    bool firmware = runFirmware(path, rows);
+    return edges && samples && forest && firmware ? 0 : 1;
+}
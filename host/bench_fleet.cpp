@@ -0,0 +1,225 @@
+// Fleet gateway (tools/fleet.h): decode cost per payload kind, scaling of
+// the work-stealing pool from one worker to every core over a recorded
+// fleet, and a loopback UDP run with the simulator.
+//
+//   bench_fleet [max_threads=cores] [units=1000] [seconds=60]
+//
+// The fleet is generated first: units at 10 Hz, half sending /data.json
+// and half /data.bin, a twentieth ten times as often, and half the
+// /data.json units deltas. Each pool size then takes all of it as fast as
+// it can; afterwards every unit's table entry must be its last update, and
+// nothing may have been stale or refused. Then one pool takes it with some
+// frames arriving after the unit's next one: every unit must end current
+// or marked as waiting for a whole update, and never hold fields from a
+// delta applied to the wrong base. Exits 1 if any of that fails, or if
+// the UDP run loses a unit.
+#include <cstdio>
+
+#include "../tools/fleet.h"
+#include "bench.h"
+
+struct Corpus
+{
+    std::vector<uint8_t> bytes;
+    std::vector<uint32_t> offsets; // frame i is bytes[offsets[i] .. offsets[i + 1])
+    uint64_t jsonFrames = 0;
+    uint64_t deltaFrames = 0;
+
+    size_t size() const { return offsets.size() - 1; }
+    const uint8_t *frame(size_t i) const { return bytes.data() + offsets[i]; }
+    size_t length(size_t i) const { return offsets[i + 1] - offsets[i]; }
+    uint32_t unit(size_t i) const { return frame(i)[0] | frame(i)[1] << 8 | frame(i)[2] << 16; }
+};
+
+static bool checkTable(const UnitTable &table, const FleetSim &sim)
+{
+    uint32_t wrong = 0;
+    for (uint32_t u = 0; u < sim.units(); u++)
+    {
+        UnitState s;
+        if (!table.read(u, s) || s.seq != sim.lastSeq(u) || s.prediction != sim.lastState(u).prediction ||
+            s.classified != s.prediction)
+            wrong++;
+    }
+    if (wrong)
+        printf("  %u units with the wrong latest state\n", wrong);
+    return wrong == 0;
+}
+
+static void decodeCost(const Corpus &corpus)
+{
+    LatencySamples json, binary;
+    UnitUpdate u;
+    for (size_t i = 0; i < corpus.size() && i < 200000; i++)
+    {
+        uint64_t t0 = bench_now_ns();
+        for (int k = 0; k < 10; k++)
+            decodeFleetFrame(corpus.frame(i), corpus.length(i), u);
+        uint64_t dt = bench_now_ns() - t0;
+        (corpus.frame(i)[4] == '{' ? json : binary).add(dt);
+    }
+    json.report("decode /data.json", "ns", 10);
+    binary.report("decode /data.bin", "ns", 10);
+}
+
+// Some frames arrive after the unit's next one, as UDP may deliver them.
+static bool reordered(const Corpus &corpus, uint32_t units, unsigned threads, const FleetSim &sim)
+{
+    std::mt19937 rng(11);
+    std::vector<int64_t> held(units, -1);
+    std::vector<size_t> order;
+    uint64_t late = 0;
+    for (size_t i = 0; i < corpus.size(); i++)
+    {
+        int64_t &h = held[corpus.unit(i)];
+        order.push_back(i);
+        if (h >= 0)
+            order.push_back(size_t(h)), h = -1;
+        else if (rng() % 20 == 0)
+            order.pop_back(), h = int64_t(i), late++;
+    }
+    for (int64_t h : held)
+        if (h >= 0)
+            order.push_back(size_t(h));
+
+    FleetGateway gateway(units, threads);
+    for (size_t i : order)
+        while (!gateway.submit(corpus.frame(i), corpus.length(i)))
+            std::this_thread::yield();
+    gateway.drain();
+    FleetStats s = gateway.stats();
+    uint32_t wrong = 0, behind = 0, waiting = 0;
+    for (uint32_t u = 0; u < units; u++)
+    {
+        UnitState t;
+        if (!gateway.units().read(u, t))
+        {
+            wrong++;
+            continue;
+        }
+        uint8_t p = sim.predictionAt(u, t.seq);
+        wrong += t.prediction != p || t.left != (p & 1) || t.right != (p >> 1);
+        waiting += t.needsFull;
+        behind += t.seq != sim.lastSeq(u) && !t.needsFull;
+    }
+    printf("  %-22s %llu frames late: %llu stale, %llu deltas refused; %u units waiting for a whole update, %u behind "
+           "unmarked, %u wrong\n",
+           "reordered", (unsigned long long)late, (unsigned long long)s.stale, (unsigned long long)s.gaps, waiting,
+           behind, wrong);
+    return wrong == 0 && behind == 0 && s.applied + s.stale + s.gaps == corpus.size();
+}
+
+// Producers split the fleet by unit, so each unit's updates go in order.
+static double runPool(const Corpus &corpus, uint32_t units, unsigned threads, FleetStats &stats, const FleetSim &sim,
+                      bool &correct)
+{
+    FleetGateway gateway(units, threads);
+    unsigned producers = (threads + 7) / 8;
+    uint64_t t0 = bench_now_ns();
+    std::vector<std::thread> feeders;
+    for (unsigned p = 0; p < producers; p++)
+        feeders.emplace_back([&, p]() {
+            for (size_t i = 0; i < corpus.size(); i++)
+                if (corpus.unit(i) % producers == p)
+                    while (!gateway.submit(corpus.frame(i), corpus.length(i)))
+                        std::this_thread::yield();
+        });
+    for (std::thread &f : feeders)
+        f.join();
+    gateway.drain();
+    double seconds = (bench_now_ns() - t0) / 1e9;
+    stats = gateway.stats();
+    stats.dropped = 0; // full queues were retried
+    correct = checkTable(gateway.units(), sim);
+    return seconds;
+}
+
+static bool udpRun(uint32_t units, unsigned threads)
+{
+    const uint16_t port = 18195;
+    int in = openFleetSocket(port, true), out = openFleetSocket(port, false);
+    if (in < 0 || out < 0)
+    {
+        printf("  %-22s no loopback socket\n", "udp");
+        return false;
+    }
+    FleetGateway gateway(units, threads);
+    std::atomic<bool> stop(false);
+    std::thread receiver(receiveFleet, in, std::ref(gateway), std::cref(stop));
+    FleetSim sim(units, 10, 0.5f, 0.05f, 7, 0.5f);
+    uint64_t sent = 0, start = bench_now_ns();
+    for (uint64_t now = start; now - start < 2000000000ull; now = bench_now_ns())
+    {
+        sim.run((now - start) / 1000, [&](const uint8_t *frame, size_t size) { sent += send(out, frame, size, 0) > 0; });
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    stop = true;
+    receiver.join();
+    gateway.drain();
+    close(in);
+    close(out);
+
+    FleetStats s = gateway.stats();
+    uint32_t heard = 0, current = 0;
+    UnitState u;
+    for (uint32_t i = 0; i < units; i++)
+        if (gateway.units().read(i, u))
+        {
+            heard++;
+            current += u.seq == sim.lastSeq(i);
+        }
+    printf("  %-22s %u units at 10 Hz for 2 s: %llu sent, %llu applied, %llu dropped; %u/%u units heard, %u current\n",
+           "udp loopback", units, (unsigned long long)sent, (unsigned long long)s.applied,
+           (unsigned long long)s.dropped, heard, units, current);
+    return heard == units;
+}
+
+int main(int argc, char **argv)
+{
+    unsigned cores = std::thread::hardware_concurrency();
+    unsigned maxThreads = argc > 1 ? atoi(argv[1]) : cores ? cores : 1;
+    uint32_t units = argc > 2 ? atoi(argv[2]) : 1000;
+    uint32_t seconds = argc > 3 ? atoi(argv[3]) : 60;
+
+    Corpus corpus;
+    FleetSim sim(units, 10, 0.5f, 0.05f, 1, 0.5f);
+    sim.keepHistory(true);
+    corpus.offsets.push_back(0);
+    for (uint32_t ms = 0; ms < seconds * 1000; ms++)
+        sim.run(ms * 1000ull, [&](const uint8_t *frame, size_t size) {
+            corpus.bytes.insert(corpus.bytes.end(), frame, frame + size);
+            corpus.offsets.push_back(corpus.bytes.size());
+            corpus.jsonFrames += frame[4] == '{';
+            UnitUpdate u;
+            corpus.deltaFrames += decodeFleetFrame(frame, size, u) && u.since;
+        });
+    printf("bench_fleet: %u units, %u s of updates: %zu frames (%llu /data.json, %llu of them deltas), %.1f MB, %u "
+           "cores\n",
+           units, seconds, corpus.size(), (unsigned long long)corpus.jsonFrames,
+           (unsigned long long)corpus.deltaFrames, corpus.bytes.size() / 1e6, cores);
+    decodeCost(corpus);
+
+    bool ok = true;
+    double base = 0;
+    printf("  %-8s %12s %8s %10s %8s %8s\n", "workers", "frames/s", "speedup", "efficiency", "stolen", "stale");
+    std::vector<unsigned> sizes;
+    for (unsigned t = 1; t < maxThreads; t = t < 4 ? t + 1 : t * 2)
+        sizes.push_back(t);
+    sizes.push_back(maxThreads);
+    for (unsigned t : sizes)
+    {
+        FleetStats s;
+        bool correct;
+        double wall = runPool(corpus, units, t, s, sim, correct);
+        double rate = corpus.size() / wall;
+        if (t == 1)
+            base = rate;
+        printf("  %-8u %12.0f %7.2fx %9.0f%% %7.1f%% %8llu%s\n", t, rate, rate / base, 100 * rate / base / t,
+               100.0 * s.stolen / corpus.size(), (unsigned long long)s.stale, correct ? "" : "  WRONG STATE");
+        ok = ok && correct && s.applied == corpus.size() && s.stale == 0 && s.gaps == 0 && s.invalid == 0;
+    }
+    ok = reordered(corpus, units, maxThreads, sim) && ok;
+    ok = udpRun(units / 2, maxThreads) && ok;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,168 @@
+// Flattened random forest: correctness against sklearn and cost per call.
+//
+//   bench_forest [predictions]
+//
+// The forest's predictProba() must match the predict_proba() values the
+// exporter recorded for every binary input, and predictProbaBatch() must
+// match predictProba() exactly. It is then timed against the
+// same forest as individually allocated node structs with child pointers
+// (what a direct port of sklearn's tree objects looks like) and against
+// the single-tree lookup table. Exits 1 on a mismatch.
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "../railway_fault_forest.h"
+#include "../railway_fault_tree.h"
+#include "bench.h"
+
+#define CLASSES RAILWAY_FOREST_CLASSES
+
+struct PointerNode
+{
+    int feature;
+    float threshold;
+    PointerNode *left;
+    PointerNode *right;
+    float proba[CLASSES];
+};
+
+static size_t pointerBytes = 0;
+
+static PointerNode *unflatten(uint16_t ref)
+{
+    PointerNode *n = new PointerNode();
+    pointerBytes += sizeof(PointerNode);
+    if (ref & FOREST_LEAF)
+    {
+        n->feature = -1;
+        for (int c = 0; c < CLASSES; c++)
+            n->proba[c] = RAILWAY_FOREST_PROBA[(ref & ~FOREST_LEAF) * CLASSES + c] / float(FOREST_PROBA_ONE);
+        return n;
+    }
+    n->feature = RAILWAY_FOREST_FEATURE[ref];
+    n->threshold = RAILWAY_FOREST_THRESHOLD[ref];
+    n->left = unflatten(RAILWAY_FOREST_CHILDREN[2 * ref]);
+    n->right = unflatten(RAILWAY_FOREST_CHILDREN[2 * ref + 1]);
+    return n;
+}
+
+static void pointerProba(const std::vector<PointerNode *> &trees, const float *x, float *out)
+{
+    for (int c = 0; c < CLASSES; c++)
+        out[c] = 0;
+    for (const PointerNode *n : trees)
+    {
+        while (n->feature >= 0)
+            n = x[n->feature] <= n->threshold ? n->left : n->right;
+        for (int c = 0; c < CLASSES; c++)
+            out[c] += n->proba[c];
+    }
+    for (int c = 0; c < CLASSES; c++)
+        out[c] /= trees.size();
+}
+
+static volatile float sink;
+
+template <typename Predict>
+static void timePredictions(const char *label, const std::vector<uint32_t> &inputs, Predict predict)
+{
+    LatencySamples batches;
+    const size_t BATCH = 1000;
+    float sum = 0;
+    for (size_t i = 0; i + BATCH <= inputs.size(); i += BATCH)
+    {
+        uint64_t start = bench_now_ns();
+        for (size_t j = i; j < i + BATCH; j++)
+        {
+            float x[2] = {float(inputs[j] & 1), float(inputs[j] >> 1)};
+            sum += predict(x);
+        }
+        batches.add(bench_now_ns() - start);
+    }
+    sink = sum;
+    batches.report(label, "ns/call", BATCH);
+}
+
+int main(int argc, char **argv)
+{
+    size_t predictions = argc > 1 ? strtoull(argv[1], nullptr, 10) : 2000000;
+    bool ok = true;
+
+    for (uint32_t in = 0; in < (1u << RAILWAY_FOREST_FEATURES); in++)
+    {
+        float x[RAILWAY_FOREST_FEATURES];
+        for (int f = 0; f < RAILWAY_FOREST_FEATURES; f++)
+            x[f] = (in >> f) & 1;
+        float proba[CLASSES];
+        railwayForest.predictProba(x, proba);
+        for (int c = 0; c < CLASSES; c++)
+        {
+            if (std::fabs(proba[c] - RAILWAY_FOREST_CHECK[in * CLASSES + c]) > 1e-4f)
+            {
+                printf("MISMATCH at input 0x%x class %d: %f, sklearn %f\n", in, c, proba[c],
+                       RAILWAY_FOREST_CHECK[in * CLASSES + c]);
+                ok = false;
+            }
+        }
+    }
+
+    // The batch path must give bit-identical probabilities.
+    std::vector<float> columnData[RAILWAY_FOREST_FEATURES];
+    const float *columns[RAILWAY_FOREST_FEATURES];
+    for (int f = 0; f < RAILWAY_FOREST_FEATURES; f++)
+    {
+        for (uint32_t i = 0; i < 1000; i++)
+            columnData[f].push_back(((i * 2654435761u) >> (16 + f)) & 1);
+        columns[f] = columnData[f].data();
+    }
+    std::vector<float> batch(1000 * CLASSES);
+    railwayForest.predictProbaBatch(columns, 1000, batch.data());
+    for (size_t i = 0; i < 1000 && ok; i++)
+    {
+        float x[RAILWAY_FOREST_FEATURES], proba[CLASSES];
+        for (int f = 0; f < RAILWAY_FOREST_FEATURES; f++)
+            x[f] = columns[f][i];
+        railwayForest.predictProba(x, proba);
+        if (memcmp(proba, &batch[i * CLASSES], sizeof(proba)))
+        {
+            printf("MISMATCH: predictProbaBatch differs from predictProba at sample %zu\n", i);
+            ok = false;
+        }
+    }
+
+    // The pointer forest keeps every tree, duplicates included.
+    std::vector<PointerNode *> pointerTrees;
+    for (int t = 0; t < RAILWAY_FOREST_UNIQUE_TREES; t++)
+        for (int copy = 0; copy < RAILWAY_FOREST_WEIGHTS[t]; copy++)
+            pointerTrees.push_back(unflatten(RAILWAY_FOREST_ROOTS[t]));
+
+    std::mt19937 rng(1);
+    std::vector<uint32_t> inputs(predictions);
+    for (uint32_t &in : inputs)
+        in = rng() & 3;
+
+    size_t tables = sizeof(RAILWAY_FOREST_ROOTS) + sizeof(RAILWAY_FOREST_WEIGHTS) + sizeof(RAILWAY_FOREST_FEATURE) + sizeof(RAILWAY_FOREST_THRESHOLD) +
+                    sizeof(RAILWAY_FOREST_CHILDREN) + sizeof(RAILWAY_FOREST_PROBA);
+    printf("bench_forest: %d trees (%d distinct), %d split nodes, %d leaf rows, %s against predict_proba\n",
+           RAILWAY_FOREST_TREES, RAILWAY_FOREST_UNIQUE_TREES, RAILWAY_FOREST_NODES, RAILWAY_FOREST_LEAF_ROWS, ok ? "verified" : "MISMATCHED");
+    printf("  %-22s %zu B flash, %zu B RAM\n", "flat forest", tables, sizeof(railwayForest));
+    printf("  %-22s %zu B heap in %d allocations\n", "pointer forest", pointerBytes,
+           int(pointerBytes / sizeof(PointerNode)));
+
+    timePredictions("flat predictProba", inputs, [](const float *x) {
+        float proba[CLASSES];
+        return proba[railwayForest.predict(x, proba)];
+    });
+    timePredictions("pointer predict_proba", inputs, [&](const float *x) {
+        float proba[CLASSES];
+        pointerProba(pointerTrees, x, proba);
+        return proba[0];
+    });
+    static constexpr TreeTable<RAILWAY_FAULT_FEATURES, RAILWAY_FAULT_CLASSES> table(RAILWAY_FAULT_TREE);
+    timePredictions("tree table (no proba)", inputs, [](const float *x) {
+        return float(table.predict(int(x[0]) | int(x[1]) << 1));
+    });
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,190 @@
+// Heap behaviour of the firmware over a long run.
+//
+//   bench_heap [iterations=2000000] [seed=1]
+//
+// Every operator new made by the firmware after the track is built is served
+// from a 48 KB first-fit arena with 8-byte headers and coalescing of
+// neighbouring free blocks, which is roughly how umm_malloc treats the
+// ESP8266's heap. loop() runs on the virtual clock over a generated track
+// (100 us per iteration), with a /data.json document rendered every 500 ms
+// as a polling dashboard would cause. Free heap, the largest free block and
+// fragmentation -- computed like ESP.getHeapFragmentation() -- are sampled
+// throughout.
+#include <cmath>
+#include <new>
+
+#include "../src/hal.h"
+#include "bench.h"
+#include "hal_host.h"
+#include "track_sim.h"
+
+void setup();
+void loop();
+size_t writeDataJson(char *out, size_t size, uint32_t since);
+
+#define ARENA_SIZE (48 * 1024)
+
+struct BlockHeader
+{
+    uint32_t size; // including the header
+    uint32_t used;
+};
+
+alignas(16) static uint8_t arena[ARENA_SIZE];
+static bool arenaOn = false;
+static uint64_t allocCount = 0, arenaMisses = 0;
+static uint32_t liveBytes = 0, peakLiveBytes = 0;
+
+static BlockHeader *blockAt(size_t offset) { return (BlockHeader *)(arena + offset); }
+
+static void *arenaAlloc(size_t n)
+{
+    uint32_t need = uint32_t((n + sizeof(BlockHeader) + 7) & ~size_t(7));
+    for (size_t at = 0; at < ARENA_SIZE; at += blockAt(at)->size)
+    {
+        BlockHeader *h = blockAt(at);
+        if (h->used)
+            continue;
+        while (at + h->size < ARENA_SIZE && !blockAt(at + h->size)->used)
+            h->size += blockAt(at + h->size)->size;
+        if (h->size < need)
+            continue;
+        if (h->size - need >= 2 * sizeof(BlockHeader))
+        {
+            BlockHeader *rest = blockAt(at + need);
+            rest->size = h->size - need;
+            rest->used = 0;
+            h->size = need;
+        }
+        h->used = 1;
+        liveBytes += h->size;
+        if (liveBytes > peakLiveBytes)
+            peakLiveBytes = liveBytes;
+        return h + 1;
+    }
+    return nullptr;
+}
+
+static bool inArena(void *p) { return p >= (void *)arena && p < (void *)(arena + ARENA_SIZE); }
+
+void *operator new(size_t size)
+{
+    void *p = nullptr;
+    if (arenaOn)
+    {
+        allocCount++;
+        p = arenaAlloc(size);
+        if (!p)
+            arenaMisses++;
+    }
+    if (!p)
+        p = malloc(size);
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void *p) noexcept
+{
+    if (inArena(p))
+    {
+        BlockHeader *h = (BlockHeader *)p - 1;
+        h->used = 0;
+        liveBytes -= h->size;
+    }
+    else
+        free(p);
+}
+
+void operator delete(void *p, size_t) noexcept { operator delete(p); }
+
+struct HeapStats
+{
+    uint32_t freeBytes = 0;
+    uint32_t largestBlock = 0;
+    uint32_t fragmentation = 0; // percent
+};
+
+// Adjacent free blocks count as one, as they would after coalescing.
+static HeapStats heapStats()
+{
+    HeapStats s;
+    double squares = 0;
+    uint32_t run = 0;
+    for (size_t at = 0; at <= ARENA_SIZE; at += blockAt(at)->size)
+    {
+        if (at < ARENA_SIZE && !blockAt(at)->used)
+        {
+            run += blockAt(at)->size - sizeof(BlockHeader);
+            continue;
+        }
+        s.freeBytes += run;
+        s.largestBlock = run > s.largestBlock ? run : s.largestBlock;
+        squares += double(run) * run;
+        run = 0;
+        if (at == ARENA_SIZE)
+            break;
+    }
+    if (s.freeBytes)
+        s.fragmentation = uint32_t(100 - sqrt(squares) * 100 / s.freeBytes);
+    return s;
+}
+
+int main(int argc, char **argv)
+{
+    uint64_t iterations = argc > 1 ? strtoull(argv[1], nullptr, 10) : 2000000;
+    uint32_t seed = argc > 2 ? strtoul(argv[2], nullptr, 10) : 1;
+
+    TrackSim track;
+    track.generate(seed);
+    hal_host::attach_track(&track, IRL_PIN, IRR_PIN);
+    hal_host::set_http_port(0);
+    blockAt(0)->size = ARENA_SIZE;
+    blockAt(0)->used = 0;
+    arenaOn = true;
+
+    setup();
+    HeapStats boot = heapStats();
+    uint64_t bootAllocs = allocCount;
+    uint32_t bootLive = liveBytes;
+    peakLiveBytes = liveBytes;
+
+    static char json[1024];
+    HeapStats worst = boot;
+    uint32_t maxFragmentation = boot.fragmentation;
+    uint64_t t0 = bench_now_ns();
+    for (uint64_t i = 0; i < iterations; i++)
+    {
+        loop();
+        hal_host::advance_us(100);
+        if (i % 5000 == 0)
+            writeDataJson(json, sizeof(json), 0);
+        if (i % 1000 == 0)
+        {
+            HeapStats now = heapStats();
+            if (now.freeBytes < worst.freeBytes)
+                worst.freeBytes = now.freeBytes;
+            if (now.largestBlock < worst.largestBlock)
+                worst.largestBlock = now.largestBlock;
+            if (now.fragmentation > maxFragmentation)
+                maxFragmentation = now.fragmentation;
+        }
+    }
+    double wallS = (bench_now_ns() - t0) / 1e9;
+    arenaOn = false;
+    HeapStats end = heapStats();
+
+    printf("bench_heap: %llu iterations (%.0f s simulated, %.1f s wall), %u track faults, %d B arena\n",
+           (unsigned long long)iterations, iterations * 100 / 1e6, wallS, track.faults(), ARENA_SIZE);
+    printf("  %-22s %u B free, largest block %u B, fragmentation %u%%\n", "after setup()", boot.freeBytes,
+           boot.largestBlock, boot.fragmentation);
+    printf("  %-22s %u B free, largest block %u B, fragmentation %u%%\n", "end of run", end.freeBytes,
+           end.largestBlock, end.fragmentation);
+    printf("  %-22s %u B free, largest block %u B, fragmentation %u%%\n", "worst sampled", worst.freeBytes,
+           worst.largestBlock, maxFragmentation);
+    printf("  %-22s %u B after setup(), peak %u B\n", "heap in use", bootLive, peakLiveBytes);
+    printf("  %-22s %llu (%.1f per track fault, %llu did not fit)\n", "allocations in loop()",
+           (unsigned long long)(allocCount - bootAllocs), double(allocCount - bootAllocs) / (track.faults() ? track.faults() : 1),
+           (unsigned long long)arenaMisses);
+    return 0;
+}
@@ -0,0 +1,214 @@
+// The event-driven web server under many clients at once: request latency,
+// throughput and how long loop() is held up while serving them.
+//
+//   bench_http [seconds=3] [clients=12] [port=18193]
+//
+// The firmware runs on the real clock. Most clients keep their connection
+// alive and poll /data.json, with the dashboard page and /data.bin mixed
+// in; a quarter of them pipeline four requests per round trip; two more
+// act like a slow phone, stalling 150 ms between the request line and the
+// rest of the request. There are more clients than connection slots, so
+// connections are closed now and then to let waiting ones in; a client
+// whose connection closes reconnects and resends what was unanswered.
+// loop() is timed on every call. Exits 1 if any request fails.
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../src/hal.h"
+#include "bench.h"
+#include "hal_host.h"
+#include "http_client.h"
+
+void setup();
+void loop();
+
+#define PIPELINE_DEPTH 4
+#define SLOW_CLIENTS 2
+#define SLOW_CLIENT_STALL_MS 150
+
+static std::atomic<bool> done(false);
+static std::atomic<uint32_t> requests(0), failures(0), reconnects(0);
+static std::mutex mutex;
+static LatencySamples keepAliveNs, pipelinedNs, slowNs;
+
+static const char *target(uint32_t i)
+{
+    if (i % 10 == 0)
+        return "/";
+    return i % 10 == 5 ? "/data.bin" : "/data.json";
+}
+
+static bool expected(int status) { return status == 200 || status == 304; }
+
+// Sends depth requests on one connection, then reads the answers.
+static void keepAliveClient(uint16_t port, int index, int depth)
+{
+    LatencySamples samples;
+    samples.reserve(1 << 16);
+    int fd = -1;
+    std::string buf, body;
+    char chunk[8192];
+    for (uint32_t i = index; !done; i += depth)
+    {
+        if (fd < 0 && (fd = http_connect(port)) < 0)
+            continue;
+        std::string batch;
+        char req[256];
+        for (int k = 0; k < depth; k++)
+        {
+            http_format_get(req, sizeof(req), target(i + k), "", true);
+            batch += req;
+        }
+        uint64_t t0 = bench_now_ns();
+        send(fd, batch.data(), batch.size(), MSG_NOSIGNAL);
+
+        int answered = 0;
+        bool closed = false;
+        buf.clear();
+        while (answered < depth)
+        {
+            int status;
+            size_t used = http_parse_response(buf, closed, status, body);
+            if (used)
+            {
+                buf.erase(0, used);
+                if (!expected(status))
+                    failures++;
+                answered++;
+                requests++;
+                samples.add(bench_now_ns() - t0);
+                continue;
+            }
+            if (closed)
+                break;
+            ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+            if (n <= 0)
+                closed = true;
+            else
+                buf.append(chunk, n);
+        }
+        // Closed for a waiting client: reconnect, and resend what was lost.
+        if (closed || answered < depth)
+        {
+            close(fd);
+            fd = -1;
+            reconnects++;
+            i -= depth - answered;
+        }
+    }
+    if (fd >= 0)
+        close(fd);
+    std::lock_guard<std::mutex> lock(mutex);
+    (depth > 1 ? pipelinedNs : keepAliveNs).merge(samples);
+}
+
+static void slowClient(uint16_t port)
+{
+    while (!done)
+    {
+        int fd = http_connect(port);
+        if (fd < 0)
+            continue;
+        static const char head[] = "GET /data.json HTTP/1.1\r\n";
+        static const char tail[] = "Host: 127.0.0.1\r\nConnection: close\r\n\r\n";
+        uint64_t t0 = bench_now_ns();
+        send(fd, head, sizeof(head) - 1, MSG_NOSIGNAL);
+        std::this_thread::sleep_for(std::chrono::milliseconds(SLOW_CLIENT_STALL_MS));
+        send(fd, tail, sizeof(tail) - 1, MSG_NOSIGNAL);
+        std::string response, body;
+        char buf[2048];
+        ssize_t n;
+        while ((n = recv(fd, buf, sizeof(buf), 0)) > 0)
+            response.append(buf, n);
+        close(fd);
+        int status;
+        if (!http_parse_response(response, true, status, body) || !expected(status))
+            failures++;
+        requests++;
+        std::lock_guard<std::mutex> lock(mutex);
+        slowNs.add(bench_now_ns() - t0);
+    }
+}
+
+// The value on a "name value" line of /metrics.
+static std::string metricValue(const std::string &text, const char *name)
+{
+    std::string needle = std::string("\n") + name + " ";
+    size_t at = text.find(needle);
+    if (at == std::string::npos)
+        return "?";
+    at += needle.size();
+    return text.substr(at, text.find('\n', at) - at);
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t seconds = argc > 1 ? atoi(argv[1]) : 3;
+    int clients = argc > 2 ? atoi(argv[2]) : 12;
+    uint16_t port = argc > 3 ? atoi(argv[3]) : 18193;
+
+    hal_host::set_realtime(true);
+    hal_host::set_http_port(port);
+    setup();
+
+    std::vector<std::thread> threads;
+    int pipelined = clients / 4;
+    for (int i = 0; i < clients; i++)
+        threads.emplace_back(keepAliveClient, port, i, i < pipelined ? PIPELINE_DEPTH : 1);
+    for (int i = 0; i < SLOW_CLIENTS; i++)
+        threads.emplace_back(slowClient, port);
+
+    LatencySamples loopNs;
+    loopNs.reserve(1 << 24);
+    uint64_t start = bench_now_ns(), end = start + seconds * 1000000000ull;
+    uint64_t now = start;
+    while (now < end)
+    {
+        loop();
+        uint64_t after = bench_now_ns();
+        loopNs.add(after - now);
+        now = after;
+    }
+    uint32_t served = requests;
+    double elapsed = (now - start) / 1e9;
+
+    // Keep serving until every client has seen its last answer.
+    done = true;
+    std::atomic<int> running(threads.size());
+    std::thread joiner([&] {
+        for (std::thread &t : threads)
+            t.join();
+        running = 0;
+    });
+    while (running)
+        loop();
+    joiner.join();
+
+    std::string metrics;
+    std::atomic<bool> fetched(false);
+    std::thread fetch([&] {
+        http_get(port, "/metrics", metrics);
+        fetched = true;
+    });
+    while (!fetched)
+        loop();
+    fetch.join();
+
+    bool ok = !failures;
+    printf("bench_http: %d keep-alive clients (%d pipelining %d deep) + %d slow, %u s, %s\n", clients, pipelined,
+           PIPELINE_DEPTH, SLOW_CLIENTS, seconds, ok ? "all requests answered" : "FAILED");
+    printf("  %-22s %.0f req/s, %u failed, %u reconnects\n", "throughput", served / elapsed, failures.load(),
+           reconnects.load());
+    keepAliveNs.report("keep-alive", "ms", 1e6);
+    pipelinedNs.report("pipelined (per batch)", "ms", 1e6);
+    slowNs.report("slow client", "ms", 1e6);
+    loopNs.report("loop() call", "us", 1e3);
+    printf("  %-22s %s evictions, %s timeouts, %s connections, %s requests\n", "server counters",
+           metricValue(metrics, "rail_http_evictions_total").c_str(),
+           metricValue(metrics, "rail_http_timeouts_total").c_str(),
+           metricValue(metrics, "rail_http_connections_total").c_str(),
+           metricValue(metrics, "rail_http_requests_total").c_str());
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,217 @@
+// Idle loop() (x.cpp's idleUntilNeeded) against the spinning one, on a
+// generated track and the virtual clock.
+//
+//   bench_idle [seconds=120] [tick_us=100]
+//
+// setup() runs once, then the process forks twice: one child calls loop()
+// every tick as railsim does, the other the same with hal_host::set_idle()
+// on, so loop() waits in esp_delay() when nothing has work. Each reports
+// its duty cycle (the share of time not spent waiting), loop() passes per
+// second, how long a sensor edge sat in the queue before loop() took it,
+// and the fault onset to motor stop (the interrupt) and to buzzer (the
+// forest) latencies. Both must log the same console records in order,
+// within a millisecond of each other. Exits 1 if they do not or a fault
+// goes unnoticed.
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+#include "../src/binlog.h"
+#include "../src/hal.h"
+#include "../src/sensors.h"
+#include "bench.h"
+#include "hal_host.h"
+#include "track_sim.h"
+
+void setup();
+void loop();
+
+#define TRACK_SEED 1
+
+static TrackSim track;
+static BinLogDecoder decoder;
+static FILE *records = nullptr;
+
+static uint32_t seenFaults = 0;
+static uint64_t onsetUs = 0;
+static bool stopPending = false, alertPending = false;
+static uint32_t missed = 0;
+static LatencySamples stopUs, alertUs;
+
+static void onSerialWrite(const uint8_t *data, size_t size)
+{
+    decoder.feed(data, size, [](uint32_t ms, const char *text) {
+        if (records)
+            fprintf(records, "%lu %s\n", (unsigned long)ms, text);
+    });
+}
+
+static void trackFaults()
+{
+    if (track.faults() == seenFaults)
+        return;
+    missed += track.faults() - seenFaults - 1 + (alertPending ? 1 : 0);
+    seenFaults = track.faults();
+    onsetUs = track.lastFaultUs();
+    stopPending = alertPending = true;
+}
+
+static void onPinWrite(uint8_t pin, int level, uint64_t t_us)
+{
+    trackFaults();
+    if (pin == MLP_PIN && level == LOW && stopPending)
+    {
+        stopUs.add(t_us - onsetUs);
+        stopPending = false;
+    }
+    if (pin == BUZZER_PIN && level == HIGH && alertPending)
+    {
+        alertUs.add(t_us - onsetUs);
+        alertPending = false;
+    }
+}
+
+// A second copy of the track says when each queued edge happened: every
+// change raises one interrupt per pin that changed, in pin order.
+class EdgeClock
+{
+public:
+    void begin()
+    {
+        copy.generate(TRACK_SEED);
+        base = sensorEvents.pushed();
+        take(hal_host::now_us(), false);
+    }
+
+    // Called after each step; samples how long the edges taken since waited.
+    void update(LatencySamples &queuedUs)
+    {
+        uint64_t now = hal_host::now_us();
+        take(now, true);
+        uint32_t popped = sensorEvents.pushed() - sensorEvents.size() - base;
+        for (; taken < popped && taken < times.size(); taken++)
+            queuedUs.add(now - times[taken]);
+    }
+
+private:
+    void take(uint64_t now, bool record)
+    {
+        TrackSample s;
+        while (copy.next(now, s))
+        {
+            int changed = (s.left != left) + (s.right != right);
+            left = s.left;
+            right = s.right;
+            while (record && changed--)
+                times.push_back(s.t_us);
+        }
+    }
+
+    TrackSim copy;
+    uint32_t base = 0;
+    uint8_t left = 0, right = 0;
+    std::vector<uint64_t> times;
+    uint32_t taken = 0;
+};
+
+static int runChild(const char *label, bool idle, double seconds, uint64_t tickUs, int fd)
+{
+    records = fdopen(fd, "w");
+    hal_host::set_idle(idle);
+    EdgeClock edges;
+    edges.begin();
+    LatencySamples queuedUs;
+    uint64_t start = hal_host::now_us(), end = start + uint64_t(seconds * 1e6), passes = 0;
+    uint64_t wall0 = bench_now_ns();
+    while (hal_host::now_us() < end)
+    {
+        loop();
+        passes++;
+        edges.update(queuedUs);
+        hal_host::advance_us(tickUs);
+        edges.update(queuedUs);
+    }
+    trackFaults();
+    double wallS = (bench_now_ns() - wall0) / 1e9;
+    double simulatedS = (hal_host::now_us() - start) / 1e6;
+    hal_host::IdleStats s = hal_host::idle_stats();
+    printf("  %s: %.0f s simulated in %.2f s wall\n", label, simulatedS, wallS);
+    printf("  %-22s %.2f%% (%llu waits, %llu ended by an edge)\n", "duty cycle", 100.0 - s.idleUs / 1e4 / simulatedS,
+           (unsigned long long)s.idles, (unsigned long long)s.interruptWakes);
+    printf("  %-22s %.0f/s\n", "loop() passes", passes / simulatedS);
+    queuedUs.report("edge queued", "us");
+    stopUs.report("onset to stop", "us");
+    alertUs.report("onset to buzzer", "ms", 1000.0);
+    printf("  %-22s %u (unnoticed %u)\n", "track faults", seenFaults, missed);
+    fflush(stdout);
+    fclose(records);
+    return missed || stopUs.count() != seenFaults ? 1 : 0;
+}
+
+struct Record
+{
+    unsigned long ms;
+    std::string text;
+};
+
+// Runs one child and collects its console records.
+static bool run(const char *label, bool idle, double seconds, uint64_t tickUs, std::vector<Record> &out)
+{
+    int fds[2];
+    if (pipe(fds))
+        return false;
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+        close(fds[0]);
+        _exit(runChild(label, idle, seconds, tickUs, fds[1]));
+    }
+    close(fds[1]);
+    FILE *in = fdopen(fds[0], "r");
+    char line[256];
+    while (fgets(line, sizeof(line), in))
+    {
+        char *text;
+        unsigned long ms = strtoul(line, &text, 10);
+        line[strcspn(line, "\n")] = '\0';
+        out.push_back({ms, text + 1});
+    }
+    fclose(in);
+    int status;
+    return pid > 0 && waitpid(pid, &status, 0) == pid && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+int main(int argc, char **argv)
+{
+    double seconds = argc > 1 ? atof(argv[1]) : 120;
+    uint64_t tickUs = argc > 2 ? strtoull(argv[2], nullptr, 10) : 100;
+    printf("bench_idle: %.0f s of generated track, %llu us tick\n", seconds, (unsigned long long)tickUs);
+
+    hal_host::set_http_port(0);
+    track.generate(TRACK_SEED);
+    hal_host::attach_track(&track, IRL_PIN, IRR_PIN);
+    hal_host::on_pin_write(onPinWrite);
+    hal_host::on_serial_write(onSerialWrite);
+    Serial.begin(115200);
+    setup();
+
+    std::vector<Record> spin, idle;
+    bool ok = run("spinning", false, seconds, tickUs, spin);
+    ok = run("idle", true, seconds, tickUs, idle) && ok;
+
+    size_t late = 0;
+    bool same = spin.size() == idle.size();
+    for (size_t i = 0; same && i < spin.size(); i++)
+    {
+        same = spin[i].text == idle[i].text;
+        late += spin[i].ms != idle[i].ms;
+        same = same && labs(long(spin[i].ms) - long(idle[i].ms)) <= 1;
+    }
+    printf("  %-22s %zu spinning, %zu idle, %zu a millisecond apart: %s\n", "console records", spin.size(),
+           idle.size(), late, same ? "same" : "DIFFERENT");
+    return ok && same ? 0 : 1;
+}
@@ -0,0 +1,105 @@
+// /data.json serialization: the original String-concatenating getDataJson()
+// against writeDataJson() from x.cpp, in throughput and heap traffic.
+#include <cstdlib>
+#include <new>
+
+#include "../src/hal.h"
+#include "bench.h"
+#include "hal_host.h"
+
+void setup();
+void loop();
+size_t writeDataJson(char *out, size_t size, uint32_t since);
+
+static uint64_t allocCount = 0;
+static uint64_t allocBytes = 0;
+
+void *operator new(size_t size)
+{
+    allocCount++;
+    allocBytes += size;
+    if (void *p = malloc(size))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+
+// Same members and values the firmware holds right after a Break, serialized
+// the way getDataJson() did before it was replaced.
+static struct
+{
+    String message = "⚠ Break detected! Train Stopped 🚨 | Fault: 93.00% | Severity: Critical";
+    String message_class = "danger";
+    String left = "1";
+    String left_class = "success";
+    String right = "1";
+    String right_class = "success";
+    String btn_fwd = "FORWARD";
+    String btn_fwd_class = "success";
+    String btn_stop = "STOP";
+    String btn_stop_class = "danger";
+    String btn_back = "BACK";
+    String btn_back_class = "success";
+} legacy;
+static String ai_status = "Break";
+static String ai_class = "danger";
+static float fault_percent = 93.0;
+static String severity = "Critical";
+
+static String legacyDataJson()
+{
+    return "{\"message\":\"" + legacy.message + "\",\"message_class\":\"" + legacy.message_class + "\", "
+           "\"left\":\"" + legacy.left + "\",\"left_class\":\"" + legacy.left_class + "\", "
+           "\"right\":\"" + legacy.right + "\",\"right_class\":\"" + legacy.right_class + "\", "
+           "\"btn_fwd\":\"" + legacy.btn_fwd + "\",\"btn_fwd_class\":\"" + legacy.btn_fwd_class + "\", "
+           "\"btn_stop\":\"" + legacy.btn_stop + "\",\"btn_stop_class\":\"" + legacy.btn_stop_class + "\", "
+           "\"btn_back\":\"" + legacy.btn_back + "\",\"btn_back_class\":\"" + legacy.btn_back_class + "\", "
+           "\"ai_status\":\"" + ai_status + "\",\"fault_percent\":\"" + String(fault_percent) + "\",\"severity\":\"" +
+           severity + "\",\"ai_class\":\"" + ai_class + "\"}";
+}
+
+template <typename F>
+static void run(const char *label, int iterations, F serialize)
+{
+    size_t bytes = 0;
+    uint64_t allocs0 = allocCount, bytes0 = allocBytes;
+    uint64_t t0 = bench_now_ns();
+    for (int i = 0; i < iterations; i++)
+        bytes += serialize();
+    uint64_t ns = bench_now_ns() - t0;
+    printf("  %-16s %6.1f ns/call  %7.1f MB/s  %5zu B/doc  %5.1f allocs/call  %7.1f heap B/call\n", label,
+           double(ns) / iterations, bytes / (ns / 1e9) / 1e6, bytes / iterations,
+           double(allocCount - allocs0) / iterations, double(allocBytes - bytes0) / iterations);
+}
+
+int main(int argc, char **argv)
+{
+    int iterations = argc > 1 ? atoi(argv[1]) : 1000000;
+
+    // Put the firmware into the Break state so both documents carry the
+    // longest banner.
+    hal_host::set_http_port(0);
+    setup();
+    hal_host::set_input(IRL_PIN, HIGH);
+    hal_host::set_input(IRR_PIN, HIGH);
+    hal_host::advance_us(1100000);
+    loop();
+
+    static char buf[768];
+    printf("bench_json: %d documents\n", iterations);
+    run("getDataJson", iterations, [] { return legacyDataJson().length(); });
+    run("writeDataJson", iterations, [] { return writeDataJson(buf, sizeof(buf), 0); });
+    printf("  sample: %s\n", buf);
+
+    // A poller that saw the state one tick ago only needs the fields that
+    // moved since then.
+    uint32_t before = 0;
+    sscanf(strstr(buf, "\"seq\":") + 6, "%u", &before);
+    hal_host::advance_us(1100000);
+    loop();
+    run("delta (1 tick)", iterations, [before] { return writeDataJson(buf, sizeof(buf), before); });
+    printf("  sample: %s\n", buf);
+    return 0;
+}
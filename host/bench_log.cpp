@@ -0,0 +1,156 @@
+// Console logging: the banner line Serial.println used to send on every
+// status change against the binary records of src/binlog.h, through the
+// host UART model (115200 baud, 128-byte FIFO) on the virtual clock.
+//
+//   bench_log [messages=2000]
+//
+// Each run logs a status change every interval and measures how long the
+// call that logs it holds up loop(): println waits for the FIFO, log() and
+// drain() never do. Records beyond what the line carries are dropped and
+// counted. The records are decoded again and must read exactly as the
+// banner did, with every dropped one accounted for. Then the firmware runs
+// on a generated track. Exits 1 on a mismatch or a blocked write from it.
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "../src/binlog.h"
+#include "../src/hal.h"
+#include "../src/sensors.h"
+#include "bench.h"
+#include "hal_host.h"
+#include "track_sim.h"
+
+void setup();
+void loop();
+
+static BinLogDecoder decoder;
+static std::vector<std::string> lines;
+static uint64_t droppedNoticed = 0;
+
+static void onSerialWrite(const uint8_t *data, size_t size)
+{
+    decoder.feed(data, size, [](uint32_t, const char *text) {
+        unsigned long n;
+        if (sscanf(text, "(%lu log records dropped)", &n) == 1)
+            droppedNoticed += n;
+        else
+            lines.push_back(text);
+    });
+}
+
+static DeviceState stateFor(uint32_t i)
+{
+    DeviceState s;
+    s.prediction = Prediction(i % 7 < 4 ? PRED_NORMAL : i % 4);
+    s.severity = s.prediction == PRED_NORMAL ? SEVERITY_SAFE : i % 2 ? SEVERITY_MODERATE : SEVERITY_CRITICAL;
+    s.faultPercent = (i * 379 % 10000) / 100.0f;
+    return s;
+}
+
+static bool run(const char *label, uint32_t messages, uint32_t intervalUs, bool binary)
+{
+    LatencySamples stallUs, hostNs;
+    uint64_t bytes0 = hal_host::serial_bytes(), blocked0 = hal_host::serial_blocked_us();
+    uint32_t dropped0 = binLog.dropped();
+    std::vector<std::string> expected;
+    lines.clear();
+    droppedNoticed = 0;
+    char message[128];
+    for (uint32_t i = 0; i < messages; i++)
+    {
+        hal_host::advance_us(intervalUs);
+        DeviceState s = stateFor(i);
+        writeMessage(message, sizeof(message), s);
+        expected.push_back(message);
+        uint64_t t0 = hal_host::now_us(), n0 = bench_now_ns();
+        if (binary)
+        {
+            binLog.log(s.prediction == PRED_NORMAL ? LOG_STATUS : LOG_FAULT, s.prediction,
+                       uint32_t(s.faultPercent * 100 + 0.5f), s.severity);
+            binLog.drain();
+        }
+        else
+        {
+            writeMessage(message, sizeof(message), s);
+            Serial.println(message);
+        }
+        hostNs.add(bench_now_ns() - n0);
+        stallUs.add(hal_host::now_us() - t0);
+    }
+    for (int i = 0; i < 1000 && binLog.pending(); i++)
+    {
+        hal_host::advance_us(1000);
+        binLog.drain();
+    }
+    // Each record leaves a notice of the ones dropped before it; drops at
+    // the very end have none yet.
+    binLog.log(LOG_BOOT);
+    for (int i = 0; i < 1000 && binLog.pending(); i++)
+    {
+        hal_host::advance_us(1000);
+        binLog.drain();
+    }
+    if (binary && !lines.empty())
+        lines.pop_back();
+
+    uint64_t bytes = hal_host::serial_bytes() - bytes0;
+    uint32_t dropped = binLog.dropped() - dropped0;
+    printf("  %-22s %u every %u us: %llu bytes, %.1f ms blocked, %u dropped\n", label, messages, intervalUs,
+           (unsigned long long)bytes, (hal_host::serial_blocked_us() - blocked0) / 1e3, dropped);
+    stallUs.report("  loop() held up", "us");
+    hostNs.report("  cpu per message", "ns");
+
+    bool ok;
+    if (!binary)
+        ok = true;
+    else if (dropped == 0)
+        ok = lines == expected;
+    else
+    {
+        // What got through must be in order, and the rest noticed.
+        size_t at = 0;
+        for (const std::string &line : lines)
+            while (at < expected.size() && expected[at] != line)
+                at++;
+        ok = at < expected.size() && lines.size() + droppedNoticed == messages && droppedNoticed == dropped;
+    }
+    if (!ok)
+        printf("  MISMATCH: %zu lines decoded, %llu noticed as dropped, %u messages\n", lines.size(),
+               (unsigned long long)droppedNoticed, messages);
+    return ok;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t messages = argc > 1 ? atoi(argv[1]) : 2000;
+    hal_host::on_serial_write(onSerialWrite);
+    Serial.begin(115200);
+    printf("bench_log: 115200 baud, %u-byte ring\n", BINLOG_RING_SIZE);
+    bool ok = run("println", messages, 1000, false);
+    ok = run("binlog", messages, 1000, true) && ok;
+    ok = run("binlog, overloaded", messages, 250, true) && ok;
+
+    // The firmware itself, a minute of track at a 100 us tick.
+    TrackSim track;
+    track.generate(1);
+    hal_host::attach_track(&track, IRL_PIN, IRR_PIN);
+    uint64_t blocked0 = hal_host::serial_blocked_us(), bytes0 = hal_host::serial_bytes();
+    uint32_t records0 = binLog.records(), dropped0 = binLog.dropped();
+    lines.clear();
+    setup();
+    LatencySamples loopUs;
+    for (uint64_t end = hal_host::now_us() + 60000000; hal_host::now_us() < end;)
+    {
+        uint64_t t0 = hal_host::now_us();
+        loop();
+        loopUs.add(hal_host::now_us() - t0);
+        hal_host::advance_us(100);
+    }
+    uint64_t blocked = hal_host::serial_blocked_us() - blocked0;
+    printf("  %-22s 60 s: %u records, %llu bytes, %zu lines decoded, %u dropped, %.1f ms blocked\n", "firmware",
+           binLog.records() - records0, (unsigned long long)(hal_host::serial_bytes() - bytes0), lines.size(),
+           binLog.dropped() - dropped0, blocked / 1e3);
+    loopUs.report("  loop() virtual time", "us");
+    return ok && blocked == 0 ? 0 : 1;
+}
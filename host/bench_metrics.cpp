@@ -0,0 +1,139 @@
+// loop() stage timings from the firmware's own instrumentation, and what the
+// instrumentation itself costs.
+//
+//   bench_metrics [iterations=500000] [port=18190]
+//
+// The firmware runs on the virtual clock over a generated track while a
+// client thread polls /data.json and loads the dashboard; at the end the
+// client fetches /metrics. The exposition must be well formed (cumulative
+// buckets, +Inf equal to _count) and agree with the requests made. Per-stage
+// figures are read back from the same histograms, so a regression in any
+// stage shows here. Exits 1 on a malformed /metrics.
+#include <atomic>
+#include <map>
+#include <sstream>
+#include <thread>
+
+#include "../src/hal.h"
+#include "../src/metrics.h"
+#include "bench.h"
+#include "hal_host.h"
+#include "http_client.h"
+#include "track_sim.h"
+
+void setup();
+void loop();
+
+static std::atomic<bool> trafficDone(false), metricsDone(false);
+static uint32_t requestsMade = 0;
+static std::string metrics;
+
+static void client(uint16_t port)
+{
+    std::string body;
+    for (uint32_t i = 0; !trafficDone; i++)
+    {
+        http_get(port, i % 10 ? "/data.json" : "/", body);
+        requestsMade++;
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    http_get(port, "/metrics", metrics);
+    requestsMade++;
+    metricsDone = true;
+}
+
+// Checks every rail_stage_seconds histogram and returns the counters.
+static bool parseMetrics(const std::string &text, std::map<std::string, double> &values)
+{
+    std::map<std::string, double> lastBucket;
+    std::istringstream lines(text);
+    std::string line;
+    bool ok = true;
+    while (std::getline(lines, line))
+    {
+        if (line.empty() || line[0] == '#')
+            continue;
+        size_t space = line.rfind(' ');
+        std::string key = line.substr(0, space);
+        double value = atof(line.c_str() + space + 1);
+        values[key] = value;
+        if (key.compare(0, 26, "rail_stage_seconds_bucket{") == 0)
+        {
+            std::string stage = key.substr(26, key.find(',') - 26);
+            if (lastBucket.count(stage) && value < lastBucket[stage])
+            {
+                printf("NON-CUMULATIVE bucket: %s\n", line.c_str());
+                ok = false;
+            }
+            lastBucket[stage] = value;
+        }
+    }
+    for (int s = 0; s < STAGE_COUNT; s++)
+    {
+        std::string label = std::string("{stage=\"") + stageNames[s] + "\"";
+        double inf = values[std::string("rail_stage_seconds_bucket") + label + ",le=\"+Inf\"}"];
+        double count = values[std::string("rail_stage_seconds_count") + label + "}"];
+        if (inf != count || !values.count(std::string("rail_stage_seconds_sum") + label + "}"))
+        {
+            printf("BAD histogram for %s: +Inf %g, count %g\n", stageNames[s], inf, count);
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+int main(int argc, char **argv)
+{
+    uint64_t iterations = argc > 1 ? strtoull(argv[1], nullptr, 10) : 500000;
+    uint16_t port = argc > 2 ? atoi(argv[2]) : 18190;
+
+    // Cost of one StageTimer, measured before the firmware records anything.
+    const int TIMERS = 1000000;
+    uint64_t t0 = bench_now_ns();
+    for (int i = 0; i < TIMERS; i++)
+        StageTimer timer(S_SERIAL);
+    double timerNs = double(bench_now_ns() - t0) / TIMERS;
+    stageCycles[S_SERIAL] = CycleHistogram();
+
+    TrackSim track;
+    track.generate(1);
+    hal_host::attach_track(&track, IRL_PIN, IRR_PIN);
+    hal_host::set_http_port(port);
+    setup();
+
+    std::thread traffic(client, port);
+    for (uint64_t i = 0; i < iterations || !metricsDone; i++)
+    {
+        if (i == iterations)
+            trafficDone = true;
+        loop();
+        hal_host::advance_us(100);
+    }
+    traffic.join();
+
+    std::map<std::string, double> values;
+    bool ok = parseMetrics(metrics, values);
+    if (values["rail_http_requests_total"] != requestsMade)
+    {
+        printf("MISMATCH: rail_http_requests_total %g, %u requests made\n", values["rail_http_requests_total"],
+               requestsMade);
+        ok = false;
+    }
+
+    printf("bench_metrics: %llu iterations, %u requests, /metrics %zu B %s\n", (unsigned long long)iterations,
+           requestsMade, metrics.size(), ok ? "well formed" : "MALFORMED");
+    printf("  %-22s %.1f ns per timed scope\n", "StageTimer overhead", timerNs);
+    float cyclesPerUs = ESP.getCpuFreqMHz();
+    for (int s = 0; s < STAGE_COUNT; s++)
+    {
+        const CycleHistogram &h = stageCycles[s];
+        if (!h.count())
+            continue;
+        printf("  %-22s mean %.2f  p50 <= %.1f  p99 <= %.1f us (n=%u)\n", stageNames[s],
+               h.cycles() / cyclesPerUs / h.count(), h.quantile(0.5f) / cyclesPerUs, h.quantile(0.99f) / cyclesPerUs,
+               h.count());
+    }
+    printf("  %-22s faults %g, safety stops %g, free heap %g B\n", "counters", values["rail_faults_total"],
+           values["rail_safety_stops_total"], values["rail_free_heap_bytes"]);
+    return ok ? 0 : 1;
+}
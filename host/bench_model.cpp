@@ -0,0 +1,294 @@
+// Runtime-loadable model images: the exporter's image against the compiled
+// forest, rejection of damaged images, the cost of evaluating in place, and
+// hot swaps over HTTP while the firmware runs.
+//
+//   bench_model [image=railway_fault_window.bin] [uploads=20] [port=18194]
+//
+// The image export_forest.py wrote must pass its checks and give exactly
+// the compiled forest's probabilities on the exporter's check inputs. Every single-bit flip of it must be
+// rejected; random node damage with a fixed-up CRC must be rejected or stay
+// inside the tables. The firmware then runs on the real clock while a
+// client uploads the image and a variant with the classes rotated, in turn,
+// each time checking that /data.json reports the new model's class for the
+// same sensor input. Last, a second store reads the flash region as a
+// reboot would. Exits 1 on any mismatch.
+#include <atomic>
+#include <cmath>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <thread>
+
+#include "../railway_fault_window.h"
+#include "../src/device_state.h"
+#include "../src/features.h"
+#include "../src/model_store.h"
+#include "bench.h"
+#include "hal_host.h"
+#include "http_client.h"
+
+void setup();
+void loop();
+
+#define FEATURES RAILWAY_WINDOW_FEATURES
+#define CLASSES RAILWAY_WINDOW_CLASSES
+#define INPUTS RAILWAY_WINDOW_CHECK_COUNT
+
+typedef Forest<FEATURES, CLASSES> RailwayForest;
+
+static void input(uint32_t in, float *x)
+{
+    memcpy(x, RAILWAY_WINDOW_CHECK_INPUTS + in % INPUTS * FEATURES, FEATURES * sizeof(float));
+}
+
+static void fixCrc(std::string &image)
+{
+    ModelHeader &h = *(ModelHeader *)&image[0];
+    uint32_t crc = crc32(image.data(), offsetof(ModelHeader, crc));
+    h.crc = crc32(image.data() + sizeof(ModelHeader), h.size - sizeof(ModelHeader), crc);
+}
+
+// The image with every leaf row moved to the next class, so it predicts
+// (c + 1) % CLASSES wherever the original predicts c.
+static std::string rotated(const std::string &image)
+{
+    std::string out = image;
+    const ModelHeader &h = *(const ModelHeader *)out.data();
+    uint16_t *proba = (uint16_t *)&out[modelLayout(h).proba];
+    for (uint16_t r = 0; r < h.leafRows; r++)
+    {
+        uint16_t row[CLASSES];
+        for (int c = 0; c < CLASSES; c++)
+            row[(c + 1) % CLASSES] = proba[r * CLASSES + c];
+        memcpy(proba + r * CLASSES, row, sizeof(row));
+    }
+    fixCrc(out);
+    return out;
+}
+
+static bool sameAsCompiled(const uint8_t *image)
+{
+    RailwayForest loaded = forestFromImage<FEATURES, CLASSES>(image);
+    for (uint32_t in = 0; in < INPUTS; in++)
+    {
+        float x[FEATURES], a[CLASSES], b[CLASSES];
+        input(in, x);
+        railwayWindow.predictProba(x, a);
+        loaded.predictProba(x, b);
+        if (memcmp(a, b, sizeof(a)))
+            return false;
+    }
+    return true;
+}
+
+static bool damageTest(const std::string &image)
+{
+    std::string copy = image;
+    uint32_t flips = 0, caught = 0;
+    for (size_t bit = 0; bit < copy.size() * 8; bit++)
+    {
+        copy[bit / 8] ^= 1 << (bit % 8);
+        flips++;
+        caught += checkModelImage((const uint8_t *)copy.data(), copy.size(), FEATURES, CLASSES) != MODEL_OK;
+        copy[bit / 8] ^= 1 << (bit % 8);
+    }
+
+    // Damage that the CRC cannot see: a node table written wrong before it
+    // was checksummed.
+    std::mt19937 rng(1);
+    const ModelHeader &h = *(const ModelHeader *)image.data();
+    ModelLayout l = modelLayout(h);
+    uint32_t trials = 20000, accepted = 0, reasons[MODEL_ERROR_COUNT] = {};
+    for (uint32_t i = 0; i < trials; i++)
+    {
+        copy = image;
+        uint32_t at = l.roots + rng() % (l.end - l.roots);
+        copy[at] = char(rng());
+        fixCrc(copy);
+        ModelError e = checkModelImage((const uint8_t *)copy.data(), copy.size(), FEATURES, CLASSES);
+        reasons[e]++;
+        if (e != MODEL_OK)
+            continue;
+        // Accepted: every walk must end on a leaf row inside the table.
+        accepted++;
+        RailwayForest forest = forestFromImage<FEATURES, CLASSES>((const uint8_t *)copy.data());
+        for (uint32_t in = 0; in < INPUTS; in++)
+        {
+            float x[FEATURES], proba[CLASSES];
+            input(in, x);
+            forest.predictProba(x, proba);
+        }
+    }
+
+    bool ok = caught == flips;
+    printf("  %-22s %u/%u single-bit flips rejected\n", "damaged images", caught, flips);
+    printf("  %-22s %u random node edits: %u accepted (still in bounds), %u bad node, %u wrong shape\n", "", trials,
+           accepted, reasons[MODEL_BAD_NODE], reasons[MODEL_WRONG_SHAPE]);
+    return ok;
+}
+
+static volatile float sink;
+
+template <typename Predict>
+static void timePredictions(const char *label, Predict predict)
+{
+    LatencySamples batches;
+    const uint32_t BATCH = 1000;
+    float sum = 0;
+    for (uint32_t i = 0; i < 2000; i++)
+    {
+        uint64_t start = bench_now_ns();
+        for (uint32_t j = 0; j < BATCH; j++)
+        {
+            float x[FEATURES], proba[CLASSES];
+            input(j * 2654435761u >> 28, x);
+            sum += predict(x, proba);
+        }
+        batches.add(bench_now_ns() - start);
+    }
+    sink = sum;
+    batches.report(label, "ns/call", BATCH);
+}
+
+static std::atomic<bool> clientDone(false);
+static std::atomic<uint32_t> failures(0), busyRetries(0);
+static LatencySamples uploadNs, swapNs;
+
+static std::string aiStatus(uint16_t port)
+{
+    std::string body;
+    http_get(port, "/data.json", body);
+    return json_value(body, "ai_status");
+}
+
+// Uploads the images in turn. A swap counts once /model reports it and the
+// save to flash is done, so the next upload is taken.
+static void uploader(uint16_t port, const std::string *images, uint32_t uploads, uint32_t in)
+{
+    std::string body;
+    for (uint32_t i = 0; i < uploads; i++)
+    {
+        const std::string &image = images[i % 2];
+        uint32_t swaps = i + 1;
+        uint64_t t0 = bench_now_ns();
+        int status;
+        while ((status = http_post(port, "/model", image, body)) == 503)
+            busyRetries++;
+        uint64_t t1 = bench_now_ns();
+        if (status != 200)
+        {
+            printf("upload %u: HTTP %d %s\n", i, status, body.c_str());
+            failures++;
+            break;
+        }
+        while (strtoul(json_value(body, "swaps").c_str(), nullptr, 10) < swaps || json_value(body, "pending") != "0")
+            http_get(port, "/model", body);
+        uploadNs.add(t1 - t0);
+        swapNs.add(bench_now_ns() - t1);
+
+        // The state was classified again with the new model: the pins have
+        // held for longer than any run the forest looks at.
+        SensorWindow<FEATURE_WINDOW> window;
+        window.begin(0, in & 1, in >> 1);
+        window.advanceTo(10000000);
+        float x[FEATURES], proba[CLASSES];
+        window.extract(x);
+        int expected = railwayWindow.predict(x, proba);
+        if (i % 2 == 0)
+            expected = (expected + 1) % CLASSES;
+        std::string shown = aiStatus(port);
+        if (shown != predictionName(Prediction(expected)))
+        {
+            printf("upload %u: ai_status %s, expected %s\n", i, shown.c_str(), predictionName(Prediction(expected)));
+            failures++;
+        }
+    }
+
+    // Images the firmware must turn away, leaving the model alone.
+    std::string bad = images[0];
+    bad[bad.size() - 1] ^= 1;
+    std::string big(MODEL_IMAGE_MAX + 4, '\0');
+    if (http_post(port, "/model", bad, body) != 400 || http_post(port, "/model", images[0].substr(0, 40), body) != 400 ||
+        http_post(port, "/model", big, body) != 413)
+    {
+        printf("a damaged upload was not refused\n");
+        failures++;
+    }
+    clientDone = true;
+}
+
+int main(int argc, char **argv)
+{
+    const char *path = argc > 1 ? argv[1] : "railway_fault_window.bin";
+    uint32_t uploads = argc > 2 ? atoi(argv[2]) : 20;
+    uint16_t port = argc > 3 ? atoi(argv[3]) : 18194;
+
+    std::ifstream file(path, std::ios::binary);
+    std::string image((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    // Keep the image word-aligned, as the firmware's buffers are.
+    std::vector<uint32_t> aligned((image.size() + 3) / 4);
+    memcpy(aligned.data(), image.data(), image.size());
+    const uint8_t *bytes = (const uint8_t *)aligned.data();
+    ModelError e = checkModelImage(bytes, image.size(), FEATURES, CLASSES);
+    bool ok = e == MODEL_OK && sameAsCompiled(bytes);
+    const ModelHeader &h = *(const ModelHeader *)bytes;
+    printf("bench_model: %s, %zu bytes, %s\n", path, image.size(),
+           e != MODEL_OK ? modelErrorName(e) : ok ? "matches the compiled forest" : "MISMATCH");
+    if (e != MODEL_OK)
+        return 1;
+    printf("  %-22s id %08x, %u trees (%u distinct), %u split nodes, %u leaf rows\n", "image", h.modelId,
+           h.weightSum, h.trees, h.nodes, h.leafRows);
+    ok = damageTest(image) && ok;
+
+    RailwayForest loaded = forestFromImage<FEATURES, CLASSES>(bytes);
+    timePredictions("compiled forest", [](const float *x, float *p) { return railwayWindow.predict(x, p); });
+    timePredictions("image, in place", [&](const float *x, float *p) { return loaded.predict(x, p); });
+    LatencySamples checkNs;
+    for (int i = 0; i < 10000; i++)
+    {
+        uint64_t t0 = bench_now_ns();
+        sink = checkModelImage(bytes, image.size(), FEATURES, CLASSES);
+        checkNs.add(bench_now_ns() - t0);
+    }
+    checkNs.report("checkModelImage", "us", 1e3);
+
+    // Hot swaps on the running firmware, with one sensor blocked.
+    uint32_t in = 1;
+    hal_host::set_input(IRL_PIN, in & 1);
+    hal_host::set_input(IRR_PIN, (in >> 1) & 1);
+    hal_host::set_realtime(true);
+    hal_host::set_http_port(port);
+    setup();
+    for (uint64_t t0 = bench_now_ns(); bench_now_ns() - t0 < 2000000000ull;)
+        loop();
+    hal_host::flash_reset_stats();
+
+    std::string images[2] = {rotated(image), image};
+    std::thread client(uploader, port, images, uploads, in);
+    LatencySamples loopNs;
+    loopNs.reserve(1 << 24);
+    while (!clientDone)
+    {
+        uint64_t t0 = bench_now_ns();
+        loop();
+        loopNs.add(bench_now_ns() - t0);
+    }
+    client.join();
+    hal_host::FlashStats flash = hal_host::flash_stats();
+
+    printf("  %-22s %u uploads, %u failed, %u refused as busy and retried\n", "hot swap", uploads, failures.load(),
+           busyRetries.load());
+    uploadNs.report("upload round trip", "ms", 1e6);
+    swapNs.report("until swapped, saved", "ms", 1e6);
+    loopNs.report("loop() call", "us", 1e3);
+    printf("  %-22s %lu erases, %lu page writes, %.1f ms of flash time on the board\n", "saving", (unsigned long)flash.erases,
+           (unsigned long)flash.writes, flash.busyUs / 1e3);
+
+    // What the next boot finds.
+    ModelStore reboot(FS_PHYS_ADDR + 8 * FLASH_SECTOR_SIZE, FEATURES, CLASSES);
+    const std::string &last = images[(uploads - 1) % 2];
+    bool restored = reboot.begin() && reboot.swap() && reboot.generation() == uploads &&
+                    !memcmp(reboot.active(), last.data(), last.size());
+    printf("  %-22s %s\n", "after a reboot", restored ? "last upload restored from flash" : "FAILED to restore");
+    return ok && restored && !failures ? 0 : 1;
+}
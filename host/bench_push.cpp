@@ -0,0 +1,153 @@
+// Fault-to-dashboard latency: a client on /events (push) against clients
+// polling /data.json every DRT = 500 ms the way the page used to. The
+// firmware runs on the realtime clock and serves a local port; latency is
+// measured from the moment the prediction flips the buzzer to the moment
+// each client sees ai_status change.
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+#include "../src/hal.h"
+#include "bench.h"
+#include "hal_host.h"
+#include "http_client.h"
+
+void setup();
+void loop();
+
+static std::atomic<bool> done(false);
+static std::mutex mutex;
+static std::vector<uint64_t> changes, pushSeen;
+
+// Pollers start at evenly spread offsets inside one DRT period, since a real
+// dashboard's phase against the prediction tick is arbitrary.
+#define POLLERS 4
+static std::vector<uint64_t> pollSeen[POLLERS];
+static int buzzer = LOW;
+
+static void onPinWrite(uint8_t pin, int level, uint64_t)
+{
+    if (pin != BUZZER_PIN || level == buzzer)
+        return;
+    buzzer = level;
+    std::lock_guard<std::mutex> lock(mutex);
+    changes.push_back(bench_now_ns());
+}
+
+// Records the time of every ai_status change after the first one seen.
+static void observe(std::string &last, const std::string &doc, std::vector<uint64_t> &seen)
+{
+    std::string status = json_value(doc, "ai_status");
+    if (status.empty() || status == last)
+        return;
+    uint64_t now = bench_now_ns();
+    if (!last.empty())
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        seen.push_back(now);
+    }
+    last = status;
+}
+
+static void pushClient(uint16_t port)
+{
+    int fd = http_connect(port);
+    if (fd < 0 || !http_send_get(fd, "/events"))
+        return;
+    timeval timeout = {0, 200000};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    std::string stream, last;
+    char buf[2048];
+    while (!done)
+    {
+        ssize_t n = recv(fd, buf, sizeof(buf), 0);
+        if (n == 0)
+            break;
+        if (n < 0)
+            continue;
+        stream.append(buf, n);
+        size_t end;
+        while ((end = stream.find("\n\n")) != std::string::npos)
+        {
+            size_t data = stream.find("data: ");
+            if (data != std::string::npos && data < end)
+                observe(last, stream.substr(data + 6, end - data - 6), pushSeen);
+            stream.erase(0, end + 2);
+        }
+    }
+    close(fd);
+}
+
+static void pollClient(uint16_t port, int index)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(500 * index / POLLERS));
+    std::string epoch = "0", seq = "0", last, body;
+    while (!done)
+    {
+        std::string target = "/data.json?epoch=" + epoch + "&since=" + seq;
+        if (http_get(port, target.c_str(), body) == 200)
+        {
+            epoch = json_value(body, "epoch");
+            seq = json_value(body, "seq");
+            observe(last, body, pollSeen[index]);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(500)); // DRT
+    }
+}
+
+static void collect(LatencySamples &latency, const std::vector<uint64_t> &seen)
+{
+    for (size_t i = 0; i < seen.size() && i < changes.size(); i++)
+        latency.add(seen[i] - changes[i]);
+}
+
+int main(int argc, char **argv)
+{
+    int faults = argc > 1 ? atoi(argv[1]) : 8;
+    uint16_t port = argc > 2 ? atoi(argv[2]) : 18180;
+
+    hal_host::set_realtime(true);
+    hal_host::set_http_port(port);
+    hal_host::on_pin_write(onPinWrite);
+    setup();
+
+    std::thread push(pushClient, port);
+    std::thread poll[POLLERS];
+    for (int i = 0; i < POLLERS; i++)
+        poll[i] = std::thread(pollClient, port, i);
+
+    // Alternate Break and clear track every 1.5 s so each state is seen by a
+    // prediction tick and by at least one poll.
+    uint64_t start = bench_now_ns() + 2000000000ULL;
+    int transitions = 0;
+    while (transitions <= faults * 2)
+    {
+        uint64_t now = bench_now_ns();
+        if (now >= start + transitions * 1500000000ULL)
+        {
+            int level = transitions < faults * 2 && transitions % 2 == 0 ? HIGH : LOW;
+            hal_host::set_input(IRL_PIN, level);
+            hal_host::set_input(IRR_PIN, level);
+            transitions++;
+        }
+        loop();
+        // Leave the client threads some CPU on small machines, roughly what
+        // the ESP8266 core's yield between loop() calls does.
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+    done = true;
+    push.join();
+    LatencySamples pushed, polled;
+    collect(pushed, pushSeen);
+    for (int i = 0; i < POLLERS; i++)
+    {
+        poll[i].join();
+        collect(polled, pollSeen[i]);
+    }
+
+    printf("bench_push: %d faults, %zu state changes\n", faults, changes.size());
+    pushed.report("push (/events)", "ms", 1e6);
+    polled.report("poll (500 ms)", "ms", 1e6);
+    return 0;
+}
@@ -0,0 +1,287 @@
+// Record and replay: a generated track run with button presses and a model
+// upload is recorded, replayed through a fresh firmware and must drive the
+// same outputs at the same instants; the same trace with one press changed
+// must be caught; a request record with an overlong path must count as
+// damage; and a dense synthetic trace measures how fast inputs are fed
+// through loop().
+//
+//   bench_replay [seconds=60] [seed=3] [image=railway_fault_window.bin]
+//
+// setup() runs once per process, so each run is a forked child. Exits 1 if
+// the exact replay diverges, the changed one does not or the damaged record
+// is read.
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cstdlib>
+#include <cstring>
+
+#include "../src/hal.h"
+#include "../src/model_store.h"
+#include "../src/trace.h"
+#include "bench.h"
+#include "hal_host.h"
+#include "trace_replay.h"
+#include "track_sim.h"
+
+void setup();
+void loop();
+void pressButton(uint8_t button);
+extern TraceRecorder traceRecorder;
+extern ModelStore modelStore;
+
+static std::vector<uint8_t> rewritten;
+
+static void appendBlock(const uint8_t *block, size_t size) { rewritten.insert(rewritten.end(), block, block + size); }
+
+// Decodes the trace and encodes it again with a fresh recorder, letting
+// change() edit records on the way.
+template <typename Change>
+static std::vector<uint8_t> rewrite(const std::vector<uint8_t> &trace, Change change)
+{
+    TraceReader reader;
+    TraceBlockHeader block;
+    TraceRecord r;
+    reader.begin(trace.data(), trace.size());
+    const TraceHeader h = reader.header();
+    TraceRecorder recorder;
+    rewritten.clear();
+    recorder.setSink(appendBlock);
+    bool begun = false;
+    while (reader.nextBlock(block))
+    {
+        if (!begun)
+            recorder.begin(h.startUs, block.pair, block.outputs, block.prediction, h.modelId);
+        begun = true;
+        while (reader.next(r))
+        {
+            change(r);
+            uint32_t t = uint32_t(r.t_us);
+            if (r.type == TR_SENSOR)
+                recorder.sensor(t, r.arg);
+            else if (r.type == TR_RESYNC)
+                recorder.resync(t, r.arg);
+            else if (r.type == TR_ACTION)
+                recorder.action(t, r.arg);
+            else if (r.type == TR_REQUEST)
+                recorder.request(t, r.method, r.path);
+            else if (r.type == TR_MODEL)
+                recorder.model(t, r.arg, r.modelId);
+            else if (r.type == TR_OUTPUT)
+                recorder.outputs(t, r.arg, r.prediction);
+        }
+    }
+    recorder.flush();
+    std::vector<uint8_t> out((const uint8_t *)&h, (const uint8_t *)&h + sizeof(h));
+    out.insert(out.end(), rewritten.begin(), rewritten.end());
+    return out;
+}
+
+template <typename Run>
+static int inChild(Run run)
+{
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+        int code = run();
+        fflush(stdout);
+        _exit(code);
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+    return WIFEXITED(status) ? WEXITSTATUS(status) : 1;
+}
+
+static bool writeAll(FILE *file, const std::vector<uint8_t> &bytes)
+{
+    return fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size() && fflush(file) == 0;
+}
+
+static std::vector<uint8_t> readAll(FILE *file)
+{
+    std::vector<uint8_t> bytes;
+    rewind(file);
+    uint8_t chunk[4096];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0)
+        bytes.insert(bytes.end(), chunk, chunk + n);
+    return bytes;
+}
+
+// A run on the generated track: stop and restart, back up, and hot-swap a
+// model halfway, the way the dashboard would.
+static int record(FILE *out, uint32_t seconds, uint32_t seed, const std::string &image)
+{
+    TrackSim track;
+    track.generate(seed);
+    hal_host::attach_track(&track, IRL_PIN, IRR_PIN);
+    std::vector<uint8_t> trace;
+    recordTrace(&trace);
+    setup();
+    uint64_t start = hal_host::now_us();
+    const uint64_t tickUs = 100, presses[][2] = {{7, 2}, {9, 1}, {23, 3}, {24, 2}, {26, 1}};
+    size_t press = 0;
+    bool uploaded = image.empty();
+    for (uint64_t t = 0; t < seconds * 1000000ull; t += tickUs)
+    {
+        loop();
+        hal_host::advance_us(tickUs);
+        uint64_t at = hal_host::now_us() - start;
+        if (press < sizeof(presses) / sizeof(presses[0]) && at >= presses[press][0] * 1000000)
+            pressButton(presses[press++][1]);
+        if (!uploaded && at >= seconds * 500000ull)
+        {
+            uploaded = true;
+            if (modelStore.beginUpload(image.size()) == MODEL_OK &&
+                modelStore.writeUpload((const uint8_t *)image.data(), image.size(), 0) == MODEL_OK &&
+                modelStore.endUpload() == MODEL_OK)
+                traceRecorder.model(micros(), MODEL_UPLOAD, modelStore.stagedHeader()->modelId);
+        }
+    }
+    finishTrace();
+    return writeAll(out, trace) ? 0 : 1;
+}
+
+static void print(const char *label, const ReplayReport &report, bool checked)
+{
+    uint64_t events = report.edges + report.actions + report.requests + report.models;
+    printf("  %-22s %.1f s of trace in %.3f s wall (%.0fx): %llu inputs (%.2fM/s), %llu loop() calls\n", label,
+           report.virtualUs / 1e6, report.wallS, report.virtualUs / 1e6 / report.wallS, (unsigned long long)events,
+           events / report.wallS / 1e6, (unsigned long long)report.loops);
+    if (checked)
+        printf("  %-22s %llu of %llu outputs matched, %llu driven%s%s\n", "", (unsigned long long)report.matched,
+               (unsigned long long)report.expected, (unsigned long long)report.produced,
+               report.divergence.empty() ? "" : "; diverged: ", report.divergence.c_str());
+}
+
+static int replay(const char *label, const std::vector<uint8_t> &trace, const ReplayOptions &options, bool expectMatch,
+                  bool checked = true)
+{
+    ReplayReport report;
+    if (!replayTrace(trace, options, report))
+    {
+        printf("  %-22s unreadable trace\n", label);
+        return 1;
+    }
+    print(label, report, checked);
+    bool matched = report.divergence.empty() && report.matched == report.expected && report.expected > 0;
+    return matched == expectMatch ? 0 : 1;
+}
+
+// One block whose only record is a request claiming a 200-byte path; the
+// reader must drop the block rather than copy the path out.
+static bool damagedRequest()
+{
+    TraceHeader h = {TRACE_MAGIC, TRACE_VERSION, sizeof(TraceHeader), TRACE_BLOCK_SIZE, 0, 0, 0};
+    TraceBlockHeader b = {};
+    b.used = TRACE_BLOCK_SIZE;
+    b.records = 1;
+    std::vector<uint8_t> trace(sizeof(h) + TRACE_BLOCK_SIZE, 'x');
+    memcpy(trace.data(), &h, sizeof(h));
+    memcpy(trace.data() + sizeof(h), &b, sizeof(b));
+    uint8_t *p = trace.data() + sizeof(h) + sizeof(b);
+    p[0] = TR_REQUEST << 4 | TRACE_GET;
+    p[1] = 0; // delta
+    p[2] = TRACE_GET;
+    p[3] = 200;
+
+    TraceReader reader;
+    TraceBlockHeader block;
+    TraceRecord r;
+    uint32_t records = 0;
+    reader.begin(trace.data(), trace.size());
+    while (reader.nextBlock(block))
+        while (reader.next(r))
+            records++;
+    bool ok = records == 0 && reader.damaged() == 1;
+    printf("  %-22s %u records read, %u blocks damaged: %s\n", "200-byte request path", records, reader.damaged(),
+           ok ? "rejected" : "ACCEPTED");
+    return ok;
+}
+
+// Edges every 25 us on average, as fast as the sensors could chatter, with
+// no outputs to check: the cost of feeding inputs through loop().
+static std::vector<uint8_t> denseTrace(uint32_t seconds)
+{
+    TraceRecorder recorder;
+    rewritten.clear();
+    recorder.setSink(appendBlock);
+    recorder.begin(0, 0, 0, 0, 0);
+    uint32_t rng = 1;
+    uint8_t pair = 0;
+    for (uint32_t t = 1000; t < seconds * 1000000u;)
+    {
+        rng = rng * 1664525u + 1013904223u;
+        t += 1 + (rng >> 24) % 49;
+        pair ^= 1 + (rng >> 8 & 1);
+        recorder.sensor(t, pair);
+    }
+    recorder.flush();
+    const TraceHeader &h = recorder.header();
+    std::vector<uint8_t> out((const uint8_t *)&h, (const uint8_t *)&h + sizeof(h));
+    out.insert(out.end(), rewritten.begin(), rewritten.end());
+    return out;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t seconds = argc > 1 ? atoi(argv[1]) : 60;
+    uint32_t seed = argc > 2 ? atoi(argv[2]) : 3;
+    const char *imagePath = argc > 3 ? argv[3] : "railway_fault_window.bin";
+    std::vector<uint8_t> bytes;
+    std::string image;
+    if (readTraceFile(imagePath, bytes))
+        image.assign(bytes.begin(), bytes.end());
+
+    FILE *file = tmpfile();
+    if (!file || inChild([&]() { return record(file, seconds, seed, image); }))
+    {
+        printf("bench_replay: recording failed\n");
+        return 1;
+    }
+    std::vector<uint8_t> trace = readAll(file);
+    fclose(file);
+    TraceReader reader;
+    TraceBlockHeader block;
+    TraceRecord r;
+    uint32_t blocks = 0, records = 0, types[TR_TYPE_COUNT] = {};
+    reader.begin(trace.data(), trace.size());
+    for (; reader.nextBlock(block); blocks++)
+        for (; reader.next(r); records++)
+            types[r.type]++;
+    printf("bench_replay: %u s of track (seed %u), %zu-byte trace, %u blocks, %u records (%.1f bytes each)\n", seconds,
+           seed, trace.size(), blocks, records, double(trace.size()) / records);
+    printf("  %-22s %u sensor, %u resync, %u action, %u model, %u output\n", "records", types[TR_SENSOR],
+           types[TR_RESYNC], types[TR_ACTION], types[TR_MODEL], types[TR_OUTPUT]);
+
+    bool ok = reader.damaged() == 0 && reader.gaps() == 0 && rewrite(trace, [](TraceRecord &) {}) == trace;
+    printf("  %-22s %s\n", "decode, encode again", ok ? "identical" : "DIFFERS");
+
+    ReplayOptions options;
+    options.toleranceUs = 0;
+    if (!image.empty())
+        options.images.push_back(imagePath);
+    ok = !inChild([&]() { return replay("exact replay", trace, options, true); }) && ok;
+
+    // The first stop press made a back press.
+    bool changed = false;
+    std::vector<uint8_t> mutated = rewrite(trace, [&](TraceRecord &r) {
+        if (r.type == TR_ACTION && r.arg == 2 && !changed)
+        {
+            r.arg = 3;
+            changed = true;
+        }
+    });
+    ok = changed && !inChild([&]() { return replay("stop made back", mutated, options, false); }) && ok;
+    ok = damagedRequest() && ok;
+
+    std::vector<uint8_t> dense = denseTrace(seconds / 6);
+    ReplayOptions fast;
+    fast.tickUs = 1000;
+    inChild([&]() {
+        replay("dense edges, 1 ms tick", dense, fast, false, false);
+        return 0;
+    });
+    return ok ? 0 : 1;
+}
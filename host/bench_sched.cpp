@@ -0,0 +1,210 @@
+// Task timing under the cooperative scheduler: jitter, overruns and skipped
+// periods, idle and with HTTP clients, and correctness across the clock wrap.
+//
+//   bench_sched [seconds=2] [clients=10] [port=18192]
+//
+// First a standalone scheduler runs on the virtual clock across the instant
+// where millis() and micros() both wrap (2^32 ms of uptime), stepping 100 us
+// per run(); every task must run exactly as often as its period says. The
+// millis() check loop() used before, "stamp + period < millis()", is run over
+// the same window for comparison. Then the firmware runs on the real clock,
+// first idle and then while the clients hammer the dashboard and /data.json,
+// and the per-task figures are read back from /metrics. Exits 1 if a task
+// runs the wrong number of times across the wrap.
+#include <atomic>
+#include <map>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "../src/scheduler.h"
+#include "bench.h"
+#include "hal_host.h"
+#include "http_client.h"
+
+void setup();
+void loop();
+
+#define WRAP_TASKS 4
+
+static Scheduler<WRAP_TASKS> wheel;
+static uint32_t fastRuns, oddRuns, slowRuns, shotRuns;
+static int shotTask;
+
+static void fastTask()
+{
+    if (++fastRuns % 50 == 1)
+        wheel.arm(shotTask, 3);
+}
+static void oddTask() { oddRuns++; }
+static void slowTask() { slowRuns++; }
+static void shotTaskFn() { shotRuns++; }
+
+static bool near(uint32_t value, uint32_t expected) { return value + 1 >= expected && value <= expected + 1; }
+
+static bool wrapTest(uint32_t seconds)
+{
+    const uint64_t STEP_US = 100;
+    // Start seconds / 2 before millis() wraps; micros() wraps there too.
+    uint64_t wrapUs = (uint64_t(1) << 32) * 1000;
+    hal_host::advance_us(wrapUs - seconds * 500000ull - hal_host::now_us());
+
+    // Same window, the old check.
+    uint32_t stamp = millis(), oldFires = 0;
+    for (uint64_t t = 0; t < seconds * 1000000ull; t += STEP_US)
+    {
+        uint32_t now = uint32_t(millis());
+        if (stamp + 500 < now)
+        {
+            stamp = now;
+            oldFires++;
+        }
+        hal_host::advance_us(STEP_US);
+    }
+    hal_host::advance_us(wrapUs - seconds * 500000ull - hal_host::now_us());
+
+    wheel.every("fast", 1, 0, fastTask);
+    wheel.every("odd", 7, 1, oddTask);
+    wheel.every("slow", 500, 2, slowTask);
+    shotTask = wheel.oneShot("shot", 3, shotTaskFn);
+    for (uint64_t t = 0; t <= seconds * 1000000ull; t += STEP_US)
+    {
+        wheel.run();
+        hal_host::advance_us(STEP_US);
+    }
+
+    // The one-shot is armed on fast runs 1, 51, 101, ... and fires 3 ms later.
+    uint32_t ms = seconds * 1000;
+    uint32_t shots = (ms - 3) / 50 + 1;
+    bool ok = near(fastRuns, ms + 1) && near(oddRuns, ms / 7 + 1) && near(slowRuns, ms / 500 + 1) &&
+              shotRuns == shots;
+    uint32_t maxLate = 0, skipped = 0, overruns = 0;
+    for (int id = 0; id < wheel.count(); id++)
+    {
+        const TaskStats &s = wheel.stats(id);
+        maxLate = s.maxLateUs > maxLate ? s.maxLateUs : maxLate;
+        skipped += s.skipped;
+        overruns += s.overruns;
+    }
+    ok = ok && maxLate < STEP_US && !skipped && !overruns;
+
+    printf("bench_sched: %u s across the millis()/micros() wrap, %s\n", seconds, ok ? "run counts exact" : "FAILED");
+    printf("  %-22s fast %u/%u  odd %u/%u  slow %u/%u  one-shot %u/%u, max lateness %u us\n", "scheduler runs",
+           fastRuns, ms + 1, oddRuns, ms / 7 + 1, slowRuns, ms / 500 + 1, shotRuns, shots, maxLate);
+    printf("  %-22s %u fires, expected %u\n", "stamp + 500 < millis()", oldFires, ms / 500);
+    return ok;
+}
+
+struct TaskFigures
+{
+    double runs, lateSum, lateMax, overruns, skipped;
+};
+
+static std::atomic<bool> stopClients(false);
+
+static void client(uint16_t port, int n)
+{
+    std::string body;
+    for (uint32_t i = n; !stopClients; i++)
+    {
+        http_get(port, i % 10 ? "/data.json" : "/", body);
+    }
+}
+
+static std::map<std::string, TaskFigures> parseTasks(const std::string &text, double &requests)
+{
+    std::map<std::string, TaskFigures> tasks;
+    std::istringstream lines(text);
+    std::string line;
+    while (std::getline(lines, line))
+    {
+        if (line.compare(0, 25, "rail_http_requests_total ") == 0)
+            requests = atof(line.c_str() + 25);
+        size_t open = line.find("{task=\"");
+        if (line[0] == '#' || open == std::string::npos)
+            continue;
+        std::string metric = line.substr(0, open);
+        std::string task = line.substr(open + 7, line.find('"', open + 7) - open - 7);
+        double value = atof(line.c_str() + line.rfind(' ') + 1);
+        TaskFigures &f = tasks[task];
+        if (metric == "rail_task_runs_total")
+            f.runs = value;
+        else if (metric == "rail_task_lateness_seconds_sum")
+            f.lateSum = value;
+        else if (metric == "rail_task_lateness_seconds_max")
+            f.lateMax = value;
+        else if (metric == "rail_task_overruns_total")
+            f.overruns = value;
+        else if (metric == "rail_task_skipped_total")
+            f.skipped = value;
+    }
+    return tasks;
+}
+
+// Runs loop() for the phase, then until a fetch of /metrics completes.
+static std::map<std::string, TaskFigures> runPhase(uint16_t port, uint32_t seconds, double &requests)
+{
+    uint64_t end = hal_host::now_us() + seconds * 1000000ull;
+    while (hal_host::now_us() < end)
+        loop();
+    std::atomic<bool> done(false);
+    std::string text;
+    std::thread fetch([&] {
+        http_get(port, "/metrics", text);
+        done = true;
+    });
+    while (!done)
+        loop();
+    fetch.join();
+    return parseTasks(text, requests);
+}
+
+static void report(const char *label, std::map<std::string, TaskFigures> &before,
+                   std::map<std::string, TaskFigures> &after)
+{
+    printf("  %s\n", label);
+    for (auto &entry : after)
+    {
+        TaskFigures &a = entry.second, &b = before[entry.first];
+        double runs = a.runs - b.runs;
+        printf("    %-20s %7.0f runs  lateness mean %7.1f us, max so far %7.1f us  %4.0f overruns  %4.0f skipped\n",
+               entry.first.c_str(), runs, runs ? (a.lateSum - b.lateSum) / runs * 1e6 : 0.0, a.lateMax * 1e6,
+               a.overruns - b.overruns, a.skipped - b.skipped);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t seconds = argc > 1 ? atoi(argv[1]) : 2;
+    int clients = argc > 2 ? atoi(argv[2]) : 10;
+    uint16_t port = argc > 3 ? atoi(argv[3]) : 18192;
+
+    bool ok = wrapTest(10);
+
+    hal_host::set_realtime(true);
+    hal_host::set_http_port(port);
+    setup();
+
+    double requests0 = 0, requests1 = 0, requests2 = 0;
+    std::map<std::string, TaskFigures> start = runPhase(port, 0, requests0);
+    std::map<std::string, TaskFigures> idle = runPhase(port, seconds, requests1);
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < clients; i++)
+        threads.emplace_back(client, port, i);
+    std::map<std::string, TaskFigures> loaded = runPhase(port, seconds, requests2);
+    stopClients = true;
+    // Let the clients' last requests through.
+    uint64_t drain = hal_host::now_us() + 200000;
+    while (hal_host::now_us() < drain)
+        loop();
+    for (std::thread &t : threads)
+        t.join();
+
+    printf("  firmware tasks on the real clock, %u s per phase\n", seconds);
+    report("idle", start, idle);
+    char label[64];
+    snprintf(label, sizeof(label), "%d clients, %.0f requests served", clients, requests2 - requests1 - 1);
+    report(label, idle, loaded);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,177 @@
+// Multi-station classification (src/stations.h): stations per microsecond
+// for the bit-parallel classify() at a few array sizes, against a per-pair
+// predict() loop over the same readings, then the firmware itself scanning
+// its shift-register chain on the virtual clock, and the chain flapping
+// while the track drives faults.
+//
+//   bench_stations [rounds=2000] [seconds=30]
+//
+// Every station's class must match the per-pair loop, and the firmware must
+// report exactly the stations broken on its chain. With the chain flapping,
+// a station chattering faster than the hold must never count and no event
+// log record may be dropped. Exits 1 otherwise.
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "../railway_fault_tree.h"
+#include "../src/event_log.h"
+#include "../src/hal.h"
+#include "../src/stations.h"
+#include "bench.h"
+#include "hal_host.h"
+#include "track_sim.h"
+
+void setup();
+void loop();
+#define STATION_HOLD_SCANS 5 // x.cpp's
+extern StationArray<STATION_COUNT, STATION_HOLD_SCANS> stations;
+extern EventLog eventLog;
+
+static const TreeTable<RAILWAY_FAULT_FEATURES, RAILWAY_FAULT_CLASSES> table(RAILWAY_FAULT_TREE);
+static volatile int sink;
+
+template <int N>
+static bool measure(int rounds)
+{
+    static StationArray<N> array;
+    std::mt19937 rng(N);
+    std::vector<uint8_t> l(N), r(N), classes(N);
+    // Mostly clear, as a real stretch of track is.
+    for (int s = 0; s < N; s++)
+    {
+        l[s] = rng() % 8 == 0;
+        r[s] = rng() % 8 == 0;
+        array.set(s, l[s], r[s]);
+    }
+    array.begin(table, STATION_LOAD_PIN, STATION_CLOCK_PIN, STATION_DATA_PIN);
+
+    uint64_t t0 = bench_now_ns();
+    for (int i = 0; i < rounds; i++)
+        sink = array.classify(i);
+    double bitUs = (bench_now_ns() - t0) / 1e3;
+
+    t0 = bench_now_ns();
+    for (int i = 0; i < rounds; i++)
+    {
+        for (int s = 0; s < N; s++)
+            classes[s] = table.predict(uint32_t(l[s] | r[s] << 1));
+        sink = classes[i % N];
+    }
+    double pairUs = (bench_now_ns() - t0) / 1e3;
+
+    int wrong = 0, inFault = 0;
+    for (int s = 0; s < N; s++)
+    {
+        wrong += array.classOf(s) != classes[s] || array.fault(s) != (classes[s] != 0);
+        inFault += classes[s] != 0;
+    }
+    wrong += array.inFault() != uint32_t(inFault);
+    printf("  %5d stations %10.1f stations/us bitset %8.1f stations/us per pair %6.1fx, %d in fault%s\n", N,
+           double(N) * rounds / bitUs, double(N) * rounds / pairUs, pairUs / bitUs, inFault,
+           wrong ? "  WRONG CLASS" : "");
+    return wrong == 0;
+}
+
+// The sketch reads its stations through the emulated 74HC165 chain.
+static bool firmware()
+{
+    hal_host::attach_shift_chain(STATION_LOAD_PIN, STATION_CLOCK_PIN, STATION_DATA_PIN, 2 * STATION_COUNT);
+    setup();
+    for (uint64_t end = hal_host::now_us() + 200000; hal_host::now_us() < end; hal_host::advance_us(100))
+        loop();
+
+    std::mt19937 rng(3);
+    std::vector<uint8_t> l(STATION_COUNT), r(STATION_COUNT);
+    uint32_t expected = 0;
+    for (int s = 0; s < STATION_COUNT; s++)
+    {
+        l[s] = rng() % 5 == 0;
+        r[s] = rng() % 5 == 0;
+        hal_host::set_chain_input(2 * s, l[s]);
+        hal_host::set_chain_input(2 * s + 1, r[s]);
+        expected += table.predict(uint32_t(l[s] | r[s] << 1)) != 0;
+    }
+    uint64_t t0 = bench_now_ns();
+    uint32_t ticks = 0;
+    for (uint64_t end = hal_host::now_us() + 100000; hal_host::now_us() < end; hal_host::advance_us(100), ticks++)
+        loop();
+    double loopUs = (bench_now_ns() - t0) / 1e3 / ticks;
+
+    int wrong = 0;
+    for (int s = 0; s < STATION_COUNT; s++)
+        wrong += stations.leftOf(s) != l[s] || stations.rightOf(s) != r[s] ||
+                 stations.classOf(s) != table.predict(uint32_t(l[s] | r[s] << 1));
+    printf("  firmware: %d stations on the chain, %u in fault (expected %u), %d wrong, %.2f us per loop()\n",
+           STATION_COUNT, stations.inFault(), expected, wrong, loopUs);
+    return wrong == 0 && stations.inFault() == expected;
+}
+
+// Station 0 chatters between a clear and a faulty reading every 10 to 40 ms,
+// too fast to hold; every other station flaps every 60 to 160 ms, slow
+// enough that each fault counts. Meanwhile the track raises real faults.
+static bool flapping(double seconds)
+{
+    int clear = -1, faulty = -1;
+    for (int e = 0; e < 4; e++)
+        (table.predict(uint32_t(e)) ? faulty : clear) = e;
+    if (clear < 0 || faulty < 0)
+        return true;
+
+    static TrackSim track;
+    track.generate(1);
+    hal_host::attach_track(&track, IRL_PIN, IRR_PIN);
+    uint32_t lastSeq = 0, onsets0 = 0, chatter0 = stations.faults(0), dropped0 = eventLog.dropped();
+    eventLog.forEach(0, [&](const LogRecord &r) { lastSeq = r.seq; });
+    for (int s = 0; s < STATION_COUNT; s++)
+        onsets0 += stations.faults(s);
+    uint64_t erases0 = hal_host::flash_stats().erases;
+
+    std::mt19937 rng(5);
+    std::vector<uint64_t> flipUs(STATION_COUNT, 0);
+    std::vector<uint8_t> inFault(STATION_COUNT, 0);
+    uint64_t start = hal_host::now_us(), end = start + uint64_t(seconds * 1e6);
+    for (; hal_host::now_us() < end; hal_host::advance_us(100))
+    {
+        for (int s = 0; s < STATION_COUNT; s++)
+        {
+            if (hal_host::now_us() < flipUs[s])
+                continue;
+            inFault[s] ^= 1;
+            int e = inFault[s] ? faulty : clear;
+            hal_host::set_chain_input(2 * s, e & 1);
+            hal_host::set_chain_input(2 * s + 1, e >> 1);
+            flipUs[s] = hal_host::now_us() + 1000 * (s ? 60 + rng() % 101 : 10 + rng() % 31);
+        }
+        loop();
+    }
+    // Let the queue drain.
+    for (uint64_t drain = hal_host::now_us() + 100000; hal_host::now_us() < drain; hal_host::advance_us(100))
+        loop();
+
+    uint32_t onsets = 0, types[EV_TYPE_COUNT] = {};
+    for (int s = 0; s < STATION_COUNT; s++)
+        onsets += stations.faults(s);
+    onsets -= onsets0;
+    eventLog.forEach(lastSeq, [&](const LogRecord &r) { types[r.type]++; });
+    uint32_t dropped = eventLog.dropped() - dropped0, chatter = stations.faults(0) - chatter0;
+    uint32_t safety = types[EV_FAULT] + types[EV_CLEAR] + types[EV_AUTO_STOP];
+    printf("  flapping: %.0f s, %u station onsets in %u records, %u from the chattering one; %u safety records "
+           "for %u track faults, %u dropped, %llu sector erases\n",
+           seconds, onsets, types[EV_STATION], chatter, safety, track.faults(), dropped,
+           (unsigned long long)(hal_host::flash_stats().erases - erases0));
+    return chatter == 0 && dropped == 0 && types[EV_FAULT] > 0 && types[EV_STATION] <= seconds + 1;
+}
+
+int main(int argc, char **argv)
+{
+    int rounds = argc > 1 ? atoi(argv[1]) : 2000;
+    double seconds = argc > 2 ? atof(argv[2]) : 30;
+    printf("bench_stations: %d rounds\n", rounds);
+    bool ok = measure<64>(rounds);
+    ok = measure<256>(rounds) && ok;
+    ok = measure<4096>(rounds) && ok;
+    ok = firmware() && ok;
+    ok = flapping(seconds) && ok;
+    return ok ? 0 : 1;
+}
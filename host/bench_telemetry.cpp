@@ -0,0 +1,179 @@
+// /data.bin against /data.json for collectors: bytes on the wire, the
+// device's cost to produce a document and the collector's cost to turn one
+// into a Telemetry record.
+//
+//   bench_telemetry [iterations=1000000] [port=18191]
+//
+// The JSON side is decoded with a single-pass flat-object scanner, which is
+// about the cheapest a collector can do; it cannot recover the motor and
+// buzzer state or the stop counter, which /data.json does not carry. Both
+// documents are also fetched over HTTP to count full responses. Exits 1 if
+// the two decoders disagree on the fields both carry.
+#include <atomic>
+#include <cstring>
+#include <thread>
+
+#include "../src/hal.h"
+#include "../src/telemetry.h"
+#include "bench.h"
+#include "hal_host.h"
+#include "http_client.h"
+
+void setup();
+void loop();
+size_t writeDataJson(char *out, size_t size, uint32_t since);
+size_t writeTelemetry(uint8_t *out);
+
+static const char *const predictionNames[] = {"Normal", "Crack_Left", "Crack_Right", "Break"};
+static const char *const severityNames[] = {"Unknown", "Safe", "Moderate", "Critical"};
+
+static uint8_t lookup(const char *value, size_t len, const char *const *names, uint8_t count, uint8_t missing)
+{
+    for (uint8_t i = 0; i < count; i++)
+        if (strlen(names[i]) == len && !memcmp(names[i], value, len))
+            return i;
+    return missing;
+}
+
+// One pass over {"key":value,...} with string or bare-number values.
+static bool decodeJson(const char *doc, size_t size, Telemetry &t)
+{
+    memset(&t, 0, sizeof(t));
+    const char *p = doc, *end = doc + size;
+    if (p == end || *p++ != '{')
+        return false;
+    while (p < end && *p == '"')
+    {
+        const char *key = ++p;
+        while (p < end && *p != '"')
+            p++;
+        size_t keyLen = p - key;
+        p += 2; // closing quote and colon
+        bool quoted = p < end && *p == '"';
+        const char *value = quoted ? ++p : p;
+        while (p < end && (quoted ? *p != '"' : (*p != ',' && *p != '}')))
+        {
+            if (quoted && *p == '\\')
+                p++;
+            p++;
+        }
+        size_t valueLen = p - value;
+        if (quoted)
+            p++;
+
+#define KEY(k) (keyLen == sizeof(k) - 1 && !memcmp(key, k, keyLen))
+        if (KEY("epoch"))
+            t.epoch = strtoul(value, nullptr, 10);
+        else if (KEY("seq"))
+            t.seq = strtoul(value, nullptr, 10);
+        else if (KEY("left"))
+            t.flags |= value[0] == '1' ? TELEMETRY_LEFT : 0;
+        else if (KEY("right"))
+            t.flags |= value[0] == '1' ? TELEMETRY_RIGHT : 0;
+        else if (KEY("ai_status"))
+            t.prediction = lookup(value, valueLen, predictionNames, 4, 4);
+        else if (KEY("severity"))
+            t.severity = lookup(value, valueLen, severityNames, 4, 0);
+        else if (KEY("confidence"))
+            t.confidence = telemetryPercent(strtof(value, nullptr));
+        else if (KEY("fault_percent"))
+            t.faultPercent = telemetryPercent(strtof(value, nullptr));
+#undef KEY
+
+        if (p < end && *p == ',')
+            p++;
+    }
+    return p < end && *p == '}';
+}
+
+static std::atomic<bool> fetched(false);
+static std::string rawJson, rawBin;
+
+static std::string fetchRaw(uint16_t port, const char *target)
+{
+    std::string response;
+    int fd = http_connect(port);
+    if (fd < 0 || !http_send_get(fd, target))
+        return response;
+    char buf[4096];
+    ssize_t n;
+    while ((n = recv(fd, buf, sizeof(buf), 0)) > 0)
+        response.append(buf, n);
+    close(fd);
+    return response;
+}
+
+static void fetchBoth(uint16_t port)
+{
+    rawJson = fetchRaw(port, "/data.json");
+    rawBin = fetchRaw(port, "/data.bin");
+    fetched = true;
+}
+
+static volatile uint32_t sink;
+
+// Makes the compiler assume every field of *p is read.
+static void keep(const void *p) { asm volatile("" : : "r"(p) : "memory"); }
+
+template <typename F>
+static double nsPerCall(int iterations, F f)
+{
+    uint64_t t0 = bench_now_ns();
+    for (int i = 0; i < iterations; i++)
+        f();
+    return double(bench_now_ns() - t0) / iterations;
+}
+
+int main(int argc, char **argv)
+{
+    int iterations = argc > 1 ? atoi(argv[1]) : 1000000;
+    uint16_t port = argc > 2 ? atoi(argv[2]) : 18191;
+
+    // A Break with the train stopped: the longest banner.
+    hal_host::set_http_port(port);
+    setup();
+    hal_host::set_input(IRL_PIN, HIGH);
+    hal_host::set_input(IRR_PIN, HIGH);
+    hal_host::advance_us(1100000);
+    loop();
+
+    std::thread client(fetchBoth, port);
+    while (!fetched)
+        loop();
+    client.join();
+
+    static char json[768];
+    static uint8_t bin[TELEMETRY_V1_SIZE];
+    size_t jsonLen = writeDataJson(json, sizeof(json), 0);
+    size_t binLen = writeTelemetry(bin);
+
+    Telemetry fromJson, fromBin;
+    bool ok = decodeJson(json, jsonLen, fromJson) && decodeTelemetry(bin, binLen, fromBin) == TELEMETRY_OK;
+    ok = ok && fromJson.epoch == fromBin.epoch && fromJson.seq == fromBin.seq &&
+         fromJson.flags == (fromBin.flags & (TELEMETRY_LEFT | TELEMETRY_RIGHT)) &&
+         fromJson.prediction == fromBin.prediction && fromJson.severity == fromBin.severity &&
+         fromJson.confidence == fromBin.confidence && fromJson.faultPercent == fromBin.faultPercent;
+
+    double encodeJson = nsPerCall(iterations, [] { sink = writeDataJson(json, sizeof(json), 0); });
+    double encodeBin = nsPerCall(iterations, [] { sink = writeTelemetry(bin); });
+    double decodeJ = nsPerCall(iterations, [jsonLen] {
+        Telemetry t;
+        keep(json);
+        decodeJson(json, jsonLen, t);
+        keep(&t);
+    });
+    double decodeB = nsPerCall(iterations, [binLen] {
+        Telemetry t = {};
+        keep(bin);
+        decodeTelemetry(bin, binLen, t);
+        keep(&t);
+    });
+
+    printf("bench_telemetry: %d iterations, decoders %s\n", iterations, ok ? "agree" : "DISAGREE");
+    printf("  %-14s %5s %6s %12s %12s\n", "", "body", "wire", "encode", "decode");
+    printf("  %-14s %4zuB %5zuB %9.1f ns %9.1f ns\n", "/data.json", jsonLen, rawJson.size(), encodeJson, decodeJ);
+    printf("  %-14s %4zuB %5zuB %9.1f ns %9.1f ns\n", "/data.bin", binLen, rawBin.size(), encodeBin, decodeB);
+    printf("  %-14s %4.1fx %5.1fx %11.1fx %11.1fx\n", "ratio", double(jsonLen) / binLen,
+           double(rawJson.size()) / rawBin.size(), encodeJson / encodeBin, decodeJ / decodeB);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,167 @@
+// Tree training (tools/train.h) against the Python pipeline wow.py runs.
+//
+//   bench_train [rows=4000000] [max_threads=cores]
+//
+// First the checked-in dataset is trained and the result must be byte for
+// byte the railway_fault_model.h micromlgen wrote. Then a generated CSV of
+// the given size (the two sensors, two noise columns, 2% of the labels
+// flipped) is loaded and binned in one go, then trained, at each thread count, which must
+// all grow the same tree, and the same file goes through pandas and sklearn
+// with $PYTHON (python3 by default), if it has them. Exits 1 on a mismatch.
+#include <cstdio>
+#include <random>
+#include <string>
+
+#include "../tools/train.h"
+#include "bench.h"
+
+static const std::vector<std::string> CLASSES = {"Normal", "Crack_Left", "Crack_Right", "Break"};
+
+static std::string eloquent(const std::vector<TrainNode> &tree)
+{
+    char *text = nullptr;
+    size_t size = 0;
+    FILE *f = open_memstream(&text, &size);
+    writeEloquentTree(f, tree);
+    fclose(f);
+    std::string out(text, size);
+    free(text);
+    return out;
+}
+
+static bool checkedInModel()
+{
+    TrainData data;
+    data.classes = CLASSES;
+    std::string error;
+    if (!loadCsv("railway_fault_dataset.csv", "status", {}, 1, data, error))
+    {
+        printf("  %-22s %s\n", "dataset", error.c_str());
+        return false;
+    }
+    TrainOptions options;
+    TreeTrainer trainer(data, options);
+    trainer.grow();
+    FILE *f = fopen("railway_fault_model.h", "r");
+    std::string checkedIn;
+    char buf[4096];
+    for (size_t n; f && (n = fread(buf, 1, sizeof(buf), f)) > 0;)
+        checkedIn.append(buf, n);
+    if (f)
+        fclose(f);
+    bool same = eloquent(trainer.tree()) == checkedIn;
+    printf("  %-22s %zu rows, %zu nodes: %s\n", "dataset", data.rows(), trainer.tree().size(),
+           same ? "same railway_fault_model.h as micromlgen" : "DIFFERS from railway_fault_model.h");
+    return same;
+}
+
+static size_t writeCsv(const char *path, size_t rows)
+{
+    FILE *f = fopen(path, "w");
+    if (!f)
+        return 0;
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> vibration(0, 4), temperature(15, 45);
+    fputs("left_sensor,right_sensor,vibration,temperature,status\n", f);
+    for (size_t r = 0; r < rows; r++)
+    {
+        int left = rng() % 3 == 0, right = rng() % 3 == 0;
+        int status = rng() % 50 == 0 ? rng() % 4 : left | right << 1;
+        fprintf(f, "%d,%d,%.3f,%.2f,%s\n", left, right, vibration(rng), temperature(rng), CLASSES[status].c_str());
+    }
+    long size = ftell(f);
+    fclose(f);
+    return size;
+}
+
+// wow.py's steps on the same file, timed inside Python.
+static bool pythonPipeline(const char *path, double &readS, double &fitS, double &accuracy)
+{
+    const char *python = getenv("PYTHON") ? getenv("PYTHON") : "python3";
+    std::string command = std::string(python) + " -c '\n"
+                          "import time, sys\n"
+                          "import pandas as pd\n"
+                          "from sklearn.tree import DecisionTreeClassifier\n"
+                          "t0 = time.perf_counter()\n"
+                          "df = pd.read_csv(sys.argv[1])\n"
+                          "df[\"status\"] = df[\"status\"].map({\"Normal\": 0, \"Crack_Left\": 1, \"Crack_Right\": 2, "
+                          "\"Break\": 3})\n"
+                          "X = df.drop(columns=[\"status\"]); y = df[\"status\"]\n"
+                          "t1 = time.perf_counter()\n"
+                          "model = DecisionTreeClassifier(max_depth=3, random_state=42).fit(X, y)\n"
+                          "t2 = time.perf_counter()\n"
+                          "print(t1 - t0, t2 - t1, model.score(X, y))\n"
+                          "' " + path + " 2>/dev/null";
+    FILE *p = popen(command.c_str(), "r");
+    if (!p)
+        return false;
+    int got = fscanf(p, "%lf %lf %lf", &readS, &fitS, &accuracy);
+    return pclose(p) == 0 && got == 3;
+}
+
+int main(int argc, char **argv)
+{
+    size_t rows = argc > 1 ? strtoull(argv[1], nullptr, 10) : 4000000;
+    unsigned cores = std::thread::hardware_concurrency();
+    unsigned maxThreads = argc > 2 ? atoi(argv[2]) : cores ? cores : 1;
+    const char *path = "build/bench_train.csv";
+
+    printf("bench_train: %zu generated rows, %u cores\n", rows, cores);
+    bool ok = checkedInModel();
+    size_t bytes = writeCsv(path, rows);
+    if (!bytes)
+    {
+        printf("  cannot write %s\n", path);
+        return 1;
+    }
+
+    std::vector<unsigned> sizes;
+    for (unsigned t = 1; t < maxThreads; t *= 2)
+        sizes.push_back(t);
+    sizes.push_back(maxThreads);
+    printf("  %-8s %9s %9s %9s %12s %10s\n", "threads", "load s", "grow s", "total s", "rows/s", "accuracy");
+    std::string first;
+    double oneThread = 0;
+    for (unsigned t : sizes)
+    {
+        TrainData data;
+        data.classes = CLASSES;
+        std::string error;
+        uint64_t t0 = bench_now_ns();
+        if (!loadCsv(path, "status", {}, t, data, error) || data.rows() != rows)
+        {
+            printf("  load: %s (%zu rows)\n", error.c_str(), data.rows());
+            return 1;
+        }
+        uint64_t t1 = bench_now_ns();
+        TrainOptions options;
+        options.threads = t;
+        TreeTrainer trainer(data, options);
+        trainer.grow();
+        uint64_t t2 = bench_now_ns();
+        std::vector<uint64_t> confusion = trainer.evaluate();
+        uint64_t right = 0;
+        for (size_t c = 0; c < CLASSES.size(); c++)
+            right += confusion[c * CLASSES.size() + c];
+        std::string tree = eloquent(trainer.tree());
+        bool same = first.empty() || tree == first;
+        if (first.empty())
+        {
+            first = tree;
+            oneThread = (t2 - t0) / 1e9;
+        }
+        printf("  %-8u %9.3f %9.3f %9.3f %12.0f %9.3f%%%s\n", t, (t1 - t0) / 1e9, (t2 - t1) / 1e9, (t2 - t0) / 1e9,
+               rows / ((t2 - t0) / 1e9), 100.0 * right / rows, same ? "" : "  DIFFERENT TREE");
+        ok = ok && same;
+    }
+    printf("  %-22s %.1f MB, %.0f MB/s on one thread\n", "csv", bytes / 1e6, bytes / 1e6 / oneThread);
+
+    double readS, fitS, accuracy;
+    if (pythonPipeline(path, readS, fitS, accuracy))
+        printf("  %-22s read_csv %.3f s, fit %.3f s, %.0f rows/s, accuracy %.3f%%: %.1fx slower than one thread\n",
+               "pandas + sklearn", readS, fitS, rows / (readS + fitS), 100 * accuracy, (readS + fitS) / oneThread);
+    else
+        printf("  %-22s skipped (no pandas/sklearn for ${PYTHON:-python3})\n", "pandas + sklearn");
+    remove(path);
+    return ok ? 0 : 1;
+}
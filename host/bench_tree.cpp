@@ -0,0 +1,214 @@
+// Lookup-table classifier against the trees it was built from.
+//
+//   bench_tree [predictions]
+//
+// 1. The exported railway tree: the table must agree with the generated
+//    Eloquent predict() on every sensor pair; then predictions/s of both.
+// 2. Random trees over N = 4..20 binary sensors: the table must agree with
+//    a tree walk on all 2^N inputs, and predictBatch() with predict() on
+//    the random stream; then predictions/s of each.
+// 3. A tree that splits one sensor at two thresholds: predict(const float *)
+//    and predictBatch() must follow the thresholds, not the table.
+// Exits 1 on any mismatch.
+#include <array>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "../railway_fault_model.h"
+#include "../railway_fault_tree.h"
+#include "bench.h"
+
+// Full tree of depth N splitting sensor d at level d; leaf class is the
+// number of faulty sensors, capped at 3. Built and flattened at compile time.
+template <int N>
+constexpr std::array<TreeNode, (2 << N) - 1> countingTree()
+{
+    std::array<TreeNode, (2 << N) - 1> nodes{};
+    for (int i = 0; i < int(nodes.size()); i++)
+    {
+        int depth = 0;
+        while ((2 << depth) - 1 <= i)
+            depth++;
+        if (depth == N)
+        {
+            int faults = 0;
+            for (int path = i + 1; path > 1; path >>= 1)
+                faults += path & 1;
+            nodes[i] = {-1, 0.0f, -1, -1, uint8_t(faults < 3 ? faults : 3)};
+        }
+        else
+            nodes[i] = {int16_t(depth), 0.5f, int16_t(2 * i + 1), int16_t(2 * i + 2), 0};
+    }
+    return nodes;
+}
+
+static constexpr auto COUNTING_TREE = countingTree<10>();
+static constexpr TreeTable<10, 4> countingTable(COUNTING_TREE.data(), COUNTING_TREE.size());
+static_assert(countingTable.predict(0u) == 0, "no faults");
+static_assert(countingTable.predict(0x200) == 1, "one fault");
+static_assert(countingTable.predict(0x081) == 2, "two faults");
+static_assert(countingTable.predict(0x3ff) == 3, "capped");
+
+// Sensor 0 split at 0.25 and again at 0.75, so it is not binarizable
+static constexpr TreeNode TWO_CUT_TREE[] = {
+    {0, 0.25f, 1, 2, 0},
+    {-1, 0.0f, -1, -1, 0},
+    {0, 0.75f, 3, 4, 0},
+    {-1, 0.0f, -1, -1, 1},
+    {-1, 0.0f, -1, -1, 2},
+};
+static constexpr TreeTable<2, 4> twoCutTable(TWO_CUT_TREE);
+static_assert(!twoCutTable.binarizable(), "two thresholds on sensor 0");
+
+// Sweeps sensor 0 across both thresholds, one sample at a time and batched
+static bool twoCuts()
+{
+    const size_t count = 1000;
+    std::vector<float> left(count), right(count, 0.0f);
+    for (size_t i = 0; i < count; i++)
+        left[i] = i / float(count);
+    const float *columns[2] = {left.data(), right.data()};
+    std::vector<uint8_t> batch(count);
+    twoCutTable.predictBatch(columns, count, batch.data());
+    size_t wrong = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        float x[2] = {left[i], right[i]};
+        int expected = left[i] <= 0.25f ? 0 : left[i] <= 0.75f ? 1 : 2;
+        wrong += twoCutTable.predict(x) != expected || batch[i] != expected;
+    }
+    printf("two thresholds on one sensor: %zu of %zu samples wrong\n", wrong, count);
+    return wrong == 0;
+}
+
+static std::vector<uint32_t> randomInputs(size_t count, uint32_t features, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::vector<uint32_t> inputs(count);
+    for (uint32_t &in : inputs)
+        in = rng() & ((uint32_t(1) << features) - 1);
+    return inputs;
+}
+
+static volatile uint64_t sink;
+
+template <typename Predict>
+static double predictionsPerSecond(const std::vector<uint32_t> &inputs, Predict predict)
+{
+    uint64_t start = bench_now_ns();
+    uint64_t sum = 0;
+    for (uint32_t in : inputs)
+        sum += predict(in);
+    double seconds = (bench_now_ns() - start) / 1e9;
+    sink = sum;
+    return inputs.size() / seconds;
+}
+
+// Random tree of up to the given depth, leaves more likely further down.
+static int16_t growTree(std::vector<TreeNode> &nodes, std::mt19937 &rng, int features, int depth)
+{
+    int16_t index = int16_t(nodes.size());
+    nodes.push_back({-1, 0.0f, -1, -1, uint8_t(rng() % 4)});
+    if (depth == 0 || rng() % 8 == 0)
+        return index;
+    int16_t feature = int16_t(rng() % features);
+    int16_t left = growTree(nodes, rng, features, depth - 1);
+    int16_t right = growTree(nodes, rng, features, depth - 1);
+    nodes[index] = {feature, 0.5f, left, right, 0};
+    return index;
+}
+
+template <int N>
+static bool scaling(size_t predictions)
+{
+    typedef TreeTable<N, 4> Table;
+    std::mt19937 rng(N);
+    std::vector<TreeNode> nodes;
+    growTree(nodes, rng, N, N < 12 ? N : 12);
+
+    uint64_t start = bench_now_ns();
+    std::unique_ptr<Table> table(new Table(nodes.data(), nodes.size()));
+    double buildMs = (bench_now_ns() - start) / 1e6;
+
+    for (uint32_t in = 0; in < Table::ENTRIES; in++)
+    {
+        if (table->predict(in) != Table::walk(nodes.data(), nodes.size(), in))
+        {
+            printf("  N=%-2d MISMATCH at input 0x%x\n", N, in);
+            return false;
+        }
+    }
+
+    std::vector<uint32_t> inputs = randomInputs(predictions, N, N);
+    double walked = predictionsPerSecond(inputs, [&](uint32_t in) { return Table::walk(nodes.data(), nodes.size(), in); });
+    double looked = predictionsPerSecond(inputs, [&](uint32_t in) { return table->predict(in); });
+
+    // The same inputs as one float column per sensor
+    std::vector<std::vector<float>> columns(N, std::vector<float>(predictions));
+    const float *columnPtrs[N];
+    for (int f = 0; f < N; f++)
+    {
+        for (size_t i = 0; i < predictions; i++)
+            columns[f][i] = (inputs[i] >> f) & 1;
+        columnPtrs[f] = columns[f].data();
+    }
+    std::vector<uint8_t> classes(predictions);
+    start = bench_now_ns();
+    table->predictBatch(columnPtrs, predictions, classes.data());
+    double batched = predictions / ((bench_now_ns() - start) / 1e9);
+    for (size_t i = 0; i < predictions; i++)
+    {
+        if (classes[i] != table->predict(inputs[i]))
+        {
+            printf("  N=%-2d BATCH MISMATCH at sample %zu\n", N, i);
+            return false;
+        }
+    }
+
+    printf("  N=%-2d %5zu nodes  table %8zu B  built %7.2f ms  walk %6.1f M/s  table %6.1f M/s  (%.1fx)  float batch %6.1f M/s\n",
+           N, nodes.size(), sizeof(Table), buildMs, walked / 1e6, looked / 1e6, looked / walked, batched / 1e6);
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    size_t predictions = argc > 1 ? strtoull(argv[1], nullptr, 10) : 10000000;
+    bool ok = true;
+
+    static constexpr TreeTable<RAILWAY_FAULT_FEATURES, RAILWAY_FAULT_CLASSES> table(RAILWAY_FAULT_TREE);
+    Eloquent::ML::Port::DecisionTree tree;
+
+    for (uint32_t in = 0; in < table.ENTRIES; in++)
+    {
+        float x[RAILWAY_FAULT_FEATURES];
+        for (int f = 0; f < RAILWAY_FAULT_FEATURES; f++)
+            x[f] = (in >> f) & 1;
+        if (table.predict(in) != tree.predict(x))
+        {
+            printf("MISMATCH at input 0x%x: table %d, predict %d\n", in, table.predict(in), tree.predict(x));
+            ok = false;
+        }
+    }
+
+    std::vector<uint32_t> inputs = randomInputs(predictions, RAILWAY_FAULT_FEATURES, 1);
+    double eloquent = predictionsPerSecond(inputs, [&](uint32_t in) {
+        float x[2] = {float(in & 1), float(in >> 1)};
+        return tree.predict(x);
+    });
+    double looked = predictionsPerSecond(inputs, [&](uint32_t in) { return table.predict(in); });
+
+    printf("bench_tree: %zu predictions, railway tree %s on all %u inputs, table %zu B\n", predictions,
+           ok ? "verified" : "MISMATCHED", table.ENTRIES, sizeof(table));
+    printf("  %-22s %.1f M/s\n", "DecisionTree::predict", eloquent / 1e6);
+    printf("  %-22s %.1f M/s (%.1fx)\n", "TreeTable::predict", looked / 1e6, looked / eloquent);
+
+    printf("random trees over N sensors:\n");
+    ok &= scaling<4>(predictions);
+    ok &= scaling<8>(predictions);
+    ok &= scaling<12>(predictions);
+    ok &= scaling<16>(predictions);
+    ok &= scaling<20>(predictions);
+    ok &= twoCuts();
+    return ok ? 0 : 1;
+}
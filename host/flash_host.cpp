@@ -0,0 +1,94 @@
+// Emulated SPI NOR flash behind the ESP.flash*() calls: the filesystem
+// region of the layout in flash_hal.h, erased (0xFF) at start.
+#include <Arduino.h>
+#include <flash_hal.h>
+
+#include "hal_host.h"
+
+namespace
+{
+const uint32_t SECTORS = FS_PHYS_SIZE / FLASH_SECTOR_SIZE;
+const uint32_t PAGE_SIZE = 256;
+const uint64_t ERASE_US = 45000;
+
+uint8_t chip[FS_PHYS_SIZE];
+uint32_t sectorErases[SECTORS];
+hal_host::FlashStats stats;
+
+struct ChipInit
+{
+    ChipInit() { memset(chip, 0xff, sizeof(chip)); }
+} chipInit;
+
+bool inRegion(uint32_t address, size_t size)
+{
+    return address >= FS_PHYS_ADDR && address - FS_PHYS_ADDR + size <= FS_PHYS_SIZE;
+}
+
+void busy(uint64_t us)
+{
+    stats.busyUs += us;
+    hal_host::advance_us(us);
+}
+}
+
+namespace hal_host
+{
+FlashStats flash_stats() { return stats; }
+
+uint32_t flash_sector_erases(uint32_t sector)
+{
+    uint32_t index = sector - FS_PHYS_ADDR / FLASH_SECTOR_SIZE;
+    return index < SECTORS ? sectorErases[index] : 0;
+}
+
+void flash_reset_stats()
+{
+    stats = FlashStats();
+    memset(sectorErases, 0, sizeof(sectorErases));
+}
+}
+
+bool EspClass::flashEraseSector(uint32_t sector)
+{
+    uint32_t address = sector * FLASH_SECTOR_SIZE;
+    if (!inRegion(address, FLASH_SECTOR_SIZE))
+        return false;
+    memset(chip + address - FS_PHYS_ADDR, 0xff, FLASH_SECTOR_SIZE);
+    sectorErases[sector - FS_PHYS_ADDR / FLASH_SECTOR_SIZE]++;
+    stats.erases++;
+    busy(ERASE_US);
+    return true;
+}
+
+bool EspClass::flashWrite(uint32_t address, const uint32_t *data, size_t size)
+{
+    if ((address | size) & 3 || !inRegion(address, size))
+        return false;
+    const uint8_t *in = (const uint8_t *)data;
+    uint8_t *out = chip + address - FS_PHYS_ADDR;
+    for (size_t i = 0; i < size; i++)
+        out[i] &= in[i]; // programming only clears bits
+    stats.writes++;
+    stats.bytesWritten += size;
+    // Each page the write touches is programmed separately.
+    uint64_t us = 0;
+    for (size_t done = 0; done < size;)
+    {
+        size_t n = PAGE_SIZE - (address + done) % PAGE_SIZE;
+        if (n > size - done)
+            n = size - done;
+        us += 30 + (n * 5 - 5) / 2;
+        done += n;
+    }
+    busy(us);
+    return true;
+}
+
+bool EspClass::flashRead(uint32_t address, uint32_t *data, size_t size)
+{
+    if ((address | size) & 3 || !inRegion(address, size))
+        return false;
+    memcpy(data, chip + address - FS_PHYS_ADDR, size);
+    return true;
+}
@@ -0,0 +1,459 @@
+// Linux backend of the HAL: Arduino core functions on top of a virtual clock,
+// simulated GPIO and a stdout/null serial port.
+#include "hal_host.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdarg>
+#include <malloc.h>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <Arduino.h>
+#include <EEPROM.h>
+#include <ESP8266WiFi.h>
+#include <coredecls.h>
+
+#include "track_sim.h"
+
+namespace
+{
+const int PIN_COUNT = 17;
+
+// Atomic so a benchmark thread can play the interrupt controller while the
+// main thread runs loop().
+std::atomic<uint8_t> levels[PIN_COUNT];
+uint8_t modes[PIN_COUNT];
+void (*isr[PIN_COUNT])(void);
+int isrMode[PIN_COUNT];
+hal_host::PinWriteHook writeHook = nullptr;
+
+std::atomic<uint64_t> clockUs{0};
+bool realtimeClock = false;
+std::chrono::steady_clock::time_point realtimeStart = std::chrono::steady_clock::now();
+
+TrackSim *track = nullptr;
+uint8_t leftPin = 0;
+uint8_t rightPin = 0;
+
+// Typical ESP8266 Arduino free heap with the soft AP and server running.
+const long DEVICE_FREE_HEAP = 48 * 1024;
+size_t heapAtStart = mallinfo2().uordblks;
+
+uint16_t httpPort = 8080;
+bool serialEcho = false;
+uint64_t serialBytes = 0;
+hal_host::SerialHook serialHook = nullptr;
+
+// The UART: a 128-byte TX FIFO emptied at baud / 10 bytes a second. A
+// write the FIFO cannot take waits for it, as the core's does, and the
+// wait is charged to the clock like flash time.
+const uint32_t UART_FIFO = 128;
+uint32_t uartBaud = 0;
+double uartQueued = 0;
+uint64_t uartAtUs = 0;
+uint64_t serialBlockedUs = 0;
+
+std::mt19937 prng(1);
+
+bool idleEnabled = false;
+std::atomic<bool> scheduled{false};
+uint64_t scheduledUs = 0;
+hal_host::IdleStats idleStats = {};
+
+bool applyingTrack = false;
+
+// A chain of 74HC165s: load low latches the inputs, then each rising clock
+// puts the next one on the data pin.
+uint8_t chainLoad = PIN_COUNT, chainClock = PIN_COUNT, chainData = PIN_COUNT;
+std::vector<uint8_t> chainInputs, chainLatched;
+uint32_t chainNext = 0;
+
+void chainOutput() { levels[chainData] = chainNext < chainLatched.size() ? chainLatched[chainNext] : LOW; }
+
+void fireInterrupt(uint8_t pin, uint8_t previous)
+{
+    if (!isr[pin] || levels[pin] == previous)
+        return;
+    int edge = levels[pin] ? RISING : FALLING;
+    if (isrMode[pin] & edge)
+        isr[pin]();
+}
+
+// Sets several input levels at once, then raises their interrupts, the way
+// two sensors that switch together look to the CPU.
+void setInputs(const uint8_t *pins, const uint8_t *values, int count)
+{
+    uint8_t previous[4];
+    for (int i = 0; i < count; i++)
+    {
+        previous[i] = levels[pins[i]];
+        levels[pins[i]] = values[i] ? HIGH : LOW;
+    }
+    for (int i = 0; i < count; i++)
+        fireInterrupt(pins[i], previous[i]);
+}
+
+void applyTrack(uint64_t until_us)
+{
+    if (applyingTrack)
+        return;
+    applyingTrack = true;
+    TrackSample s;
+    while (track && track->next(until_us, s))
+    {
+        if (!realtimeClock && s.t_us > clockUs)
+            clockUs = s.t_us;
+        uint8_t pins[2] = {leftPin, rightPin};
+        uint8_t values[2] = {s.left, s.right};
+        setInputs(pins, values, 2);
+    }
+    applyingTrack = false;
+}
+}
+
+namespace hal_host
+{
+uint64_t now_us()
+{
+    if (realtimeClock)
+    {
+        clockUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - realtimeStart).count();
+        applyTrack(clockUs);
+    }
+    return clockUs;
+}
+
+void advance_us(uint64_t us)
+{
+    if (realtimeClock)
+        return;
+    uint64_t target = clockUs + us;
+    applyTrack(target);
+    clockUs = target;
+}
+
+void set_realtime(bool realtime)
+{
+    realtimeClock = realtime;
+    realtimeStart = std::chrono::steady_clock::now() - std::chrono::microseconds(clockUs.load());
+}
+
+bool realtime() { return realtimeClock; }
+
+void set_input(uint8_t pin, int level)
+{
+    if (pin >= PIN_COUNT)
+        return;
+    uint8_t value = level;
+    setInputs(&pin, &value, 1);
+}
+
+void set_inputs(const uint8_t *pins, const uint8_t *values, int count)
+{
+    for (int i = 0; i < count; i++)
+        if (pins[i] >= PIN_COUNT)
+            return;
+    setInputs(pins, values, count < 4 ? count : 4);
+}
+
+void attach_shift_chain(uint8_t load_pin, uint8_t clock_pin, uint8_t data_pin, uint32_t inputs)
+{
+    if (load_pin >= PIN_COUNT || clock_pin >= PIN_COUNT || data_pin >= PIN_COUNT)
+        return;
+    chainLoad = load_pin;
+    chainClock = clock_pin;
+    chainData = data_pin;
+    chainInputs.assign(inputs, LOW);
+    chainLatched.clear();
+}
+
+void set_chain_input(uint32_t input, int level)
+{
+    if (input < chainInputs.size())
+        chainInputs[input] = level ? HIGH : LOW;
+}
+
+int pin_level(uint8_t pin) { return pin < PIN_COUNT ? levels[pin].load() : LOW; }
+
+void on_pin_write(PinWriteHook hook) { writeHook = hook; }
+
+void attach_track(TrackSim *sim, uint8_t left_pin, uint8_t right_pin)
+{
+    track = sim;
+    leftPin = left_pin;
+    rightPin = right_pin;
+    applyTrack(now_us());
+}
+
+void set_http_port(uint16_t port) { httpPort = port; }
+uint16_t http_port() { return httpPort; }
+
+void set_serial_echo(bool echo) { serialEcho = echo; }
+uint64_t serial_bytes() { return serialBytes; }
+uint64_t serial_blocked_us() { return serialBlockedUs; }
+void on_serial_write(SerialHook hook) { serialHook = hook; }
+
+void set_idle(bool idle) { idleEnabled = idle; }
+IdleStats idle_stats() { return idleStats; }
+}
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+    if (pin < PIN_COUNT)
+        modes[pin] = mode;
+}
+
+int digitalRead(uint8_t pin)
+{
+    if (realtimeClock)
+        hal_host::now_us();
+    return pin < PIN_COUNT ? levels[pin].load() : LOW;
+}
+
+void digitalWrite(uint8_t pin, uint8_t val)
+{
+    if (pin >= PIN_COUNT)
+        return;
+    uint8_t previous = levels[pin];
+    levels[pin] = val ? HIGH : LOW;
+    if (pin == chainLoad && !val)
+    {
+        chainLatched = chainInputs;
+        chainNext = 0;
+        chainOutput();
+    }
+    else if (pin == chainClock && val && !previous && levels[chainLoad])
+    {
+        chainNext++;
+        chainOutput();
+    }
+    if (writeHook)
+        writeHook(pin, levels[pin], hal_host::now_us());
+}
+
+void attachInterrupt(uint8_t pin, void (*handler)(void), int mode)
+{
+    if (pin >= PIN_COUNT)
+        return;
+    isr[pin] = handler;
+    isrMode[pin] = mode;
+}
+
+void detachInterrupt(uint8_t pin)
+{
+    if (pin < PIN_COUNT)
+        isr[pin] = nullptr;
+}
+
+// Both wrap at 32 bits, as on the ESP8266.
+unsigned long millis() { return uint32_t(hal_host::now_us() / 1000); }
+unsigned long micros() { return uint32_t(hal_host::now_us()); }
+
+void delay(unsigned long ms)
+{
+    if (realtimeClock)
+        std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+    else
+        hal_host::advance_us(uint64_t(ms) * 1000);
+}
+
+void delayMicroseconds(unsigned int us)
+{
+    if (realtimeClock)
+        std::this_thread::sleep_for(std::chrono::microseconds(us));
+    else
+        hal_host::advance_us(us);
+}
+
+void yield() {}
+
+void esp_schedule()
+{
+    scheduledUs = clockUs;
+    scheduled = true;
+}
+
+void esp_delay(uint32_t timeout_ms, const std::function<bool()> &blocked, uint32_t intvl_ms)
+{
+    if (!idleEnabled)
+        return;
+    uint64_t start = hal_host::now_us(), end = start + uint64_t(timeout_ms) * 1000;
+    scheduled = false;
+    while (!scheduled && blocked())
+    {
+        uint64_t now = hal_host::now_us();
+        if (now >= end)
+            break;
+        uint64_t step = intvl_ms ? std::min(end, now + uint64_t(intvl_ms) * 1000) : end;
+        if (realtimeClock)
+        {
+            // now_us() raises the track's interrupts; look every 100 us.
+            std::this_thread::sleep_for(std::chrono::microseconds(std::min<uint64_t>(step - now, 100)));
+            continue;
+        }
+        // Stop at the next track change, so its interrupt ends the wait.
+        uint64_t change;
+        if (track && track->peek(change) && change > now && change < step)
+            step = change;
+        hal_host::advance_us(step - now);
+    }
+    uint64_t now = hal_host::now_us();
+    if (now == start)
+        return;
+    idleStats.idles++;
+    idleStats.idleUs += now - start;
+    if (scheduled)
+    {
+        uint64_t latency = now - scheduledUs;
+        idleStats.interruptWakes++;
+        idleStats.wakeLatencySumUs += latency;
+        idleStats.wakeLatencyMaxUs = std::max(idleStats.wakeLatencyMaxUs, latency);
+    }
+}
+
+long random(long howbig)
+{
+    if (howbig <= 0)
+        return 0;
+    return long(prng() % uint32_t(howbig));
+}
+
+long random(long howsmall, long howbig)
+{
+    if (howsmall >= howbig)
+        return howsmall;
+    return random(howbig - howsmall) + howsmall;
+}
+
+void randomSeed(unsigned long seed)
+{
+    if (seed != 0)
+        prng.seed(uint32_t(seed));
+}
+
+static String formatInteger(unsigned long value, bool negative, unsigned char base)
+{
+    char buf[8 * sizeof(long) + 2];
+    char *p = buf + sizeof(buf) - 1;
+    *p = '\0';
+    if (base < 2)
+        base = 10;
+    do
+    {
+        unsigned digit = value % base;
+        *--p = char(digit < 10 ? '0' + digit : 'A' + digit - 10);
+        value /= base;
+    } while (value);
+    if (negative)
+        *--p = '-';
+    return String(p);
+}
+
+String::String(unsigned char value, unsigned char base) : String(formatInteger(value, false, base)) {}
+String::String(int value, unsigned char base) : String(long(value), base) {}
+String::String(unsigned int value, unsigned char base) : String(formatInteger(value, false, base)) {}
+String::String(long value, unsigned char base)
+    : String(base == 10 && value < 0 ? formatInteger(0UL - (unsigned long)value, true, base) : formatInteger((unsigned long)value, false, base)) {}
+String::String(unsigned long value, unsigned char base) : String(formatInteger(value, false, base)) {}
+String::String(float value, unsigned char decimalPlaces) : String(double(value), decimalPlaces) {}
+
+String::String(double value, unsigned char decimalPlaces)
+{
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%.*f", decimalPlaces, value);
+    buffer = buf;
+}
+
+HardwareSerial Serial;
+
+static double uartLevel()
+{
+    uint64_t now = hal_host::now_us();
+    uartQueued = std::max(0.0, uartQueued - (now - uartAtUs) * (uartBaud / 10e6));
+    uartAtUs = now;
+    return uartQueued;
+}
+
+void HardwareSerial::begin(unsigned long baud)
+{
+    uartBaud = baud;
+    uartQueued = 0;
+    uartAtUs = hal_host::now_us();
+}
+
+int HardwareSerial::availableForWrite() { return uartBaud ? int(UART_FIFO - std::ceil(uartLevel())) : UART_FIFO; }
+
+size_t HardwareSerial::write(const uint8_t *buffer, size_t size)
+{
+    if (uartBaud)
+    {
+        double over = uartLevel() + size - UART_FIFO;
+        if (over > 0)
+        {
+            uint64_t waitUs = uint64_t(std::ceil(over * 10e6 / uartBaud));
+            serialBlockedUs += waitUs;
+            if (realtimeClock)
+                std::this_thread::sleep_for(std::chrono::microseconds(waitUs));
+            else
+                hal_host::advance_us(waitUs);
+            uartLevel();
+        }
+        uartQueued += size;
+    }
+    serialBytes += size;
+    if (serialEcho)
+        fwrite(buffer, 1, size, stdout);
+    if (serialHook)
+        serialHook(buffer, size);
+    return size;
+}
+
+size_t HardwareSerial::printf(const char *format, ...)
+{
+    char buf[256];
+    va_list args;
+    va_start(args, format);
+    int len = vsnprintf(buf, sizeof(buf), format, args);
+    va_end(args);
+    if (len < 0)
+        return 0;
+    return write((const uint8_t *)buf, size_t(len) < sizeof(buf) ? size_t(len) : sizeof(buf) - 1);
+}
+
+EspClass ESP;
+
+uint32_t EspClass::random() { return prng(); }
+
+uint32_t EspClass::getCycleCount()
+{
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch());
+    return uint32_t(uint64_t(ns.count()) * 2 / 25);
+}
+
+uint32_t EspClass::getFreeHeap()
+{
+    long used = long(mallinfo2().uordblks) - long(heapAtStart);
+    if (used < 0)
+        used = 0;
+    return used < DEVICE_FREE_HEAP ? uint32_t(DEVICE_FREE_HEAP - used) : 0;
+}
+
+ESP8266WiFiClass WiFi;
+
+bool ESP8266WiFiClass::softAP(const char *, const char *) { return true; }
+bool ESP8266WiFiClass::softAPConfig(IPAddress, IPAddress, IPAddress) { return true; }
+
+EEPROMClass EEPROM;
+
+void EEPROMClass::begin(size_t requested) { size = requested < sizeof(data) ? requested : sizeof(data); }
+uint8_t EEPROMClass::read(int address) const { return address >= 0 && size_t(address) < size ? data[address] : 0; }
+
+void EEPROMClass::write(int address, uint8_t value)
+{
+    if (address >= 0 && size_t(address) < size)
+        data[address] = value;
+}
@@ -0,0 +1,74 @@
+#pragma once
+// Control surface of the Linux HAL backend: the virtual clock, simulated
+// GPIO levels and the local TCP port the web server binds to.
+#include <cstddef>
+#include <cstdint>
+
+class TrackSim;
+
+namespace hal_host
+{
+typedef void (*PinWriteHook)(uint8_t pin, int level, uint64_t t_us);
+
+// Virtual clock. In realtime mode it follows the monotonic clock instead and
+// advance_us() is a no-op.
+uint64_t now_us();
+void advance_us(uint64_t us);
+void set_realtime(bool realtime);
+bool realtime();
+
+void set_input(uint8_t pin, int level);
+// Several at once (at most 4), then their interrupts, as the track does.
+void set_inputs(const uint8_t *pins, const uint8_t *levels, int count);
+int pin_level(uint8_t pin);
+void on_pin_write(PinWriteHook hook);
+
+// A chain of 74HC165 shift registers on those pins with inputs parallel
+// inputs, all low to begin with; input 0 is shifted out first.
+void attach_shift_chain(uint8_t load_pin, uint8_t clock_pin, uint8_t data_pin, uint32_t inputs);
+void set_chain_input(uint32_t input, int level);
+
+// Sensor pins follow the track script as the clock moves forward.
+void attach_track(TrackSim *track, uint8_t left_pin, uint8_t right_pin);
+
+// esp_delay() (host/include/coredecls.h) returns at once unless idle is on.
+// Then it moves the clock on to the timeout or the next track change, and
+// stops early for esp_schedule() or once blocked() is false. Runners that
+// set inputs themselves between loop() calls leave it off.
+struct IdleStats
+{
+    uint64_t idles;            // esp_delay() calls that waited
+    uint64_t idleUs;
+    uint64_t interruptWakes;   // ended by esp_schedule()
+    uint64_t wakeLatencySumUs; // from esp_schedule() to esp_delay() returning
+    uint64_t wakeLatencyMaxUs;
+};
+void set_idle(bool idle);
+IdleStats idle_stats();
+
+// 0 keeps the server closed, which is what most benchmarks want.
+void set_http_port(uint16_t port);
+uint16_t http_port();
+
+// Serial output goes through a 128-byte FIFO at the Serial.begin() baud
+// rate; serial_blocked_us() is the time write() spent waiting for room.
+typedef void (*SerialHook)(const uint8_t *data, size_t size);
+void set_serial_echo(bool echo);
+void on_serial_write(SerialHook hook);
+uint64_t serial_bytes();
+uint64_t serial_blocked_us();
+
+// The emulated flash charges datasheet timings to the virtual clock:
+// 45 ms per sector erase, 30 us + 2.5 us per further byte for each page
+// programmed. Counters cover everything since the last reset.
+struct FlashStats
+{
+    uint64_t erases;
+    uint64_t writes;
+    uint64_t bytesWritten;
+    uint64_t busyUs;
+};
+FlashStats flash_stats();
+uint32_t flash_sector_erases(uint32_t sector);
+void flash_reset_stats();
+}
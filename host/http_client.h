@@ -0,0 +1,163 @@
+#pragma once
+// Minimal blocking HTTP/1.1 client for host benchmarks against the firmware's
+// local port. Not a general-purpose client: no redirects, no TLS.
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+inline int http_connect(uint16_t port)
+{
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0)
+        return -1;
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    if (connect(fd, (sockaddr *)&addr, sizeof(addr)) < 0)
+    {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Formats a GET into out; keep-alive requests leave the connection open.
+inline int http_format_get(char *out, size_t size, const char *target, const char *extraHeaders = "",
+                           bool keepAlive = false)
+{
+    return snprintf(out, size, "GET %s HTTP/1.1\r\nHost: 127.0.0.1\r\n%s%s\r\n", target,
+                    keepAlive ? "" : "Connection: close\r\n", extraHeaders);
+}
+
+inline bool http_send_get(int fd, const char *target, const char *extraHeaders = "", bool keepAlive = false)
+{
+    char req[512];
+    int len = http_format_get(req, sizeof(req), target, extraHeaders, keepAlive);
+    return len > 0 && send(fd, req, len, MSG_NOSIGNAL) == len;
+}
+
+// If buf starts with a complete response, returns its length and fills
+// status and body (de-chunked); returns 0 while more bytes are needed.
+// A response without a length or chunking ends at the close, so it is only
+// complete once closed is set.
+inline size_t http_parse_response(const std::string &buf, bool closed, int &status, std::string &body)
+{
+    size_t split = buf.find("\r\n\r\n");
+    if (split == std::string::npos || sscanf(buf.c_str(), "HTTP/1.%*d %d", &status) != 1)
+        return 0;
+    std::string head = buf.substr(0, split + 2);
+    for (char &c : head)
+        c = tolower(c);
+    size_t at = split + 4;
+    body.clear();
+    if (status == 304 || status == 204)
+        return at;
+    size_t length = head.find("\r\ncontent-length:");
+    if (length != std::string::npos)
+    {
+        size_t n = strtoul(head.c_str() + length + 17, nullptr, 10);
+        if (buf.size() < at + n)
+            return 0;
+        body = buf.substr(at, n);
+        return at + n;
+    }
+    if (head.find("\r\ntransfer-encoding: chunked") != std::string::npos)
+    {
+        for (;;)
+        {
+            size_t eol = buf.find("\r\n", at);
+            if (eol == std::string::npos)
+                return 0;
+            size_t n = strtoul(buf.c_str() + at, nullptr, 16);
+            if (buf.size() < eol + 2 + n + 2)
+                return 0;
+            body.append(buf, eol + 2, n);
+            at = eol + 2 + n + 2;
+            if (!n)
+                return at;
+        }
+    }
+    if (!closed)
+        return 0;
+    body = buf.substr(at);
+    return buf.size();
+}
+
+// Reads a response until the server closes, then closes fd. Returns the
+// status code, or -1 on a transport error.
+inline int http_read_close(int fd, std::string &body)
+{
+    std::string response;
+    char buf[4096];
+    ssize_t n;
+    while ((n = recv(fd, buf, sizeof(buf), 0)) > 0)
+        response.append(buf, n);
+    close(fd);
+
+    int status = -1;
+    return http_parse_response(response, true, status, body) ? status : -1;
+}
+
+// One request on a fresh connection, read until the server closes it.
+// Returns the status code, or -1 on a transport error.
+inline int http_get(uint16_t port, const char *target, std::string &body, const char *extraHeaders = "")
+{
+    body.clear();
+    int fd = http_connect(port);
+    if (fd < 0)
+        return -1;
+    if (!http_send_get(fd, target, extraHeaders))
+    {
+        close(fd);
+        return -1;
+    }
+
+    return http_read_close(fd, body);
+}
+
+// A POST of payload, the same way.
+inline int http_post(uint16_t port, const char *target, const std::string &payload, std::string &body,
+                     const char *contentType = "application/octet-stream")
+{
+    body.clear();
+    int fd = http_connect(port);
+    if (fd < 0)
+        return -1;
+    char head[512];
+    int len = snprintf(head, sizeof(head),
+                       "POST %s HTTP/1.1\r\nHost: 127.0.0.1\r\nConnection: close\r\nContent-Type: %s\r\n"
+                       "Content-Length: %lu\r\n\r\n",
+                       target, contentType, (unsigned long)payload.size());
+    std::string request = std::string(head, len) + payload;
+    if (send(fd, request.data(), request.size(), MSG_NOSIGNAL) != ssize_t(request.size()))
+    {
+        close(fd);
+        return -1;
+    }
+    return http_read_close(fd, body);
+}
+
+// Value of "key":"..." or "key":123 in a flat JSON document; empty if absent.
+inline std::string json_value(const std::string &doc, const char *key)
+{
+    std::string needle = std::string("\"") + key + "\":";
+    size_t at = doc.find(needle);
+    if (at == std::string::npos)
+        return std::string();
+    at += needle.size();
+    if (doc[at] == '"')
+        return doc.substr(at + 1, doc.find('"', at + 1) - at - 1);
+    size_t end = doc.find_first_of(",}", at);
+    return doc.substr(at, end - at);
+}
@@ -0,0 +1,184 @@
+#pragma once
+// Host (Linux) stand-in for the subset of the ESP8266 Arduino core that the
+// firmware uses. GPIO, time and Serial are routed to the host backend in
+// host/hal_host.cpp.
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#define HIGH 0x1
+#define LOW 0x0
+
+#define INPUT 0x00
+#define OUTPUT 0x01
+#define INPUT_PULLUP 0x02
+
+#define RISING 0x01
+#define FALLING 0x02
+#define CHANGE 0x03
+
+// NodeMCU / Wemos D1 mini pin labels -> GPIO numbers
+static const uint8_t D0 = 16;
+static const uint8_t D1 = 5;
+static const uint8_t D2 = 4;
+static const uint8_t D3 = 0;
+static const uint8_t D4 = 2;
+static const uint8_t D5 = 14;
+static const uint8_t D6 = 12;
+static const uint8_t D7 = 13;
+static const uint8_t D8 = 15;
+
+#define IRAM_ATTR
+#define ICACHE_RAM_ATTR
+#define PROGMEM
+#define PGM_P const char *
+#define PSTR(s) (s)
+#define pgm_read_byte(addr) (*(const uint8_t *)(addr))
+#define pgm_read_word(addr) (*(const uint16_t *)(addr))
+#define pgm_read_dword(addr) (*(const uint32_t *)(addr))
+#define pgm_read_float(addr) (*(const float *)(addr))
+#define memcpy_P memcpy
+#define strlen_P strlen
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+void pinMode(uint8_t pin, uint8_t mode);
+int digitalRead(uint8_t pin);
+void digitalWrite(uint8_t pin, uint8_t val);
+
+// Handlers run synchronously when the simulated level changes, at the
+// virtual time of the change.
+#define digitalPinToInterrupt(p) (p)
+void attachInterrupt(uint8_t pin, void (*handler)(void), int mode);
+void detachInterrupt(uint8_t pin);
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+
+long random(long howbig);
+long random(long howsmall, long howbig);
+void randomSeed(unsigned long seed);
+
+class String
+{
+public:
+    String(const char *cstr = "") : buffer(cstr ? cstr : "") {}
+    String(const String &other) = default;
+    String(String &&other) = default;
+    explicit String(char c) : buffer(1, c) {}
+    explicit String(unsigned char value, unsigned char base = 10);
+    explicit String(int value, unsigned char base = 10);
+    explicit String(unsigned int value, unsigned char base = 10);
+    explicit String(long value, unsigned char base = 10);
+    explicit String(unsigned long value, unsigned char base = 10);
+    explicit String(float value, unsigned char decimalPlaces = 2);
+    explicit String(double value, unsigned char decimalPlaces = 2);
+
+    String &operator=(const String &rhs) = default;
+    String &operator=(String &&rhs) = default;
+    String &operator=(const char *cstr)
+    {
+        buffer = cstr ? cstr : "";
+        return *this;
+    }
+
+    String &operator+=(const String &rhs)
+    {
+        buffer += rhs.buffer;
+        return *this;
+    }
+    String &operator+=(const char *cstr)
+    {
+        buffer += cstr;
+        return *this;
+    }
+    String &operator+=(char c)
+    {
+        buffer += c;
+        return *this;
+    }
+
+    friend String operator+(const String &lhs, const String &rhs)
+    {
+        String s(lhs);
+        s += rhs;
+        return s;
+    }
+    friend String operator+(const String &lhs, const char *rhs)
+    {
+        String s(lhs);
+        s += rhs;
+        return s;
+    }
+    friend String operator+(const char *lhs, const String &rhs)
+    {
+        String s(lhs);
+        s += rhs;
+        return s;
+    }
+
+    bool operator==(const String &rhs) const { return buffer == rhs.buffer; }
+    bool operator==(const char *cstr) const { return buffer == cstr; }
+    bool operator!=(const String &rhs) const { return buffer != rhs.buffer; }
+    bool operator!=(const char *cstr) const { return buffer != cstr; }
+    bool equals(const String &rhs) const { return buffer == rhs.buffer; }
+
+    const char *c_str() const { return buffer.c_str(); }
+    unsigned int length() const { return buffer.size(); }
+    char operator[](unsigned int index) const { return index < buffer.size() ? buffer[index] : 0; }
+    long toInt() const { return strtol(buffer.c_str(), nullptr, 10); }
+    bool reserve(unsigned int size)
+    {
+        buffer.reserve(size);
+        return true;
+    }
+
+private:
+    std::string buffer;
+};
+
+class HardwareSerial
+{
+public:
+    void begin(unsigned long baud);
+    // Bytes that fit in the TX FIFO right now; write() waits for the rest.
+    int availableForWrite();
+    size_t write(const uint8_t *buffer, size_t size);
+    size_t print(const char *s) { return write((const uint8_t *)s, strlen(s)); }
+    size_t print(const String &s) { return write((const uint8_t *)s.c_str(), s.length()); }
+    size_t println(const char *s) { return print(s) + print("\r\n"); }
+    size_t println(const String &s) { return print(s) + print("\r\n"); }
+    size_t printf(const char *format, ...) __attribute__((format(printf, 2, 3)));
+};
+
+extern HardwareSerial Serial;
+
+class EspClass
+{
+public:
+    uint32_t random();
+    // A nominal 80 MHz counter on the monotonic clock: like the CCOUNT
+    // register it wraps at 32 bits and keeps running while the virtual
+    // clock stands still, so stage timings are real host time.
+    uint32_t getCycleCount();
+    uint8_t getCpuFreqMHz() { return 80; }
+    // The device's usual free heap after WiFi start, less what the process
+    // has allocated since startup.
+    uint32_t getFreeHeap();
+
+    // Emulated NOR flash (host/flash_host.cpp). Addresses are flash
+    // offsets; writes must be 4-byte aligned and can only clear bits.
+    bool flashEraseSector(uint32_t sector);
+    bool flashWrite(uint32_t address, const uint32_t *data, size_t size);
+    bool flashRead(uint32_t address, uint32_t *data, size_t size);
+};
+
+extern EspClass ESP;
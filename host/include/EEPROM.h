@@ -0,0 +1,20 @@
+#pragma once
+// Host stand-in for the ESP8266 EEPROM emulation, backed by plain RAM.
+#include "Arduino.h"
+
+class EEPROMClass
+{
+public:
+    void begin(size_t size);
+    uint8_t read(int address) const;
+    void write(int address, uint8_t value);
+    bool commit() { return true; }
+    void end() {}
+    size_t length() const { return size; }
+
+private:
+    uint8_t data[4096] = {};
+    size_t size = 0;
+};
+
+extern EEPROMClass EEPROM;
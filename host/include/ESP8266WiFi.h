@@ -0,0 +1,80 @@
+#pragma once
+// Host stand-in for the ESP8266 WiFi API. The soft AP is a no-op; clients
+// reach the firmware through a local TCP port instead (see hal_host.h).
+#include <memory>
+
+#include "Arduino.h"
+
+class IPAddress
+{
+public:
+    IPAddress(uint8_t a = 0, uint8_t b = 0, uint8_t c = 0, uint8_t d = 0) : octets{a, b, c, d} {}
+    uint8_t operator[](int index) const { return octets[index]; }
+
+private:
+    uint8_t octets[4];
+};
+
+// A TCP connection. Copies share the socket, which closes when the last copy
+// goes away or stop() is called -- the same ownership model as on the device.
+class WiFiClient
+{
+public:
+    WiFiClient() = default;
+    explicit WiFiClient(int fd);
+
+    uint8_t connected();
+    explicit operator bool() { return connected(); }
+    void stop();
+    void setNoDelay(bool nodelay);
+
+    // Blocks until everything is queued, like the device with setSync(true).
+    size_t write(const uint8_t *buf, size_t size);
+    size_t write(const char *s) { return write((const uint8_t *)s, strlen(s)); }
+    size_t print(const char *s) { return write(s); }
+    size_t print(const String &s) { return write((const uint8_t *)s.c_str(), s.length()); }
+    // Bytes that can be written right now without blocking.
+    size_t availableForWrite();
+
+    int available();
+    int read(uint8_t *buf, size_t size);
+
+    int fd() const { return socket ? socket->fd : -1; }
+
+private:
+    struct Socket
+    {
+        int fd;
+        ~Socket();
+    };
+    std::shared_ptr<Socket> socket;
+};
+
+// Listening socket. Like the device's, accept() never blocks: it returns an
+// unconnected client when nobody is waiting.
+class WiFiServer
+{
+public:
+    explicit WiFiServer(uint16_t port) : port(port) {}
+    ~WiFiServer() { close(); }
+
+    void begin();
+    void close();
+    void setNoDelay(bool nodelay) { noDelay = nodelay; }
+    bool hasClient();
+    WiFiClient accept();
+
+private:
+    uint16_t port;
+    int listenFd = -1;
+    bool noDelay = false;
+};
+
+class ESP8266WiFiClass
+{
+public:
+    bool softAP(const char *ssid, const char *passphrase = nullptr);
+    bool softAPConfig(IPAddress local_ip, IPAddress gateway, IPAddress subnet);
+};
+
+extern ESP8266WiFiClass WiFi;
@@ -0,0 +1,11 @@
+#pragma once
+// Host stand-in for the core's esp_delay()/esp_schedule() pair. loop() waits
+// in esp_delay() until timeout_ms has passed, blocked() returns false (it is
+// asked every intvl_ms) or an interrupt calls esp_schedule(). The emulation
+// is in host/hal_host.cpp and is off unless hal_host::set_idle() turns it
+// on: then the virtual clock jumps to the next track change or the timeout.
+#include <cstdint>
+#include <functional>
+
+void esp_schedule();
+void esp_delay(uint32_t timeout_ms, const std::function<bool()> &blocked, uint32_t intvl_ms);
@@ -0,0 +1,9 @@
+#pragma once
+// Host stand-in for the core's flash layout. Only the filesystem region is
+// backed, by the emulated chip in host/flash_host.cpp; the firmware uses it
+// as raw sectors through ESP.flashEraseSector/flashWrite/flashRead.
+#include "Arduino.h"
+
+#define FLASH_SECTOR_SIZE 0x1000
+#define FS_PHYS_ADDR 0x200000
+#define FS_PHYS_SIZE 0x10000
@@ -0,0 +1,192 @@
+// Host runner for the firmware: calls setup() once, then loop() against the
+// virtual clock and the track simulator, timing every iteration.
+//
+//   railsim [--iterations N] [--tick-us US] [--track FILE | --seed S]
+//           [--port P] [--realtime] [--idle] [--serial] [--serial-log FILE] [--record FILE]
+//
+// --idle lets loop() wait in esp_delay() as it does on the board; the
+// clock then jumps to the next deadline or track change, and the report
+// gives the duty cycle (the share of time not spent waiting) and how long
+// an edge took to end a wait.
+// --serial prints the console log as text (src/binlog.h); --serial-log
+// saves the raw UART bytes for build/logdecode. --record writes a trace
+// (src/trace.h) of the run for build/replay.
+// --iterations 0 runs until interrupted (useful with --realtime and a
+// browser on http://127.0.0.1:8080/). Run it under perf or valgrind as-is.
+#include <cstdlib>
+#include <cstring>
+
+#include "../src/binlog.h"
+#include "../src/hal.h"
+#include "../src/sensors.h"
+#include "bench.h"
+#include "hal_host.h"
+#include "trace_replay.h"
+#include "track_sim.h"
+
+void setup();
+void loop();
+
+static TrackSim track;
+static uint32_t seenFaults = 0;
+static bool faultPending = false;
+static uint64_t faultOnsetUs = 0;
+static uint32_t missedFaults = 0;
+static LatencySamples detection;
+static BinLogDecoder console;
+static FILE *serialLog = nullptr;
+
+static void onSerialWrite(const uint8_t *data, size_t size)
+{
+    if (serialLog)
+        fwrite(data, 1, size, serialLog);
+    else
+        console.feed(data, size, [](uint32_t ms, const char *text) { printf("[%10.3f] %s\n", ms / 1e3, text); });
+}
+
+static void trackFaults()
+{
+    uint32_t faults = track.faults();
+    if (faults == seenFaults)
+        return;
+    missedFaults += faults - seenFaults - 1 + (faultPending ? 1 : 0);
+    seenFaults = faults;
+    faultPending = true;
+    faultOnsetUs = track.lastFaultUs();
+}
+
+// The buzzer going high is the first externally visible reaction to a fault.
+static void onPinWrite(uint8_t pin, int level, uint64_t t_us)
+{
+    trackFaults();
+    if (pin != BUZZER_PIN || level != HIGH || !faultPending)
+        return;
+    detection.add(t_us - faultOnsetUs);
+    faultPending = false;
+}
+
+static void usage()
+{
+    fprintf(stderr, "usage: railsim [--iterations N] [--tick-us US] [--track FILE | --seed S]\n"
+                    "               [--port P] [--realtime] [--idle] [--serial] [--serial-log FILE] [--record FILE]\n");
+    exit(2);
+}
+
+int main(int argc, char **argv)
+{
+    uint64_t iterations = 1000000;
+    uint64_t tickUs = 100;
+    const char *trackPath = nullptr;
+    uint32_t seed = 1;
+    bool realtime = false;
+    const char *recordPath = nullptr;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char *a = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (!strcmp(a, "--iterations") && hasValue)
+            iterations = strtoull(argv[++i], nullptr, 10);
+        else if (!strcmp(a, "--tick-us") && hasValue)
+            tickUs = strtoull(argv[++i], nullptr, 10);
+        else if (!strcmp(a, "--track") && hasValue)
+            trackPath = argv[++i];
+        else if (!strcmp(a, "--seed") && hasValue)
+            seed = strtoul(argv[++i], nullptr, 10);
+        else if (!strcmp(a, "--port") && hasValue)
+            hal_host::set_http_port(atoi(argv[++i]));
+        else if (!strcmp(a, "--realtime"))
+            realtime = true;
+        else if (!strcmp(a, "--idle"))
+            hal_host::set_idle(true);
+        else if (!strcmp(a, "--serial"))
+            hal_host::on_serial_write(onSerialWrite);
+        else if (!strcmp(a, "--serial-log") && hasValue)
+        {
+            if (!(serialLog = fopen(argv[++i], "wb")))
+            {
+                perror(argv[i]);
+                return 1;
+            }
+            hal_host::on_serial_write(onSerialWrite);
+        }
+        else if (!strcmp(a, "--record") && hasValue)
+            recordPath = argv[++i];
+        else
+            usage();
+    }
+
+    if (trackPath)
+    {
+        if (!track.load(trackPath))
+        {
+            perror(trackPath);
+            return 1;
+        }
+    }
+    else
+        track.generate(seed);
+
+    hal_host::set_realtime(realtime);
+    hal_host::attach_track(&track, IRL_PIN, IRR_PIN);
+    hal_host::on_pin_write(onPinWrite);
+    randomSeed(seed);
+    std::vector<uint8_t> trace;
+    if (recordPath)
+        recordTrace(&trace);
+
+    setup();
+
+    uint32_t peakQueue = 0;
+    LatencySamples loopNs;
+    loopNs.reserve(iterations ? iterations : 1 << 20);
+    uint64_t startUs = hal_host::now_us();
+    uint64_t wallStart = bench_now_ns();
+
+    for (uint64_t i = 0; iterations == 0 || i < iterations; i++)
+    {
+        uint64_t t0 = bench_now_ns();
+        loop();
+        uint64_t t1 = bench_now_ns();
+        if (iterations)
+            loopNs.add(t1 - t0);
+        hal_host::advance_us(tickUs);
+        trackFaults();
+        if (sensorEvents.size() > peakQueue)
+            peakQueue = sensorEvents.size();
+    }
+
+    double wallS = (bench_now_ns() - wallStart) / 1e9;
+    double virtualS = (hal_host::now_us() - startUs) / 1e6;
+
+    printf("railsim: %llu iterations, %.3f s simulated, %.3f s wall\n", (unsigned long long)iterations, virtualS, wallS);
+    printf("  %-22s %.0f iter/s\n", "loop() throughput", iterations / wallS);
+    loopNs.report("loop() latency", "ns");
+    printf("  %-22s %u (detected %zu, missed %u)\n", "track faults", seenFaults, detection.count(), missedFaults);
+    detection.report("detection latency", "ms", 1000.0);
+    printf("  %-22s %u (%.1f/s simulated, dropped %u, peak queue %u/%d)\n", "sensor edges", sensorEvents.pushed(),
+           sensorEvents.pushed() / virtualS, sensorEvents.dropped(), peakQueue, SENSOR_QUEUE_SIZE);
+    printf("  %-22s %llu (%u records, %u dropped, %.1f ms blocked)\n", "serial bytes",
+           (unsigned long long)hal_host::serial_bytes(), binLog.records(), binLog.dropped(),
+           hal_host::serial_blocked_us() / 1e3);
+    hal_host::IdleStats idle = hal_host::idle_stats();
+    printf("  %-22s %.1f%% (%llu waits, %.1f%% of the time; %llu ended by an edge, latency avg %.1f us, max %llu us)\n",
+           "duty cycle", 100.0 - idle.idleUs / 1e4 / virtualS, (unsigned long long)idle.idles, idle.idleUs / 1e4 / virtualS,
+           (unsigned long long)idle.interruptWakes,
+           idle.interruptWakes ? double(idle.wakeLatencySumUs) / idle.interruptWakes : 0.0,
+           (unsigned long long)idle.wakeLatencyMaxUs);
+    if (serialLog)
+        fclose(serialLog);
+    if (recordPath)
+    {
+        finishTrace();
+        FILE *file = fopen(recordPath, "wb");
+        if (!file || fwrite(trace.data(), 1, trace.size(), file) != trace.size() || fclose(file))
+        {
+            perror(recordPath);
+            return 1;
+        }
+        printf("  %-22s %zu bytes to %s\n", "trace", trace.size(), recordPath);
+    }
+    return 0;
+}
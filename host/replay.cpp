@@ -0,0 +1,116 @@
+// Replays a trace through the firmware and checks its outputs, or dumps it.
+//
+//   replay TRACE [--tick-us US] [--tolerance-us US] [--warm-up-us US]
+//                [--image FILE]... [--dump]
+//
+// TRACE comes from railsim --record or from the board's /trace.bin. Exits 1
+// when the replay diverges from the trace.
+#include <cstdlib>
+#include <cstring>
+
+#include "../src/device_state.h"
+#include "../src/trace.h"
+#include "trace_replay.h"
+
+static void usage()
+{
+    fprintf(stderr, "usage: replay TRACE [--tick-us US] [--tolerance-us US] [--warm-up-us US]\n"
+                    "              [--image FILE]... [--dump]\n");
+    exit(2);
+}
+
+static void dump(const std::vector<uint8_t> &trace)
+{
+    TraceReader reader;
+    TraceBlockHeader block;
+    TraceRecord r;
+    reader.begin(trace.data(), trace.size());
+    const TraceHeader &h = reader.header();
+    printf("trace v%u, %u-byte blocks, started at %u us on model %08x\n", h.version, h.blockSize, h.startUs, h.modelId);
+    while (reader.nextBlock(block))
+    {
+        printf("block %u: pair %u, outputs %u, %s, %u records\n", block.seq, block.pair, block.outputs,
+               predictionName(Prediction(block.prediction)), block.records);
+        while (reader.next(r))
+        {
+            printf("  %12.6f %-8s %u", r.t_us / 1e6, traceTypeName(r.type), r.arg);
+            if (r.type == TR_REQUEST)
+                printf(" %s", r.path);
+            else if (r.type == TR_MODEL)
+                printf(" %08x", r.modelId);
+            else if (r.type == TR_OUTPUT)
+                printf(" %s", predictionName(Prediction(r.prediction)));
+            printf("\n");
+        }
+    }
+    printf("%u blocks missing, %u damaged\n", reader.gaps(), reader.damaged());
+}
+
+int main(int argc, char **argv)
+{
+    const char *path = nullptr;
+    ReplayOptions options;
+    bool dumpOnly = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char *a = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (!strcmp(a, "--tick-us") && hasValue)
+            options.tickUs = strtoull(argv[++i], nullptr, 10);
+        else if (!strcmp(a, "--tolerance-us") && hasValue)
+            options.toleranceUs = strtoull(argv[++i], nullptr, 10);
+        else if (!strcmp(a, "--warm-up-us") && hasValue)
+            options.warmUpUs = strtoull(argv[++i], nullptr, 10);
+        else if (!strcmp(a, "--image") && hasValue)
+            options.images.push_back(argv[++i]);
+        else if (!strcmp(a, "--dump"))
+            dumpOnly = true;
+        else if (a[0] != '-' && !path)
+            path = a;
+        else
+            usage();
+    }
+    if (!path || !options.tickUs)
+        usage();
+
+    std::vector<uint8_t> trace;
+    if (!readTraceFile(path, trace))
+    {
+        perror(path);
+        return 1;
+    }
+    TraceReader reader;
+    if (!reader.begin(trace.data(), trace.size()))
+    {
+        fprintf(stderr, "%s: not a trace\n", path);
+        return 1;
+    }
+    if (dumpOnly)
+    {
+        dump(trace);
+        return 0;
+    }
+
+    ReplayReport report;
+    if (!replayTrace(trace, options, report))
+    {
+        fprintf(stderr, "%s: no records\n", path);
+        return 1;
+    }
+    uint64_t events = report.edges + report.actions + report.requests + report.models;
+    printf("replay: %.3f s of trace in %.3f s wall, %llu loop() calls\n", report.virtualUs / 1e6, report.wallS,
+           (unsigned long long)report.loops);
+    printf("  %-22s %llu edges, %llu presses, %llu requests, %llu models (%.0f/s)\n", "inputs",
+           (unsigned long long)report.edges, (unsigned long long)report.actions, (unsigned long long)report.requests,
+           (unsigned long long)report.models, events / report.wallS);
+    printf("  %-22s %llu of %llu matched, %llu driven, %u blocks missing\n", "outputs",
+           (unsigned long long)report.matched, (unsigned long long)report.expected,
+           (unsigned long long)report.produced, report.gaps);
+    if (!report.divergence.empty())
+    {
+        printf("  diverged: %s\n", report.divergence.c_str());
+        return 1;
+    }
+    return 0;
+}
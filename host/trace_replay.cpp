@@ -0,0 +1,230 @@
+#include "trace_replay.h"
+
+#include <cinttypes>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+
+#include "../src/device_state.h"
+#include "../src/hal.h"
+#include "../src/model_store.h"
+#include "../src/trace.h"
+#include "bench.h"
+#include "hal_host.h"
+
+void setup();
+void loop();
+void pressButton(uint8_t button);
+extern TraceRecorder traceRecorder;
+extern ModelStore modelStore;
+
+namespace
+{
+struct Output
+{
+    uint64_t t_us;
+    uint8_t outputs;
+    uint8_t prediction;
+};
+
+std::vector<uint8_t> *recording = nullptr;
+std::vector<uint8_t> recordedBlocks;
+
+void appendBlock(const uint8_t *block, size_t size) { recordedBlocks.insert(recordedBlocks.end(), block, block + size); }
+
+std::string describe(const Output &o)
+{
+    std::string s = o.outputs & TRACE_OUT_FORWARD ? "forward" : o.outputs & TRACE_OUT_BACK ? "back" : "stopped";
+    if ((o.outputs & (TRACE_OUT_FORWARD | TRACE_OUT_BACK)) == (TRACE_OUT_FORWARD | TRACE_OUT_BACK))
+        s = "forward+back";
+    if (o.outputs & TRACE_OUT_BUZZER)
+        s += ", buzzer";
+    return s + ", " + predictionName(Prediction(o.prediction));
+}
+
+// Stages the image with that id; the sensors task swaps it in.
+bool stageImage(const std::vector<std::string> &images, uint32_t id)
+{
+    for (const std::string &path : images)
+    {
+        std::vector<uint8_t> image;
+        if (!readTraceFile(path.c_str(), image) || image.size() < sizeof(ModelHeader) ||
+            ((const ModelHeader *)image.data())->modelId != id)
+            continue;
+        return modelStore.beginUpload(image.size()) == MODEL_OK &&
+               modelStore.writeUpload(image.data(), image.size(), 0) == MODEL_OK && modelStore.endUpload() == MODEL_OK;
+    }
+    return false;
+}
+
+std::vector<Output> outputsOf(const std::vector<uint8_t> &trace, uint64_t fromUs, int64_t offset)
+{
+    std::vector<Output> out;
+    TraceReader reader;
+    TraceBlockHeader block;
+    TraceRecord r;
+    reader.begin(trace.data(), trace.size());
+    while (reader.nextBlock(block))
+        while (reader.next(r))
+            if (r.type == TR_OUTPUT && r.t_us + offset >= fromUs)
+                out.push_back({r.t_us + offset, r.arg, r.prediction});
+    return out;
+}
+}
+
+bool readTraceFile(const char *path, std::vector<uint8_t> &trace)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+        return false;
+    trace.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return true;
+}
+
+void recordTrace(std::vector<uint8_t> *trace)
+{
+    recording = trace;
+    recordedBlocks.clear();
+    traceRecorder.setSink(appendBlock);
+}
+
+void finishTrace()
+{
+    traceRecorder.flush();
+    const TraceHeader &h = traceRecorder.header();
+    recording->assign((const uint8_t *)&h, (const uint8_t *)&h + sizeof(h));
+    recording->insert(recording->end(), recordedBlocks.begin(), recordedBlocks.end());
+}
+
+bool replayTrace(const std::vector<uint8_t> &trace, const ReplayOptions &options, ReplayReport &report)
+{
+    report = ReplayReport();
+    TraceReader reader;
+    TraceBlockHeader first, block;
+    TraceRecord r;
+    if (!reader.begin(trace.data(), trace.size()) || !reader.nextBlock(first))
+        return false;
+    // Where the trace starts, and where it ends.
+    uint64_t firstUs = 0, lastUs = 0;
+    bool any = false;
+    do
+        while (reader.next(r))
+        {
+            firstUs = any ? firstUs : r.t_us;
+            lastUs = r.t_us > lastUs ? r.t_us : lastUs;
+            any = true;
+        }
+    while (reader.nextBlock(block));
+    report.gaps = reader.gaps();
+    if (!any)
+        return false;
+
+    // setup() reads the pins the trace started with.
+    uint8_t pins[2] = {IRL_PIN, IRR_PIN}, levels[2] = {uint8_t(first.pair & 1), uint8_t(first.pair >> 1 & 1)};
+    hal_host::set_inputs(pins, levels, 2);
+    std::vector<uint8_t> mine;
+    recordTrace(&mine);
+    setup();
+    uint64_t start = hal_host::now_us();
+    // A whole trace lines up with this boot; one that lost its start begins
+    // at the first record.
+    int64_t offset = first.seq ? int64_t(start) - int64_t(firstUs) : int64_t(start) - int64_t(reader.header().startUs);
+    uint64_t warmEndUs = first.seq ? start + options.warmUpUs : 0;
+    if (first.seq)
+    {
+        digitalWrite(MLP_PIN, first.outputs & TRACE_OUT_FORWARD ? HIGH : LOW);
+        digitalWrite(MLN_PIN, first.outputs & TRACE_OUT_BACK ? HIGH : LOW);
+    }
+    const ModelHeader *active = modelStore.header();
+    uint32_t modelId = reader.header().modelId;
+    if (modelId != (active ? active->modelId : 0) && !stageImage(options.images, modelId))
+    {
+        char why[96];
+        snprintf(why, sizeof(why), "the trace starts on model %08" PRIx32 ", which was not given", modelId);
+        report.divergence = why;
+    }
+
+    reader.begin(trace.data(), trace.size());
+    bool more = reader.nextBlock(block) && reader.next(r);
+    auto advance = [&]() {
+        while (!(more = reader.next(r)) && reader.nextBlock(block))
+            ;
+    };
+    uint64_t endUs = lastUs + offset + options.toleranceUs + options.tickUs;
+    uint64_t wall0 = bench_now_ns();
+    while (hal_host::now_us() < endUs)
+    {
+        loop();
+        report.loops++;
+        uint64_t tickEnd = hal_host::now_us() + options.tickUs;
+        // Inputs up to the next loop() land at their own instants, as the
+        // track simulator's do.
+        for (; more && r.t_us + offset <= tickEnd; advance())
+        {
+            uint64_t at = r.t_us + offset;
+            if (at > hal_host::now_us())
+                hal_host::advance_us(at - hal_host::now_us());
+            if (r.type == TR_SENSOR || r.type == TR_RESYNC)
+            {
+                report.edges++;
+                levels[0] = r.arg & 1;
+                levels[1] = r.arg >> 1 & 1;
+                hal_host::set_inputs(pins, levels, 2);
+            }
+            else if (r.type == TR_ACTION)
+            {
+                report.actions++;
+                pressButton(r.arg);
+            }
+            else if (r.type == TR_REQUEST)
+                report.requests++;
+            else if (r.type == TR_MODEL)
+            {
+                report.models++;
+                if (!stageImage(options.images, r.modelId) && report.divergence.empty())
+                {
+                    char why[96];
+                    snprintf(why, sizeof(why), "model %08" PRIx32 " uploaded at %.3f s was not given", r.modelId,
+                             at / 1e6);
+                    report.divergence = why;
+                }
+            }
+        }
+        if (tickEnd > hal_host::now_us())
+            hal_host::advance_us(tickEnd - hal_host::now_us());
+    }
+    report.wallS = (bench_now_ns() - wall0) / 1e9;
+    report.virtualUs = hal_host::now_us() - start;
+    finishTrace();
+
+    std::vector<Output> want = outputsOf(trace, warmEndUs, offset), got = outputsOf(mine, warmEndUs, 0);
+    report.expected = want.size();
+    report.produced = got.size();
+    for (size_t i = 0; i < want.size() && report.divergence.empty(); i++)
+    {
+        uint64_t t = want[i].t_us;
+        bool same = i < got.size() && got[i].outputs == want[i].outputs && got[i].prediction == want[i].prediction;
+        uint64_t skew = i < got.size() ? (got[i].t_us > t ? got[i].t_us - t : t - got[i].t_us) : 0;
+        if (same && skew <= options.toleranceUs)
+        {
+            report.matched++;
+            continue;
+        }
+        char why[192];
+        if (i >= got.size())
+            snprintf(why, sizeof(why), "at %.6f s the trace has %s; the replay drove nothing more", t / 1e6,
+                     describe(want[i]).c_str());
+        else
+            snprintf(why, sizeof(why), "at %.6f s the trace has %s; the replay drove %s at %.6f s", t / 1e6,
+                     describe(want[i]).c_str(), describe(got[i]).c_str(), got[i].t_us / 1e6);
+        report.divergence = why;
+    }
+    if (report.divergence.empty() && got.size() > want.size())
+    {
+        char why[160];
+        snprintf(why, sizeof(why), "the replay drove %s at %.6f s after the trace's last output",
+                 describe(got[want.size()]).c_str(), got[want.size()].t_us / 1e6);
+        report.divergence = why;
+    }
+    return true;
+}
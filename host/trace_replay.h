@@ -0,0 +1,52 @@
+#pragma once
+// Replays a trace (src/trace.h) through the firmware on the virtual clock:
+// setup(), then loop() every tickUs of trace time with the recorded sensor
+// edges, button presses and model uploads applied at their instants. The
+// firmware records its own trace meanwhile, and its outputs are compared
+// with the recorded ones, in order, each within toleranceUs.
+//
+// A trace recorded by the host build replays exactly at the tick it was
+// recorded with (railsim's default is 100 us). One from the board is
+// replayed from its first block's snapshot; outputs are only compared
+// after warmUpUs, once the sensor window has filled again. HTTP requests
+// are counted, not served. setup() runs once per process, so there is one
+// replay per process.
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct ReplayOptions
+{
+    uint64_t tickUs = 100;
+    uint64_t toleranceUs = 2000;
+    uint64_t warmUpUs = 300000;
+    std::vector<std::string> images; // model images, looked up by id
+};
+
+struct ReplayReport
+{
+    uint64_t edges = 0;
+    uint64_t actions = 0;
+    uint64_t requests = 0;
+    uint64_t models = 0;
+    uint64_t loops = 0;
+    uint64_t expected = 0; // outputs recorded after the warm-up
+    uint64_t matched = 0;  // in order and in time
+    uint64_t produced = 0; // outputs the replay drove after the warm-up
+    uint32_t gaps = 0;     // blocks missing from the trace
+    uint64_t virtualUs = 0;
+    double wallS = 0;
+    std::string divergence; // the first mismatch, empty if none
+};
+
+bool readTraceFile(const char *path, std::vector<uint8_t> &trace);
+
+// Returns false if the trace cannot be read; report.divergence says whether
+// the outputs matched.
+bool replayTrace(const std::vector<uint8_t> &trace, const ReplayOptions &options, ReplayReport &report);
+
+// Every full block the firmware's recorder closes is appended to trace,
+// after the header once setup() has run; the host build's recording.
+void recordTrace(std::vector<uint8_t> *trace);
+// The header, once the recorder has begun, and the block being filled.
+void finishTrace();
@@ -0,0 +1,87 @@
+#include "track_sim.h"
+
+#include <cstdio>
+
+bool TrackSim::load(const char *path)
+{
+    FILE *f = fopen(path, "r");
+    if (!f)
+        return false;
+
+    samples.clear();
+    cursor = 0;
+    generated = false;
+    faultCount = 0;
+    inFault = false;
+
+    char line[128];
+    while (fgets(line, sizeof(line), f))
+    {
+        double t_ms;
+        unsigned left, right;
+        if (sscanf(line, "%lf,%u,%u", &t_ms, &left, &right) != 3)
+            continue; // header or comment
+        samples.push_back({uint64_t(t_ms * 1000.0), uint8_t(left != 0), uint8_t(right != 0)});
+    }
+    fclose(f);
+    return true;
+}
+
+void TrackSim::generate(uint32_t seed, uint32_t mean_clear_ms, uint32_t max_fault_ms)
+{
+    samples.clear();
+    cursor = 0;
+    generated = true;
+    rng.seed(seed);
+    meanClearMs = mean_clear_ms;
+    maxFaultMs = max_fault_ms;
+    horizonUs = 0;
+    faultCount = 0;
+    inFault = false;
+    samples.push_back({0, 0, 0});
+}
+
+void TrackSim::refill()
+{
+    std::exponential_distribution<double> clear(1.0 / meanClearMs);
+    std::uniform_int_distribution<uint32_t> duration(50, maxFaultMs);
+    std::uniform_int_distribution<int> kind(1, 3); // Crack_Left, Crack_Right, Break
+
+    samples.erase(samples.begin(), samples.begin() + cursor);
+    cursor = 0;
+
+    horizonUs += uint64_t(clear(rng) * 1000.0) + 1000;
+    int k = kind(rng);
+    samples.push_back({horizonUs, uint8_t(k & 1), uint8_t((k >> 1) & 1)});
+
+    horizonUs += uint64_t(duration(rng)) * 1000;
+    samples.push_back({horizonUs, 0, 0});
+}
+
+bool TrackSim::peek(uint64_t &t_us)
+{
+    if (generated && cursor >= samples.size())
+        refill();
+    if (cursor >= samples.size())
+        return false;
+    t_us = samples[cursor].t_us;
+    return true;
+}
+
+bool TrackSim::next(uint64_t until_us, TrackSample &sample)
+{
+    if (generated && cursor >= samples.size())
+        refill();
+    if (cursor >= samples.size() || samples[cursor].t_us > until_us)
+        return false;
+    sample = samples[cursor++];
+
+    bool fault = sample.left || sample.right;
+    if (fault && !inFault)
+    {
+        faultCount++;
+        faultOnsetUs = sample.t_us;
+    }
+    inFault = fault;
+    return true;
+}
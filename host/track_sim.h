@@ -0,0 +1,45 @@
+#pragma once
+// Scripted track for the host build. A script is a CSV of
+// "t_ms,left,right" rows (header optional); each row sets both IR sensor
+// levels from that time on. Without a script, faults are generated from a
+// seeded PRNG for as long as the simulation runs.
+#include <cstdint>
+#include <random>
+#include <vector>
+
+struct TrackSample
+{
+    uint64_t t_us;
+    uint8_t left;
+    uint8_t right;
+};
+
+class TrackSim
+{
+public:
+    bool load(const char *path);
+    void generate(uint32_t seed, uint32_t mean_clear_ms = 4000, uint32_t max_fault_ms = 2000);
+
+    // Pops the next change scheduled at or before until_us.
+    bool next(uint64_t until_us, TrackSample &sample);
+    // Time of the next change, without taking it.
+    bool peek(uint64_t &t_us);
+
+    // Fault onsets the clock has passed so far.
+    uint32_t faults() const { return faultCount; }
+    uint64_t lastFaultUs() const { return faultOnsetUs; }
+
+private:
+    void refill();
+
+    std::vector<TrackSample> samples;
+    size_t cursor = 0;
+    bool generated = false;
+    std::mt19937 rng;
+    uint32_t meanClearMs = 0;
+    uint32_t maxFaultMs = 0;
+    uint64_t horizonUs = 0;
+    uint32_t faultCount = 0;
+    bool inFault = false;
+    uint64_t faultOnsetUs = 0;
+};
@@ -0,0 +1,94 @@
+// Host WiFiClient over a plain TCP socket.
+#include <ESP8266WiFi.h>
+
+#include <errno.h>
+#include <linux/sockios.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+WiFiClient::Socket::~Socket()
+{
+    if (fd >= 0)
+        close(fd);
+}
+
+WiFiClient::WiFiClient(int fd) : socket(std::make_shared<Socket>())
+{
+    socket->fd = fd;
+}
+
+uint8_t WiFiClient::connected()
+{
+    if (!socket || socket->fd < 0)
+        return 0;
+    char c;
+    ssize_t n = recv(socket->fd, &c, 1, MSG_PEEK | MSG_DONTWAIT);
+    if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK))
+        return 0;
+    return 1;
+}
+
+void WiFiClient::stop()
+{
+    if (socket && socket->fd >= 0)
+    {
+        close(socket->fd);
+        socket->fd = -1;
+    }
+    socket.reset();
+}
+
+void WiFiClient::setNoDelay(bool nodelay)
+{
+    int on = nodelay ? 1 : 0;
+    if (socket && socket->fd >= 0)
+        setsockopt(socket->fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+}
+
+size_t WiFiClient::write(const uint8_t *buf, size_t size)
+{
+    size_t done = 0;
+    while (socket && socket->fd >= 0 && done < size)
+    {
+        ssize_t n = send(socket->fd, buf + done, size - done, MSG_NOSIGNAL);
+        if (n <= 0)
+        {
+            if (n < 0 && errno == EINTR)
+                continue;
+            break;
+        }
+        done += n;
+    }
+    return done;
+}
+
+size_t WiFiClient::availableForWrite()
+{
+    if (!socket || socket->fd < 0)
+        return 0;
+    int sndbuf = 0, queued = 0;
+    socklen_t len = sizeof(sndbuf);
+    if (getsockopt(socket->fd, SOL_SOCKET, SO_SNDBUF, &sndbuf, &len) < 0 || ioctl(socket->fd, SIOCOUTQ, &queued) < 0)
+        return 0;
+    // Linux reports double the requested buffer to account for bookkeeping.
+    return sndbuf / 2 > queued ? sndbuf / 2 - queued : 0;
+}
+
+int WiFiClient::available()
+{
+    int bytes = 0;
+    if (!socket || socket->fd < 0 || ioctl(socket->fd, FIONREAD, &bytes) < 0)
+        return 0;
+    return bytes;
+}
+
+int WiFiClient::read(uint8_t *buf, size_t size)
+{
+    if (!socket || socket->fd < 0)
+        return -1;
+    ssize_t n = recv(socket->fd, buf, size, MSG_DONTWAIT);
+    return n < 0 ? -1 : int(n);
+}
@@ -0,0 +1,67 @@
+// Host WiFiServer over a non-blocking listening socket.
+#include <ESP8266WiFi.h>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "hal_host.h"
+
+void WiFiServer::begin()
+{
+    // The device port (80) is remapped to the host's configured port.
+    (void)port;
+    uint16_t hostPort = hal_host::http_port();
+    if (hostPort == 0 || listenFd >= 0)
+        return;
+
+    listenFd = socket(AF_INET, SOCK_STREAM, 0);
+    if (listenFd < 0)
+        return;
+
+    int one = 1;
+    setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(hostPort);
+    if (bind(listenFd, (sockaddr *)&addr, sizeof(addr)) < 0 || listen(listenFd, 32) < 0)
+    {
+        perror("web server");
+        ::close(listenFd);
+        listenFd = -1;
+        return;
+    }
+    fcntl(listenFd, F_SETFL, fcntl(listenFd, F_GETFL) | O_NONBLOCK);
+}
+
+void WiFiServer::close()
+{
+    if (listenFd >= 0)
+        ::close(listenFd);
+    listenFd = -1;
+}
+
+bool WiFiServer::hasClient()
+{
+    if (listenFd < 0)
+        return false;
+    pollfd p = {listenFd, POLLIN, 0};
+    return poll(&p, 1, 0) > 0 && (p.revents & POLLIN);
+}
+
+WiFiClient WiFiServer::accept()
+{
+    if (listenFd < 0)
+        return WiFiClient();
+    int fd = ::accept(listenFd, nullptr, nullptr);
+    if (fd < 0)
+        return WiFiClient();
+    WiFiClient client(fd);
+    client.setNoDelay(noDelay);
+    return client;
+}
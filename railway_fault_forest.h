@@ -0,0 +1,40 @@
+#pragma once
+// Generated by export_forest.py from railway_fault_AI_with_confidence.pkl.
+#include "src/forest.h"
+
+#define RAILWAY_FOREST_FEATURES 2
+#define RAILWAY_FOREST_CLASSES 4
+#define RAILWAY_FOREST_TREES 100
+#define RAILWAY_FOREST_UNIQUE_TREES 2
+#define RAILWAY_FOREST_NODES 6
+#define RAILWAY_FOREST_LEAF_ROWS 4
+
+static const uint16_t RAILWAY_FOREST_ROOTS[] PROGMEM = {
+    0x0000, 0x0003,
+};
+static const uint16_t RAILWAY_FOREST_WEIGHTS[] PROGMEM = {
+    51, 49,
+};
+static const uint8_t RAILWAY_FOREST_FEATURE[] PROGMEM = {
+    1, 0, 0, 0, 1, 1,
+};
+static const float RAILWAY_FOREST_THRESHOLD[] PROGMEM = {
+    0.5f, 0.5f, 0.5f, 0.5f, 0.5f, 0.5f,
+};
+static const uint16_t RAILWAY_FOREST_CHILDREN[] PROGMEM = {
+    0x0001, 0x0002, 0x8000, 0x8001, 0x8002, 0x8003, 0x0004, 0x0005, 0x8000, 0x8002, 0x8001, 0x8003,
+};
+static const uint16_t RAILWAY_FOREST_PROBA[] PROGMEM = {
+    65535, 0, 0, 0, 0, 65535, 0, 0, 0, 0, 65535, 0,
+    0, 0, 0, 65535,
+};
+
+// predict_proba() of every binary input, bit i = feature i, for host checks
+static const float RAILWAY_FOREST_CHECK[] PROGMEM = {
+    1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f,
+    0.0f, 0.0f, 0.0f, 1.0f,
+};
+
+static const Forest<RAILWAY_FOREST_FEATURES, RAILWAY_FOREST_CLASSES> railwayForest(
+    RAILWAY_FOREST_UNIQUE_TREES, RAILWAY_FOREST_TREES, RAILWAY_FOREST_ROOTS, RAILWAY_FOREST_WEIGHTS,
+    RAILWAY_FOREST_FEATURE, RAILWAY_FOREST_THRESHOLD, RAILWAY_FOREST_CHILDREN, RAILWAY_FOREST_PROBA);
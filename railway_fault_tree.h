@@ -0,0 +1,17 @@
+#pragma once
+// Generated by wow.py from the same tree as railway_fault_model.h.
+#include "src/tree_table.h"
+
+#define RAILWAY_FAULT_FEATURES 2
+#define RAILWAY_FAULT_CLASSES 4
+
+// {feature, threshold, left, right, label}; feature -1 marks a leaf
+static constexpr TreeNode RAILWAY_FAULT_TREE[] = {
+    {1, 0.5f, 1, 4, 0},
+    {0, 0.5f, 2, 3, 0},
+    {-1, 0.0f, -1, -1, 0},
+    {-1, 0.0f, -1, -1, 1},
+    {0, 0.5f, 5, 6, 0},
+    {-1, 0.0f, -1, -1, 2},
+    {-1, 0.0f, -1, -1, 3},
+};
@@ -0,0 +1,244 @@
+#pragma once
+// Generated by export_forest.py from railway_fault_window.pkl.
+#include "src/forest.h"
+
+#define RAILWAY_WINDOW_FEATURES 10
+#define RAILWAY_WINDOW_CLASSES 4
+#define RAILWAY_WINDOW_TREES 6
+#define RAILWAY_WINDOW_UNIQUE_TREES 6
+#define RAILWAY_WINDOW_NODES 179
+#define RAILWAY_WINDOW_LEAF_ROWS 185
+
+static const uint16_t RAILWAY_WINDOW_ROOTS[] PROGMEM = {
+    0x0000, 0x001e, 0x003d, 0x005b, 0x0078, 0x0096,
+};
+static const uint16_t RAILWAY_WINDOW_WEIGHTS[] PROGMEM = {
+    1, 1, 1, 1, 1, 1,
+};
+static const uint8_t RAILWAY_WINDOW_FEATURE[] PROGMEM = {
+    1, 4, 0, 7, 2, 3, 6, 2, 0, 0, 0, 3,
+    9, 6, 2, 9, 6, 4, 6, 5, 6, 3, 8, 6,
+    6, 3, 3, 3, 9, 6, 3, 4, 9, 3, 0, 3,
+    1, 2, 9, 8, 2, 5, 6, 7, 7, 0, 8, 0,
+    8, 3, 5, 7, 8, 6, 1, 7, 8, 4, 3, 6,
+    9, 2, 1, 1, 6, 0, 2, 8, 2, 8, 3, 3,
+    3, 7, 9, 8, 8, 0, 3, 6, 9, 7, 2, 6,
+    0, 4, 8, 6, 7, 3, 2, 0, 3, 1, 1, 6,
+    6, 3, 6, 3, 7, 1, 9, 9, 2, 2, 2, 3,
+    7, 9, 3, 8, 3, 8, 3, 3, 4, 8, 8, 6,
+    1, 2, 0, 4, 7, 7, 3, 4, 0, 7, 0, 3,
+    7, 9, 7, 0, 0, 6, 2, 8, 6, 8, 5, 8,
+    8, 8, 2, 7, 6, 3, 0, 1, 3, 6, 6, 2,
+    8, 2, 8, 7, 5, 7, 6, 9, 9, 7, 7, 4,
+    2, 7, 7, 8, 7, 2, 6, 7, 7, 7, 6,
+};
+static const float RAILWAY_WINDOW_THRESHOLD[] PROGMEM = {
+    0.5f, 9.765625f, 0.5f, 893.5f, 0.974609375f, 0.025390625f, 3.5f, 0.990234375f, 0.5f, 0.5f, 0.5f, 0.017578125f,
+    0.399737f, 2.5f, 0.041015625f, -0.0196164148f, 2.5f, 1.953125f, 10.5f, 29.296875f, 3.5f, 0.982421875f, 2.5f, 948.0f,
+    514.0f, 0.041015625f, 0.021484375f, 0.029296875f, 0.975761354f, 10.5f, 0.041015625f, 9.765625f, 0.562341779f, 0.001953125f, 0.5f, 0.998046875f,
+    0.5f, 0.044921875f, -0.0170800546f, 2.5f, 0.041015625f, 25.390625f, 839.5f, 2.5f, 2.5f, 0.5f, 244.5f, 0.5f,
+    8.5f, 0.001953125f, 17.578125f, 16.0f, 2.5f, 1538.5f, 0.5f, 613.5f, 839.5f, 17.578125f, 0.974609375f, 1.5f,
+    0.733774185f, 0.041015625f, 0.5f, 0.5f, 8.5f, 0.5f, 0.974609375f, 2.5f, 0.021484375f, 2.5f, 0.025390625f, 0.021484375f,
+    0.021484375f, 135.5f, 0.988259107f, 4.5f, 2.5f, 0.5f, 0.09765625f, 10.5f, 0.573933929f, 1.5f, 0.013671875f, 7.5f,
+    0.5f, 9.765625f, 2.5f, 6.5f, 1.5f, 0.912109375f, 0.080078125f, 0.5f, 0.958984375f, 0.5f, 0.5f, 129.0f,
+    3.5f, 0.025390625f, 2.5f, 0.021484375f, 2.5f, 0.5f, 0.495554671f, 0.297858998f, 0.013671875f, 0.041015625f, 0.08203125f, 0.896484375f,
+    2.5f, 0.447611377f, 0.986328125f, 6.5f, 0.982421875f, 3.5f, 0.001953125f, 0.013671875f, 7.8125f, 2.5f, 7.5f, 2.5f,
+    0.5f, 0.974609375f, 0.5f, 17.578125f, 135.5f, 3.5f, 0.021484375f, 9.765625f, 0.5f, 2.5f, 0.5f, 0.041015625f,
+    10.5f, 0.955525339f, 3.5f, 0.5f, 0.5f, 2.5f, 0.029296875f, 1.5f, 2.5f, 2.5f, 5.859375f, 1.5f,
+    4.5f, 1725.0f, 0.021484375f, 1.5f, 1.5f, 0.041015625f, 0.5f, 0.5f, 0.021484375f, 2.5f, 194.5f, 0.025390625f,
+    2.5f, 0.12109375f, 2.5f, 3.5f, 1.953125f, 37.5f, 2.5f, 0.827515274f, 0.0605449341f, 150.0f, 112.0f, 1.953125f,
+    0.974609375f, 1.5f, 11.5f, 1697.0f, 3.5f, 0.013671875f, 3.5f, 340.0f, 68.5f, 1.5f, 10.5f,
+};
+static const uint16_t RAILWAY_WINDOW_CHILDREN[] PROGMEM = {
+    0x0001, 0x0002, 0x0003, 0x0004, 0x0005, 0x0006, 0x0007, 0x0008, 0x0009, 0x000a, 0x000b, 0x000c,
+    0x000d, 0x000e, 0x000f, 0x0010, 0x0011, 0x0012, 0x0013, 0x0014, 0x0015, 0x0016, 0x0017, 0x0018,
+    0x0019, 0x8016, 0x001a, 0x001b, 0x001c, 0x001d, 0x8000, 0x8001, 0x8002, 0x8003, 0x8004, 0x8005,
+    0x8006, 0x8007, 0x8008, 0x8009, 0x800a, 0x800b, 0x800c, 0x800d, 0x800e, 0x800f, 0x8010, 0x8011,
+    0x8012, 0x8013, 0x8014, 0x8015, 0x8017, 0x8018, 0x8019, 0x801a, 0x801b, 0x801c, 0x801d, 0x801e,
+    0x001f, 0x0020, 0x0021, 0x0022, 0x0023, 0x0024, 0x0025, 0x0026, 0x0027, 0x0028, 0x0029, 0x002a,
+    0x002b, 0x002c, 0x002d, 0x002e, 0x002f, 0x0030, 0x0031, 0x0032, 0x0033, 0x0034, 0x0035, 0x0036,
+    0x0037, 0x0038, 0x0039, 0x003a, 0x003b, 0x003c, 0x801f, 0x8020, 0x8021, 0x8022, 0x8023, 0x8024,
+    0x8025, 0x8026, 0x8027, 0x8028, 0x8029, 0x802a, 0x802b, 0x802c, 0x802d, 0x802e, 0x802f, 0x8030,
+    0x8031, 0x8032, 0x8033, 0x8034, 0x8035, 0x8036, 0x8037, 0x8038, 0x8039, 0x803a, 0x803b, 0x803c,
+    0x803d, 0x803e, 0x003e, 0x003f, 0x0040, 0x0041, 0x0042, 0x0043, 0x0044, 0x0045, 0x0046, 0x0047,
+    0x0048, 0x0049, 0x004a, 0x004b, 0x004c, 0x004d, 0x004e, 0x004f, 0x0050, 0x0051, 0x0052, 0x0053,
+    0x0054, 0x0055, 0x0056, 0x0057, 0x8057, 0x0058, 0x0059, 0x005a, 0x803f, 0x8040, 0x8041, 0x8042,
+    0x8043, 0x8044, 0x8045, 0x8046, 0x8047, 0x8048, 0x8049, 0x804a, 0x804b, 0x804c, 0x804d, 0x804e,
+    0x804f, 0x8050, 0x8051, 0x8052, 0x8053, 0x8054, 0x8055, 0x8056, 0x8058, 0x8059, 0x805a, 0x805b,
+    0x805c, 0x805d, 0x005c, 0x005d, 0x005e, 0x005f, 0x0060, 0x0061, 0x0062, 0x0063, 0x0064, 0x0065,
+    0x0066, 0x0067, 0x0068, 0x0069, 0x006a, 0x006b, 0x006c, 0x006d, 0x006e, 0x006f, 0x0070, 0x0071,
+    0x0072, 0x8070, 0x0073, 0x8073, 0x0074, 0x0075, 0x0076, 0x0077, 0x805e, 0x805f, 0x8060, 0x8061,
+    0x8062, 0x8063, 0x8064, 0x8065, 0x8066, 0x8067, 0x8068, 0x8069, 0x806a, 0x806b, 0x806c, 0x806d,
+    0x806e, 0x806f, 0x8071, 0x8072, 0x8074, 0x8075, 0x8076, 0x8077, 0x8078, 0x8079, 0x807a, 0x807b,
+    0x0079, 0x007a, 0x007b, 0x007c, 0x007d, 0x007e, 0x007f, 0x0080, 0x0081, 0x0082, 0x0083, 0x0084,
+    0x0085, 0x0086, 0x0087, 0x0088, 0x0089, 0x008a, 0x008b, 0x8086, 0x008c, 0x008d, 0x008e, 0x008f,
+    0x0090, 0x0091, 0x0092, 0x0093, 0x0094, 0x0095, 0x807c, 0x807d, 0x807e, 0x807f, 0x8080, 0x8081,
+    0x8082, 0x8083, 0x8084, 0x8085, 0x8087, 0x8088, 0x8089, 0x808a, 0x808b, 0x808c, 0x808d, 0x808e,
+    0x808f, 0x8090, 0x8091, 0x8092, 0x8093, 0x8094, 0x8095, 0x8096, 0x8097, 0x8098, 0x8099, 0x809a,
+    0x0097, 0x0098, 0x0099, 0x009a, 0x009b, 0x009c, 0x009d, 0x009e, 0x009f, 0x00a0, 0x00a1, 0x00a2,
+    0x00a3, 0x00a4, 0x00a5, 0x00a6, 0x00a7, 0x00a8, 0x00a9, 0x00aa, 0x00ab, 0x00ac, 0x00ad, 0x00ae,
+    0x00af, 0x00b0, 0x80b3, 0x00b1, 0x80b6, 0x00b2, 0x809b, 0x809c, 0x809d, 0x809e, 0x809f, 0x80a0,
+    0x80a1, 0x80a2, 0x80a3, 0x80a4, 0x80a5, 0x80a6, 0x80a7, 0x80a8, 0x80a9, 0x80aa, 0x80ab, 0x80ac,
+    0x80ad, 0x80ae, 0x80af, 0x80b0, 0x80b1, 0x80b2, 0x80b4, 0x80b5, 0x80b7, 0x80b8,
+};
+static const uint16_t RAILWAY_WINDOW_PROBA[] PROGMEM = {
+    38550, 26985, 0, 0, 65060, 408, 45, 22, 18950, 19739, 0, 26846,
+    0, 65535, 0, 0, 65509, 8, 12, 6, 65253, 275, 7, 0,
+    21401, 43622, 0, 512, 13, 65522, 0, 0, 65302, 122, 3, 108,
+    64127, 0, 54, 1354, 31298, 33342, 0, 894, 67, 65393, 0, 75,
+    41576, 22315, 0, 1644, 27482, 0, 0, 38053, 20940, 44595, 0, 0,
+    90, 65445, 0, 0, 52679, 0, 9825, 3031, 45485, 0, 15860, 4189,
+    35108, 0, 25746, 4681, 24239, 0, 40398, 898, 14878, 0, 50657, 0,
+    156, 0, 65379, 0, 18853, 0, 46682, 0, 55881, 0, 0, 9654,
+    17104, 0, 0, 48431, 53302, 0, 0, 12233, 5208, 0, 0, 60327,
+    0, 0, 0, 65535, 37874, 0, 0, 27661, 1937, 0, 0, 63598,
+    45, 0, 0, 65490, 65519, 12, 2, 2, 41459, 21377, 0, 2699,
+    12854, 52681, 0, 0, 11, 65524, 0, 0, 57952, 1083, 6499, 0,
+    697, 64838, 0, 0, 58965, 320, 3678, 2572, 65496, 8, 16, 14,
+    40605, 24930, 0, 0, 54717, 2767, 2013, 6038, 65526, 0, 7, 2,
+    65254, 0, 281, 0, 32857, 0, 0, 32678, 25085, 39531, 0, 919,
+    16319, 46108, 0, 3108, 101, 65241, 0, 193, 12223, 0, 53203, 109,
+    25629, 0, 39906, 0, 65332, 0, 203, 0, 1066, 0, 64317, 152,
+    58, 0, 10242, 55235, 185, 0, 3527, 61824, 0, 0, 65504, 31,
+    123, 0, 34046, 31366, 28690, 0, 0, 36845, 45406, 0, 0, 20129,
+    65366, 0, 0, 169, 54380, 0, 0, 11155, 17662, 0, 0, 47873,
+    14016, 0, 1136, 50382, 1456, 0, 8738, 55341, 56, 0, 15, 65465,
+    55274, 7651, 0, 2610, 63847, 1479, 0, 209, 61486, 1500, 300, 2249,
+    15055, 49594, 0, 886, 62060, 0, 3282, 193, 32879, 0, 32656, 0,
+    63200, 2223, 0, 111, 65525, 4, 4, 1, 45717, 0, 16140, 3678,
+    53118, 0, 4139, 8278, 26949, 0, 38586, 0, 179, 0, 65356, 0,
+    58751, 0, 0, 6784, 37449, 0, 0, 28086, 12509, 0, 0, 53026,
+    30403, 0, 0, 35132, 65153, 367, 0, 15, 110, 65393, 0, 31,
+    64956, 0, 0, 579, 65261, 0, 0, 274, 30711, 0, 0, 34824,
+    57719, 0, 0, 7816, 19350, 46185, 0, 0, 34, 65501, 0, 0,
+    28001, 0, 2383, 35151, 23002, 0, 0, 42533, 11787, 0, 0, 53748,
+    12136, 0, 1618, 51781, 1080, 0, 0, 64455, 1939, 0, 646, 62950,
+    43, 0, 9, 65483, 58866, 4078, 0, 2591, 29424, 29424, 0, 6687,
+    65509, 6, 13, 7, 64715, 0, 820, 0, 52785, 0, 9808, 2942,
+    34257, 0, 23831, 7447, 797, 0, 64730, 7, 26214, 0, 37573, 1748,
+    46711, 0, 0, 18824, 20585, 0, 0, 44950, 63773, 0, 0, 1762,
+    55512, 0, 0, 10023, 60976, 0, 4559, 0, 31831, 0, 33704, 0,
+    11183, 0, 54352, 0, 14, 0, 65521, 0, 32179, 31852, 0, 1504,
+    38345, 25099, 0, 2092, 55580, 6636, 0, 3318, 122, 65401, 0, 12,
+    2234, 63301, 0, 0, 5461, 59294, 0, 780, 59762, 0, 0, 5773,
+    50358, 0, 0, 15177, 40140, 0, 0, 25395, 25172, 0, 0, 40363,
+    9161, 0, 0, 56374, 28755, 0, 0, 36780, 15434, 0, 0, 50101,
+    84, 0, 0, 65451, 65474, 14, 34, 13, 7211, 57899, 0, 425,
+    65352, 104, 12, 67, 3284, 61795, 0, 456, 39600, 11992, 0, 13944,
+    65521, 0, 9, 5, 25674, 38510, 0, 1351, 349, 65163, 0, 23,
+    22378, 0, 0, 43157, 38277, 0, 0, 27258, 57915, 0, 0, 7620,
+    32673, 32862, 0, 0, 63194, 2341, 0, 0, 18447, 47088, 0, 0,
+    32, 65503, 0, 0, 53481, 0, 7724, 4330, 44801, 0, 18142, 2592,
+    25845, 0, 39690, 0, 8913, 0, 56622, 0, 8507, 0, 55453, 1575,
+    5393, 0, 60142, 0, 7, 0, 65528, 0, 799, 0, 64736, 0,
+    48136, 0, 0, 17399, 30895, 0, 0, 34640, 65195, 0, 0, 340,
+    50548, 0, 0, 14987, 22215, 0, 0, 43320, 11440, 0, 0, 54095,
+    16495, 0, 0, 49040, 35, 0, 0, 65500, 59806, 235, 0, 5494,
+    57749, 7786, 0, 0, 35434, 0, 0, 30101, 32507, 33028, 0, 0,
+    50703, 0, 14487, 345, 60476, 0, 4369, 690, 65519, 5, 6, 5,
+    60826, 785, 0, 3924, 55991, 0, 8908, 636, 51027, 0, 9005, 5503,
+    2809, 0, 61790, 936, 0, 0, 65535, 0, 17, 0, 65518, 0,
+    1456, 0, 64079, 0, 35160, 0, 27583, 2792, 357, 0, 65157, 21,
+    58792, 0, 0, 6743, 37449, 390, 0, 27696, 46371, 16170, 0, 2994,
+    20648, 41745, 0, 3142, 27972, 28771, 0, 8791, 21051, 44087, 0, 397,
+    7384, 41536, 0, 16615, 107, 65424, 0, 4, 41527, 0, 0, 24008,
+    22917, 0, 0, 42618, 12725, 0, 0, 52810, 71, 0, 0, 65464,
+    4366, 0, 0, 61169, 8, 0, 0, 65527,
+};
+
+// predict_proba() of the inputs at sample CHECK_SAMPLES of host/tracks/glitchy.csv, for host checks
+#define RAILWAY_WINDOW_CHECK_TRACE "host/tracks/glitchy.csv"
+#define RAILWAY_WINDOW_CHECK_COUNT 65
+static const uint32_t RAILWAY_WINDOW_CHECK_SAMPLES[] PROGMEM = {
+    0, 3774, 7548, 9574, 9576, 9579, 9594, 11322, 15096, 15265, 15267, 15270,
+    15285, 17635, 17637, 17640, 17655, 18870, 22644, 26418, 26979, 26981, 26984, 26999,
+    30192, 32788, 32790, 32793, 32808, 33966, 34239, 34241, 34244, 34259, 37740, 41119,
+    41121, 41124, 41139, 41514, 45288, 49062, 51929, 51931, 51934, 51949, 52836, 56610,
+    60384, 64158, 67932, 71706, 75480, 79254, 83028, 86802, 90576, 94350, 98124, 101898,
+    105672, 109446, 113220, 116994, 120768,
+};
+static const float RAILWAY_WINDOW_CHECK_INPUTS[] PROGMEM = {
+    0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f, 0.0f, 0.0f, 0.0f,
+    0.0f, 0.0f, 0.0f, 0.0f, 1113.0f, 792.0f, 792.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f,
+    0.0f, 0.0f, 1485.0f, 1485.0f, 1485.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.00390625f, 0.0f, 3.90625f,
+    851.0f, 1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0078125f, 0.0f, 11.71875f, 853.0f, 1.0f,
+    1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.01171875f, 0.0f, 15.625f, 856.0f, 2.0f, 2.0f, 0.0f,
+    0.0f, 1.0f, 0.0f, 0.0703125f, 0.0f, 19.53125f, 871.0f, 15.0f, 15.0f, 0.0f, 0.0f, 0.0f,
+    0.0f, 0.43359375f, 0.0f, 11.71875f, 2599.0f, 143.0f, 143.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f,
+    0.0f, 0.0f, 484.0f, 445.0f, 445.0f, 0.0f, 1.0f, 0.0f, 0.00390625f, 0.0f, 3.90625f, 0.0f,
+    1.0f, 614.0f, 1.0f, 0.0f, 1.0f, 0.0f, 0.01171875f, 0.0f, 3.90625f, 0.0f, 3.0f, 616.0f,
+    3.0f, 0.0f, 1.0f, 0.0f, 0.0234375f, 0.0f, 3.90625f, 0.0f, 6.0f, 619.0f, 6.0f, 0.0f,
+    1.0f, 0.0f, 0.08203125f, 0.0f, 3.90625f, 0.0f, 21.0f, 634.0f, 21.0f, 0.0f, 1.0f, 0.0f,
+    0.015625f, 0.0f, 19.53125f, 0.0f, 1.0f, 2984.0f, 1.0f, 0.0f, 1.0f, 0.0f, 0.0234375f, 0.0f,
+    19.53125f, 0.0f, 3.0f, 2986.0f, 3.0f, 0.0f, 1.0f, 0.0f, 0.03515625f, 0.0f, 19.53125f, 0.0f,
+    6.0f, 2989.0f, 6.0f, 0.0f, 1.0f, 0.0f, 0.09375f, 0.0f, 19.53125f, 0.0f, 21.0f, 3004.0f,
+    21.0f, 0.0f, 0.0f, 0.0f, 0.00390625f, 0.00390625f, 7.8125f, 7.8125f, 55.0f, 55.0f, 55.0f, 1.0f,
+    0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 403.0f, 403.0f, 403.0f, 0.0f, 0.0f, 0.0f,
+    0.0f, 0.0f, 0.0f, 0.0f, 1302.0f, 1302.0f, 1302.0f, 0.0f, 1.0f, 0.0f, 0.00390625f, 0.0f,
+    3.90625f, 0.0f, 1.0f, 1863.0f, 1.0f, 0.0f, 1.0f, 0.0f, 0.01171875f, 0.0f, 3.90625f, 0.0f,
+    3.0f, 1865.0f, 3.0f, 0.0f, 1.0f, 0.0f, 0.0234375f, 0.0f, 3.90625f, 0.0f, 6.0f, 1868.0f,
+    6.0f, 0.0f, 1.0f, 0.0f, 0.08203125f, 0.0f, 3.90625f, 0.0f, 21.0f, 1883.0f, 21.0f, 0.0f,
+    0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1264.0f, 1264.0f, 1264.0f, 0.0f, 0.0f, 0.0f,
+    0.0f, 0.0078125f, 0.0f, 7.8125f, 626.0f, 150.0f, 150.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.01171875f,
+    0.0f, 11.71875f, 628.0f, 1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.01953125f, 0.0f, 19.53125f,
+    631.0f, 1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.078125f, 0.0f, 19.53125f, 646.0f, 16.0f,
+    16.0f, 0.0f, 0.0f, 0.0f, 0.0078125f, 0.0f, 7.8125f, 0.0f, 170.0f, 739.0f, 170.0f, 0.0f,
+    0.0f, 0.0f, 0.0078125f, 0.0078125f, 7.8125f, 7.8125f, 249.0f, 249.0f, 249.0f, 1.0f, 0.0f, 0.0f,
+    0.0078125f, 0.01171875f, 7.8125f, 15.625f, 251.0f, 1.0f, 1.0f, 0.814887702f, 0.0f, 1.0f, 0.0078125f, 0.01953125f,
+    3.90625f, 15.625f, 254.0f, 2.0f, 2.0f, 0.628709495f, 0.0f, 1.0f, 0.0f, 0.0703125f, 0.0f, 11.71875f,
+    269.0f, 17.0f, 17.0f, 0.0f, 0.0f, 0.0f, 0.0078125f, 0.0078125f, 7.8125f, 7.8125f, 196.0f, 196.0f,
+    196.0f, 1.0f, 1.0f, 0.0f, 0.00390625f, 0.0f, 3.90625f, 0.0f, 1.0f, 2564.0f, 1.0f, 0.0f,
+    1.0f, 0.0f, 0.01171875f, 0.0f, 3.90625f, 0.0f, 3.0f, 2566.0f, 3.0f, 0.0f, 1.0f, 0.0f,
+    0.0234375f, 0.0f, 3.90625f, 0.0f, 6.0f, 2569.0f, 6.0f, 0.0f, 1.0f, 0.0f, 0.08203125f, 0.0f,
+    3.90625f, 0.0f, 21.0f, 2584.0f, 21.0f, 0.0f, 1.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f,
+    396.0f, 2959.0f, 396.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 481.0f, 829.0f,
+    481.0f, 0.0f, 0.0f, 0.0f, 0.0078125f, 0.0078125f, 7.8125f, 7.8125f, 135.0f, 135.0f, 135.0f, 1.0f,
+    1.0f, 0.0f, 0.0078125f, 0.00390625f, 11.71875f, 7.8125f, 1.0f, 99.0f, 1.0f, 0.705718935f, 1.0f, 0.0f,
+    0.01171875f, 0.00390625f, 19.53125f, 7.8125f, 1.0f, 101.0f, 1.0f, 0.575081706f, 1.0f, 0.0f, 0.01953125f, 0.00390625f,
+    27.34375f, 7.8125f, 2.0f, 104.0f, 2.0f, 0.443692178f, 1.0f, 0.0f, 0.0703125f, 0.00390625f, 35.15625f, 7.8125f,
+    13.0f, 119.0f, 13.0f, 0.227710024f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 834.0f, 1006.0f,
+    834.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 460.0f, 460.0f, 460.0f, 0.0f,
+    0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 572.0f, 1577.0f, 572.0f, 0.0f, 0.0f, 0.0f,
+    0.0234375f, 0.0f, 15.625f, 0.0f, 101.0f, 335.0f, 101.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.9921875f,
+    0.0f, 7.8125f, 765.0f, 253.0f, 253.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f,
+    367.0f, 367.0f, 367.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 773.0f, 1744.0f,
+    773.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.15234375f, 0.0f, 19.53125f, 297.0f, 36.0f, 36.0f, 0.0f,
+    0.0f, 0.0f, 0.00390625f, 0.0f, 7.8125f, 0.0f, 7.0f, 1332.0f, 7.0f, 0.0f, 0.0f, 0.0f,
+    0.00390625f, 0.0f, 7.8125f, 0.0f, 206.0f, 448.0f, 206.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0078125f,
+    0.0f, 7.8125f, 538.0f, 245.0f, 245.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f,
+    963.0f, 369.0f, 369.0f, 0.0f, 0.0f, 0.0f, 0.01171875f, 0.0f, 7.8125f, 0.0f, 161.0f, 3043.0f,
+    161.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1104.0f, 1104.0f, 1104.0f, 0.0f,
+    0.0f, 0.0f, 0.0f, 0.00390625f, 0.0f, 7.8125f, 863.0f, 217.0f, 217.0f, 0.0f, 0.0f, 0.0f,
+    0.0f, 0.00390625f, 0.0f, 7.8125f, 958.0f, 135.0f, 135.0f, 0.0f, 0.0f, 1.0f, 0.0f, 1.0f,
+    0.0f, 0.0f, 2854.0f, 807.0f, 807.0f, 0.0f, 0.0f, 0.0f, 0.015625f, 0.00390625f, 15.625f, 7.8125f,
+    40.0f, 240.0f, 40.0f, 0.497050136f, 1.0f, 0.0f, 0.99609375f, 0.0f, 7.8125f, 0.0f, 1.0f, 1588.0f,
+    1.0f, 0.0f,
+};
+static const float RAILWAY_WINDOW_CHECK[] PROGMEM = {
+    0.94096799f, 0.031532958f, 0.000207457701f, 0.0272915942f, 0.998464541f, 0.00114403266f, 0.000266878103f, 0.000124547767f, 0.999606795f, 0.000127572934f, 0.000182101731f, 8.35306549e-05f,
+    0.759865801f, 0.000814417823f, 0.190120496f, 0.0491992847f, 0.737789866f, 0.000814417823f, 0.216616999f, 0.044778717f, 0.935306025f, 0.0019038468f, 0.0547757472f, 0.00801438121f,
+    0.03489166f, 0.0f, 0.964761307f, 0.000347033209f, 0.897018103f, 0.00111279711f, 0.101750232f, 0.000118868576f, 0.998464541f, 0.00114403266f, 0.000266878103f, 0.000124547767f,
+    0.629569139f, 0.344236081f, 0.000115453695f, 0.0260793262f, 0.651372741f, 0.328539571f, 0.000115453695f, 0.0199722341f, 0.380342665f, 0.601266677f, 0.000115453695f, 0.0182752036f,
+    0.217348457f, 0.781277886f, 0.000115453695f, 0.00125820385f, 0.549019466f, 0.424853324f, 0.0f, 0.0261272096f, 0.446736742f, 0.531521367f, 0.0f, 0.0217418914f,
+    0.103722785f, 0.891395478f, 0.0f, 0.00488173729f, 0.00217747416f, 0.996959172f, 0.0f, 0.00086335403f, 0.998406848f, 0.0011341529f, 0.000303520912f, 0.000155478497f,
+    0.998464541f, 0.00114403266f, 0.000266878103f, 0.000124547767f, 0.999606795f, 0.000127572934f, 0.000182101731f, 8.35306549e-05f, 0.518538008f, 0.454136131f, 0.0f, 0.0273258611f,
+    0.540341609f, 0.438439622f, 0.0f, 0.021218769f, 0.269311534f, 0.711166728f, 0.0f, 0.0195217385f, 0.0519244003f, 0.946872944f, 0.0f, 0.00120265537f,
+    0.999606795f, 0.000127572934f, 0.000182101731f, 8.35306549e-05f, 0.998406848f, 0.0011341529f, 0.000303520912f, 0.000155478497f, 0.737789866f, 0.000814417823f, 0.216616999f, 0.044778717f,
+    0.66546241f, 0.000814417823f, 0.294370016f, 0.0393531565f, 0.03489166f, 0.0f, 0.964761307f, 0.000347033209f, 0.998464541f, 0.00114403266f, 0.000266878103f, 0.000124547767f,
+    0.998406848f, 0.0011341529f, 0.000303520912f, 0.000155478497f, 0.960159826f, 0.0019038468f, 0.029044753f, 0.0088915742f, 0.711926258f, 0.000814417823f, 0.226586595f, 0.0606727294f,
+    0.03489166f, 0.0f, 0.964761307f, 0.000347033209f, 0.998406848f, 0.0011341529f, 0.000303520912f, 0.000155478497f, 0.518538008f, 0.454136131f, 0.0f, 0.0273258611f,
+    0.540341609f, 0.438439622f, 0.0f, 0.021218769f, 0.269311534f, 0.711166728f, 0.0f, 0.0195217385f, 0.0519244003f, 0.946872944f, 0.0f, 0.00120265537f,
+    0.000810181891f, 0.999148049f, 0.0f, 4.17695678e-05f, 0.998464541f, 0.00114403266f, 0.000266878103f, 0.000124547767f, 0.998406848f, 0.0011341529f, 0.000303520912f, 0.000155478497f,
+    0.551593147f, 0.419942948f, 0.0f, 0.0284639052f, 0.60853335f, 0.360726304f, 0.0f, 0.0307403462f, 0.564700869f, 0.407678454f, 0.0f, 0.0276206766f,
+    0.00217747416f, 0.996959172f, 0.0f, 0.00086335403f, 0.999606795f, 0.000127572934f, 0.000182101731f, 8.35306549e-05f, 0.998464541f, 0.00114403266f, 0.000266878103f, 0.000124547767f,
+    0.999606795f, 0.000127572934f, 0.000182101731f, 8.35306549e-05f, 0.998789584f, 0.000614274683f, 0.000116142276f, 0.000479998574f, 0.032898287f, 0.0f, 0.966772788f, 0.00032892514f,
+    0.998464541f, 0.00114403266f, 0.000266878103f, 0.000124547767f, 0.999606795f, 0.000127572934f, 0.000182101731f, 8.35306549e-05f, 0.03489166f, 0.0f, 0.964761307f, 0.000347033209f,
+    0.994688119f, 0.00455556888f, 0.000159526663f, 0.000596785824f, 0.998464541f, 0.00114403266f, 0.000266878103f, 0.000124547767f, 0.998406848f, 0.0011341529f, 0.000303520912f, 0.000155478497f,
+    0.998464541f, 0.00114403266f, 0.000266878103f, 0.000124547767f, 0.998955944f, 0.000804762261f, 0.000170294113f, 6.89992914e-05f, 0.999606795f, 0.000127572934f, 0.000182101731f, 8.35306549e-05f,
+    0.998406848f, 0.0011341529f, 0.000303520912f, 0.000155478497f, 0.998406848f, 0.0011341529f, 0.000303520912f, 0.000155478497f, 0.000947948987f, 0.0f, 0.998973249f, 7.88022065e-05f,
+    0.998789584f, 0.000614274683f, 0.000116142276f, 0.000479998574f, 0.318612212f, 0.675249922f, 0.0f, 0.00613786631f,
+};
+
+static const Forest<RAILWAY_WINDOW_FEATURES, RAILWAY_WINDOW_CLASSES> railwayWindow(
+    RAILWAY_WINDOW_UNIQUE_TREES, RAILWAY_WINDOW_TREES, RAILWAY_WINDOW_ROOTS, RAILWAY_WINDOW_WEIGHTS,
+    RAILWAY_WINDOW_FEATURE, RAILWAY_WINDOW_THRESHOLD, RAILWAY_WINDOW_CHILDREN, RAILWAY_WINDOW_PROBA);
@@ -0,0 +1,86 @@
+#include "binlog.h"
+#include "hal.h"
+
+BinLog binLog;
+
+#define BINLOG_ARGS(id, args, format) args,
+static const uint8_t argCounts[LOG_MESSAGE_COUNT] = {BINLOG_MESSAGES(BINLOG_ARGS)};
+#undef BINLOG_ARGS
+
+static uint8_t *putVarint(uint8_t *p, uint32_t v)
+{
+    while (v >= 0x40)
+    {
+        *p++ = 0x40 | (v & 0x3f);
+        v >>= 6;
+    }
+    *p++ = v;
+    return p;
+}
+
+static uint8_t *encode(uint8_t *p, LogMessage id, uint32_t sinceMs, const uint32_t *args, int count)
+{
+    *p++ = BINLOG_MARK;
+    *p++ = uint8_t(count << 5 | id);
+    p = putVarint(p, sinceMs);
+    for (int i = 0; i < count; i++)
+        p = putVarint(p, args[i]);
+    return p;
+}
+
+void BinLog::log(LogMessage id, uint32_t a, uint32_t b, uint32_t c)
+{
+    uint32_t args[3] = {a, b, c};
+    uint32_t nowMs = millis();
+    // The notice of a gap goes in with the next record or not at all, so a
+    // nearly full ring does not fill up with notices.
+    uint8_t record[2 * BINLOG_RECORD_MAX];
+    uint8_t *p = record;
+    if (droppedUnreported)
+        p = encode(p, LOG_DROPPED, nowMs - lastMs, &droppedUnreported, 1);
+    p = encode(p, id, droppedUnreported ? 0 : nowMs - lastMs, args, argCounts[id]);
+    if (!push(record, p - record))
+    {
+        droppedUnreported++;
+        droppedTotal++;
+        return;
+    }
+    lastMs = nowMs;
+    droppedUnreported = 0;
+    logged++;
+}
+
+bool BinLog::push(const uint8_t *data, uint32_t size)
+{
+    uint32_t h = head.load(std::memory_order_relaxed);
+    if (BINLOG_RING_SIZE - (h - tail.load(std::memory_order_acquire)) < size)
+        return false;
+    for (uint32_t i = 0; i < size; i++)
+        ring[(h + i) & (BINLOG_RING_SIZE - 1)] = data[i];
+    head.store(h + size, std::memory_order_release);
+    return true;
+}
+
+size_t BinLog::drain()
+{
+    uint32_t t = tail.load(std::memory_order_relaxed);
+    uint32_t h = head.load(std::memory_order_acquire);
+    int room = Serial.availableForWrite();
+    size_t total = 0;
+    while (t != h && room > 0)
+    {
+        uint32_t at = t & (BINLOG_RING_SIZE - 1);
+        uint32_t n = h - t;
+        if (n > BINLOG_RING_SIZE - at)
+            n = BINLOG_RING_SIZE - at;
+        if (n > uint32_t(room))
+            n = room;
+        Serial.write(ring + at, n);
+        t += n;
+        room -= n;
+        total += n;
+    }
+    tail.store(t, std::memory_order_release);
+    sent += total;
+    return total;
+}
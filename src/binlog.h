@@ -0,0 +1,218 @@
+#pragma once
+// Console log as compact binary records. log() encodes a message id and its
+// arguments into a RAM ring and returns; drain(), called from loop() when
+// the tasks are done, hands the UART only as many bytes as its FIFO has
+// room for. Nothing waits on the 115200 baud line and nothing allocates.
+// A record that does not fit in the ring is dropped and counted, and the
+// next one that does fit is preceded by a LOG_DROPPED record saying how
+// many went missing.
+//
+// A record is 0xfe, a byte with the argument count (bits 5-6) and message
+// id, then the milliseconds since the previous record and each argument as
+// varints of six bits a byte, bit 6 set on all but the last. Every byte but
+// the marker is below 0x80, so the decoder resyncs on the next 0xfe after
+// line noise or the boot ROM's chatter. build/logdecode (host) turns a
+// captured stream back into the lines Serial.println used to print.
+//
+// Formats take %u, %d, %x, %h (hundredths: 1234 prints as 12.34), %P (a
+// Prediction's name) and %S (a Severity's name).
+#include <atomic>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "device_state.h"
+
+#define BINLOG_MESSAGES(X)                                                                                           \
+    X(LOG_DROPPED, 1, "(%u log records dropped)")                                                                    \
+    X(LOG_BOOT, 0, "starting...")                                                                                    \
+    X(LOG_NO_EVENT_LOG, 0, "event log disabled: flash layout has no room")                                           \
+    X(LOG_MODEL_LOADED, 0, "model loaded from flash")                                                                \
+    X(LOG_SERVER_STARTED, 0, "server started.")                                                                      \
+    X(LOG_STATUS, 3, "AI Status: %P | Fault: %h%% | Severity: %S")                                                   \
+    X(LOG_FAULT, 3, "⚠ %P detected! Train Stopped 🚨 | Fault: %h%% | Severity: %S")
+
+#define BINLOG_ID(id, args, format) id,
+enum LogMessage : uint8_t
+{
+    BINLOG_MESSAGES(BINLOG_ID) LOG_MESSAGE_COUNT
+};
+#undef BINLOG_ID
+
+#define BINLOG_MARK 0xfe
+#define BINLOG_RING_SIZE 512
+// Marker, header, and six bytes for each 32-bit varint.
+#define BINLOG_RECORD_MAX (2 + 6 * 4)
+
+class BinLog
+{
+    static_assert((BINLOG_RING_SIZE & (BINLOG_RING_SIZE - 1)) == 0, "ring size must be a power of two");
+
+public:
+    // From loop() and its tasks only: one producer, never an interrupt.
+    void log(LogMessage id, uint32_t a = 0, uint32_t b = 0, uint32_t c = 0);
+
+    // Writes what the UART takes without blocking. Returns the bytes sent.
+    size_t drain();
+
+    uint32_t pending() const
+    {
+        return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+    }
+    uint32_t records() const { return logged; }
+    uint32_t dropped() const { return droppedTotal; }
+    uint64_t bytesSent() const { return sent; }
+
+private:
+    bool push(const uint8_t *data, uint32_t size);
+
+    uint8_t ring[BINLOG_RING_SIZE];
+    std::atomic<uint32_t> head{0};
+    std::atomic<uint32_t> tail{0};
+    uint32_t lastMs = 0;
+    uint32_t logged = 0;
+    uint32_t droppedTotal = 0;
+    uint32_t droppedUnreported = 0;
+    uint64_t sent = 0;
+};
+
+extern BinLog binLog;
+
+// Host side: feed it the UART bytes in any slices, get one line per record.
+class BinLogDecoder
+{
+public:
+    // line(timeMs, text) for each complete record. Bytes outside records
+    // are counted and skipped.
+    template <typename Line>
+    void feed(const uint8_t *data, size_t size, Line line)
+    {
+        for (size_t i = 0; i < size; i++)
+        {
+            uint8_t b = data[i];
+            if (b == BINLOG_MARK)
+            {
+                if (state != IDLE)
+                    broken++;
+                state = HEADER;
+                continue;
+            }
+            switch (state)
+            {
+            case IDLE:
+                skipped++;
+                break;
+            case HEADER:
+                id = b & 0x1f;
+                count = b >> 5;
+                field = 0;
+                value = 0;
+                shift = 0;
+                state = b < 0x80 && id < LOG_MESSAGE_COUNT && count <= 3 ? FIELDS : IDLE;
+                if (state == IDLE)
+                    broken++;
+                break;
+            case FIELDS:
+                if (b & 0x80)
+                {
+                    broken++;
+                    state = IDLE;
+                    break;
+                }
+                value |= uint32_t(b & 0x3f) << shift;
+                shift += 6;
+                if (b & 0x40 && shift < 36)
+                    break;
+                if (field == 0)
+                    timeMs += value;
+                else
+                    args[field - 1] = value;
+                field++;
+                value = 0;
+                shift = 0;
+                if (field > count)
+                {
+                    char text[192];
+                    format(text, sizeof(text), formats()[id], args, count);
+                    line(timeMs, (const char *)text);
+                    decoded++;
+                    state = IDLE;
+                }
+                break;
+            }
+        }
+    }
+
+    uint64_t decoded = 0;
+    uint64_t skipped = 0; // bytes between records
+    uint64_t broken = 0;  // records cut short by a new marker or a bad id
+
+    static const char *const *formats()
+    {
+#define BINLOG_FORMAT(id, args, format) format,
+        static const char *const table[] = {BINLOG_MESSAGES(BINLOG_FORMAT)};
+#undef BINLOG_FORMAT
+        return table;
+    }
+
+    static void format(char *out, size_t size, const char *f, const uint32_t *args, int count)
+    {
+        size_t n = 0;
+        int next = 0;
+        for (; *f && n + 1 < size; f++)
+        {
+            if (*f != '%' || !f[1])
+            {
+                out[n++] = *f;
+                continue;
+            }
+            char spec = *++f;
+            uint32_t v = spec != '%' && next < count ? args[next++] : 0;
+            int w = 0;
+            switch (spec)
+            {
+            case 'u':
+                w = snprintf(out + n, size - n, "%lu", (unsigned long)v);
+                break;
+            case 'd':
+                w = snprintf(out + n, size - n, "%ld", (long)int32_t(v));
+                break;
+            case 'x':
+                w = snprintf(out + n, size - n, "%lx", (unsigned long)v);
+                break;
+            case 'h':
+                w = snprintf(out + n, size - n, "%lu.%02lu", (unsigned long)v / 100, (unsigned long)v % 100);
+                break;
+            case 'P':
+                w = snprintf(out + n, size - n, "%s", predictionName(Prediction(v <= PRED_UNKNOWN ? v : PRED_UNKNOWN)));
+                break;
+            case 'S':
+                w = snprintf(out + n, size - n, "%s", severityName(Severity(v <= SEVERITY_CRITICAL ? v : 0)));
+                break;
+            default:
+                w = snprintf(out + n, size - n, "%%");
+                break;
+            }
+            n += w > 0 ? size_t(w) : 0;
+            if (n >= size)
+                n = size - 1;
+        }
+        out[n] = '\0';
+    }
+
+private:
+    enum State : uint8_t
+    {
+        IDLE,
+        HEADER,
+        FIELDS
+    };
+    State state = IDLE;
+    uint8_t id = 0;
+    int count = 0;
+    int field = 0;
+    uint32_t value = 0;
+    int shift = 0;
+    uint32_t args[3] = {};
+    uint32_t timeMs = 0;
+};
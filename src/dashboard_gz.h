@@ -0,0 +1,257 @@
+#pragma once
+// Generated by gen_dashboard.py from dashboard.html (12828 bytes) -- do not edit.
+#include "hal.h"
+
+#define DASHBOARD_ETAG "\"d79b89ffa847a520\""
+const size_t DASHBOARD_GZ_LEN = 3970;
+const uint8_t DASHBOARD_GZ[] PROGMEM = {
+    0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xed, 0x5b, 0x6b, 0x73, 0xdb, 0xc8,
+    0x72, 0xfd, 0x6c, 0xfe, 0x8a, 0x59, 0x6e, 0xed, 0x82, 0x2a, 0x09, 0x10, 0x1e, 0x04, 0x09, 0x8a,
+    0xa2, 0x36, 0x32, 0x2d, 0xc7, 0x4e, 0x64, 0x6b, 0xcb, 0x52, 0xea, 0xde, 0xd4, 0xd6, 0x96, 0x0b,
+    0x02, 0x86, 0x24, 0xd6, 0x20, 0x40, 0x03, 0xa0, 0x28, 0xd9, 0x57, 0xff, 0x3d, 0xa7, 0x67, 0x06,
+    0x20, 0xf8, 0x92, 0x29, 0xfb, 0x56, 0x92, 0xaa, 0x84, 0x25, 0xe2, 0x31, 0xd3, 0x73, 0xba, 0x7b,
+    0xfa, 0x31, 0x3d, 0x00, 0x75, 0xfa, 0xd3, 0xab, 0xab, 0xe1, 0xcd, 0x7f, 0xfe, 0x7e, 0xc1, 0x26,
+    0xc5, 0x34, 0x3e, 0x6b, 0x9c, 0x96, 0x27, 0xee, 0x87, 0x38, 0xe5, 0xc5, 0x43, 0xcc, 0xcf, 0x6e,
+    0xd3, 0xf0, 0xe1, 0x6b, 0xe3, 0xd6, 0x0f, 0x3e, 0x8d, 0xb3, 0x74, 0x9e, 0x84, 0x7a, 0x90, 0xc6,
+    0x69, 0x76, 0xc2, 0x7e, 0x7e, 0x6d, 0xbd, 0x1e, 0xbe, 0x7e, 0xdd, 0x6f, 0xcc, 0xfc, 0x30, 0x8c,
+    0x92, 0xf1, 0x89, 0x39, 0xbb, 0xef, 0x37, 0xa6, 0x7e, 0x36, 0x8e, 0x12, 0x79, 0x5d, 0xf0, 0xfb,
+    0x42, 0xf7, 0xe3, 0x68, 0x9c, 0x9c, 0xb0, 0x80, 0x27, 0x05, 0xcf, 0xfa, 0x8d, 0xc7, 0x06, 0x81,
+    0xf3, 0xec, 0x2b, 0xce, 0xd1, 0x78, 0x52, 0x9c, 0x38, 0x2e, 0x91, 0x96, 0x18, 0xd6, 0xfa, 0xc0,
+    0x98, 0x8f, 0x8a, 0x7e, 0x23, 0x8c, 0xf2, 0x59, 0xec, 0x3f, 0x9c, 0xb0, 0x51, 0xcc, 0xd1, 0xbf,
+    0x45, 0x18, 0xd3, 0xec, 0x39, 0x17, 0x3d, 0x00, 0xa5, 0x79, 0x54, 0x44, 0x69, 0x72, 0x32, 0x8a,
+    0xee, 0x79, 0xd8, 0x6f, 0x2c, 0xa2, 0xb0, 0x98, 0x00, 0xd6, 0xfc, 0xa5, 0xdf, 0xf8, 0xa2, 0x47,
+    0x49, 0xc8, 0xef, 0xe9, 0x0e, 0x3c, 0xd2, 0xd9, 0x89, 0x49, 0xf2, 0x8c, 0xd2, 0xb4, 0x20, 0x79,
+    0x4a, 0x11, 0x6c, 0x21, 0xc2, 0x63, 0x03, 0x1d, 0xd9, 0xf4, 0x6b, 0xa9, 0x90, 0x05, 0x31, 0x99,
+    0x3f, 0x2f, 0x52, 0x66, 0xaa, 0x0b, 0xd2, 0xf5, 0x5e, 0x97, 0xf8, 0x3d, 0x82, 0xdf, 0x22, 0xd5,
+    0xb9, 0xf8, 0x2c, 0xd5, 0x63, 0x02, 0xc6, 0x54, 0x27, 0x0c, 0x49, 0x33, 0xcc, 0x85, 0x9e, 0xf9,
+    0x61, 0x34, 0xcf, 0x4f, 0x98, 0xab, 0x38, 0xdf, 0xce, 0x8b, 0x22, 0x4d, 0x2a, 0xde, 0xde, 0x26,
+    0xeb, 0xe7, 0xb2, 0x35, 0x25, 0x5b, 0x73, 0x37, 0xdb, 0x51, 0x9a, 0x14, 0x7a, 0x1e, 0x7d, 0xe1,
+    0x27, 0xcc, 0x6e, 0x57, 0x0d, 0x0b, 0x69, 0x24, 0x76, 0x9b, 0xc6, 0x98, 0x4c, 0x89, 0xbf, 0x98,
+    0x44, 0x05, 0x2f, 0x41, 0x4e, 0x58, 0x92, 0x26, 0x9c, 0xa4, 0x96, 0x42, 0x9f, 0xf8, 0x41, 0x11,
+    0xdd, 0x71, 0xf6, 0x55, 0x89, 0xe8, 0xf5, 0x7e, 0xd9, 0x2d, 0x87, 0xc4, 0xbb, 0x8d, 0xa1, 0x01,
+    0x21, 0x44, 0xc9, 0x6c, 0x5e, 0xec, 0xa9, 0xf5, 0xf7, 0xaa, 0x66, 0x53, 0xc3, 0x0a, 0xdf, 0x75,
+    0x3d, 0x1a, 0xb1, 0x7f, 0xcb, 0xe3, 0x27, 0x0d, 0xbf, 0x4d, 0x0e, 0x29, 0x86, 0x92, 0x62, 0x83,
+    0x63, 0xe9, 0xc0, 0xb7, 0x71, 0x2a, 0x75, 0x6d, 0x18, 0x24, 0x62, 0xaa, 0x93, 0xe5, 0x66, 0x5b,
+    0x98, 0x55, 0x57, 0x5b, 0x2c, 0x53, 0xf7, 0xe9, 0x12, 0x58, 0x06, 0x06, 0x1d, 0xf5, 0x30, 0xca,
+    0x78, 0x20, 0x62, 0x80, 0x65, 0xe9, 0x62, 0x4b, 0x34, 0x3d, 0x96, 0xcc, 0x57, 0x35, 0x35, 0xeb,
+    0x81, 0xa8, 0x82, 0x40, 0x12, 0x96, 0xc6, 0x74, 0xec, 0xd5, 0x10, 0x57, 0xb3, 0x4e, 0x17, 0xa5,
+    0xeb, 0x1a, 0x01, 0xa4, 0x45, 0xac, 0x97, 0xa8, 0x3a, 0xc5, 0x59, 0xb7, 0x44, 0x43, 0x67, 0x22,
+    0x65, 0xab, 0xfa, 0x49, 0x24, 0x15, 0x73, 0xca, 0x7d, 0x95, 0x7f, 0x81, 0x3c, 0x4d, 0xe2, 0x28,
+    0xe1, 0x95, 0x80, 0xcc, 0x93, 0x73, 0xcc, 0x74, 0x6f, 0xcd, 0xac, 0x56, 0x67, 0x39, 0x7e, 0x39,
+    0x3c, 0xf0, 0xb3, 0xf0, 0x39, 0x01, 0xfc, 0xbc, 0x28, 0x35, 0x66, 0x59, 0x04, 0xec, 0xed, 0xb9,
+    0xd1, 0x7b, 0x39, 0xec, 0x5c, 0x0c, 0xfb, 0x8d, 0xbb, 0x28, 0x8f, 0x6e, 0xa3, 0x38, 0x2a, 0x90,
+    0xbb, 0xc4, 0x75, 0x2c, 0x45, 0xcb, 0x39, 0xa6, 0x22, 0xdc, 0x35, 0xba, 0x8c, 0xdf, 0x9d, 0xa3,
+    0xe7, 0x41, 0xc0, 0xf3, 0x7c, 0x3b, 0x67, 0x3b, 0x30, 0x3b, 0xce, 0xee, 0xb1, 0xa1, 0x9f, 0x8c,
+    0x29, 0xdd, 0x6d, 0x4b, 0xe8, 0xdd, 0x0e, 0x3e, 0xbb, 0x87, 0x2e, 0xfc, 0x2c, 0xc1, 0xfc, 0x6c,
+    0x1d, 0x7b, 0xe1, 0xbc, 0x72, 0xba, 0xdd, 0xdd, 0x63, 0x27, 0x51, 0x08, 0x43, 0xd6, 0x7b, 0xd1,
+    0x12, 0xf2, 0x84, 0x3a, 0xff, 0x65, 0xca, 0xc3, 0xc8, 0x67, 0xb0, 0xf6, 0x03, 0xcb, 0x83, 0x8c,
+    0xf3, 0x84, 0xf9, 0x49, 0xc8, 0x5a, 0x53, 0xb8, 0x87, 0x34, 0x0f, 0x73, 0x4d, 0x58, 0xed, 0x00,
+    0x59, 0x45, 0x18, 0x95, 0x7d, 0xad, 0x99, 0xae, 0x6d, 0x2a, 0xef, 0x5a, 0x66, 0xcd, 0x8d, 0xae,
+    0x32, 0x95, 0x6f, 0x74, 0x54, 0x11, 0xb0, 0xd1, 0x03, 0x5f, 0x9e, 0x58, 0x6c, 0xe9, 0x7b, 0xf6,
+    0x36, 0x0f, 0x9d, 0xd8, 0x3b, 0x28, 0xaa, 0x9c, 0x76, 0x7a, 0x2c, 0x57, 0xd1, 0xc6, 0xe9, 0x94,
+    0x17, 0x3e, 0x0b, 0x26, 0x7e, 0x96, 0xf3, 0x62, 0xa0, 0xcd, 0x8b, 0x91, 0xee, 0x69, 0x65, 0xf3,
+    0xa4, 0x28, 0x66, 0x3a, 0xff, 0x3c, 0x8f, 0xee, 0x06, 0xda, 0xdf, 0xf5, 0xff, 0x38, 0xd7, 0x87,
+    0xe9, 0x74, 0xe6, 0x17, 0x34, 0x7b, 0x1a, 0x53, 0x11, 0x35, 0xd0, 0xde, 0x5e, 0x0c, 0x78, 0x38,
+    0xe6, 0x34, 0xaa, 0x88, 0x0a, 0x80, 0xbe, 0x4d, 0x8b, 0xd3, 0x63, 0x79, 0xa9, 0x80, 0x12, 0x7f,
+    0xca, 0x07, 0xda, 0x5d, 0xc4, 0x17, 0xb3, 0x34, 0x2b, 0x6a, 0x63, 0x85, 0x76, 0x83, 0x90, 0xdf,
+    0x45, 0x01, 0x97, 0xaa, 0x1e, 0xb1, 0x28, 0xc1, 0x52, 0xe9, 0xc7, 0x7a, 0x1e, 0xf8, 0x31, 0x1f,
+    0x58, 0x84, 0x8b, 0x78, 0xfb, 0xc4, 0x32, 0x1e, 0x0f, 0x34, 0x21, 0x76, 0x3e, 0xe1, 0x1c, 0x28,
+    0xc5, 0xc3, 0x0c, 0xa8, 0x94, 0x47, 0x8e, 0x83, 0x3c, 0xd7, 0x98, 0xb0, 0x17, 0x48, 0x84, 0xad,
+    0x34, 0x36, 0xc9, 0xf8, 0x68, 0xa0, 0x4d, 0xfd, 0x28, 0x31, 0xa8, 0xfb, 0xac, 0x01, 0xad, 0x55,
+    0x09, 0x41, 0xc5, 0x03, 0x19, 0x36, 0xf5, 0xc3, 0x41, 0x33, 0x2f, 0xfc, 0xac, 0xb8, 0xc4, 0xea,
+    0xf0, 0xca, 0x2f, 0xfc, 0xd6, 0x41, 0x53, 0x55, 0x1a, 0x3c, 0xa3, 0x5a, 0x63, 0xe6, 0x27, 0x2c,
+    0x88, 0xfd, 0x3c, 0x1f, 0x34, 0x97, 0x59, 0xa2, 0xc9, 0xa2, 0xb0, 0xba, 0xe7, 0x21, 0x8d, 0xc8,
+    0xef, 0xc6, 0xec, 0x7e, 0x1a, 0x27, 0xa0, 0xa3, 0x59, 0x3b, 0x39, 0x3e, 0x5e, 0x2c, 0x16, 0xc6,
+    0xc2, 0x31, 0xd2, 0x6c, 0x7c, 0x6c, 0x9b, 0xa6, 0x79, 0x0c, 0x8a, 0x26, 0x93, 0xfa, 0x36, 0x1d,
+    0xbb, 0xc9, 0x64, 0xa1, 0x21, 0xaf, 0x47, 0x51, 0x1c, 0x03, 0x70, 0x9e, 0x65, 0x98, 0x95, 0x21,
+    0xd9, 0xaa, 0xb9, 0xc6, 0x15, 0x5c, 0x18, 0xcd, 0xdf, 0xcb, 0xf4, 0x7e, 0xd0, 0xa4, 0x64, 0x63,
+    0x75, 0xf0, 0x47, 0x9c, 0x61, 0x90, 0x09, 0x83, 0x38, 0xef, 0x2c, 0xd7, 0x70, 0xbc, 0x36, 0xeb,
+    0x18, 0x96, 0xe5, 0xfa, 0x46, 0xdb, 0x73, 0xe9, 0x2b, 0x12, 0x93, 0xa9, 0x1b, 0x66, 0xbb, 0xab,
+    0x1b, 0x5d, 0xa7, 0x73, 0x6e, 0xd9, 0x46, 0xbb, 0xdd, 0x66, 0xea, 0x24, 0x7a, 0x99, 0xc7, 0x9c,
+    0xa1, 0x6b, 0xd8, 0x6e, 0x8f, 0x39, 0xcc, 0x36, 0xba, 0xb6, 0xc3, 0x1c, 0xc3, 0xf3, 0x6c, 0xa3,
+    0xd3, 0x71, 0x18, 0x40, 0xbb, 0xbd, 0x2d, 0x70, 0x1e, 0xa1, 0x19, 0xae, 0xe5, 0xd1, 0x57, 0xe1,
+    0x60, 0x80, 0x67, 0x98, 0xee, 0xb9, 0x65, 0x01, 0xdc, 0x63, 0xea, 0x24, 0xa4, 0x05, 0x8f, 0x76,
+    0x60, 0x1b, 0xae, 0xd9, 0xc5, 0x5d, 0xdb, 0xf0, 0xec, 0xae, 0xe1, 0x99, 0x36, 0x84, 0xed, 0x42,
+    0x11, 0xdb, 0xb0, 0x3a, 0x6d, 0xc3, 0x36, 0x5d, 0xc3, 0x02, 0x6e, 0xbb, 0x67, 0x58, 0x0e, 0x41,
+    0x11, 0x9b, 0xde, 0x97, 0xe6, 0xf1, 0x8a, 0x92, 0x8e, 0x61, 0xdb, 0x3d, 0xe6, 0x19, 0x76, 0xd7,
+    0x22, 0xa9, 0x6c, 0xfa, 0x56, 0x52, 0x75, 0x1c, 0x28, 0xd9, 0x76, 0xcf, 0x7b, 0x46, 0xdb, 0x75,
+    0x99, 0x3c, 0x96, 0x2a, 0x76, 0x02, 0xdd, 0x32, 0x7a, 0x26, 0x1a, 0x74, 0xa0, 0x43, 0xec, 0x8e,
+    0x0e, 0x7e, 0x1d, 0x4c, 0xa3, 0xe1, 0xda, 0x1d, 0xc2, 0x32, 0x94, 0xb0, 0x12, 0x89, 0x80, 0xd0,
+    0x23, 0xbe, 0x95, 0x7e, 0xae, 0x8d, 0x2e, 0xf7, 0x1c, 0xa4, 0x1d, 0x26, 0x0e, 0xa5, 0x72, 0x5d,
+    0x7f, 0xbd, 0xad, 0x6d, 0xb8, 0x5d, 0x02, 0x77, 0x9c, 0x4e, 0x00, 0xdd, 0x60, 0x16, 0x87, 0x84,
+    0x35, 0x2c, 0xd3, 0x03, 0x8e, 0x43, 0x3c, 0xdc, 0x2f, 0x53, 0x1d, 0xba, 0x7b, 0x34, 0xeb, 0x38,
+    0x82, 0xcc, 0xee, 0xe8, 0x74, 0xc0, 0x9d, 0xab, 0x1b, 0x1d, 0x13, 0x07, 0x0b, 0x1a, 0xb9, 0xe7,
+    0x1d, 0xa3, 0xdd, 0x75, 0x98, 0x3c, 0x96, 0x0a, 0xf5, 0x48, 0x21, 0x13, 0xec, 0x74, 0x12, 0xca,
+    0x86, 0xfd, 0xda, 0xb8, 0xea, 0xb5, 0x31, 0xa7, 0x66, 0x1b, 0x30, 0x1e, 0x4d, 0x27, 0x10, 0x1c,
+    0xe0, 0xb9, 0x36, 0x5a, 0x2c, 0x20, 0xc5, 0x86, 0x09, 0x3f, 0xc1, 0x37, 0x80, 0xee, 0xf4, 0xd7,
+    0x36, 0xbb, 0x86, 0xd5, 0x33, 0x3a, 0x30, 0x96, 0xd9, 0x3b, 0x87, 0x91, 0xbb, 0x1e, 0x93, 0xc7,
+    0x52, 0x35, 0xcb, 0x0c, 0x0c, 0xaf, 0x43, 0xf7, 0x96, 0xd1, 0xe9, 0x41, 0x15, 0x0b, 0xe2, 0xb6,
+    0x61, 0xcb, 0x0e, 0xae, 0x1d, 0xa0, 0x62, 0x9e, 0x00, 0xd2, 0x81, 0xa4, 0x66, 0xcf, 0x22, 0x06,
+    0x50, 0x02, 0x1c, 0xbe, 0xbc, 0xeb, 0x91, 0x78, 0xc2, 0xd3, 0xc0, 0xad, 0x87, 0x56, 0x1c, 0xf0,
+    0x85, 0x61, 0x5d, 0x9b, 0x8c, 0x0b, 0x15, 0xe1, 0x90, 0x46, 0xaf, 0xc7, 0xc4, 0xa1, 0x54, 0x0c,
+    0xa2, 0xb8, 0xfe, 0x5a, 0x33, 0xa9, 0x0a, 0x15, 0xbd, 0x00, 0x8a, 0x39, 0x98, 0x44, 0x52, 0x10,
+    0xfe, 0xd7, 0xee, 0xb4, 0x09, 0x08, 0x38, 0x31, 0xb4, 0x26, 0xcd, 0x61, 0x49, 0x98, 0xac, 0x34,
+    0x58, 0x97, 0xfc, 0x8d, 0xba, 0xc8, 0xfb, 0xcd, 0xae, 0x74, 0x26, 0x0a, 0x45, 0x71, 0x42, 0x70,
+    0x7f, 0x23, 0xc6, 0x51, 0xc7, 0xfc, 0xaf, 0x0b, 0x73, 0x93, 0xb4, 0x44, 0x84, 0xda, 0xbd, 0x36,
+    0x45, 0xb3, 0xdb, 0x76, 0x99, 0x3a, 0xfd, 0xf7, 0x46, 0xb3, 0xd1, 0x71, 0x84, 0x4f, 0xd8, 0x08,
+    0x58, 0x84, 0x95, 0x65, 0x78, 0x88, 0x0e, 0x04, 0x70, 0x8c, 0x0b, 0x58, 0x05, 0x87, 0x2f, 0xef,
+    0xfe, 0xa9, 0x61, 0x47, 0xd1, 0x05, 0x5a, 0xaf, 0x26, 0x87, 0x03, 0x79, 0x81, 0x6f, 0x77, 0x2f,
+    0xc1, 0xe9, 0xcb, 0x14, 0xd3, 0xd0, 0x23, 0xe4, 0x36, 0x5c, 0xa2, 0x4b, 0x21, 0x84, 0x03, 0xc9,
+    0x09, 0x19, 0x49, 0x50, 0x24, 0x1d, 0x31, 0x5b, 0xd4, 0x0c, 0x99, 0xba, 0xab, 0x09, 0xc4, 0x62,
+    0x5b, 0xf9, 0xc3, 0xad, 0x6b, 0xfc, 0x3b, 0xb6, 0x3a, 0x96, 0x5e, 0x49, 0xde, 0xdc, 0x73, 0x6c,
+    0x52, 0xd5, 0x82, 0xa7, 0xf5, 0x1c, 0x87, 0xee, 0x1d, 0xbf, 0x23, 0x92, 0x4f, 0xa7, 0x4a, 0x41,
+    0x14, 0x34, 0x26, 0xe5, 0x35, 0xa7, 0x1b, 0x94, 0xb1, 0x59, 0x86, 0xa6, 0x8c, 0x4c, 0xbd, 0x0c,
+    0x4d, 0x78, 0x30, 0x52, 0x05, 0xbe, 0x15, 0xff, 0xed, 0xc1, 0x29, 0x62, 0xc5, 0xfc, 0x32, 0x6d,
+    0xd3, 0xfc, 0xea, 0xe2, 0x08, 0xe9, 0xc9, 0xd3, 0xdb, 0xe0, 0xe1, 0xf6, 0x0c, 0x07, 0xaa, 0x5a,
+    0x2e, 0x78, 0x0a, 0xa5, 0x3b, 0x1e, 0x1d, 0x4d, 0x67, 0xd5, 0xfc, 0xa4, 0x75, 0xbb, 0x0b, 0xf3,
+    0x77, 0x57, 0xcc, 0x4f, 0x5c, 0x85, 0xf9, 0x85, 0xdd, 0x7b, 0x4e, 0x79, 0x2a, 0xd5, 0xf6, 0x2c,
+    0x9a, 0x77, 0x44, 0x14, 0x05, 0xb9, 0x4d, 0xbd, 0x5d, 0x2f, 0x50, 0xa1, 0x59, 0x46, 0xa6, 0x0a,
+    0x4c, 0x11, 0x79, 0xab, 0x91, 0x69, 0xe9, 0x2a, 0x32, 0xf5, 0x2a, 0x34, 0x03, 0xca, 0x0e, 0x6e,
+    0x75, 0x40, 0x23, 0x89, 0xb3, 0x35, 0x47, 0x58, 0x2a, 0x47, 0x04, 0x70, 0xe6, 0xb6, 0x88, 0x72,
+    0x1b, 0x69, 0x88, 0xa4, 0x80, 0x28, 0x30, 0xb3, 0x47, 0x53, 0xe2, 0xb8, 0xae, 0xde, 0xa3, 0x29,
+    0xa1, 0xd9, 0xc4, 0x5f, 0xa9, 0x6c, 0xd7, 0x15, 0x73, 0x4d, 0x51, 0x04, 0xdd, 0xe8, 0xb8, 0x42,
+    0x40, 0xd9, 0x96, 0xbe, 0xb1, 0xe8, 0x92, 0x64, 0xcf, 0xc9, 0x1a, 0x14, 0xa9, 0x65, 0xb3, 0xdc,
+    0x27, 0xc8, 0x44, 0x52, 0x5e, 0x9f, 0x5d, 0x89, 0x8b, 0xd3, 0xe3, 0x59, 0x0d, 0xeb, 0xb8, 0xac,
+    0x37, 0x1a, 0xa7, 0x61, 0x74, 0x57, 0x43, 0xa5, 0x22, 0x89, 0x20, 0xeb, 0xad, 0x54, 0x68, 0x52,
+    0xd9, 0x2a, 0x71, 0xa7, 0x28, 0xb8, 0xfd, 0x31, 0x6f, 0x2a, 0x89, 0xce, 0x2a, 0xcc, 0x89, 0x85,
+    0x6b, 0x1c, 0x80, 0x8e, 0xd1, 0x5b, 0x30, 0xd4, 0x3e, 0x41, 0xc2, 0xd0, 0x76, 0xa7, 0xc2, 0xc0,
+    0x60, 0xe7, 0xec, 0x12, 0x2d, 0x00, 0x70, 0x9e, 0x9d, 0xf4, 0xda, 0xde, 0x32, 0xe9, 0xd1, 0xb5,
+    0x4c, 0x7a, 0x19, 0x65, 0x36, 0xc5, 0xfe, 0x36, 0x62, 0xb7, 0x91, 0xbe, 0xf0, 0x0b, 0x9e, 0x3d,
+    0x99, 0xed, 0x68, 0xa4, 0x9e, 0xcd, 0x51, 0x04, 0x36, 0xf9, 0x1d, 0x4f, 0xd2, 0x10, 0x10, 0xb2,
+    0xd0, 0x61, 0x5e, 0x2d, 0xcb, 0xc3, 0x53, 0xf0, 0xf7, 0xc6, 0x26, 0x2f, 0x8a, 0xe1, 0x08, 0x88,
+    0x00, 0x3a, 0x56, 0xee, 0x66, 0x11, 0x49, 0xd7, 0xf4, 0xc4, 0x21, 0xd6, 0xdb, 0xac, 0x5d, 0x5f,
+    0x22, 0xc4, 0x22, 0xe1, 0xc5, 0x6b, 0xad, 0x15, 0xfd, 0xa5, 0x80, 0x45, 0xcc, 0xbb, 0x6f, 0xe0,
+    0xd8, 0xee, 0x79, 0x8d, 0x86, 0xc4, 0xd8, 0xe6, 0x19, 0x98, 0xf4, 0xf7, 0x69, 0xc1, 0x5e, 0xf1,
+    0x42, 0x24, 0xf4, 0x67, 0x58, 0x21, 0xa3, 0x59, 0x5b, 0x35, 0xc3, 0x07, 0x6a, 0xfa, 0x27, 0xda,
+    0x41, 0xec, 0x11, 0xd6, 0x2c, 0x51, 0x4c, 0x78, 0x36, 0x4d, 0x51, 0xa8, 0x63, 0x37, 0x39, 0xf1,
+    0xe3, 0xd1, 0xf7, 0x19, 0xa5, 0x6e, 0x13, 0xc4, 0x19, 0xd9, 0x64, 0x42, 0x69, 0xa1, 0xe7, 0xc4,
+    0xfa, 0x16, 0xab, 0xc8, 0x60, 0x2c, 0xad, 0xb2, 0x32, 0xfd, 0x56, 0x69, 0x94, 0x55, 0x5b, 0x59,
+    0x4b, 0x2b, 0x5e, 0x52, 0x19, 0x88, 0x6c, 0x24, 0xcc, 0x52, 0xb7, 0x8a, 0x45, 0xc9, 0x61, 0x87,
+    0x51, 0x1c, 0x93, 0xfd, 0x1a, 0xf2, 0x71, 0x9f, 0x0d, 0x57, 0x4c, 0x22, 0x6c, 0x42, 0x7b, 0x02,
+    0xb1, 0x4f, 0xc3, 0xae, 0x20, 0x88, 0xa3, 0xe0, 0x13, 0x45, 0xec, 0x90, 0x2e, 0x5e, 0x16, 0x49,
+    0x4b, 0xbb, 0x2d, 0x92, 0x8f, 0xa3, 0x45, 0xa8, 0x1d, 0x48, 0x3b, 0xa9, 0xdb, 0xe6, 0xd9, 0xeb,
+    0xab, 0x0f, 0x7f, 0x3b, 0xff, 0xf0, 0xea, 0xf4, 0x58, 0x0e, 0x5e, 0x31, 0xf3, 0x1e, 0x90, 0x79,
+    0x91, 0xce, 0xea, 0x98, 0x74, 0xdf, 0x3c, 0xbb, 0xbe, 0xb9, 0xfa, 0xfd, 0x7b, 0x11, 0x69, 0x0b,
+    0x5c, 0x47, 0xa4, 0xfb, 0xe6, 0xd9, 0xcb, 0xf3, 0xe1, 0xbf, 0x6f, 0x20, 0x7e, 0xc3, 0x17, 0xfd,
+    0xe8, 0x23, 0x35, 0x36, 0xcf, 0x4e, 0x27, 0xf6, 0xd9, 0xf9, 0x5b, 0xf6, 0xda, 0x9f, 0xc7, 0xa5,
+    0x53, 0x23, 0xd1, 0x61, 0x0a, 0x6d, 0x74, 0x39, 0x25, 0x2d, 0x36, 0x51, 0xc5, 0x3c, 0xff, 0x48,
+    0x9b, 0x31, 0x68, 0x20, 0x6e, 0x4e, 0x98, 0x2e, 0x1c, 0xb7, 0x46, 0x35, 0x22, 0x10, 0x45, 0x24,
+    0x00, 0x41, 0xc3, 0x7e, 0x59, 0xa7, 0xca, 0xe1, 0x58, 0x19, 0x36, 0xe3, 0x25, 0x9a, 0xba, 0xdd,
+    0x82, 0x87, 0x14, 0x39, 0x42, 0x2a, 0x4c, 0x02, 0xae, 0x68, 0x87, 0x55, 0x43, 0x0d, 0x79, 0x2f,
+    0x7d, 0x49, 0x01, 0xe8, 0x95, 0x4b, 0xad, 0x99, 0xd8, 0x67, 0x8a, 0xfa, 0x4f, 0x3c, 0xc7, 0xa2,
+    0xa7, 0x70, 0x72, 0x2a, 0xae, 0x15, 0xdd, 0xca, 0x04, 0x54, 0x83, 0xa5, 0x14, 0x6f, 0x13, 0x36,
+    0x52, 0xda, 0x49, 0x09, 0x88, 0x73, 0x9d, 0xae, 0xa9, 0x84, 0xda, 0x4f, 0xb4, 0x38, 0x0d, 0xfc,
+    0x72, 0x71, 0xf1, 0xe5, 0xb6, 0x56, 0x24, 0x80, 0x1c, 0x19, 0x60, 0xea, 0xcf, 0x72, 0xc3, 0x9f,
+    0xcd, 0x8c, 0x71, 0x9a, 0x1a, 0xe3, 0xf8, 0xf8, 0x6f, 0xd3, 0x87, 0xcf, 0x99, 0xf5, 0xa6, 0x3d,
+    0x79, 0xf0, 0xfc, 0xc5, 0xe2, 0xaf, 0xf7, 0xdd, 0x5a, 0x3a, 0xf9, 0xff, 0xfc, 0xf1, 0x43, 0xf9,
+    0xe3, 0x52, 0x99, 0xa1, 0xcc, 0x1e, 0xfe, 0x32, 0x94, 0xe8, 0x53, 0x06, 0xaa, 0x7c, 0x70, 0x2f,
+    0x9e, 0x36, 0x2c, 0x2f, 0xf3, 0x20, 0x8b, 0x66, 0xc5, 0xd9, 0x9d, 0x9f, 0xb1, 0x57, 0x1f, 0x6e,
+    0xd8, 0x80, 0x9e, 0x1c, 0xf5, 0x1b, 0xa3, 0x79, 0x22, 0x82, 0x89, 0xcd, 0x67, 0x21, 0x56, 0xc3,
+    0xe1, 0xf5, 0xf5, 0x90, 0xe6, 0xb5, 0xc5, 0x63, 0x3e, 0xc5, 0xca, 0x7f, 0xc4, 0x82, 0x3c, 0x3f,
+    0xf8, 0xda, 0x60, 0xf8, 0x44, 0xa3, 0x16, 0x6e, 0xd8, 0x4f, 0x03, 0xa6, 0x29, 0xdf, 0xd0, 0x0e,
+    0x44, 0x07, 0x7d, 0x14, 0xbd, 0x21, 0xac, 0x72, 0x19, 0xe5, 0x85, 0x91, 0xf1, 0x69, 0x7a, 0xc7,
+    0x5b, 0x4b, 0xda, 0xfe, 0x3a, 0x4a, 0xf5, 0xa8, 0x6f, 0x2f, 0x9c, 0x1a, 0xf5, 0x26, 0x92, 0x7c,
+    0xec, 0xb7, 0x1f, 0x4e, 0x49, 0xbb, 0x81, 0x22, 0x1f, 0x00, 0xee, 0x05, 0x52, 0x92, 0x6e, 0x60,
+    0xa8, 0x27, 0x81, 0x7b, 0x81, 0x54, 0xb4, 0x1b, 0x28, 0x54, 0x5c, 0xed, 0x05, 0x21, 0x09, 0xe5,
+    0xf8, 0x4d, 0x2a, 0x3f, 0x0c, 0x09, 0xf2, 0x40, 0xbe, 0xb4, 0x59, 0xb5, 0xb4, 0x78, 0xd2, 0x84,
+    0x0b, 0x1f, 0xd6, 0x7d, 0x11, 0xa6, 0xc1, 0x5c, 0x8c, 0x1d, 0xf3, 0xe2, 0x42, 0xc2, 0xbc, 0x7c,
+    0x78, 0x1b, 0xb6, 0xaa, 0xda, 0xee, 0xc0, 0x08, 0x26, 0x51, 0x1c, 0x62, 0xd3, 0xf8, 0x87, 0xf5,
+    0xa7, 0x11, 0xa1, 0xd6, 0xcc, 0xde, 0xdc, 0xbc, 0xbb, 0x84, 0x17, 0x35, 0x9b, 0x87, 0x84, 0x62,
+    0x28, 0xca, 0xc3, 0x66, 0xb3, 0xdf, 0x78, 0xb1, 0xe6, 0x4c, 0xdf, 0x86, 0x3f, 0x62, 0x75, 0x90,
+    0x8f, 0x42, 0x05, 0x88, 0xbd, 0x5b, 0x30, 0x51, 0x2d, 0x7e, 0x5b, 0x2a, 0x22, 0x7b, 0x9e, 0x48,
+    0x12, 0x58, 0xc9, 0x43, 0x37, 0x7b, 0x08, 0x23, 0x8b, 0xa6, 0x6f, 0x4b, 0x23, 0xe8, 0x9e, 0x27,
+    0x8e, 0x82, 0x56, 0xf2, 0x88, 0xbb, 0x3d, 0x04, 0x2a, 0xab, 0x83, 0x83, 0xad, 0x62, 0xa8, 0xde,
+    0xe7, 0x09, 0x52, 0x41, 0x2a, 0x51, 0xd4, 0xfd, 0x9e, 0xc2, 0x88, 0xb2, 0x62, 0xb7, 0x34, 0xd4,
+    0xfd, 0x7c, 0x71, 0x24, 0x68, 0x4d, 0x1e, 0x6a, 0xd8, 0x53, 0x20, 0x51, 0x95, 0xec, 0x16, 0x88,
+    0xba, 0x9f, 0x2f, 0x90, 0x04, 0xad, 0x09, 0x44, 0x0d, 0x95, 0x40, 0x3b, 0x87, 0xae, 0xd5, 0x2e,
+    0x6b, 0x52, 0x95, 0x95, 0x4c, 0x93, 0x1d, 0x4a, 0xe0, 0x8a, 0xbc, 0xff, 0x14, 0x62, 0xad, 0xce,
+    0x59, 0x03, 0x54, 0x55, 0x4f, 0x85, 0x27, 0x29, 0x67, 0x3c, 0xa3, 0x37, 0xd1, 0x68, 0x6c, 0xb2,
+    0x5f, 0x9a, 0x4f, 0x42, 0xaf, 0x16, 0x47, 0xeb, 0xe2, 0x56, 0xa5, 0x52, 0xc5, 0xa0, 0xa4, 0x7f,
+    0x12, 0x74, 0xbd, 0x8e, 0x5a, 0x83, 0xad, 0x57, 0x55, 0x15, 0xf0, 0x72, 0x4c, 0x29, 0xf6, 0xbe,
+    0xd6, 0x2a, 0x4b, 0xcb, 0xd2, 0x58, 0x74, 0x5f, 0xfa, 0x0d, 0xf2, 0xb0, 0x14, 0x5b, 0x56, 0x4a,
+    0x1f, 0x51, 0xdf, 0x20, 0x29, 0x0f, 0xd8, 0x3c, 0x09, 0xf9, 0x08, 0x1b, 0xe7, 0xf0, 0xa0, 0xf1,
+    0x42, 0xb9, 0x45, 0x59, 0x89, 0x6d, 0x0c, 0x50, 0xb0, 0x55, 0x51, 0x16, 0x25, 0xd2, 0x20, 0x32,
+    0x15, 0x1f, 0x1f, 0xb3, 0xab, 0x84, 0xb3, 0xfc, 0xf3, 0xdc, 0xcf, 0x38, 0xc3, 0xcc, 0x33, 0x45,
+    0x88, 0xe5, 0x36, 0x8d, 0xd3, 0x39, 0x76, 0xaa, 0xec, 0xf6, 0x81, 0x45, 0x45, 0x2e, 0xab, 0x1c,
+    0x16, 0x46, 0xe3, 0xa8, 0x60, 0x51, 0xc2, 0x6a, 0x2c, 0x0c, 0x76, 0x33, 0xe1, 0x04, 0x25, 0xaa,
+    0x35, 0x74, 0x3c, 0xe4, 0xea, 0xcd, 0x11, 0x6a, 0x73, 0x76, 0x9b, 0xa2, 0x35, 0x67, 0xb7, 0xf3,
+    0x08, 0x25, 0xf3, 0x22, 0x2a, 0x26, 0xe9, 0xbc, 0x60, 0xe2, 0x2d, 0x4b, 0x94, 0x18, 0x0d, 0x2a,
+    0x02, 0xae, 0x6f, 0xce, 0x6f, 0xde, 0x5e, 0xbd, 0xff, 0x38, 0xbc, 0xba, 0xbc, 0xfa, 0x70, 0x8d,
+    0x39, 0xfe, 0x43, 0xfb, 0xd9, 0xe6, 0xdd, 0xd0, 0xb1, 0xb5, 0x23, 0xa6, 0xfd, 0x3c, 0xea, 0xf9,
+    0x9e, 0xed, 0x8a, 0x4b, 0x3e, 0xea, 0x04, 0xa6, 0x29, 0x2e, 0x83, 0x8e, 0xed, 0xd9, 0x9e, 0xf6,
+    0xe7, 0x46, 0xe1, 0x50, 0xcd, 0x84, 0x50, 0x3e, 0x4a, 0x84, 0x93, 0xd1, 0xd2, 0x42, 0xac, 0xc6,
+    0x59, 0x14, 0x82, 0xc1, 0x4e, 0x6b, 0x54, 0x35, 0xe9, 0x93, 0x61, 0xbb, 0x5a, 0x1e, 0x1f, 0x18,
+    0xa2, 0x3e, 0x36, 0x54, 0x79, 0x2c, 0xe2, 0x57, 0x1a, 0x8f, 0xb8, 0x55, 0xa9, 0x18, 0x29, 0x3c,
+    0x19, 0xa3, 0xe6, 0xc3, 0xaa, 0x4a, 0x73, 0x26, 0xef, 0x48, 0xae, 0x17, 0x82, 0x6c, 0x35, 0xfe,
+    0x31, 0xfe, 0xc5, 0x28, 0xcd, 0x5a, 0x24, 0x73, 0x84, 0x16, 0xb3, 0x8f, 0xd3, 0x69, 0x6d, 0x20,
+    0xee, 0x0f, 0x0f, 0xc5, 0x68, 0xa1, 0x57, 0xc0, 0xe3, 0xb8, 0xae, 0x57, 0x90, 0x71, 0x4c, 0x85,
+    0x12, 0x1a, 0x02, 0xa3, 0x6e, 0x13, 0x2a, 0xbd, 0x78, 0x41, 0x94, 0x86, 0x78, 0x1f, 0x55, 0x86,
+    0x34, 0x4d, 0x1d, 0x39, 0x72, 0xb4, 0xec, 0x97, 0x0a, 0x61, 0xc1, 0xbe, 0x41, 0x00, 0x10, 0x5d,
+    0x59, 0xfa, 0x47, 0xe2, 0x81, 0x8d, 0x2e, 0x5f, 0x91, 0xab, 0x77, 0xdc, 0xf4, 0x4e, 0x4d, 0xfd,
+    0x50, 0x44, 0x5c, 0x97, 0x2f, 0x73, 0x67, 0xf7, 0x42, 0x0d, 0xa9, 0x1e, 0xaa, 0x72, 0x9e, 0x84,
+    0x43, 0x9a, 0x8b, 0x16, 0xb1, 0x10, 0xc2, 0x3c, 0x36, 0xe8, 0x6f, 0x0f, 0x3d, 0xcb, 0x49, 0xaa,
+    0x96, 0xb5, 0xe8, 0x4f, 0x25, 0xe3, 0xf2, 0x35, 0x27, 0x46, 0xaf, 0x3a, 0xd2, 0x1f, 0x84, 0x42,
+    0x2f, 0xf3, 0x86, 0x69, 0xc8, 0xcf, 0x8b, 0x56, 0x74, 0x80, 0x5d, 0x50, 0xdb, 0xfb, 0x93, 0xfd,
+    0xe3, 0x1f, 0xf0, 0x9f, 0x6e, 0xb7, 0xab, 0xed, 0x65, 0xe3, 0x6d, 0x39, 0x60, 0xb9, 0xa7, 0x11,
+    0x13, 0x27, 0x7d, 0x4c, 0x44, 0x7e, 0x3a, 0x12, 0x4d, 0x35, 0x05, 0xf6, 0x4f, 0xdc, 0x6b, 0x6e,
+    0x55, 0x39, 0x2f, 0x3b, 0x43, 0x31, 0xfe, 0x5b, 0x55, 0x15, 0xb2, 0x13, 0x56, 0x2f, 0x65, 0xeb,
+    0x05, 0x15, 0x10, 0x87, 0xe9, 0x74, 0xea, 0x27, 0x61, 0x8b, 0x92, 0x7e, 0x14, 0x1e, 0xb1, 0x3b,
+    0x3f, 0x9e, 0x73, 0x72, 0x14, 0xf8, 0xa3, 0x6c, 0x63, 0xc8, 0x20, 0xcb, 0x45, 0x94, 0x5c, 0x08,
+    0x5d, 0x82, 0x8c, 0x7a, 0xb4, 0xab, 0xf7, 0x9a, 0xf4, 0xab, 0x8c, 0x17, 0xf3, 0x2c, 0x41, 0xc3,
+    0xeb, 0xd7, 0x9a, 0xb0, 0x16, 0x8f, 0x73, 0xbe, 0xd2, 0xa3, 0x76, 0xfc, 0x5a, 0x69, 0xcb, 0x2d,
+    0x3c, 0xe4, 0xca, 0xf8, 0x23, 0x4c, 0xe8, 0x09, 0xc0, 0x53, 0x1c, 0xe4, 0x52, 0xf7, 0x23, 0x1c,
+    0xe8, 0x89, 0x40, 0xc5, 0x81, 0xea, 0xd7, 0x95, 0x39, 0xad, 0x3d, 0x55, 0x90, 0x9c, 0xcb, 0x5c,
+    0x02, 0x5e, 0x4f, 0xa4, 0x12, 0x45, 0xbb, 0xf4, 0x9b, 0xbe, 0x1c, 0x15, 0x4c, 0xc9, 0x53, 0x37,
+    0x0d, 0x05, 0x34, 0x55, 0x3d, 0x63, 0x2d, 0xc9, 0x53, 0xb8, 0x76, 0x9c, 0x8e, 0x5b, 0xa0, 0x86,
+    0xf3, 0xe7, 0x08, 0x9d, 0x97, 0xe2, 0x81, 0x85, 0x10, 0xa5, 0xa5, 0x1d, 0xfb, 0x41, 0xf1, 0x9b,
+    0x76, 0x28, 0x87, 0x1e, 0x6a, 0x03, 0xed, 0x50, 0x10, 0x3e, 0xd2, 0xd6, 0x6b, 0x2d, 0x1d, 0xbe,
+    0xe7, 0xc5, 0x22, 0xcd, 0x3e, 0xb5, 0xaa, 0x77, 0x2a, 0xb5, 0x3d, 0xd4, 0x5a, 0x13, 0x7d, 0x76,
+    0xa9, 0xa3, 0xd5, 0x5f, 0xfe, 0x68, 0x9b, 0x29, 0x4f, 0xa3, 0x87, 0x02, 0x5a, 0xff, 0xdb, 0x38,
+    0x4f, 0x82, 0x88, 0xbc, 0xb2, 0x0f, 0x8a, 0x7c, 0x82, 0xac, 0xad, 0x86, 0xa5, 0x26, 0x1f, 0x27,
+    0xab, 0xf1, 0x8f, 0x6a, 0x2b, 0x42, 0xc6, 0xfe, 0x31, 0xa9, 0xf6, 0x55, 0xed, 0x5b, 0x53, 0xf4,
+    0xa3, 0xda, 0x8d, 0x46, 0x2b, 0xea, 0x91, 0xb5, 0xb1, 0xe8, 0x5e, 0xfa, 0x79, 0xc1, 0x46, 0x73,
+    0xe4, 0x7f, 0xca, 0x1f, 0xbc, 0xcf, 0x8e, 0xc5, 0x82, 0xff, 0x57, 0x9e, 0x26, 0xbf, 0xe5, 0x11,
+    0x2a, 0x92, 0xc1, 0x7b, 0xf9, 0xb3, 0x0d, 0xe9, 0xee, 0x39, 0x2b, 0x26, 0x9c, 0x8d, 0x22, 0x1e,
+    0x87, 0x74, 0xe9, 0x17, 0xb4, 0x12, 0x23, 0xaf, 0x84, 0x72, 0x2d, 0x16, 0x18, 0xe0, 0xf6, 0x95,
+    0xcf, 0xd2, 0x60, 0x72, 0xc2, 0xcc, 0x23, 0x96, 0xf3, 0xcf, 0x38, 0x3f, 0xd6, 0x16, 0xda, 0x29,
+    0xcf, 0xc6, 0x2b, 0xdb, 0x36, 0xe5, 0x50, 0x82, 0xb1, 0x18, 0x48, 0xab, 0x9c, 0x80, 0x92, 0xb7,
+    0xcb, 0x0d, 0x64, 0x85, 0xff, 0x28, 0xd5, 0x28, 0x93, 0xff, 0x27, 0xfe, 0x40, 0x55, 0x85, 0xc0,
+    0x5b, 0x25, 0xfe, 0x03, 0x5d, 0x7f, 0x52, 0xa0, 0xa1, 0x4b, 0x5c, 0xcb, 0x81, 0xb5, 0xbd, 0xa3,
+    0x20, 0x5b, 0xcb, 0x84, 0xeb, 0x21, 0x33, 0xcf, 0x62, 0x8a, 0xdb, 0x2a, 0xc0, 0x0a, 0x76, 0x3f,
+    0xc9, 0x80, 0x9a, 0xf0, 0x05, 0xfb, 0xfb, 0xbb, 0xcb, 0x37, 0x45, 0x31, 0xfb, 0xc0, 0x3f, 0xcf,
+    0x79, 0x5e, 0xb4, 0x54, 0x18, 0xa2, 0xdf, 0x48, 0xb1, 0x68, 0xb5, 0xb4, 0x7f, 0xbd, 0xb8, 0x41,
+    0xc9, 0x01, 0x84, 0x23, 0x56, 0x64, 0x73, 0x5e, 0xef, 0x17, 0xbf, 0x9a, 0x00, 0x4c, 0xeb, 0x80,
+    0x0d, 0xce, 0xd8, 0xd2, 0xd1, 0x30, 0x19, 0xd4, 0x8f, 0x55, 0x38, 0x7c, 0xb8, 0x96, 0x2a, 0x23,
+    0x29, 0xad, 0x32, 0x32, 0x5e, 0x5d, 0xbd, 0xbf, 0x60, 0xbf, 0xfe, 0x2a, 0x90, 0x64, 0x1d, 0x2d,
+    0xa8, 0x6c, 0xd3, 0x3c, 0xa8, 0x41, 0xd1, 0x87, 0x66, 0x88, 0xf4, 0x1f, 0xb0, 0x7f, 0xbb, 0xbe,
+    0x7a, 0x6f, 0xcc, 0xe8, 0x07, 0x2a, 0x8a, 0x41, 0x3e, 0x83, 0x36, 0x9c, 0xd6, 0xe9, 0x83, 0xfe,
+    0xca, 0x98, 0x35, 0x23, 0xad, 0x76, 0xae, 0xe6, 0x86, 0x9a, 0x56, 0xcb, 0xc8, 0x79, 0xac, 0x69,
+    0xc9, 0xb3, 0x2c, 0xa5, 0xd9, 0x2a, 0xa7, 0xb7, 0x55, 0x17, 0x70, 0x15, 0x6b, 0xe4, 0x23, 0xe2,
+    0x14, 0xd8, 0xe3, 0x72, 0xa6, 0xc8, 0x1e, 0x2d, 0x69, 0x23, 0x7c, 0x48, 0x9f, 0x84, 0x17, 0x01,
+    0xd6, 0xed, 0x42, 0xac, 0xfa, 0x4b, 0xc3, 0x65, 0x5c, 0xc5, 0x50, 0x6b, 0xe9, 0x57, 0x4b, 0x52,
+    0xd0, 0xd6, 0x92, 0x55, 0x3d, 0x53, 0x36, 0x3f, 0xf0, 0x22, 0x7b, 0x88, 0x92, 0x71, 0xf3, 0xe0,
+    0xbb, 0x23, 0xac, 0x84, 0x30, 0x8c, 0x5a, 0x94, 0xe6, 0xbc, 0xb8, 0x89, 0xa6, 0x1c, 0x55, 0x6b,
+    0x2b, 0x56, 0xbf, 0x8b, 0x39, 0xff, 0xcb, 0xbf, 0x3f, 0xb2, 0x4c, 0xd8, 0x69, 0x49, 0x26, 0xa3,
+    0xab, 0x36, 0x73, 0x95, 0xd0, 0xfa, 0x80, 0x59, 0x9b, 0x99, 0xbd, 0x29, 0x3a, 0x9b, 0x47, 0x25,
+    0x99, 0x82, 0xfa, 0xbe, 0x9c, 0xc0, 0x5a, 0xda, 0x61, 0x09, 0x74, 0xa8, 0x1d, 0x28, 0xe9, 0x6b,
+    0x92, 0x57, 0xb3, 0x7a, 0xc4, 0x94, 0xdc, 0x8f, 0x94, 0x3b, 0x7e, 0xcf, 0xf8, 0x08, 0x35, 0x3f,
+    0x65, 0x84, 0x9c, 0x67, 0xd8, 0x1b, 0xb1, 0xd9, 0x3c, 0x9f, 0x20, 0xee, 0xe0, 0xb8, 0xd3, 0x3e,
+    0x9b, 0xa5, 0xc8, 0x2a, 0x22, 0x77, 0x2c, 0x26, 0x1c, 0xfb, 0x83, 0x8b, 0x3b, 0x88, 0x73, 0x8d,
+    0x5d, 0x01, 0xb6, 0x39, 0x51, 0xce, 0xa6, 0x51, 0x8e, 0x04, 0x33, 0x66, 0x69, 0x46, 0x58, 0x04,
+    0x22, 0x7f, 0xbb, 0xc4, 0x26, 0x7e, 0xce, 0x92, 0x94, 0x8d, 0x32, 0xce, 0x15, 0x16, 0xcb, 0xe3,
+    0xb4, 0x30, 0x6a, 0xe1, 0xb9, 0xfa, 0x33, 0xa3, 0xca, 0xd2, 0x3f, 0x2d, 0xa2, 0x24, 0x4c, 0x17,
+    0x46, 0x8d, 0x53, 0xcd, 0xde, 0xf5, 0xf9, 0x6f, 0x6d, 0xcc, 0x7d, 0x3d, 0xed, 0x8b, 0x54, 0x26,
+    0x05, 0x95, 0x31, 0x5e, 0x03, 0xc4, 0xf2, 0x49, 0x0f, 0x5b, 0x8b, 0xea, 0xc1, 0x9b, 0x24, 0x84,
+    0x9b, 0xab, 0x87, 0x3e, 0x75, 0x47, 0xaf, 0xb3, 0x5f, 0x46, 0x54, 0x2d, 0x0a, 0x91, 0xe1, 0x29,
+    0xbc, 0x6a, 0xd2, 0xec, 0x8c, 0xad, 0xc7, 0x35, 0x76, 0x9b, 0x51, 0xb5, 0x92, 0x40, 0x14, 0xdd,
+    0x5a, 0x0e, 0xa9, 0x29, 0x62, 0x0c, 0x2f, 0xaf, 0xae, 0x2f, 0x5e, 0x1d, 0xac, 0xe6, 0x0a, 0x35,
+    0x2c, 0x88, 0x53, 0x48, 0xb7, 0x16, 0xf6, 0xbb, 0x26, 0xf0, 0xb1, 0xf6, 0x80, 0x2f, 0xe7, 0x4f,
+    0x64, 0x8a, 0xb5, 0xe8, 0xae, 0x67, 0xdc, 0x55, 0xec, 0xaf, 0x3f, 0x90, 0x69, 0xb5, 0xda, 0x0a,
+    0x26, 0x96, 0x0f, 0xd4, 0x37, 0xb5, 0xc5, 0xe4, 0x50, 0xfb, 0x55, 0xae, 0x6b, 0x65, 0x2b, 0x16,
+    0xa8, 0xff, 0x23, 0x99, 0xf9, 0xa9, 0x7c, 0x44, 0xcf, 0xd2, 0x77, 0x9a, 0x14, 0x6a, 0xb3, 0xef,
+    0xd7, 0xdb, 0x31, 0xdb, 0x6b, 0x4e, 0xf6, 0x3f, 0x2e, 0xe5, 0x93, 0xf2, 0xd4, 0xbd, 0xb4, 0xfc,
+    0xd4, 0x96, 0x1b, 0x77, 0xb5, 0xa7, 0xb6, 0xe2, 0x6c, 0xac, 0x81, 0xfd, 0x1f, 0x5f, 0x04, 0x77,
+    0x33, 0xdf, 0x60, 0xbc, 0xb9, 0x5e, 0xbe, 0xa0, 0x10, 0x3b, 0x3d, 0x56, 0x6f, 0x4c, 0x70, 0x45,
+    0x3f, 0xd6, 0x14, 0x3f, 0x92, 0xa0, 0xff, 0x02, 0xf9, 0x2f, 0x66, 0xba, 0xa9, 0x63, 0x1c, 0x32,
+    0x00, 0x00,
+};
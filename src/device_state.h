@@ -0,0 +1,92 @@
+#pragma once
+// Dashboard state as one-byte codes. The strings the page shows -- CSS
+// classes, class names, severity and the banner message -- are produced from
+// these only when a document is serialized, so changing state never touches
+// the heap.
+#include <stdint.h>
+#include <stdio.h>
+
+enum Style : uint8_t
+{
+    STYLE_HIDE,
+    STYLE_PRIMARY,
+    STYLE_SUCCESS,
+    STYLE_WARNING,
+    STYLE_DANGER
+};
+
+enum Severity : uint8_t
+{
+    SEVERITY_UNKNOWN,
+    SEVERITY_SAFE,
+    SEVERITY_MODERATE,
+    SEVERITY_CRITICAL
+};
+
+// The model's classes in export order, then "no prediction yet".
+enum Prediction : uint8_t
+{
+    PRED_NORMAL,
+    PRED_CRACK_LEFT,
+    PRED_CRACK_RIGHT,
+    PRED_BREAK,
+    PRED_UNKNOWN
+};
+
+inline const char *styleName(Style style)
+{
+    static const char *const names[] = {"hide", "primary", "success", "warning", "danger"};
+    return names[style];
+}
+
+inline const char *severityName(Severity severity)
+{
+    static const char *const names[] = {"Unknown", "Safe", "Moderate", "Critical"};
+    return names[severity];
+}
+
+inline const char *predictionName(Prediction prediction)
+{
+    static const char *const names[] = {"Normal", "Crack_Left", "Crack_Right", "Break", "Unknown"};
+    return names[prediction];
+}
+
+struct DeviceState
+{
+    float faultPercent = 0;
+    float confidence = 0;
+    Prediction prediction = PRED_UNKNOWN;
+    Severity severity = SEVERITY_UNKNOWN;
+    uint8_t left = 0;
+    uint8_t right = 0;
+    Style messageStyle = STYLE_HIDE;
+    Style leftStyle = STYLE_SUCCESS;
+    Style rightStyle = STYLE_SUCCESS;
+    Style fwdStyle = STYLE_SUCCESS;
+    Style stopStyle = STYLE_SUCCESS;
+    Style backStyle = STYLE_SUCCESS;
+    Style aiStyle = STYLE_PRIMARY;
+};
+
+// Button labels never change.
+#define BTN_FWD_LABEL "FORWARD"
+#define BTN_STOP_LABEL "STOP"
+#define BTN_BACK_LABEL "BACK"
+
+// The top banner; empty until the first prediction. Returns the length, as
+// snprintf does.
+inline int writeMessage(char *out, size_t size, const DeviceState &state)
+{
+    const char *name = predictionName(state.prediction);
+    const char *severity = severityName(state.severity);
+    if (state.prediction == PRED_UNKNOWN)
+    {
+        if (size)
+            out[0] = '\0';
+        return 0;
+    }
+    if (state.prediction == PRED_NORMAL)
+        return snprintf(out, size, "AI Status: %s | Fault: %.2f%% | Severity: %s", name, state.faultPercent, severity);
+    return snprintf(out, size, "⚠ %s detected! Train Stopped 🚨 | Fault: %.2f%% | Severity: %s", name,
+                    state.faultPercent, severity);
+}
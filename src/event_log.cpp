@@ -0,0 +1,175 @@
+#include "event_log.h"
+
+#define LOG_MAGIC 0x474f4c52 // "RLOG"
+
+static const char *const eventNames[EV_TYPE_COUNT] = {"boot", "fault", "clear", "auto_stop", "manual", "edges_lost",
+                                                           "model",     "glitch",  "station"};
+
+const char *logEventName(uint8_t type) { return type < EV_TYPE_COUNT ? eventNames[type] : "unknown"; }
+
+// FNV-1a over the first 12 bytes. Never 0xffffffff, so an erased slot
+// cannot pass.
+uint32_t logRecordCheck(const LogRecord &r)
+{
+    const uint8_t *p = (const uint8_t *)&r;
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < offsetof(LogRecord, check); i++)
+        h = (h ^ p[i]) * 16777619u;
+    return h == 0xffffffff ? 0xfffffffe : h;
+}
+
+static uint32_t headerCheck(uint32_t magic, uint32_t seq, uint32_t erases)
+{
+    return (magic ^ seq * 2654435761u ^ erases * 40503u) + 1;
+}
+
+static bool isBlank(const uint32_t *words, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+        if (words[i] != 0xffffffff)
+            return false;
+    return true;
+}
+
+bool EventLog::readHeader(uint32_t sector, SectorHeader &h) const
+{
+    return ESP.flashRead(base + sector * FLASH_SECTOR_SIZE, (uint32_t *)&h, sizeof(h)) && h.magic == LOG_MAGIC &&
+           h.check == headerCheck(h.magic, h.seq, h.erases);
+}
+
+bool EventLog::eraseSector(uint32_t sector)
+{
+    SectorHeader h;
+    nextErases = readHeader(sector, h) ? h.erases + 1 : nextErases;
+    nextErased = ESP.flashEraseSector(base / FLASH_SECTOR_SIZE + sector);
+    return nextErased;
+}
+
+bool EventLog::openSector(uint32_t sector, uint32_t seq)
+{
+    SectorHeader h = {LOG_MAGIC, seq, nextErases, headerCheck(LOG_MAGIC, seq, nextErases)};
+    if (!ESP.flashWrite(base + sector * FLASH_SECTOR_SIZE, (const uint32_t *)&h, sizeof(h)))
+        return false;
+    head = sector;
+    headSeq = seq;
+    slot = 0;
+    nextErased = false;
+    return true;
+}
+
+bool EventLog::writeRecord(const LogRecord &r)
+{
+    // A failed write may still have cleared bits, so the slot is spent.
+    return ESP.flashWrite(address(head, slot++), (const uint32_t *)&r, sizeof(r));
+}
+
+bool EventLog::begin()
+{
+    mounted = false;
+    if (sectors < 2 || base % FLASH_SECTOR_SIZE)
+        return false;
+
+    bool found = false;
+    SectorHeader h, headHeader = {};
+    for (uint32_t s = 0; s < sectors; s++)
+    {
+        if (readHeader(s, h) && (!found || int32_t(h.seq - headSeq) > 0))
+        {
+            found = true;
+            head = s;
+            headSeq = h.seq;
+            headHeader = h;
+        }
+    }
+
+    LogRecord last = {};
+    if (!found)
+    {
+        nextErases = 1;
+        if (!eraseSector(0) || !openSector(0, 1))
+            return false;
+    }
+    else
+    {
+        // The head's first blank slot is where writing resumes; a torn
+        // record before it is skipped.
+        slot = LOG_RECORDS_PER_SECTOR;
+        LogRecord r;
+        for (uint32_t i = 0; i < LOG_RECORDS_PER_SECTOR; i++)
+        {
+            ESP.flashRead(address(head, i), (uint32_t *)&r, sizeof(r));
+            if (isBlank((const uint32_t *)&r, sizeof(r) / 4))
+            {
+                slot = i;
+                break;
+            }
+            if (r.check == logRecordCheck(r))
+                last = r;
+        }
+        // A head without records was opened just before the reboot.
+        uint32_t previous = (head + sectors - 1) % sectors;
+        if (!last.seq && readHeader(previous, h))
+        {
+            for (uint32_t i = 0; i < LOG_RECORDS_PER_SECTOR; i++)
+            {
+                ESP.flashRead(address(previous, i), (uint32_t *)&r, sizeof(r));
+                if (r.check == logRecordCheck(r))
+                    last = r;
+            }
+        }
+
+        // The sector ahead may have been erased before the reboot. Wear is
+        // even around the ring, so a blank one takes the head's count.
+        uint32_t next = (head + 1) % sectors;
+        uint32_t words[64];
+        nextErased = true;
+        for (uint32_t at = 0; at < FLASH_SECTOR_SIZE && nextErased; at += sizeof(words))
+        {
+            ESP.flashRead(base + next * FLASH_SECTOR_SIZE + at, words, sizeof(words));
+            nextErased = isBlank(words, 64);
+        }
+        nextErases = headHeader.erases;
+    }
+
+    nextSeq = last.seq + 1;
+    bootCount = last.boot + 1;
+    mounted = true;
+    append(EV_BOOT);
+    return true;
+}
+
+void EventLog::append(LogEventType type, uint8_t arg)
+{
+    LogRecord r;
+    r.seq = nextSeq;
+    r.uptimeMs = millis();
+    r.boot = bootCount;
+    r.type = type;
+    r.arg = arg;
+    r.check = logRecordCheck(r);
+    if (queue.push(r))
+        nextSeq++;
+}
+
+void EventLog::service()
+{
+    if (!mounted)
+        return;
+    uint32_t next = (head + 1) % sectors;
+    if (queue.size())
+    {
+        if (slot == LOG_RECORDS_PER_SECTOR)
+        {
+            // Only when records arrive faster than idle time erases ahead.
+            if (!nextErased && !eraseSector(next))
+                return;
+            if (!openSector(next, headSeq + 1))
+                return;
+        }
+        LogRecord r;
+        queue.pop(r);
+        writeRecord(r);
+    }
+    else if (!nextErased)
+        eraseSector(next);
+}
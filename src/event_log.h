@@ -0,0 +1,132 @@
+#pragma once
+// Append-only event log in raw flash sectors, kept across reboots.
+//
+// The sectors form a ring. Each starts with a header (magic, a sequence
+// number that grows every time a sector is reused, and its erase count)
+// followed by fixed 16-byte records, each with a check word so a record torn
+// by a power cut reads as absent. Writing always moves forward through the
+// ring, so every sector is erased equally often: wear leveling without a
+// mapping table. One sector ahead of the head is kept erased, so the log
+// holds the last (sectors - 2) * 255 to (sectors - 1) * 255 records.
+//
+// append() only queues the record in RAM. service(), called from loop(),
+// programs at most one record per call (about 70 us of flash time); the
+// 45 ms erase of the next sector only runs from service() when nothing is
+// queued.
+#include "hal.h"
+#include "spsc_ring.h"
+
+enum LogEventType : uint8_t
+{
+    EV_BOOT,       // arg: 0
+    EV_FAULT,      // arg: predicted class
+    EV_CLEAR,      // fault cleared, arg: 0
+    EV_AUTO_STOP,  // interrupt stops since the last record, capped at 255
+    EV_MANUAL,     // arg: 1 forward, 2 stop, 3 back
+    EV_EDGES_LOST, // sensor queue overflowed, arg: 0
+    EV_MODEL,      // model image swapped in, arg: ModelSource
+    EV_GLITCH,     // the window saw no fault behind an interrupt stop, arg: 1 if the drive was put back
+    EV_STATION,    // station fault onsets since the last record, capped at 255
+    EV_TYPE_COUNT
+};
+
+struct LogRecord
+{
+    uint32_t seq;
+    uint32_t uptimeMs;
+    uint16_t boot;
+    uint8_t type;
+    uint8_t arg;
+    uint32_t check;
+};
+
+#define LOG_RECORDS_PER_SECTOR (FLASH_SECTOR_SIZE / sizeof(LogRecord) - 1)
+#define LOG_QUEUE_SIZE 16
+
+const char *logEventName(uint8_t type);
+
+class EventLog
+{
+public:
+    // The log owns sectors [base, base + sectors) of flash; base is a flash
+    // offset aligned to a sector.
+    EventLog(uint32_t base, uint32_t sectors) : base(base), sectors(sectors) {}
+
+    // Finds the head after a reboot, formatting the region if it holds no
+    // log, and queues an EV_BOOT record. May erase one sector.
+    bool begin();
+
+    void append(LogEventType type, uint8_t arg = 0);
+    void service();
+    // Nothing for service() to do: no record queued, the next sector erased.
+    bool idle() const { return !mounted || (!queue.size() && nextErased); }
+
+    // Calls f(const LogRecord &) for every record in flash with seq > since,
+    // oldest first. Records still queued in RAM are not visited.
+    template <typename F>
+    void forEach(uint32_t since, F f) const;
+
+    uint16_t boot() const { return bootCount; }
+    uint32_t lastSeq() const { return nextSeq - 1; }
+    uint32_t pending() const { return queue.size(); }
+    uint32_t dropped() const { return queue.dropped(); }
+    bool ok() const { return mounted; }
+
+private:
+    struct SectorHeader
+    {
+        uint32_t magic;
+        uint32_t seq;
+        uint32_t erases;
+        uint32_t check;
+    };
+
+    uint32_t address(uint32_t sector, uint32_t slot) const
+    {
+        return base + sector * FLASH_SECTOR_SIZE + (slot + 1) * sizeof(LogRecord);
+    }
+    bool readHeader(uint32_t sector, SectorHeader &h) const;
+    bool eraseSector(uint32_t sector);
+    bool openSector(uint32_t sector, uint32_t seq);
+    bool writeRecord(const LogRecord &r);
+
+    uint32_t base;
+    uint32_t sectors;
+    bool mounted = false;
+    uint32_t head = 0;      // sector being filled
+    uint32_t headSeq = 0;   // its header sequence
+    uint32_t slot = 0;      // next free record slot in it
+    bool nextErased = false;
+    uint32_t nextErases = 1; // erase count for the next sector's header
+    uint32_t nextSeq = 1;
+    uint16_t bootCount = 0;
+    SpscRing<LogRecord, LOG_QUEUE_SIZE> queue;
+};
+
+uint32_t logRecordCheck(const LogRecord &r);
+
+template <typename F>
+void EventLog::forEach(uint32_t since, F f) const
+{
+    if (!mounted)
+        return;
+    const uint32_t BATCH = 16;
+    LogRecord batch[BATCH];
+    // head + 1 is the pre-erased sector, so the walk starts at the oldest.
+    for (uint32_t i = 1; i <= sectors; i++)
+    {
+        uint32_t sector = (head + i) % sectors;
+        SectorHeader h;
+        if (!readHeader(sector, h))
+            continue;
+        uint32_t used = sector == head ? slot : LOG_RECORDS_PER_SECTOR;
+        for (uint32_t first = 0; first < used; first += BATCH)
+        {
+            uint32_t n = used - first < BATCH ? used - first : BATCH;
+            ESP.flashRead(address(sector, first), (uint32_t *)batch, n * sizeof(LogRecord));
+            for (uint32_t k = 0; k < n; k++)
+                if (batch[k].check == logRecordCheck(batch[k]) && batch[k].seq > since)
+                    f(batch[k]);
+        }
+    }
+}
@@ -0,0 +1,137 @@
+#pragma once
+// Server-sent events for a handful of long-lived dashboard connections.
+// Each subscriber remembers the last state sequence it was sent, so publish()
+// only ships the fields that changed since then. A subscriber whose socket
+// buffer is full is skipped rather than waited on; it catches up with a
+// larger delta on a later call.
+#include "hal.h"
+
+#define EVENT_HEARTBEAT_MS 15000
+
+template <int MAX_CLIENTS>
+class EventStream
+{
+public:
+    // Takes over the request's connection and answers with the stream
+    // headers. Returns false when every slot is busy.
+    bool subscribe(WiFiClient client)
+    {
+        int slot = -1;
+        for (int i = 0; i < MAX_CLIENTS; i++)
+        {
+            if (!subscribers[i].active || !subscribers[i].client.connected())
+            {
+                drop(i);
+                if (slot < 0)
+                    slot = i;
+            }
+        }
+        if (slot < 0)
+            return false;
+
+        static const char headers[] PROGMEM = "HTTP/1.1 200 OK\r\n"
+                                              "Content-Type: text/event-stream\r\n"
+                                              "Cache-Control: no-cache\r\n"
+                                              "Connection: keep-alive\r\n\r\n"
+                                              "retry: 2000\n\n";
+        client.setNoDelay(true);
+        client.write((const uint8_t *)headers, sizeof(headers) - 1);
+
+        Subscriber &s = subscribers[slot];
+        s.client = client;
+        s.seq = 0; // first event carries the full state
+        s.lastSendMs = 0;
+        s.active = true;
+        return true;
+    }
+
+    // writeState(since, out, size) serializes the state changed after since
+    // (everything for 0) and returns its length, 0 on overflow.
+    template <typename Writer>
+    void publish(uint32_t seq, uint32_t nowMs, char *buf, size_t size, Writer writeState)
+    {
+        for (int i = 0; i < MAX_CLIENTS; i++)
+        {
+            Subscriber &s = subscribers[i];
+            if (!s.active)
+                continue;
+
+            if (s.seq == seq)
+            {
+                if (nowMs - s.lastSendMs >= EVENT_HEARTBEAT_MS)
+                    send(i, ":\n\n", 3, nowMs); // comment line keeps proxies and dead-peer detection honest
+                continue;
+            }
+
+            int head = snprintf(buf, size, "id: %lu\ndata: ", (unsigned long)seq);
+            if (head < 0 || size_t(head) + 2 >= size)
+                return;
+            size_t len = writeState(s.seq, buf + head, size - head - 2);
+            if (!len)
+                continue;
+            len += head;
+            buf[len++] = '\n';
+            buf[len++] = '\n';
+            if (send(i, buf, len, nowMs))
+                s.seq = seq;
+        }
+    }
+
+    // Whether publish() has anything to send: a subscriber behind seq or
+    // due a heartbeat.
+    bool pending(uint32_t seq, uint32_t nowMs) const
+    {
+        for (int i = 0; i < MAX_CLIENTS; i++)
+        {
+            const Subscriber &s = subscribers[i];
+            if (s.active && (s.seq != seq || nowMs - s.lastSendMs >= EVENT_HEARTBEAT_MS))
+                return true;
+        }
+        return false;
+    }
+
+    int count() const
+    {
+        int n = 0;
+        for (int i = 0; i < MAX_CLIENTS; i++)
+            n += subscribers[i].active;
+        return n;
+    }
+
+private:
+    struct Subscriber
+    {
+        WiFiClient client;
+        uint32_t seq = 0;
+        uint32_t lastSendMs = 0;
+        bool active = false;
+    };
+
+    bool send(int i, const char *data, size_t len, uint32_t nowMs)
+    {
+        Subscriber &s = subscribers[i];
+        if (s.client.availableForWrite() < len)
+        {
+            if (!s.client.connected())
+                drop(i);
+            return false;
+        }
+        if (s.client.write((const uint8_t *)data, len) != len)
+        {
+            drop(i);
+            return false;
+        }
+        s.lastSendMs = nowMs;
+        return true;
+    }
+
+    void drop(int i)
+    {
+        if (subscribers[i].active)
+            subscribers[i].client.stop();
+        subscribers[i].client = WiFiClient();
+        subscribers[i].active = false;
+    }
+
+    Subscriber subscribers[MAX_CLIENTS];
+};
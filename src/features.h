@@ -0,0 +1,178 @@
+#pragma once
+// Windowed features of the IR sensor pair for the classifier. The pair is
+// sampled on a fixed grid of FEATURE_SAMPLE_US, reconstructed from the
+// timestamped edges, so a late or skipped loop() changes nothing; the last
+// WINDOW samples are kept at 2 bits each.
+//
+// Every feature is a running count updated as a sample enters the window
+// and another leaves it, so a sample costs O(1) whatever the window:
+//
+//   left, right            the levels of the newest sample
+//   left_duty, right_duty  fraction of the window each sensor was high
+//   left_edges, ..._edges  transitions per second within the window
+//   left_run_ms, ...       how long each sensor has held its level
+//   since_edge_ms          since either sensor last changed, the shorter run
+//   correlation            phi coefficient of left and right over the
+//                          window, 0 while either is constant
+//
+// A one-sample glitch has a short run and no history; a crack holds one
+// sensor; a break holds both, correlated. features.py computes the same
+// values, bit for bit, from recorded traces for training.
+#include <math.h>
+#include <stdint.h>
+
+#define FEATURE_SAMPLE_US 1000
+#define FEATURE_WINDOW 256
+#define FEATURE_RUN_CAP 60000 // samples; runs and since_edge stop growing here
+
+enum FeatureIndex
+{
+    FEAT_LEFT,
+    FEAT_RIGHT,
+    FEAT_LEFT_DUTY,
+    FEAT_RIGHT_DUTY,
+    FEAT_LEFT_EDGES,
+    FEAT_RIGHT_EDGES,
+    FEAT_LEFT_RUN_MS,
+    FEAT_RIGHT_RUN_MS,
+    FEAT_SINCE_EDGE_MS,
+    FEAT_CORRELATION,
+    FEATURE_COUNT
+};
+
+inline const char *featureName(int feature)
+{
+    static const char *const names[FEATURE_COUNT] = {
+        "left",        "right",        "left_duty",     "right_duty",    "left_edges",
+        "right_edges", "left_run_ms", "right_run_ms", "since_edge_ms", "correlation",
+    };
+    return feature >= 0 && feature < FEATURE_COUNT ? names[feature] : "unknown";
+}
+
+template <int WINDOW>
+class SensorWindow
+{
+    static_assert(WINDOW >= 4 && (WINDOW & (WINDOW - 1)) == 0, "window must be a power of two of 4 or more");
+    static_assert(WINDOW < 65536, "counts are 16-bit");
+
+public:
+    // Starts the grid at nowUs with the pins as they are, and takes its
+    // first sample there.
+    void begin(uint32_t nowUs, int left, int right)
+    {
+        *this = SensorWindow();
+        set(left, right);
+        push(level);
+        nextUs = nowUs + FEATURE_SAMPLE_US;
+    }
+
+    // The pair changed; samples after this take the new levels.
+    void set(int left, int right) { level = (left ? 1 : 0) | (right ? 2 : 0); }
+
+    // Takes a sample at every grid point up to tUs. Returns how many.
+    uint32_t advanceTo(uint32_t tUs)
+    {
+        if (int32_t(tUs - nextUs) < 0)
+            return 0;
+        uint32_t due = (tUs - nextUs) / FEATURE_SAMPLE_US + 1;
+        nextUs += due * FEATURE_SAMPLE_US;
+        uint32_t left = due;
+        // After a window of the same level more of it only lengthens the runs.
+        if (left > WINDOW)
+        {
+            push(level);
+            grow(left - WINDOW);
+            left = WINDOW - 1;
+        }
+        while (left--)
+            push(level);
+        return due;
+    }
+
+    // One sample of the pair (bit 0 left, bit 1 right).
+    void push(uint8_t pair)
+    {
+        if (count == WINDOW)
+        {
+            // The oldest sample sits where the new one goes.
+            uint8_t old = get(head);
+            uint8_t next = get((head + 1) & (WINDOW - 1));
+            for (int s = 0; s < 2; s++)
+            {
+                ones[s] -= (old >> s) & 1;
+                edges[s] -= ((old ^ next) >> s) & 1;
+            }
+            both -= old == 3;
+            count--;
+        }
+        uint8_t changed = count ? pair ^ last : 0;
+        for (int s = 0; s < 2; s++)
+        {
+            ones[s] += (pair >> s) & 1;
+            edges[s] += (changed >> s) & 1;
+            run[s] = !count || (changed >> s) & 1 ? 1 : cap(run[s] + 1);
+        }
+        both += pair == 3;
+        ring[head / 4] = (ring[head / 4] & ~(3 << (head % 4 * 2))) | pair << (head % 4 * 2);
+        head = (head + 1) & (WINDOW - 1);
+        count++;
+        total++;
+        last = pair;
+    }
+
+    // The feature vector of the newest sample, FEATURE_COUNT floats.
+    void extract(float *out) const
+    {
+        uint32_t n = count ? count : 1;
+        out[FEAT_LEFT] = last & 1;
+        out[FEAT_RIGHT] = last >> 1;
+        for (int s = 0; s < 2; s++)
+        {
+            out[FEAT_LEFT_DUTY + s] = float(ones[s]) / float(n);
+            out[FEAT_LEFT_EDGES + s] = float(edges[s] * (1000000 / FEATURE_SAMPLE_US)) / float(n);
+            out[FEAT_LEFT_RUN_MS + s] = float(run[s] * FEATURE_SAMPLE_US / 1000);
+        }
+        uint32_t sinceEdge = run[0] < run[1] ? run[0] : run[1];
+        out[FEAT_SINCE_EDGE_MS] = float(sinceEdge * FEATURE_SAMPLE_US / 1000);
+        uint32_t varLeft = ones[0] * (n - ones[0]), varRight = ones[1] * (n - ones[1]);
+        if (!count || !varLeft || !varRight)
+            out[FEAT_CORRELATION] = 0;
+        else
+            out[FEAT_CORRELATION] = float(int32_t(n * both) - int32_t(ones[0] * ones[1])) /
+                                    sqrtf(float(varLeft) * float(varRight));
+    }
+
+    int left() const { return last & 1; }
+    int right() const { return last >> 1; }
+    // A full window without an edge, and no new level waiting: each further
+    // sample only lengthens the two runs.
+    bool steady() const { return count == WINDOW && !edges[0] && !edges[1] && level == last; }
+    // When the next sample is taken.
+    uint32_t nextSampleUs() const { return nextUs; }
+    // Samples taken since begin().
+    uint32_t samples() const { return total; }
+
+private:
+    static uint32_t cap(uint32_t v) { return v < FEATURE_RUN_CAP ? v : FEATURE_RUN_CAP; }
+
+    uint8_t get(uint32_t i) const { return (ring[i / 4] >> (i % 4 * 2)) & 3; }
+
+    void grow(uint32_t samples)
+    {
+        run[0] = cap(run[0] + samples);
+        run[1] = cap(run[1] + samples);
+        total += samples;
+    }
+
+    uint8_t ring[WINDOW / 4] = {};
+    uint32_t head = 0;
+    uint32_t count = 0;
+    uint32_t total = 0;
+    uint32_t nextUs = 0;
+    uint16_t ones[2] = {};
+    uint16_t edges[2] = {};
+    uint16_t both = 0;
+    uint32_t run[2] = {}; // samples each sensor has held its level, newest included
+    uint8_t level = 0;
+    uint8_t last = 0;
+};
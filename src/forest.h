@@ -0,0 +1,145 @@
+#pragma once
+// Random forest stored as flat structure-of-arrays node tables in flash.
+//
+// Each tree's split nodes are laid out breadth-first and contiguously, so a
+// walk touches a few neighbouring entries of each array. Split node n keeps
+// its children at children[2n] (x <= threshold) and children[2n + 1], so a
+// step is one compare feeding an index. A child reference with FOREST_LEAF
+// set is a leaf: the low bits index a row of CLASSES probabilities in
+// 1/FOREST_PROBA_ONE units. Identical leaf rows are shared.
+//
+// Identical trees are stored once with a weight, the number of the
+// original forest's trees they stand for.
+//
+// The tables are generated by export_forest.py.
+#include <math.h>
+#include <string.h>
+
+#include "hal.h"
+
+#define FOREST_LEAF 0x8000
+#define FOREST_PROBA_ONE 65535
+#define FOREST_MAX_DEPTH 32
+
+template <int FEATURES, int CLASSES>
+class Forest
+{
+public:
+    constexpr Forest(uint16_t trees, uint16_t weightSum, const uint16_t *roots, const uint16_t *weights,
+                     const uint8_t *feature, const float *threshold, const uint16_t *children, const uint16_t *proba)
+        : trees(trees), weightSum(weightSum), roots(roots), weights(weights), feature(feature), threshold(threshold),
+          children(children), proba(proba)
+    {
+    }
+
+    // Mean of the trees' leaf distributions, like sklearn's predict_proba().
+    void predictProba(const float *x, float *out) const
+    {
+        uint32_t sum[CLASSES] = {};
+        for (uint16_t t = 0; t < trees; t++)
+        {
+            uint16_t node = pgm_read_word(roots + t);
+            while (!(node & FOREST_LEAF))
+            {
+                if (x[pgm_read_byte(feature + node)] <= pgm_read_float(threshold + node))
+                    node = pgm_read_word(children + 2 * node);
+                else
+                    node = pgm_read_word(children + 2 * node + 1);
+            }
+            const uint16_t *row = proba + (node & ~FOREST_LEAF) * CLASSES;
+            uint32_t weight = pgm_read_word(weights + t);
+            for (int c = 0; c < CLASSES; c++)
+                sum[c] += weight * pgm_read_word(row + c);
+        }
+        float scale = 1.0f / (float(weightSum) * FOREST_PROBA_ONE);
+        for (int c = 0; c < CLASSES; c++)
+            out[c] = sum[c] * scale;
+    }
+
+    // predictProba() for count samples given as one array per feature; out
+    // receives count rows of CLASSES. Walks each tree over a block of
+    // samples in turn, so one tree's nodes stay hot; the integer sums make
+    // the results identical to predictProba().
+    void predictProbaBatch(const float *const columns[FEATURES], size_t count, float *out) const
+    {
+        const size_t BLOCK = 64;
+        uint32_t sum[BLOCK][CLASSES];
+        float scale = 1.0f / (float(weightSum) * FOREST_PROBA_ONE);
+        for (size_t base = 0; base < count; base += BLOCK)
+        {
+            size_t n = count - base < BLOCK ? count - base : BLOCK;
+            memset(sum, 0, sizeof(sum));
+            for (uint16_t t = 0; t < trees; t++)
+            {
+                uint16_t root = pgm_read_word(roots + t);
+                uint32_t weight = pgm_read_word(weights + t);
+                for (size_t i = 0; i < n; i++)
+                {
+                    uint16_t node = root;
+                    while (!(node & FOREST_LEAF))
+                    {
+                        if (columns[pgm_read_byte(feature + node)][base + i] <= pgm_read_float(threshold + node))
+                            node = pgm_read_word(children + 2 * node);
+                        else
+                            node = pgm_read_word(children + 2 * node + 1);
+                    }
+                    const uint16_t *row = proba + (node & ~FOREST_LEAF) * CLASSES;
+                    for (int c = 0; c < CLASSES; c++)
+                        sum[i][c] += weight * pgm_read_word(row + c);
+                }
+            }
+            for (size_t i = 0; i < n; i++)
+                for (int c = 0; c < CLASSES; c++)
+                    out[(base + i) * CLASSES + c] = sum[i][c] * scale;
+        }
+    }
+
+    // Most probable class; ties go to the lower class, as numpy's argmax.
+    int predict(const float *x, float *out) const
+    {
+        predictProba(x, out);
+        int best = 0;
+        for (int c = 1; c < CLASSES; c++)
+            if (out[c] > out[best])
+                best = c;
+        return best;
+    }
+
+    // The lowest split threshold on feature f at or above x, INFINITY if
+    // there is none. While x stays at or below it no split on f changes
+    // sides, so a vector where only f grows keeps its prediction.
+    float nextThreshold(int f, float x) const
+    {
+        float best = INFINITY;
+        uint16_t stack[FOREST_MAX_DEPTH + 1];
+        for (uint16_t t = 0; t < trees; t++)
+        {
+            int depth = 0;
+            stack[depth++] = pgm_read_word(roots + t);
+            while (depth)
+            {
+                uint16_t node = stack[--depth];
+                if (node & FOREST_LEAF)
+                    continue;
+                float threshold = pgm_read_float(this->threshold + node);
+                if (pgm_read_byte(feature + node) == f && threshold >= x && threshold < best)
+                    best = threshold;
+                if (depth + 2 > FOREST_MAX_DEPTH + 1)
+                    return x; // deeper than expected: assume the next step changes it
+                stack[depth++] = pgm_read_word(children + 2 * node);
+                stack[depth++] = pgm_read_word(children + 2 * node + 1);
+            }
+        }
+        return best;
+    }
+
+private:
+    uint16_t trees;
+    uint16_t weightSum;
+    const uint16_t *roots;
+    const uint16_t *weights;
+    const uint8_t *feature;
+    const float *threshold;
+    const uint16_t *children;
+    const uint16_t *proba;
+};
@@ -0,0 +1,29 @@
+#pragma once
+// Hardware abstraction layer the firmware compiles against. On the board the
+// names below resolve to the ESP8266 Arduino core; the host build puts
+// host/include first on the include path so the same calls land in the Linux
+// backend (virtual clock, simulated track, local TCP sockets).
+#include <Arduino.h>
+#include <EEPROM.h>
+#include <ESP8266WiFi.h>
+#include <coredecls.h>
+#include <flash_hal.h>
+
+// Board wiring
+#define LOLIN_LED D4
+#define IRL_PIN D1
+#define IRR_PIN D2
+#define MLP_PIN D5
+#define MLN_PIN D6
+#define BUZZER_PIN D7
+
+// Chain of 74HC165s with the other stations' sensors (src/stations.h). D3
+// idles high and D8 low, as they must at boot; D0 only reads.
+#define STATION_LOAD_PIN D3
+#define STATION_CLOCK_PIN D8
+#define STATION_DATA_PIN D0
+// Stations on the chain. A board without one would read a floating D0, so
+// the scan is only built in when the board opts in with -DSTATION_COUNT=N.
+#ifndef STATION_COUNT
+#define STATION_COUNT 0
+#endif
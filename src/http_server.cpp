@@ -0,0 +1,698 @@
+#include "http_server.h"
+
+static const char *statusText(int code)
+{
+    switch (code)
+    {
+    case 200:
+        return "OK";
+    case 204:
+        return "No Content";
+    case 302:
+        return "Found";
+    case 304:
+        return "Not Modified";
+    case 400:
+        return "Bad Request";
+    case 404:
+        return "Not Found";
+    case 405:
+        return "Method Not Allowed";
+    case 411:
+        return "Length Required";
+    case 413:
+        return "Payload Too Large";
+    case 414:
+        return "URI Too Long";
+    case 431:
+        return "Request Header Fields Too Large";
+    case 500:
+        return "Internal Server Error";
+    case 503:
+        return "Service Unavailable";
+    default:
+        return "";
+    }
+}
+
+static int hexValue(char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    return -1;
+}
+
+// Decodes %XX and '+' in place.
+static char *urlDecode(char *s)
+{
+    char *out = s;
+    for (const char *p = s; *p; p++)
+    {
+        if (*p == '+')
+            *out++ = ' ';
+        else if (*p == '%' && hexValue(p[1]) >= 0 && hexValue(p[2]) >= 0)
+        {
+            *out++ = char(hexValue(p[1]) * 16 + hexValue(p[2]));
+            p += 2;
+        }
+        else
+            *out++ = *p;
+    }
+    *out = '\0';
+    return s;
+}
+
+void HttpServer::begin()
+{
+    listener.begin();
+    listener.setNoDelay(true);
+}
+
+void HttpServer::on(const char *uri, HttpHandler handler)
+{
+    if (routeCount < HTTP_MAX_ROUTES)
+        routes[routeCount++] = {uri, handler, nullptr};
+}
+
+void HttpServer::onUpload(const char *uri, HttpBodySink sink, HttpHandler done)
+{
+    if (routeCount < HTTP_MAX_ROUTES)
+        routes[routeCount++] = {uri, done, sink};
+}
+
+void HttpServer::collectHeaders(const char *const keys[], size_t count)
+{
+    headerKeyCount = HTTP_BUILTIN_HEADERS; // always kept
+    for (size_t i = 0; i < count && headerKeyCount < HTTP_MAX_HEADER_KEYS + HTTP_BUILTIN_HEADERS; i++)
+        headerKeys[headerKeyCount++] = keys[i];
+}
+
+const char *HttpServer::arg(const char *name) const
+{
+    for (int i = 0; i < argCount; i++)
+        if (!strcmp(argNames[i], name))
+            return argValues[i];
+    return "";
+}
+
+bool HttpServer::hasArg(const char *name) const
+{
+    for (int i = 0; i < argCount; i++)
+        if (!strcmp(argNames[i], name))
+            return true;
+    return false;
+}
+
+const char *HttpServer::header(const char *name) const
+{
+    for (int i = 0; i < headerCount; i++)
+        if (!strcasecmp(headerNames[i], name))
+            return headerValues[i];
+    return "";
+}
+
+WiFiClient HttpServer::client() { return current ? current->client : WiFiClient(); }
+
+void HttpServer::detach()
+{
+    if (!current)
+        return;
+    current->client = WiFiClient();
+    reset(*current);
+    current = nullptr;
+}
+
+int HttpServer::openConnections() const
+{
+    int n = 0;
+    for (const Connection &c : connections)
+        n += c.phase != FREE;
+    return n;
+}
+
+bool HttpServer::idle() { return !openConnections() && !listener.hasClient(); }
+
+void HttpServer::handleClient()
+{
+    uint32_t now = millis();
+    accept(now);
+    for (Connection &c : connections)
+    {
+        if (c.phase == READING)
+            read(c, now);
+        if (c.phase == READING && c.headEnd)
+            dispatch(c);
+        if (c.phase == RECEIVING)
+            receive(c, now);
+        if (c.phase == WRITING)
+            write(c, now);
+    }
+}
+
+// One connection per pass. With every slot taken, the connection idle the
+// longest makes room, but only if it has been idle a moment: one that just
+// got its response is likely sending the next request.
+void HttpServer::accept(uint32_t now)
+{
+    if (!listener.hasClient())
+        return;
+    Connection *slot = nullptr;
+    for (Connection &c : connections)
+    {
+        if (c.phase == FREE)
+        {
+            slot = &c;
+            break;
+        }
+    }
+    if (!slot)
+    {
+        uint32_t longest = HTTP_EVICT_IDLE_MS;
+        for (Connection &c : connections)
+        {
+            if (c.phase == READING && !c.inUsed && now - c.lastActiveMs >= longest)
+            {
+                longest = now - c.lastActiveMs;
+                slot = &c;
+            }
+        }
+        if (!slot)
+            return;
+        close(*slot);
+        counters.evicted++;
+    }
+
+    slot->client = listener.accept();
+    if (!slot->client)
+        return;
+    slot->client.setNoDelay(true);
+    slot->phase = READING;
+    slot->served = 0;
+    slot->lastActiveMs = now;
+    counters.accepted++;
+}
+
+void HttpServer::read(Connection &c, uint32_t now)
+{
+    if (!c.headEnd)
+    {
+        int available = c.client.available();
+        if (available > 0)
+        {
+            size_t room = sizeof(c.in) - c.inUsed;
+            int n = c.client.read((uint8_t *)c.in + c.inUsed, size_t(available) < room ? available : room);
+            if (n > 0)
+            {
+                if (!c.inUsed)
+                    c.startedMs = now;
+                c.inUsed += n;
+                c.lastActiveMs = now;
+                if (!scan(c))
+                    return;
+            }
+        }
+        else if (!c.client.connected())
+        {
+            close(c);
+            return;
+        }
+    }
+    if (c.headEnd)
+        return;
+    if (c.inUsed ? now - c.startedMs > HTTP_REQUEST_TIMEOUT_MS : now - c.lastActiveMs > HTTP_IDLE_TIMEOUT_MS)
+    {
+        counters.timedOut++;
+        close(c);
+    }
+}
+
+bool HttpServer::keepHeader(const char *line, size_t length) const
+{
+    for (int i = 0; i < headerKeyCount; i++)
+    {
+        size_t n = strlen(headerKeys[i]);
+        if (length > n && line[n] == ':' && !strncasecmp(line, headerKeys[i], n))
+            return true;
+    }
+    return false;
+}
+
+// Finds the end of the request head in the new bytes, dropping header lines
+// nobody asked for. Returns false if the request was rejected.
+bool HttpServer::scan(Connection &c)
+{
+    while (c.scanned < c.inUsed)
+    {
+        char *newline = (char *)memchr(c.in + c.scanned, '\n', c.inUsed - c.scanned);
+        if (c.skipping)
+        {
+            // The start of this line is already gone; drop through its end.
+            uint16_t end = newline ? newline + 1 - c.in : c.inUsed;
+            memmove(c.in + c.lineStart, c.in + end, c.inUsed - end);
+            c.inUsed -= end - c.lineStart;
+            c.scanned = c.lineStart;
+            c.skipping = !newline;
+            continue;
+        }
+        if (!newline)
+        {
+            c.scanned = c.inUsed;
+            break;
+        }
+        uint16_t end = newline + 1 - c.in;
+        if (c.lineStart && end - c.lineStart <= 2)
+        {
+            c.headEnd = c.scanned = end; // blank line
+            return true;
+        }
+        if (c.lineStart && !keepHeader(c.in + c.lineStart, end - c.lineStart))
+        {
+            memmove(c.in + c.lineStart, c.in + end, c.inUsed - end);
+            c.inUsed -= end - c.lineStart;
+            c.scanned = c.lineStart;
+            continue;
+        }
+        c.lineStart = c.scanned = end;
+    }
+
+    if (c.inUsed < sizeof(c.in))
+        return true;
+    // Full without a complete head: a header line nobody wants is dropped
+    // as it arrives; anything else is too long.
+    if (!c.lineStart || keepHeader(c.in + c.lineStart, c.inUsed - c.lineStart))
+    {
+        reject(c, c.lineStart ? 431 : 414);
+        return false;
+    }
+    c.inUsed = c.scanned = c.lineStart;
+    c.skipping = true;
+    return true;
+}
+
+void HttpServer::dispatch(Connection &c)
+{
+    // Request line, NUL-terminated in place.
+    char *line = c.in;
+    char *eol = (char *)memchr(line, '\n', c.headEnd);
+    *eol = '\0';
+    if (eol > line && eol[-1] == '\r')
+        eol[-1] = '\0';
+    char *target = strchr(line, ' ');
+    char *version = target ? strchr(target + 1, ' ') : nullptr;
+    if (!version || strncmp(version + 1, "HTTP/1.", 7))
+    {
+        reject(c, 400);
+        return;
+    }
+    *target++ = '\0';
+    *version++ = '\0';
+    head = !strcmp(line, "HEAD");
+    upload = !strcmp(line, "POST") || !strcmp(line, "PUT");
+    if (!head && !upload && strcmp(line, "GET"))
+    {
+        // Bodies are not read, so the connection cannot be reused.
+        reject(c, 405);
+        return;
+    }
+    http10 = !strcmp(version, "HTTP/1.0");
+
+    headerCount = 0;
+    const char *connection = "";
+    for (char *h = eol + 1; h < c.in + c.headEnd;)
+    {
+        char *end = (char *)memchr(h, '\n', c.in + c.headEnd - h);
+        *end = '\0';
+        if (end > h && end[-1] == '\r')
+            end[-1] = '\0';
+        char *colon = strchr(h, ':');
+        if (colon && headerCount < HTTP_MAX_HEADER_KEYS + HTTP_BUILTIN_HEADERS)
+        {
+            *colon++ = '\0';
+            while (*colon == ' ')
+                colon++;
+            headerNames[headerCount] = h;
+            headerValues[headerCount++] = colon;
+            if (!strcasecmp(h, "Connection"))
+                connection = colon;
+        }
+        h = end + 1;
+    }
+    c.keepAlive = http10 ? !strcasecmp(connection, "keep-alive") : strcasecmp(connection, "close") != 0;
+    if (c.keepAlive && ++c.served >= HTTP_FAIR_SHARE && listener.hasClient())
+        c.keepAlive = false; // give the slot to a waiting client
+
+    argCount = 0;
+    char *query = strchr(target, '?');
+    if (query)
+    {
+        *query++ = '\0';
+        while (*query && argCount < HTTP_MAX_ARGS)
+        {
+            char *next = strchr(query, '&');
+            if (next)
+                *next++ = '\0';
+            char *eq = strchr(query, '=');
+            if (eq)
+                *eq++ = '\0';
+            argNames[argCount] = urlDecode(query);
+            argValues[argCount++] = eq ? urlDecode(eq) : (char *)"";
+            query = next ? next : query + strlen(query);
+        }
+    }
+    requestUri = urlDecode(target);
+
+    HttpHandler handler = notFound;
+    const Route *route = nullptr;
+    for (int i = 0; i < routeCount; i++)
+    {
+        if (!strcmp(routes[i].uri, requestUri) && !routes[i].sink == !upload)
+        {
+            route = &routes[i];
+            handler = route->handler;
+            break;
+        }
+    }
+    if (requestObserver)
+        requestObserver();
+    if (upload)
+    {
+        if (!route)
+            reject(c, 405);
+        else
+            beginBody(c, *route);
+        return;
+    }
+
+    counters.requests++;
+    current = &c;
+    answered = false;
+    extraLen = 0;
+    if (handler)
+        handler();
+    else
+        send(404, "text/plain", "Not found");
+    if (current && !answered)
+        send(500, "text/plain", "no response");
+    current = nullptr;
+}
+
+void HttpServer::beginBody(Connection &c, const Route &route)
+{
+    const char *length = header("Content-Length");
+    if (!*length)
+    {
+        reject(c, 411); // chunked request bodies are not taken
+        return;
+    }
+    counters.requests++;
+    c.upload = &route;
+    c.uriAt = requestUri - c.in;
+    c.bodyOffset = 0;
+    c.bodyTotal = strtoul(length, nullptr, 10);
+    int refused = route.sink(nullptr, 0, 0, c.bodyTotal);
+    if (refused)
+    {
+        reject(c, refused);
+        return;
+    }
+    if (!strcasecmp(header("Expect"), "100-continue"))
+    {
+        static const char CONTINUE[] = "HTTP/1.1 100 Continue\r\n\r\n";
+        c.client.write((const uint8_t *)CONTINUE, sizeof(CONTINUE) - 1);
+    }
+    c.phase = RECEIVING;
+}
+
+// Hands the body to the route's sink: first what was read along with the
+// head, then what arrives, read through the idle response buffer. Runs the
+// route's handler once the last byte is in.
+void HttpServer::receive(Connection &c, uint32_t now)
+{
+    if (c.inUsed > c.headEnd)
+    {
+        size_t n = c.inUsed - c.headEnd;
+        if (n > c.bodyTotal - c.bodyOffset)
+            n = c.bodyTotal - c.bodyOffset;
+        if (!consume(c, c.in + c.headEnd, n))
+            return;
+        // Whatever follows the body is the next pipelined request.
+        memmove(c.in + c.headEnd, c.in + c.headEnd + n, c.inUsed - c.headEnd - n);
+        c.inUsed -= n;
+    }
+    while (c.bodyOffset < c.bodyTotal)
+    {
+        int available = c.client.available();
+        if (available <= 0)
+        {
+            if (!c.client.connected())
+                close(c);
+            else if (now - c.lastActiveMs > HTTP_REQUEST_TIMEOUT_MS)
+            {
+                counters.timedOut++;
+                close(c);
+            }
+            return;
+        }
+        size_t want = c.bodyTotal - c.bodyOffset;
+        if (want > sizeof(c.out))
+            want = sizeof(c.out);
+        if (want > size_t(available))
+            want = available;
+        int n = c.client.read((uint8_t *)c.out, want);
+        if (n <= 0)
+            return;
+        c.lastActiveMs = now;
+        if (!consume(c, c.out, n))
+            return;
+    }
+
+    current = &c;
+    answered = false;
+    head = http10 = false;
+    upload = true;
+    requestUri = c.in + c.uriAt;
+    argCount = headerCount = 0;
+    extraLen = 0;
+    c.upload->handler();
+    if (current && !answered)
+        send(500, "text/plain", "no response");
+    current = nullptr;
+}
+
+bool HttpServer::consume(Connection &c, const char *data, size_t length)
+{
+    int refused = c.upload->sink((const uint8_t *)data, length, c.bodyOffset, c.bodyTotal);
+    if (refused)
+    {
+        reject(c, refused);
+        return false;
+    }
+    c.bodyOffset += length;
+    return true;
+}
+
+void HttpServer::sendHeader(const char *name, const char *value)
+{
+    int n = snprintf(extraHeaders + extraLen, sizeof(extraHeaders) - extraLen, "%s: %s\r\n", name, value);
+    if (n > 0 && size_t(n) < sizeof(extraHeaders) - extraLen)
+        extraLen += n;
+    else
+        extraHeaders[extraLen] = '\0';
+}
+
+bool HttpServer::beginResponse(int code, const char *contentType, size_t length, bool chunked)
+{
+    if (!current || answered)
+        return false;
+    Connection &c = *current;
+    size_t size = sizeof(c.out);
+    int n = snprintf(c.out, size, "HTTP/1.1 %d %s\r\nContent-Type: %s\r\n", code, statusText(code),
+                     contentType ? contentType : "text/html");
+    if (code == 304)
+        ;
+    else if (length != SIZE_MAX)
+        n += snprintf(c.out + n, size - n, "Content-Length: %lu\r\n", (unsigned long)length);
+    else if (chunked)
+        n += snprintf(c.out + n, size - n, "Transfer-Encoding: chunked\r\n");
+    n += snprintf(c.out + n, size - n, "Connection: %s\r\n%.*s\r\n", c.keepAlive ? "keep-alive" : "close",
+                  int(extraLen), extraHeaders);
+    if (n < 0 || size_t(n) >= size)
+        return false;
+    c.outLen = n;
+    c.outSent = 0;
+    c.phase = WRITING;
+    answered = true;
+    return true;
+}
+
+void HttpServer::send(int code, const char *contentType, const char *body, size_t length)
+{
+    if (length == SIZE_MAX)
+        length = strlen(body);
+    if (!beginResponse(code, contentType, code == 304 ? SIZE_MAX : length, false))
+        return;
+    Connection &c = *current;
+    if (head || code == 304)
+        return;
+    if (c.outLen + length > sizeof(c.out))
+    {
+        // Only reachable with a handler bug; fail loudly rather than truncate.
+        answered = false;
+        extraLen = 0;
+        c.keepAlive = false;
+        send(500, "text/plain", "response too large");
+        return;
+    }
+    memcpy(c.out + c.outLen, body, length);
+    c.outLen += length;
+}
+
+void HttpServer::send_P(int code, const char *contentType, PGM_P body, size_t length)
+{
+    if (!beginResponse(code, contentType, length, false) || head)
+        return;
+    current->source = BODY_FLASH;
+    current->flash = body;
+    current->flashLeft = length;
+}
+
+void HttpServer::sendStream(int code, const char *contentType, HttpProducer producer, uint32_t arg)
+{
+    if (current && http10)
+        current->keepAlive = false; // the end of the body is the close
+    if (!beginResponse(code, contentType, SIZE_MAX, !http10) || head)
+        return;
+    current->source = http10 ? BODY_STREAM_RAW : BODY_STREAM;
+    current->producer = producer;
+    current->stream = {arg, 0, 0};
+}
+
+// Sends a canned error and closes once it is out.
+void HttpServer::reject(Connection &c, int code)
+{
+    counters.rejected++;
+    current = &c;
+    answered = false;
+    head = false;
+    extraLen = 0;
+    c.keepAlive = false;
+    c.headEnd = c.inUsed;
+    send(code, "text/plain", statusText(code));
+    current = nullptr;
+}
+
+#define HTTP_WRITES_PER_PASS 4
+
+void HttpServer::write(Connection &c, uint32_t now)
+{
+    for (int i = 0; i < HTTP_WRITES_PER_PASS; i++)
+    {
+        if (c.outSent == c.outLen)
+        {
+            refill(c);
+            if (c.outSent == c.outLen)
+            {
+                finish(c, now);
+                return;
+            }
+        }
+        size_t room = c.client.availableForWrite();
+        if (!room)
+        {
+            if (!c.client.connected())
+            {
+                close(c);
+                return;
+            }
+            break;
+        }
+        size_t pending = c.outLen - c.outSent;
+        size_t n = pending < room ? pending : room;
+        size_t written = c.client.write((const uint8_t *)c.out + c.outSent, n);
+        c.outSent += written;
+        if (written)
+            c.lastActiveMs = now;
+        if (written < n)
+            break;
+    }
+    if (now - c.lastActiveMs > HTTP_WRITE_TIMEOUT_MS)
+    {
+        counters.timedOut++;
+        close(c);
+    }
+}
+
+#define CHUNK_HEAD 5 // "5b4\r\n"
+
+void HttpServer::refill(Connection &c)
+{
+    c.outLen = c.outSent = 0;
+    if (c.source == BODY_FLASH && c.flashLeft)
+    {
+        size_t n = c.flashLeft < sizeof(c.out) ? c.flashLeft : sizeof(c.out);
+        memcpy_P(c.out, c.flash, n);
+        c.flash += n;
+        c.flashLeft -= n;
+        c.outLen = n;
+    }
+    else if (c.source == BODY_STREAM_RAW && c.producer)
+    {
+        c.outLen = c.producer(c.out, sizeof(c.out), c.stream);
+        if (!c.outLen)
+            c.producer = nullptr;
+    }
+    else if (c.source == BODY_STREAM && c.producer)
+    {
+        size_t n = c.producer(c.out + CHUNK_HEAD, sizeof(c.out) - CHUNK_HEAD - 2, c.stream);
+        if (!n)
+            c.producer = nullptr; // last chunk
+        char size[CHUNK_HEAD + 1];
+        snprintf(size, sizeof(size), "%03x\r\n", unsigned(n));
+        memcpy(c.out, size, CHUNK_HEAD);
+        memcpy(c.out + CHUNK_HEAD + n, "\r\n", 2);
+        c.outLen = CHUNK_HEAD + n + 2;
+    }
+}
+
+// The response is out: close, or start on the next pipelined request.
+void HttpServer::finish(Connection &c, uint32_t now)
+{
+    if (!c.keepAlive)
+    {
+        close(c);
+        return;
+    }
+    uint16_t left = c.inUsed - c.headEnd;
+    memmove(c.in, c.in + c.headEnd, left);
+    c.inUsed = left;
+    c.scanned = c.lineStart = c.headEnd = 0;
+    c.skipping = false;
+    c.source = BODY_NONE;
+    c.producer = nullptr;
+    c.upload = nullptr;
+    c.phase = READING;
+    c.lastActiveMs = c.startedMs = now;
+    scan(c);
+}
+
+void HttpServer::reset(Connection &c)
+{
+    c.phase = FREE;
+    c.source = BODY_NONE;
+    c.producer = nullptr;
+    c.keepAlive = c.skipping = false;
+    c.inUsed = c.scanned = c.lineStart = c.headEnd = 0;
+    c.outLen = c.outSent = 0;
+    c.upload = nullptr;
+}
+
+void HttpServer::close(Connection &c)
+{
+    c.client.stop();
+    c.client = WiFiClient();
+    reset(c);
+}
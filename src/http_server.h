@@ -0,0 +1,212 @@
+#pragma once
+// Event-driven HTTP/1.1 server. handleClient() makes one non-blocking pass
+// over a fixed pool of connections: it accepts, reads what has arrived,
+// answers at most one complete request per connection and writes as much of
+// each response as the socket takes without waiting. A slow or stalled
+// client only holds its own slot, never loop().
+//
+// Connections are kept alive and requests may be pipelined; they are
+// answered in order, and the next one is not read until the previous
+// response has gone out. Each connection owns a request buffer and a
+// response buffer of fixed size:
+//  - headers are dropped while they arrive unless collectHeaders() asked
+//    for them, so a browser's long header block still fits;
+//  - a body too large for the response buffer is either sent from flash
+//    (send_P) or produced a piece at a time (sendStream, chunked encoding).
+// When every slot is taken and another client is waiting, an idle
+// keep-alive connection is closed, and busy ones answer with
+// "Connection: close" once they have had their share of requests.
+//
+// Handlers run inside handleClient() and read the request through the
+// server, much like ESP8266WebServer. Every handler must answer with one
+// send*() call, or hand the socket over with detach().
+//
+// Only routes added with onUpload() take a body (POST or PUT, with a
+// Content-Length). It is handed to the route's sink as it arrives, through
+// the response buffer, so its size is not limited by the request buffer;
+// the route's handler answers once all of it has been taken.
+#include "hal.h"
+
+#define HTTP_MAX_CONNECTIONS 6
+#define HTTP_REQUEST_BUFFER 512
+#define HTTP_RESPONSE_BUFFER 1460 // one TCP segment
+#define HTTP_MAX_ROUTES 12
+#define HTTP_MAX_ARGS 6
+#define HTTP_MAX_HEADER_KEYS 4
+#define HTTP_BUILTIN_HEADERS 3 // Connection, Content-Length, Expect
+#define HTTP_EXTRA_HEADERS 192
+
+#define HTTP_IDLE_TIMEOUT_MS 5000    // keep-alive connection with no request
+#define HTTP_REQUEST_TIMEOUT_MS 2000 // to finish a started request
+#define HTTP_WRITE_TIMEOUT_MS 5000   // without the peer taking any data
+#define HTTP_EVICT_IDLE_MS 10        // idle long enough to close for a waiting client
+#define HTTP_FAIR_SHARE 16           // requests before yielding to a waiting client
+
+// Position of a streamed response. arg is set by the handler; the producer
+// owns the rest and starts with both at 0.
+struct HttpStream
+{
+    uint32_t arg;
+    uint32_t cursor;
+    uint32_t count;
+};
+
+// Writes the next piece of a streamed body, at most size bytes, and returns
+// its length; 0 ends the body. A piece must make progress whenever size is
+// at least HTTP_RESPONSE_BUFFER - 8.
+typedef size_t (*HttpProducer)(char *out, size_t size, HttpStream &stream);
+typedef void (*HttpHandler)();
+// Takes the next length bytes of a request body of total bytes, offset
+// bytes in. Called first with no data, so the size can be refused before
+// anything arrives. Returns 0 to go on, or the HTTP status to refuse with;
+// the connection is closed after the refusal.
+typedef int (*HttpBodySink)(const uint8_t *data, size_t length, uint32_t offset, uint32_t total);
+
+struct HttpServerStats
+{
+    uint32_t accepted;
+    uint32_t requests;
+    uint32_t evicted;  // idle connections closed for a waiting client
+    uint32_t timedOut;
+    uint32_t rejected; // malformed or oversized requests
+};
+
+class HttpServer
+{
+public:
+    explicit HttpServer(uint16_t port) : listener(port) {}
+
+    void begin();
+    void handleClient();
+
+    void on(const char *uri, HttpHandler handler);
+    // done() runs once the body is in; it sees uri(), not the query or headers.
+    void onUpload(const char *uri, HttpBodySink sink, HttpHandler done);
+    void onNotFound(HttpHandler handler) { notFound = handler; }
+    // Runs for every well-formed request before its handler, or before an
+    // upload's body is read, with uri() and the arguments set.
+    void onRequest(HttpHandler observer) { requestObserver = observer; }
+    bool isUpload() const { return upload; }
+    void collectHeaders(const char *const keys[], size_t count);
+
+    // The request being handled. Strings stay valid until the handler returns.
+    const char *uri() const { return requestUri; }
+    bool isHead() const { return head; }
+    int args() const { return argCount; }
+    const char *argName(int i) const { return i < argCount ? argNames[i] : ""; }
+    const char *arg(int i) const { return i < argCount ? argValues[i] : ""; }
+    const char *arg(const char *name) const;
+    bool hasArg(const char *name) const;
+    // Value of a collected header, "" when absent.
+    const char *header(const char *name) const;
+
+    void sendHeader(const char *name, const char *value);
+    // The body is copied; it must fit in the response buffer with the headers.
+    void send(int code, const char *contentType = "text/plain", const char *body = "", size_t length = SIZE_MAX);
+    // The body stays where it is (flash) and is copied out as the socket drains.
+    void send_P(int code, const char *contentType, PGM_P body, size_t length);
+    void sendStream(int code, const char *contentType, HttpProducer producer, uint32_t arg = 0);
+
+    // The request's connection, and handing it over: the server forgets the
+    // socket without closing it.
+    WiFiClient client();
+    void detach();
+
+    int openConnections() const;
+    // No connection open and none waiting: handleClient() has nothing to do.
+    bool idle();
+    const HttpServerStats &stats() const { return counters; }
+
+private:
+    enum Phase : uint8_t
+    {
+        FREE,
+        READING,
+        RECEIVING, // a request body, for an upload route
+        WRITING
+    };
+    enum BodySource : uint8_t
+    {
+        BODY_NONE,
+        BODY_FLASH,
+        BODY_STREAM,
+        BODY_STREAM_RAW // HTTP/1.0: no chunked encoding, close ends the body
+    };
+
+    struct Route
+    {
+        const char *uri;
+        HttpHandler handler;
+        HttpBodySink sink; // set for upload routes
+    };
+
+    struct Connection
+    {
+        WiFiClient client;
+        Phase phase = FREE;
+        BodySource source = BODY_NONE;
+        bool keepAlive = false;
+        bool skipping = false; // dropping the rest of an uncollected header line
+        uint16_t inUsed = 0;
+        uint16_t scanned = 0;
+        uint16_t lineStart = 0;
+        uint16_t headEnd = 0; // end of a complete request head, 0 while reading
+        uint16_t outLen = 0;
+        uint16_t outSent = 0;
+        uint16_t served = 0;
+        uint32_t lastActiveMs = 0;
+        uint32_t startedMs = 0; // first byte of the request being read
+        PGM_P flash = nullptr;
+        uint32_t flashLeft = 0;
+        HttpProducer producer = nullptr;
+        HttpStream stream = {};
+        const Route *upload = nullptr;
+        uint16_t uriAt = 0;
+        uint32_t bodyOffset = 0;
+        uint32_t bodyTotal = 0;
+        char in[HTTP_REQUEST_BUFFER];
+        char out[HTTP_RESPONSE_BUFFER];
+    };
+
+    void accept(uint32_t now);
+    void read(Connection &c, uint32_t now);
+    bool scan(Connection &c);
+    bool keepHeader(const char *line, size_t length) const;
+    void dispatch(Connection &c);
+    void beginBody(Connection &c, const Route &route);
+    void receive(Connection &c, uint32_t now);
+    bool consume(Connection &c, const char *data, size_t length);
+    void write(Connection &c, uint32_t now);
+    void refill(Connection &c);
+    void finish(Connection &c, uint32_t now);
+    void reject(Connection &c, int code);
+    bool beginResponse(int code, const char *contentType, size_t length, bool chunked);
+    void reset(Connection &c);
+    void close(Connection &c);
+
+    WiFiServer listener;
+    Connection connections[HTTP_MAX_CONNECTIONS];
+    Route routes[HTTP_MAX_ROUTES];
+    int routeCount = 0;
+    HttpHandler notFound = nullptr;
+    HttpHandler requestObserver = nullptr;
+    const char *headerKeys[HTTP_MAX_HEADER_KEYS + HTTP_BUILTIN_HEADERS] = {"Connection", "Content-Length", "Expect"};
+    int headerKeyCount = HTTP_BUILTIN_HEADERS;
+    HttpServerStats counters = {};
+
+    // The request being handled.
+    Connection *current = nullptr;
+    bool answered = false;
+    bool head = false;
+    bool upload = false;
+    bool http10 = false;
+    const char *requestUri = "";
+    const char *argNames[HTTP_MAX_ARGS];
+    const char *argValues[HTTP_MAX_ARGS];
+    int argCount = 0;
+    const char *headerNames[HTTP_MAX_HEADER_KEYS + HTTP_BUILTIN_HEADERS];
+    const char *headerValues[HTTP_MAX_HEADER_KEYS + HTTP_BUILTIN_HEADERS];
+    int headerCount = 0;
+    char extraHeaders[HTTP_EXTRA_HEADERS];
+    size_t extraLen = 0;
+};
@@ -0,0 +1,183 @@
+#pragma once
+// Writes a flat JSON object into a caller-provided buffer without touching
+// the heap. Once the buffer is full the writer stops and ok() turns false, so
+// a truncated document is never sent.
+#include <limits.h>
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+class JsonWriter
+{
+public:
+    JsonWriter(char *buf, size_t size) : out(buf), cap(size), len(0), failed(size == 0)
+    {
+        if (size)
+            out[0] = '\0';
+    }
+
+    void beginObject()
+    {
+        raw('{');
+        first = true;
+    }
+
+    void endObject()
+    {
+        raw('}');
+        terminate();
+    }
+
+    void field(const char *key, const char *value)
+    {
+        name(key);
+        raw('"');
+        escaped(value);
+        raw('"');
+    }
+
+    void field(const char *key, long value)
+    {
+        name(key);
+        integer(value);
+    }
+
+    // Fixed-point text such as "12.50", quoted like String(float) output.
+    void fieldFixed(const char *key, float value, uint8_t decimals = 2)
+    {
+        name(key);
+        raw('"');
+        fixed(value, decimals);
+        raw('"');
+    }
+
+    bool ok() const { return !failed; }
+    size_t length() const { return len; }
+    const char *c_str() const { return out; }
+
+private:
+    void name(const char *key)
+    {
+        if (!first)
+            raw(',');
+        first = false;
+        raw('"');
+        escaped(key);
+        raw('"');
+        raw(':');
+    }
+
+    void raw(char c)
+    {
+        if (failed || len + 1 >= cap)
+        {
+            failed = true;
+            return;
+        }
+        out[len++] = c;
+    }
+
+    void raw(const char *s, size_t n)
+    {
+        if (failed || len + n >= cap)
+        {
+            failed = true;
+            return;
+        }
+        memcpy(out + len, s, n);
+        len += n;
+    }
+
+    void escaped(const char *s)
+    {
+        static const char hex[] = "0123456789abcdef";
+        while (*s)
+        {
+            // Copy the run that needs no escaping in one go; UTF-8 passes through.
+            const char *run = s;
+            while (uint8_t(*s) >= 0x20 && *s != '"' && *s != '\\')
+                s++;
+            if (s > run)
+                raw(run, s - run);
+            if (!*s)
+                break;
+
+            uint8_t c = uint8_t(*s++);
+            if (c == '"' || c == '\\')
+            {
+                char e[2] = {'\\', char(c)};
+                raw(e, 2);
+            }
+            else if (c == '\n')
+                raw("\\n", 2);
+            else if (c == '\r')
+                raw("\\r", 2);
+            else if (c == '\t')
+                raw("\\t", 2);
+            else
+            {
+                char u[6] = {'\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xf]};
+                raw(u, sizeof(u));
+            }
+        }
+    }
+
+    void integer(long value)
+    {
+        char digits[3 * sizeof(long) + 1];
+        int n = 0;
+        unsigned long v = value < 0 ? 0UL - (unsigned long)value : (unsigned long)value;
+        do
+        {
+            digits[n++] = char('0' + v % 10);
+            v /= 10;
+        } while (v);
+        if (value < 0)
+            raw('-');
+        while (n)
+            raw(digits[--n]);
+    }
+
+    void fixed(float value, uint8_t decimals)
+    {
+        if (decimals > 6)
+            decimals = 6;
+        long scale = 1;
+        for (uint8_t i = 0; i < decimals; i++)
+            scale *= 10;
+        bool negative = value < 0;
+        float magnitude = (negative ? -value : value) * scale + 0.5f;
+        // What Print::printFloat writes where a long can't hold the digits
+        if (!(magnitude < float(LONG_MAX)))
+        {
+            raw(isnan(value) ? "nan" : isinf(value) ? "inf" : "ovf", 3);
+            return;
+        }
+        long scaled = long(magnitude);
+        if (negative && scaled)
+            raw('-');
+        integer(scaled / scale);
+        if (!decimals)
+            return;
+        raw('.');
+        long frac = scaled % scale;
+        for (long div = scale / 10; div; div /= 10)
+        {
+            raw(char('0' + frac / div));
+            frac %= div;
+        }
+    }
+
+    void terminate()
+    {
+        if (cap)
+            out[len < cap ? len : cap - 1] = '\0';
+    }
+
+    char *out;
+    size_t cap;
+    size_t len;
+    bool failed;
+    bool first = true;
+};
@@ -0,0 +1,44 @@
+#include "metrics.h"
+
+const char *const stageNames[STAGE_COUNT] = {"handle_client", "data_json",  "home_page", "prediction",
+                                             "serial",        "push_state", "loop"};
+CycleHistogram stageCycles[STAGE_COUNT];
+
+size_t writeStageMetrics(char *out, size_t size, int stage, int &line)
+{
+    const CycleHistogram &h = stageCycles[stage];
+    const char *name = stageNames[stage];
+    float cyclesPerSecond = ESP.getCpuFreqMHz() * 1e6f;
+    const char *header = stage == 0 ? "# HELP rail_stage_seconds Time spent in each loop() stage.\n"
+                                      "# TYPE rail_stage_seconds histogram\n"
+                                    : "";
+    uint32_t cumulative = 0;
+    for (int i = 0; i < line && i < METRIC_BUCKETS - 1; i++)
+        cumulative += h.bucket(i);
+
+    size_t len = 0;
+    for (; line < STAGE_METRIC_LINES; line++)
+    {
+        char *at = out + len;
+        size_t room = size - len;
+        int n;
+        if (line < METRIC_BUCKETS - 1)
+            n = snprintf(at, room, "%srail_stage_seconds_bucket{stage=\"%s\",le=\"%.4g\"} %lu\n", line ? "" : header,
+                         name, CycleHistogram::bound(line) / cyclesPerSecond,
+                         (unsigned long)(cumulative + h.bucket(line)));
+        else if (line == METRIC_BUCKETS - 1)
+            n = snprintf(at, room, "rail_stage_seconds_bucket{stage=\"%s\",le=\"+Inf\"} %lu\n", name,
+                         (unsigned long)h.count());
+        else if (line == METRIC_BUCKETS)
+            n = snprintf(at, room, "rail_stage_seconds_sum{stage=\"%s\"} %.9g\n", name,
+                         double(h.cycles()) / cyclesPerSecond);
+        else
+            n = snprintf(at, room, "rail_stage_seconds_count{stage=\"%s\"} %lu\n", name, (unsigned long)h.count());
+        if (n < 0 || size_t(n) >= room)
+            break;
+        if (line < METRIC_BUCKETS - 1)
+            cumulative += h.bucket(line);
+        len += n;
+    }
+    return len;
+}
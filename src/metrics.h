@@ -0,0 +1,89 @@
+#pragma once
+// Hot-path timing for loop(). Each stage is timed with the CPU cycle counter
+// (two register reads on the ESP8266) into a fixed set of power-of-two
+// buckets, so recording is a subtract, a count-leading-zeros and two adds,
+// with no allocation and no floating point. Seconds only appear when /metrics
+// is rendered.
+//
+// Stages nest: handle_client includes data_json and home_page when a request
+// for them is served, prediction includes serial, and loop includes
+// everything.
+#include "hal.h"
+
+// Bucket i holds samples of at most (64 << i) cycles, 0.8 us at 80 MHz;
+// the last bucket is +Inf.
+#define METRIC_BUCKETS 20
+#define METRIC_FIRST_BOUND 64
+
+class CycleHistogram
+{
+public:
+    void add(uint32_t cycles)
+    {
+        int bucket = cycles <= METRIC_FIRST_BOUND ? 0 : 32 - __builtin_clz(cycles - 1) - 6;
+        counts[bucket < METRIC_BUCKETS ? bucket : METRIC_BUCKETS - 1]++;
+        total++;
+        sum += cycles;
+    }
+
+    uint32_t count() const { return total; }
+    uint64_t cycles() const { return sum; }
+    uint32_t bucket(int i) const { return counts[i]; }
+    static uint32_t bound(int i) { return uint32_t(METRIC_FIRST_BOUND) << i; }
+
+    // Upper bound, in cycles, of the bucket holding quantile q; 0 for the
+    // overflow bucket.
+    uint32_t quantile(float q) const
+    {
+        uint32_t rank = uint32_t(q * total), seen = 0;
+        for (int i = 0; i < METRIC_BUCKETS - 1; i++)
+        {
+            seen += counts[i];
+            if (seen > rank)
+                return bound(i);
+        }
+        return 0;
+    }
+
+private:
+    uint32_t counts[METRIC_BUCKETS] = {};
+    uint32_t total = 0;
+    uint64_t sum = 0;
+};
+
+enum Stage
+{
+    S_HANDLE_CLIENT,
+    S_DATA_JSON,
+    S_HOME_PAGE,
+    S_PREDICTION,
+    S_SERIAL,
+    S_PUSH_STATE,
+    S_LOOP,
+    STAGE_COUNT
+};
+
+extern const char *const stageNames[STAGE_COUNT];
+extern CycleHistogram stageCycles[STAGE_COUNT];
+
+// Times the enclosing scope into a stage.
+class StageTimer
+{
+public:
+    explicit StageTimer(Stage stage) : stage(stage), start(ESP.getCycleCount()) {}
+    ~StageTimer() { stageCycles[stage].add(ESP.getCycleCount() - start); }
+
+private:
+    Stage stage;
+    uint32_t start;
+};
+
+// Bucket lines (the last is +Inf), then _sum and _count.
+#define STAGE_METRIC_LINES (METRIC_BUCKETS + 2)
+
+// Prometheus text exposition of one stage's histogram, preceded by the
+// HELP/TYPE lines for stage 0. Writes whole lines from line onwards while
+// they fit in out, advances line past them and returns the length written;
+// the stage is complete when line reaches STAGE_METRIC_LINES. About 1.6 KB
+// per stage, no line over 100 bytes.
+size_t writeStageMetrics(char *out, size_t size, int stage, int &line);
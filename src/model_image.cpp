@@ -0,0 +1,89 @@
+#include "model_image.h"
+
+static const char *const errorNames[MODEL_ERROR_COUNT] = {"ok",      "truncated", "bad magic", "bad version", "wrong shape",
+                                                          "bad crc", "bad node",  "too large", "busy"};
+
+const char *modelErrorName(uint8_t error) { return error < MODEL_ERROR_COUNT ? errorNames[error] : "unknown"; }
+
+// Reflected CRC-32 (zlib's), a nibble at a time: a 64-byte table instead
+// of 1 KB of RAM.
+uint32_t crc32(const void *data, size_t length, uint32_t crc)
+{
+    static const uint32_t table[16] = {
+        0x00000000, 0x1db71064, 0x3b6e20c8, 0x26d930ac, 0x76dc4190, 0x6b6b51f4, 0x4db26158, 0x5005713c,
+        0xedb88320, 0xf00f9344, 0xd6d6a3e8, 0xcb61b38c, 0x9b64c2b0, 0x86d3d2d4, 0xa00ae278, 0xbdbdf21c,
+    };
+    const uint8_t *p = (const uint8_t *)data;
+    crc = ~crc;
+    for (size_t i = 0; i < length; i++)
+    {
+        crc = table[(crc ^ p[i]) & 0xf] ^ (crc >> 4);
+        crc = table[(crc ^ (p[i] >> 4)) & 0xf] ^ (crc >> 4);
+    }
+    return ~crc;
+}
+
+ModelLayout modelLayout(const ModelHeader &h)
+{
+    ModelLayout l;
+    l.threshold = h.headerSize;
+    l.roots = l.threshold + h.nodes * sizeof(float);
+    l.weights = l.roots + h.trees * sizeof(uint16_t);
+    l.children = l.weights + h.trees * sizeof(uint16_t);
+    l.proba = l.children + 2 * h.nodes * sizeof(uint16_t);
+    l.feature = l.proba + uint32_t(h.leafRows) * h.classes * sizeof(uint16_t);
+    l.end = l.feature + h.nodes;
+    return l;
+}
+
+// A child or root reference: a leaf row, or a split node after `after`.
+static bool validRef(uint16_t ref, int32_t after, const ModelHeader &h)
+{
+    if (ref & FOREST_LEAF)
+        return (ref & ~FOREST_LEAF) < h.leafRows;
+    return int32_t(ref) > after && ref < h.nodes;
+}
+
+ModelError checkModelImage(const uint8_t *image, size_t size, uint8_t features, uint8_t classes)
+{
+    if (size < sizeof(ModelHeader))
+        return MODEL_TRUNCATED;
+    const ModelHeader &h = *(const ModelHeader *)image;
+    if (h.magic != MODEL_MAGIC)
+        return MODEL_BAD_MAGIC;
+    if (h.version != MODEL_VERSION || h.headerSize < sizeof(ModelHeader) || h.headerSize % 4)
+        return MODEL_BAD_VERSION;
+    if (h.size > size || h.size % 4)
+        return MODEL_TRUNCATED;
+    if (h.features != features || h.classes != classes)
+        return MODEL_WRONG_SHAPE;
+    ModelLayout l = modelLayout(h);
+    if (l.end > h.size)
+        return MODEL_TRUNCATED;
+    uint32_t crc = crc32(image, offsetof(ModelHeader, crc));
+    if (crc32(image + sizeof(ModelHeader), h.size - sizeof(ModelHeader), crc) != h.crc)
+        return MODEL_BAD_CRC;
+
+    if (!h.trees || !h.weightSum || h.nodes >= FOREST_LEAF || h.leafRows >= FOREST_LEAF)
+        return MODEL_BAD_NODE;
+    const uint16_t *roots = (const uint16_t *)(image + l.roots);
+    const uint16_t *weights = (const uint16_t *)(image + l.weights);
+    const uint16_t *children = (const uint16_t *)(image + l.children);
+    const uint8_t *feature = image + l.feature;
+    uint32_t weightSum = 0;
+    for (uint16_t t = 0; t < h.trees; t++)
+    {
+        if (!validRef(roots[t], -1, h))
+            return MODEL_BAD_NODE;
+        weightSum += weights[t];
+    }
+    // The sums in Forest stay within 32 bits because weightSum is 16.
+    if (weightSum != h.weightSum)
+        return MODEL_BAD_NODE;
+    for (uint16_t n = 0; n < h.nodes; n++)
+    {
+        if (feature[n] >= features || !validRef(children[2 * n], n, h) || !validRef(children[2 * n + 1], n, h))
+            return MODEL_BAD_NODE;
+    }
+    return MODEL_OK;
+}
@@ -0,0 +1,103 @@
+#pragma once
+// Binary model image: the forest tables of src/forest.h in one versioned,
+// checksummed block that can be loaded at run time. export_forest.py writes
+// it next to the generated header.
+//
+// Little-endian. A 32-byte header, then the sections back to back, widest
+// first so every one is naturally aligned when the image starts on a 4-byte
+// boundary:
+//
+//   off size  field
+//    0   4    magic "RFMD"
+//    4   2    version (MODEL_VERSION)
+//    6   2    header size (32)
+//    8   1    features
+//    9   1    classes
+//   10   2    trees          distinct trees stored
+//   12   2    weight sum     trees of the original forest
+//   14   2    nodes          split nodes
+//   16   2    leaf rows
+//   18   2    reserved, 0
+//   20   4    size           of the whole image, a multiple of 4
+//   24   4    model id       chosen by the exporter, reported back
+//   28   4    crc            CRC-32 of every other byte of the image
+//   32        float    threshold[nodes]
+//             uint16_t roots[trees], weights[trees]
+//             uint16_t children[2 * nodes], proba[leaf rows * classes]
+//             uint8_t  feature[nodes], zero padding to size
+//
+// Fields are only ever appended to the header; the sections start at its
+// size, which stays a multiple of 4. Within the version a reader skips
+// fields it does not know.
+//
+// The sections are the Forest tables as they are, so a checked image is
+// evaluated where it lies. checkModelImage() also bounds every reference
+// and requires a split node's children to come after it (the exporter's
+// breadth-first order), so no image, however corrupt, can make a walk leave
+// the tables or loop.
+#include <stddef.h>
+#include <stdint.h>
+
+#include "forest.h"
+
+#define MODEL_MAGIC 0x444d4652 // "RFMD"
+#define MODEL_VERSION 1
+
+struct ModelHeader
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t headerSize;
+    uint8_t features;
+    uint8_t classes;
+    uint16_t trees;
+    uint16_t weightSum;
+    uint16_t nodes;
+    uint16_t leafRows;
+    uint16_t reserved;
+    uint32_t size;
+    uint32_t modelId;
+    uint32_t crc;
+};
+static_assert(sizeof(ModelHeader) == 32, "the header is part of the format");
+
+enum ModelError : uint8_t
+{
+    MODEL_OK,
+    MODEL_TRUNCATED,
+    MODEL_BAD_MAGIC,
+    MODEL_BAD_VERSION,
+    MODEL_WRONG_SHAPE, // features or classes differ from the firmware's
+    MODEL_BAD_CRC,
+    MODEL_BAD_NODE,
+    MODEL_TOO_LARGE,
+    MODEL_BUSY, // the store is still taking the previous image
+    MODEL_ERROR_COUNT
+};
+
+const char *modelErrorName(uint8_t error);
+
+uint32_t crc32(const void *data, size_t length, uint32_t crc = 0);
+
+// Where each section starts, from the counts in the header.
+struct ModelLayout
+{
+    uint32_t threshold, roots, weights, children, proba, feature, end;
+};
+ModelLayout modelLayout(const ModelHeader &h);
+
+// Validates an image of size bytes for a firmware that feeds it features
+// inputs and reads classes outputs.
+ModelError checkModelImage(const uint8_t *image, size_t size, uint8_t features, uint8_t classes);
+
+// A forest over a checked image, evaluated in place; image must outlive it.
+template <int FEATURES, int CLASSES>
+Forest<FEATURES, CLASSES> forestFromImage(const uint8_t *image)
+{
+    const ModelHeader &h = *(const ModelHeader *)image;
+    ModelLayout l = modelLayout(h);
+    return Forest<FEATURES, CLASSES>(h.trees, h.weightSum, (const uint16_t *)(image + l.roots),
+                                     (const uint16_t *)(image + l.weights), image + l.feature,
+                                     (const float *)(image + l.threshold), (const uint16_t *)(image + l.children),
+                                     (const uint16_t *)(image + l.proba));
+}
@@ -0,0 +1,160 @@
+#include "model_store.h"
+
+#define SLOT_MAGIC 0x544c5352 // "RSLT"
+
+static const char *const sourceNames[] = {"builtin", "flash", "upload"};
+
+const char *modelSourceName(uint8_t source) { return source <= MODEL_UPLOAD ? sourceNames[source] : "unknown"; }
+
+static uint32_t trailerCheck(uint32_t generation, uint32_t size)
+{
+    return (SLOT_MAGIC ^ generation * 2654435761u ^ size * 40503u) + 1;
+}
+
+bool ModelStore::readTrailer(int slot, Trailer &t) const
+{
+    return ESP.flashRead(slotAddress(slot) + FLASH_SECTOR_SIZE - sizeof(Trailer), (uint32_t *)&t, sizeof(t)) &&
+           t.magic == SLOT_MAGIC && t.check == trailerCheck(t.generation, t.size) && t.size <= MODEL_IMAGE_MAX &&
+           t.size % 4 == 0;
+}
+
+bool ModelStore::loadSlot(int slot, uint32_t size)
+{
+    uint32_t *buffer = buffers[spare()];
+    return ESP.flashRead(slotAddress(slot), buffer, size) &&
+           checkModelImage((const uint8_t *)buffer, size, features, classes) == MODEL_OK;
+}
+
+bool ModelStore::begin()
+{
+    Trailer t[MODEL_SLOTS];
+    bool valid[MODEL_SLOTS];
+    for (int slot = 0; slot < MODEL_SLOTS; slot++)
+        valid[slot] = readTrailer(slot, t[slot]);
+    // Newest first; an older slot is the fallback if the newest is corrupt.
+    int order[2] = {0, 1};
+    if (valid[1] && (!valid[0] || int32_t(t[1].generation - t[0].generation) > 0))
+        order[0] = 1, order[1] = 0;
+    for (int slot : order)
+    {
+        if (!valid[slot])
+            continue;
+        if (!loadSlot(slot, t[slot].size))
+        {
+            rejectCount++;
+            continue;
+        }
+        savedSlot = slot;
+        staged = true;
+        stagedSource = MODEL_FLASH;
+        stagedGeneration = t[slot].generation;
+        return true;
+    }
+    return false;
+}
+
+ModelError ModelStore::fail(ModelError e)
+{
+    rejectCount++;
+    error = e;
+    uploadSize = uploaded = 0;
+    return e;
+}
+
+ModelError ModelStore::beginUpload(uint32_t size)
+{
+    if (busy())
+        return MODEL_BUSY;
+    if (size > MODEL_IMAGE_MAX)
+        return fail(MODEL_TOO_LARGE);
+    if (size < sizeof(ModelHeader))
+        return fail(MODEL_TRUNCATED);
+    uploadSize = size;
+    uploaded = 0;
+    return MODEL_OK;
+}
+
+ModelError ModelStore::writeUpload(const uint8_t *data, size_t length, uint32_t offset)
+{
+    if (busy())
+        return MODEL_BUSY;
+    if (!uploadSize || offset != uploaded || length > uploadSize - uploaded)
+        return fail(MODEL_TRUNCATED);
+    memcpy((uint8_t *)buffers[spare()] + offset, data, length);
+    uploaded += length;
+    return MODEL_OK;
+}
+
+ModelError ModelStore::endUpload()
+{
+    if (busy())
+        return MODEL_BUSY;
+    if (!uploadSize || uploaded != uploadSize)
+        return fail(MODEL_TRUNCATED);
+    ModelError e = checkModelImage((const uint8_t *)buffers[spare()], uploadSize, features, classes);
+    if (e != MODEL_OK)
+        return fail(e);
+
+    uint32_t newest = activeGeneration;
+    Trailer t;
+    if (savedSlot >= 0 && readTrailer(savedSlot, t) && int32_t(t.generation - newest) > 0)
+        newest = t.generation;
+    staged = true;
+    stagedSource = MODEL_UPLOAD;
+    stagedGeneration = newest + 1;
+
+    saving = SAVE_ERASE;
+    saveSlot = savedSlot == 0 ? 1 : 0;
+    saveBuffer = spare();
+    saveOffset = 0;
+    saveSize = ((const ModelHeader *)buffers[saveBuffer])->size;
+    saveGeneration = stagedGeneration;
+    uploadSize = uploaded = 0;
+    error = MODEL_OK;
+    return MODEL_OK;
+}
+
+bool ModelStore::swap()
+{
+    if (!staged)
+        return false;
+    activeBuffer = spare();
+    activeSource = stagedSource;
+    activeGeneration = stagedGeneration;
+    staged = false;
+    swapCount++;
+    return true;
+}
+
+void ModelStore::service()
+{
+    switch (saving)
+    {
+    case SAVE_IDLE:
+        return;
+    case SAVE_ERASE:
+        saving = ESP.flashEraseSector(slotAddress(saveSlot) / FLASH_SECTOR_SIZE) ? SAVE_WRITE : SAVE_IDLE;
+        return;
+    case SAVE_WRITE:
+    {
+        uint32_t n = saveSize - saveOffset < MODEL_SAVE_CHUNK ? saveSize - saveOffset : MODEL_SAVE_CHUNK;
+        if (!ESP.flashWrite(slotAddress(saveSlot) + saveOffset, buffers[saveBuffer] + saveOffset / 4, n))
+        {
+            saving = SAVE_IDLE;
+            return;
+        }
+        saveOffset += n;
+        if (saveOffset == saveSize)
+            saving = SAVE_TRAILER;
+        return;
+    }
+    case SAVE_TRAILER:
+    {
+        Trailer t = {SLOT_MAGIC, saveGeneration, saveSize, trailerCheck(saveGeneration, saveSize)};
+        if (ESP.flashWrite(slotAddress(saveSlot) + FLASH_SECTOR_SIZE - sizeof(t), (const uint32_t *)&t, sizeof(t)))
+            savedSlot = saveSlot;
+        saving = SAVE_IDLE;
+        return;
+    }
+    }
+}
@@ -0,0 +1,118 @@
+#pragma once
+// The model images the firmware can switch to at run time, kept in flash
+// across reboots.
+//
+// Two RAM buffers hold images: the active one, which inference reads in
+// place, and a spare that receives the next one, from flash at boot or
+// from an upload. A checked image in the spare is staged; swap(), called
+// between inferences, makes it active by flipping which buffer is which, so
+// an inference always sees one whole model. With no image active the
+// firmware uses the forest compiled into it.
+//
+// Flash has two slots of one sector, written alternately so the last good
+// image survives a power cut part way through saving the next. A slot is
+// the image from the start of the sector and a 16-byte trailer (magic,
+// generation, size, check) in its last bytes, programmed last; begin()
+// takes the valid slot with the highest generation. Saving runs from
+// service(), one step per call like the event log: the sector erase, then
+// MODEL_SAVE_CHUNK bytes at a time.
+//
+// Flash above the first megabyte is not mapped into the address space, so
+// an image is read into its buffer once rather than run from flash.
+#include "hal.h"
+#include "model_image.h"
+
+#define MODEL_IMAGE_MAX 4080 // a slot less its trailer
+#define MODEL_SLOTS 2
+#define MODEL_SAVE_CHUNK 256
+
+enum ModelSource : uint8_t
+{
+    MODEL_BUILTIN,
+    MODEL_FLASH,
+    MODEL_UPLOAD
+};
+
+const char *modelSourceName(uint8_t source);
+
+class ModelStore
+{
+public:
+    // The store owns sectors [base, base + MODEL_SLOTS) of flash; base is a
+    // flash offset aligned to a sector. Images must have the given shape.
+    ModelStore(uint32_t base, uint8_t features, uint8_t classes) : base(base), features(features), classes(classes)
+    {
+    }
+
+    // Stages the newest image saved in flash, if there is one.
+    bool begin();
+
+    // An upload of size bytes into the spare buffer, given in order. Fails
+    // while a staged image waits for swap() or is still being saved.
+    ModelError beginUpload(uint32_t size);
+    ModelError writeUpload(const uint8_t *data, size_t length, uint32_t offset);
+    // Checks the upload, and stages it to be swapped in and saved.
+    ModelError endUpload();
+    bool busy() const { return staged || saving != SAVE_IDLE; }
+
+    // Activates the staged image, if any. Call between inferences.
+    bool swap();
+    void service();
+
+    // The active image, or nullptr for the built-in model.
+    const uint8_t *active() const { return activeBuffer < 0 ? nullptr : (const uint8_t *)buffers[activeBuffer]; }
+    const ModelHeader *header() const { return (const ModelHeader *)active(); }
+    // The image waiting for swap(), or nullptr.
+    const ModelHeader *stagedHeader() const { return staged ? (const ModelHeader *)buffers[spare()] : nullptr; }
+    ModelSource source() const { return activeSource; }
+    uint32_t generation() const { return activeGeneration; }
+    uint32_t swaps() const { return swapCount; }
+    uint32_t rejected() const { return rejectCount; }
+    ModelError lastError() const { return error; }
+
+private:
+    struct Trailer
+    {
+        uint32_t magic;
+        uint32_t generation;
+        uint32_t size;
+        uint32_t check;
+    };
+    enum SaveStep : uint8_t
+    {
+        SAVE_IDLE,
+        SAVE_ERASE,
+        SAVE_WRITE,
+        SAVE_TRAILER
+    };
+
+    uint32_t slotAddress(int slot) const { return base + slot * FLASH_SECTOR_SIZE; }
+    bool readTrailer(int slot, Trailer &t) const;
+    bool loadSlot(int slot, uint32_t size);
+    int spare() const { return activeBuffer == 0 ? 1 : 0; }
+    ModelError fail(ModelError e);
+
+    uint32_t base;
+    uint8_t features;
+    uint8_t classes;
+    uint32_t buffers[2][MODEL_IMAGE_MAX / 4];
+    int8_t activeBuffer = -1;
+    bool staged = false;
+    ModelSource stagedSource = MODEL_BUILTIN;
+    ModelSource activeSource = MODEL_BUILTIN;
+    uint32_t stagedGeneration = 0;
+    uint32_t activeGeneration = 0;
+    uint32_t uploadSize = 0;
+    uint32_t uploaded = 0;
+    uint32_t swapCount = 0;
+    uint32_t rejectCount = 0;
+    ModelError error = MODEL_OK;
+
+    int8_t savedSlot = -1; // slot holding the newest saved image
+    SaveStep saving = SAVE_IDLE;
+    int8_t saveSlot = 0;
+    int8_t saveBuffer = 0;
+    uint32_t saveOffset = 0;
+    uint32_t saveSize = 0;
+    uint32_t saveGeneration = 0;
+};
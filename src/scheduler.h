@@ -0,0 +1,252 @@
+#pragma once
+// Cooperative scheduler for loop(): periodic and one-shot tasks on a timer
+// wheel. Due times are micros() values compared by signed difference, so
+// nothing misbehaves when the clock wraps (every 71 minutes for micros(),
+// 49 days for millis()).
+//
+// The wheel has SCHED_WHEEL_SLOTS slots of 1.024 ms; a task sits in the slot
+// of its due tick, and run() only looks at the slots passed since the last
+// call. A task due further out than one revolution is looked at once per
+// revolution and left in place until it is due. Tasks that are due together
+// run in priority order (lower value first), then by due time.
+//
+// Per task the scheduler keeps how late each run started (jitter), how many
+// runs finished after their deadline (overruns; the deadline defaults to
+// the period) and how many periods were skipped entirely because a run
+// could not start before the next one was due.
+//
+// For an idle loop(), idleUs() says how long nothing needs to run. Tasks
+// that only poll for work can say whether they have any: while they have
+// none they do not shorten the wait, and afterIdle() picks their phase up
+// again instead of counting the periods slept through as skipped.
+#include "hal.h"
+
+#define SCHED_TICK_SHIFT 10
+#define SCHED_WHEEL_SLOTS 32
+
+struct TaskStats
+{
+    uint32_t runs;
+    uint32_t maxLateUs;
+    uint64_t totalLateUs;
+    uint32_t maxRunUs;
+    uint32_t overruns;
+    uint32_t skipped;
+};
+
+template <int MAX_TASKS>
+class Scheduler
+{
+    static_assert(MAX_TASKS < 128, "task links are int8_t");
+
+public:
+    typedef void (*TaskFunction)();
+
+    Scheduler()
+    {
+        for (int i = 0; i < SCHED_WHEEL_SLOTS; i++)
+            slots[i] = -1;
+    }
+
+    // Runs fn every periodMs, first as soon as run() is next called.
+    // Returns the task id, or -1 when every slot is taken.
+    int every(const char *name, uint32_t periodMs, uint8_t priority, TaskFunction fn, uint32_t deadlineMs = 0)
+    {
+        int id = add(name, periodMs * 1000, priority, fn, (deadlineMs ? deadlineMs : periodMs) * 1000);
+        if (id >= 0)
+            arm(id, 0);
+        return id;
+    }
+
+    // A task that runs once each time it is armed.
+    int oneShot(const char *name, uint8_t priority, TaskFunction fn, uint32_t deadlineMs = 1)
+    {
+        return add(name, 0, priority, fn, deadlineMs * 1000);
+    }
+
+    // (Re)schedules a task delayMs from now. Safe to call from handlers and
+    // tasks, not from interrupts.
+    void arm(int id, uint32_t delayMs = 0)
+    {
+        Task &t = tasks[id];
+        if (t.armed)
+            unlink(id);
+        t.due = micros() + delayMs * 1000;
+        link(id);
+    }
+
+    // busy() is asked before an idle wait whether the task has work.
+    void setPoll(int id, bool (*busy)()) { tasks[id].busy = busy; }
+
+    // Time until the next task with work is due, at most maxUs; 0 when one
+    // is due now.
+    uint32_t idleUs(uint32_t maxUs) const
+    {
+        uint32_t now = micros();
+        uint32_t wait = maxUs;
+        for (int i = 0; i < taskCount; i++)
+        {
+            const Task &t = tasks[i];
+            if (!t.armed || (t.busy && !t.busy()))
+                continue;
+            int32_t left = int32_t(t.due - now);
+            if (left <= 0)
+                return 0;
+            if (uint32_t(left) < wait)
+                wait = left;
+        }
+        return wait;
+    }
+
+    // After an idle wait: a polling task that fell due meanwhile is due at
+    // its last release, in phase, with the periods before it not skipped.
+    void afterIdle()
+    {
+        uint32_t now = micros();
+        for (int i = 0; i < taskCount; i++)
+        {
+            Task &t = tasks[i];
+            if (!t.busy || !t.armed || !t.periodUs || int32_t(now - t.due) < int32_t(t.periodUs))
+                continue;
+            unlink(i);
+            t.due += (now - t.due) / t.periodUs * t.periodUs;
+            link(i);
+        }
+    }
+
+    // Runs whatever is due. Call from loop().
+    void run()
+    {
+        uint32_t now = micros();
+        uint32_t nowTick = now >> SCHED_TICK_SHIFT;
+        uint32_t visit = nowTick - lastTick + 1;
+        if (visit > SCHED_WHEEL_SLOTS)
+            visit = SCHED_WHEEL_SLOTS;
+
+        int8_t ready[MAX_TASKS];
+        int count = 0;
+        for (uint32_t k = 0; k < visit; k++)
+        {
+            int8_t *link = &slots[(lastTick + k) & (SCHED_WHEEL_SLOTS - 1)];
+            while (*link >= 0)
+            {
+                Task &t = tasks[*link];
+                if (int32_t(now - t.due) < 0)
+                {
+                    link = &t.next;
+                    continue;
+                }
+                int id = *link;
+                *link = t.next;
+                t.armed = false;
+                // Insertion sort by priority, then due time.
+                int at = count++;
+                while (at > 0 && before(id, ready[at - 1]))
+                {
+                    ready[at] = ready[at - 1];
+                    at--;
+                }
+                ready[at] = id;
+            }
+        }
+        lastTick = nowTick;
+
+        for (int i = 0; i < count; i++)
+            dispatch(ready[i]);
+    }
+
+    int count() const { return taskCount; }
+    const char *name(int id) const { return tasks[id].name; }
+    const TaskStats &stats(int id) const { return tasks[id].stats; }
+
+private:
+    struct Task
+    {
+        const char *name;
+        TaskFunction fn;
+        bool (*busy)();    // set for polling tasks
+        uint32_t periodUs; // 0 for one-shot
+        uint32_t deadlineUs;
+        uint32_t due;
+        uint8_t priority;
+        bool armed;
+        int8_t next;
+        TaskStats stats;
+    };
+
+    int add(const char *name, uint32_t periodUs, uint8_t priority, TaskFunction fn, uint32_t deadlineUs)
+    {
+        if (taskCount == MAX_TASKS)
+            return -1;
+        Task &t = tasks[taskCount];
+        t.name = name;
+        t.fn = fn;
+        t.busy = nullptr;
+        t.periodUs = periodUs;
+        t.deadlineUs = deadlineUs;
+        t.priority = priority;
+        t.armed = false;
+        t.next = -1;
+        t.stats = TaskStats();
+        return taskCount++;
+    }
+
+    bool before(int a, int b) const
+    {
+        if (tasks[a].priority != tasks[b].priority)
+            return tasks[a].priority < tasks[b].priority;
+        return int32_t(tasks[a].due - tasks[b].due) < 0;
+    }
+
+    void link(int id)
+    {
+        Task &t = tasks[id];
+        int8_t &head = slots[(t.due >> SCHED_TICK_SHIFT) & (SCHED_WHEEL_SLOTS - 1)];
+        t.next = head;
+        head = id;
+        t.armed = true;
+    }
+
+    void unlink(int id)
+    {
+        int8_t *link = &slots[(tasks[id].due >> SCHED_TICK_SHIFT) & (SCHED_WHEEL_SLOTS - 1)];
+        while (*link >= 0 && *link != id)
+            link = &tasks[*link].next;
+        if (*link == id)
+            *link = tasks[id].next;
+        tasks[id].armed = false;
+    }
+
+    void dispatch(int id)
+    {
+        Task &t = tasks[id];
+        uint32_t start = micros();
+        uint32_t late = start - t.due;
+        t.fn();
+        uint32_t end = micros();
+
+        TaskStats &s = t.stats;
+        s.runs++;
+        s.totalLateUs += late;
+        if (late > s.maxLateUs)
+            s.maxLateUs = late;
+        if (end - start > s.maxRunUs)
+            s.maxRunUs = end - start;
+        if (int32_t(end - (t.due + t.deadlineUs)) > 0)
+            s.overruns++;
+
+        // The task may have re-armed itself.
+        if (!t.periodUs || t.armed)
+            return;
+        // Keep the phase: the next due time is the first release after now.
+        uint32_t periods = (end - t.due) / t.periodUs + 1;
+        s.skipped += periods - 1;
+        t.due += periods * t.periodUs;
+        link(id);
+    }
+
+    Task tasks[MAX_TASKS];
+    int8_t slots[SCHED_WHEEL_SLOTS];
+    int taskCount = 0;
+    uint32_t lastTick = micros() >> SCHED_TICK_SHIFT;
+};
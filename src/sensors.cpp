@@ -0,0 +1,44 @@
+#include "sensors.h"
+
+SpscRing<SensorEvent, SENSOR_QUEUE_SIZE> sensorEvents;
+std::atomic<uint32_t> safetyStops{0};
+std::atomic<uint8_t> stoppedDrive{0};
+
+// Bit (left | right << 1) is set when that sensor pair is a fault.
+static uint8_t stopMask = 0;
+
+static void IRAM_ATTR onSensorEdge()
+{
+    SensorEvent ev;
+    ev.t_us = micros();
+    ev.left = digitalRead(IRL_PIN);
+    ev.right = digitalRead(IRR_PIN);
+
+    if (stopMask & (1 << (ev.left | ev.right << 1)))
+    {
+        // A second edge of the same stop finds the motor already off.
+        uint8_t drive = (digitalRead(MLP_PIN) ? 1 : 0) | (digitalRead(MLN_PIN) ? 2 : 0);
+        if (drive)
+            stoppedDrive.store(drive, std::memory_order_relaxed);
+        digitalWrite(MLP_PIN, LOW);
+        digitalWrite(MLN_PIN, LOW);
+        safetyStops.store(safetyStops.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    sensorEvents.push(ev);
+    // Ends an idle loop()'s esp_delay() now rather than at its timeout.
+    esp_schedule();
+}
+
+void setUpSensors(int (*classify)(int left, int right))
+{
+    stopMask = 0;
+    for (int pair = 0; pair < 4; pair++)
+        if (classify(pair & 1, pair >> 1) != 0)
+            stopMask |= 1 << pair;
+
+    pinMode(IRL_PIN, INPUT);
+    pinMode(IRR_PIN, INPUT);
+    attachInterrupt(digitalPinToInterrupt(IRL_PIN), onSensorEdge, CHANGE);
+    attachInterrupt(digitalPinToInterrupt(IRR_PIN), onSensorEdge, CHANGE);
+}
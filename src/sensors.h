@@ -0,0 +1,47 @@
+#pragma once
+// Edge-triggered sampling of the IR sensor pair. Every level change on
+// either pin is timestamped in the interrupt handler and queued for loop(),
+// so a crack that passes between two loop() iterations is still seen.
+//
+// The handler is also the emergency stop: when the new pair classifies as a
+// fault it drives both motor pins low before queuing anything, so the stop
+// does not wait for loop(), the web server or Serial. Its worst case is one
+// interrupt entry plus four pin reads and two pin writes -- a few
+// microseconds on the ESP8266. Buzzer and dashboard follow from loop().
+//
+// A misread of a few milliseconds stops the train the same way, and the
+// stop stays latched until the driver acts: the windowed classifier in
+// loop() only decides what is reported. The handler keeps the drive it cut
+// in stoppedDrive so loop() can tell such a glitch from a fault.
+#include <atomic>
+
+#include "hal.h"
+#include "spsc_ring.h"
+
+// Building with -DSENSOR_GLITCH_RESUME=1 has loop() put the drive back when
+// the window calls no fault behind an interrupt stop. That is a safety
+// trade-off: fewer hitches, but the motor restarts on the word of a model
+// that POST /model can replace, so the hardware stop no longer stands on
+// its own.
+#ifndef SENSOR_GLITCH_RESUME
+#define SENSOR_GLITCH_RESUME 0
+#endif
+
+struct SensorEvent
+{
+    uint32_t t_us;
+    uint8_t left;
+    uint8_t right;
+};
+
+#define SENSOR_QUEUE_SIZE 64
+
+extern SpscRing<SensorEvent, SENSOR_QUEUE_SIZE> sensorEvents;
+extern std::atomic<uint32_t> safetyStops;
+// The motor pins before the last interrupt stop, MLP_PIN in bit 0 and
+// MLN_PIN in bit 1; 0 once loop() has dealt with it or nothing was moving.
+extern std::atomic<uint8_t> stoppedDrive;
+
+// classify(left, right) is evaluated here for all four sensor pairs; any
+// non-zero class stops the motor from the interrupt handler.
+void setUpSensors(int (*classify)(int left, int right));
@@ -0,0 +1,48 @@
+#pragma once
+// Fixed-size single-producer/single-consumer queue. The producer may be an
+// interrupt handler and the consumer loop(); neither side ever blocks or
+// allocates. When full, push() drops the new item and counts it.
+#include <atomic>
+#include <stdint.h>
+
+template <typename T, uint32_t N>
+class SpscRing
+{
+    static_assert(N && (N & (N - 1)) == 0, "ring size must be a power of two");
+
+public:
+    // Producer side only.
+    bool push(const T &item)
+    {
+        uint32_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) == N)
+        {
+            dropped_.store(dropped_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return false;
+        }
+        items[head & (N - 1)] = item;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side only.
+    bool pop(T &item)
+    {
+        uint32_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail == head_.load(std::memory_order_acquire))
+            return false;
+        item = items[tail & (N - 1)];
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    uint32_t size() const { return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire); }
+    uint32_t pushed() const { return head_.load(std::memory_order_relaxed); }
+    uint32_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    T items[N];
+    std::atomic<uint32_t> head_{0};
+    std::atomic<uint32_t> tail_{0};
+    std::atomic<uint32_t> dropped_{0};
+};
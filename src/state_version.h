@@ -0,0 +1,36 @@
+#pragma once
+// Change tracking for the dashboard state. Every real mutation of a field
+// bumps a global sequence number and stamps the field with it, so a client
+// that last saw sequence N can be sent only the fields changed after N.
+// The epoch is picked once per boot and tells clients their N is stale.
+#include <stdint.h>
+
+template <int FIELDS>
+class StateVersion
+{
+public:
+    void begin(uint32_t bootEpoch) { bootEpoch_ = bootEpoch & 0x7fffffff; }
+
+    uint32_t epoch() const { return bootEpoch_; }
+    uint32_t seq() const { return current; }
+
+    bool changedSince(int field, uint32_t since) const { return fieldSeq[field] > since; }
+
+    void touch(int field) { fieldSeq[field] = ++current; }
+
+    // Assigns only if the value differs; returns whether it did.
+    template <typename T, typename V>
+    bool update(int field, T &dst, const V &value)
+    {
+        if (dst == value)
+            return false;
+        dst = value;
+        touch(field);
+        return true;
+    }
+
+private:
+    uint32_t bootEpoch_ = 0;
+    uint32_t current = 0;
+    uint32_t fieldSeq[FIELDS] = {};
+};
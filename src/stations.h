@@ -0,0 +1,181 @@
+#pragma once
+// Sensor pairs at many stations along a stretch of track, on one
+// controller. Readings are packed 64 stations to a word, left and right
+// sensors in separate bitsets, and classified together: the pair table
+// (tree_table.h) has four entries, so a class's bitset is the OR of the
+// minterms ~L & ~R, L & ~R, ~L & R, L & R whose entry is that class. That
+// is a dozen word operations for 64 stations instead of 64 predict()
+// calls, and the loop over words vectorizes on the host.
+//
+// Classes come out as two bit planes (bit 0 and bit 1 of the class), so up
+// to four classes; any non-zero class is a fault. A station's class only
+// takes effect once its readings have given it for HOLD_SCANS classify()
+// calls in a row, so a chattering sensor does not count as a stream of
+// faults. Each station keeps its fault onsets and when the current fault
+// began.
+//
+// On the board the stations hang off a chain of 74HC165 shift registers,
+// two inputs per station -- bit 2s is station s's left sensor, 2s + 1 its
+// right -- loaded and clocked out by scan().
+#include <stdint.h>
+#include <string.h>
+
+#include "hal.h"
+
+template <int STATIONS, int HOLD_SCANS = 1>
+class StationArray
+{
+    static_assert(STATIONS > 0, "at least one station");
+    static_assert(HOLD_SCANS > 0, "at least one scan");
+
+public:
+    static const int WORDS = (STATIONS + 63) / 64;
+
+    // table.predict(left | right << 1) gives a pair's class.
+    template <typename Table>
+    void begin(const Table &table, uint8_t loadPin, uint8_t clockPin, uint8_t dataPin)
+    {
+        for (int e = 0; e < 4; e++)
+        {
+            int c = table.predict(uint32_t(e));
+            classLo[e] = c & 1 ? ~uint64_t(0) : 0;
+            classHi[e] = c & 2 ? ~uint64_t(0) : 0;
+        }
+        loadLine = loadPin;
+        clockLine = clockPin;
+        dataLine = dataPin;
+        pinMode(loadLine, OUTPUT);
+        pinMode(clockLine, OUTPUT);
+        pinMode(dataLine, INPUT);
+        digitalWrite(loadLine, HIGH);
+        digitalWrite(clockLine, LOW);
+    }
+
+    // Latches every input at once, then shifts them out one clock each.
+    void scan()
+    {
+        memset(left, 0, sizeof(left));
+        memset(right, 0, sizeof(right));
+        digitalWrite(loadLine, LOW);
+        digitalWrite(loadLine, HIGH);
+        for (int s = 0; s < STATIONS; s++)
+        {
+            uint64_t bit = uint64_t(1) << (s & 63);
+            if (digitalRead(dataLine))
+                left[s >> 6] |= bit;
+            pulse();
+            if (digitalRead(dataLine))
+                right[s >> 6] |= bit;
+            pulse();
+        }
+    }
+
+    void set(int station, bool l, bool r)
+    {
+        uint64_t bit = uint64_t(1) << (station & 63);
+        left[station >> 6] = l ? left[station >> 6] | bit : left[station >> 6] & ~bit;
+        right[station >> 6] = r ? right[station >> 6] | bit : right[station >> 6] & ~bit;
+    }
+
+    // Classifies every station from the last readings; onFault(station,
+    // class) is called for each that went into a fault. Returns whether any
+    // station's class changed.
+    //
+    // The raw classes of the last HOLD_SCANS calls are kept per word; a
+    // station whose raw class differs in any of them keeps the class it had.
+    template <typename OnFault>
+    bool classify(uint32_t nowMs, OnFault onFault)
+    {
+        uint64_t rising[WORDS], changed = 0;
+        for (int w = 0; w < WORDS; w++)
+        {
+            uint64_t l = left[w], r = right[w];
+            uint64_t m0 = ~l & ~r, m1 = l & ~r, m2 = ~l & r, m3 = l & r;
+            uint64_t lo = (m0 & classLo[0]) | (m1 & classLo[1]) | (m2 & classLo[2]) | (m3 & classLo[3]);
+            uint64_t hi = (m0 & classHi[0]) | (m1 & classHi[1]) | (m2 & classHi[2]) | (m3 & classHi[3]);
+            lo &= valid(w);
+            hi &= valid(w);
+            heldLo[slot][w] = lo;
+            heldHi[slot][w] = hi;
+            uint64_t steady = ~uint64_t(0);
+            for (int k = 0; k < HOLD_SCANS; k++)
+                steady &= ~((lo ^ heldLo[k][w]) | (hi ^ heldHi[k][w]));
+            lo = (lo & steady) | (planeLo[w] & ~steady);
+            hi = (hi & steady) | (planeHi[w] & ~steady);
+            uint64_t fault = lo | hi;
+            rising[w] = fault & ~faultBits[w];
+            changed |= (lo ^ planeLo[w]) | (hi ^ planeHi[w]);
+            planeLo[w] = lo;
+            planeHi[w] = hi;
+            faultBits[w] = fault;
+        }
+        slot = slot + 1 < HOLD_SCANS ? slot + 1 : 0;
+        for (int w = 0; w < WORDS; w++)
+            for (uint64_t bits = rising[w]; bits; bits &= bits - 1)
+            {
+                int s = w * 64 + __builtin_ctzll(bits);
+                faultCount[s]++;
+                faultSinceMs[s] = nowMs;
+                onFault(s, classOf(s));
+            }
+        return changed != 0;
+    }
+
+    bool classify(uint32_t nowMs)
+    {
+        return classify(nowMs, [](int, int) {});
+    }
+
+    int classOf(int station) const
+    {
+        return int(planeLo[station >> 6] >> (station & 63) & 1) | int(planeHi[station >> 6] >> (station & 63) & 1) << 1;
+    }
+    bool fault(int station) const { return faultBits[station >> 6] >> (station & 63) & 1; }
+    bool leftOf(int station) const { return left[station >> 6] >> (station & 63) & 1; }
+    bool rightOf(int station) const { return right[station >> 6] >> (station & 63) & 1; }
+    uint32_t faults(int station) const { return faultCount[station]; }
+    // When the current fault began; meaningless while the station is clear.
+    uint32_t faultSince(int station) const { return faultSinceMs[station]; }
+
+    uint32_t inFault() const
+    {
+        uint32_t n = 0;
+        for (int w = 0; w < WORDS; w++)
+            n += __builtin_popcountll(faultBits[w]);
+        return n;
+    }
+
+    // One class digit per station, '0'..'3'; out must hold STATIONS + 1.
+    void writeMap(char *out) const
+    {
+        for (int s = 0; s < STATIONS; s++)
+            out[s] = char('0' + classOf(s));
+        out[STATIONS] = '\0';
+    }
+
+private:
+    static constexpr uint64_t valid(int w)
+    {
+        return w < WORDS - 1 || STATIONS % 64 == 0 ? ~uint64_t(0) : (uint64_t(1) << (STATIONS % 64)) - 1;
+    }
+
+    void pulse()
+    {
+        digitalWrite(clockLine, HIGH);
+        digitalWrite(clockLine, LOW);
+    }
+
+    uint64_t left[WORDS] = {};
+    uint64_t right[WORDS] = {};
+    uint64_t planeLo[WORDS] = {};
+    uint64_t planeHi[WORDS] = {};
+    uint64_t faultBits[WORDS] = {};
+    uint64_t heldLo[HOLD_SCANS][WORDS] = {};
+    uint64_t heldHi[HOLD_SCANS][WORDS] = {};
+    int slot = 0;
+    uint64_t classLo[4] = {};
+    uint64_t classHi[4] = {};
+    uint32_t faultCount[STATIONS] = {};
+    uint32_t faultSinceMs[STATIONS] = {};
+    uint8_t loadLine = 0, clockLine = 0, dataLine = 0;
+};
@@ -0,0 +1,147 @@
+#pragma once
+// Packed binary telemetry served at /data.bin, and the decoder collectors
+// use. The layout is fixed and little-endian, written byte by byte so it is
+// the same on every host:
+//
+//   off size  field
+//    0   2    magic "RT"
+//    2   1    version (TELEMETRY_VERSION)
+//    3   1    length of the whole record in bytes
+//    4   4    epoch          boot epoch, as in the ETag of /data.json
+//    8   4    seq            state sequence number
+//   12   4    uptime_ms
+//   16   1    flags          TELEMETRY_LEFT | _RIGHT | _BUZZER | _FAULT
+//   17   1    prediction     model class, or 4 before the first prediction
+//   18   1    severity       0 unknown, 1 safe, 2 moderate, 3 critical
+//   19   1    motor          TelemetryMotor
+//   20   2    confidence     0.01 % units
+//   22   2    fault_percent  0.01 % units
+//   24   4    safety_stops
+//
+// Versioning: fields are only ever appended. A decoder reads the fields it
+// knows from any record whose version is at least its own minimum and whose
+// length covers them, and skips the rest; length lets it step over a record
+// without understanding it.
+#include <stddef.h>
+#include <stdint.h>
+
+#define TELEMETRY_MAGIC0 'R'
+#define TELEMETRY_MAGIC1 'T'
+#define TELEMETRY_VERSION 1
+#define TELEMETRY_V1_SIZE 28
+
+#define TELEMETRY_LEFT 0x01
+#define TELEMETRY_RIGHT 0x02
+#define TELEMETRY_BUZZER 0x04
+#define TELEMETRY_FAULT 0x08
+
+enum TelemetryMotor : uint8_t
+{
+    MOTOR_STOPPED,
+    MOTOR_FORWARD,
+    MOTOR_BACK,
+    MOTOR_INVALID // both driver inputs high
+};
+
+struct Telemetry
+{
+    uint8_t version;
+    uint32_t epoch;
+    uint32_t seq;
+    uint32_t uptimeMs;
+    uint8_t flags;
+    uint8_t prediction;
+    uint8_t severity;
+    uint8_t motor;
+    uint16_t confidence;   // 0.01 %
+    uint16_t faultPercent; // 0.01 %
+    uint32_t safetyStops;
+};
+
+enum TelemetryStatus
+{
+    TELEMETRY_OK,
+    TELEMETRY_SHORT,       // fewer bytes than the record claims or v1 needs
+    TELEMETRY_BAD_MAGIC,
+    TELEMETRY_BAD_VERSION, // older than anything this decoder reads
+};
+
+// 0..100 % to the wire's 0.01 % units, clamped.
+inline uint16_t telemetryPercent(float percent)
+{
+    if (!(percent > 0))
+        return 0;
+    if (percent >= 100)
+        return 10000;
+    return uint16_t(percent * 100 + 0.5f);
+}
+
+namespace telemetry_detail
+{
+inline void put16(uint8_t *p, uint16_t v)
+{
+    p[0] = uint8_t(v);
+    p[1] = uint8_t(v >> 8);
+}
+
+inline void put32(uint8_t *p, uint32_t v)
+{
+    put16(p, uint16_t(v));
+    put16(p + 2, uint16_t(v >> 16));
+}
+
+inline uint16_t get16(const uint8_t *p) { return uint16_t(p[0] | p[1] << 8); }
+inline uint32_t get32(const uint8_t *p) { return get16(p) | uint32_t(get16(p + 2)) << 16; }
+}
+
+// Writes the current version's record; out must hold TELEMETRY_V1_SIZE
+// bytes. Returns the length.
+inline size_t encodeTelemetry(const Telemetry &t, uint8_t *out)
+{
+    using namespace telemetry_detail;
+    out[0] = TELEMETRY_MAGIC0;
+    out[1] = TELEMETRY_MAGIC1;
+    out[2] = TELEMETRY_VERSION;
+    out[3] = TELEMETRY_V1_SIZE;
+    put32(out + 4, t.epoch);
+    put32(out + 8, t.seq);
+    put32(out + 12, t.uptimeMs);
+    out[16] = t.flags;
+    out[17] = t.prediction;
+    out[18] = t.severity;
+    out[19] = t.motor;
+    put16(out + 20, t.confidence);
+    put16(out + 22, t.faultPercent);
+    put32(out + 24, t.safetyStops);
+    return TELEMETRY_V1_SIZE;
+}
+
+// Reads one record from the start of in. On success consumed, if given, is
+// set to the record's length, which may exceed what this decoder reads.
+inline TelemetryStatus decodeTelemetry(const uint8_t *in, size_t size, Telemetry &t, size_t *consumed = nullptr)
+{
+    using namespace telemetry_detail;
+    if (size < 4)
+        return TELEMETRY_SHORT;
+    if (in[0] != TELEMETRY_MAGIC0 || in[1] != TELEMETRY_MAGIC1)
+        return TELEMETRY_BAD_MAGIC;
+    if (in[2] < 1)
+        return TELEMETRY_BAD_VERSION;
+    if (in[3] < TELEMETRY_V1_SIZE || size < in[3])
+        return TELEMETRY_SHORT;
+
+    t.version = in[2];
+    t.epoch = get32(in + 4);
+    t.seq = get32(in + 8);
+    t.uptimeMs = get32(in + 12);
+    t.flags = in[16];
+    t.prediction = in[17];
+    t.severity = in[18];
+    t.motor = in[19];
+    t.confidence = get16(in + 20);
+    t.faultPercent = get16(in + 22);
+    t.safetyStops = get32(in + 24);
+    if (consumed)
+        *consumed = in[3];
+    return TELEMETRY_OK;
+}
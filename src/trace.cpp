@@ -0,0 +1,220 @@
+#include "trace.h"
+
+#include <string.h>
+
+static const char *const typeNames[TR_TYPE_COUNT] = {"sensor", "resync", "action", "request", "model", "output"};
+
+const char *traceTypeName(uint8_t type) { return type < TR_TYPE_COUNT ? typeNames[type] : "unknown"; }
+
+static size_t putVarint(uint8_t *out, uint32_t v)
+{
+    size_t n = 0;
+    while (v >= 0x80)
+    {
+        out[n++] = uint8_t(v) | 0x80;
+        v >>= 7;
+    }
+    out[n++] = uint8_t(v);
+    return n;
+}
+
+void TraceRecorder::begin(uint32_t nowUs, uint8_t pair, uint8_t outputs, uint8_t prediction, uint32_t modelId)
+{
+    head = {TRACE_MAGIC, TRACE_VERSION, sizeof(TraceHeader), TRACE_BLOCK_SIZE, 0, nowUs, modelId};
+    first = held = seq = 0;
+    recordCount = dropped = 0;
+    isOpen = false;
+    this->pair = pair;
+    lastOutputs = outputs;
+    lastPrediction = prediction;
+    open(nowUs);
+}
+
+const uint8_t *TraceRecorder::block(uint32_t i) const
+{
+    return i < held ? (const uint8_t *)ring[(first + i) % TRACE_BLOCKS] : nullptr;
+}
+
+// A new block with the state as it is now; the oldest goes when all are
+// taken.
+void TraceRecorder::open(uint32_t tUs)
+{
+    if (held == TRACE_BLOCKS)
+    {
+        first = (first + 1) % TRACE_BLOCKS;
+        held--;
+        dropped++;
+    }
+    held++;
+    TraceBlockHeader h = {seq++, tUs, sizeof(TraceBlockHeader), 0, pair, lastOutputs, lastPrediction, 0};
+    memset(current(), 0, TRACE_BLOCK_SIZE);
+    memcpy(current(), &h, sizeof(h));
+    lastUs = tUs;
+    isOpen = true;
+}
+
+void TraceRecorder::close()
+{
+    if (!isOpen)
+        return;
+    isOpen = false;
+    if (blockSink)
+        blockSink(current(), TRACE_BLOCK_SIZE);
+}
+
+void TraceRecorder::flush() { close(); }
+
+void TraceRecorder::record(uint8_t type, uint8_t arg, uint32_t tUs, const uint8_t *payload, size_t length)
+{
+    if (!head.magic)
+        return; // not begun
+    uint8_t buffer[TRACE_RECORD_MAX];
+    TraceBlockHeader *h = (TraceBlockHeader *)current();
+    for (;;)
+    {
+        int32_t delta = int32_t(tUs - lastUs);
+        size_t n = 0;
+        buffer[n++] = uint8_t(type << 4 | (arg & 0xf));
+        n += putVarint(buffer + n, uint32_t(delta) << 1 ^ uint32_t(delta >> 31));
+        if (length)
+            memcpy(buffer + n, payload, length);
+        n += length;
+        if (isOpen && h->used + n <= TRACE_BLOCK_SIZE)
+        {
+            memcpy((uint8_t *)h + h->used, buffer, n);
+            h->used += n;
+            h->records++;
+            break;
+        }
+        close();
+        open(tUs);
+        h = (TraceBlockHeader *)current();
+    }
+    lastUs = tUs;
+    recordCount++;
+    if (type == TR_SENSOR || type == TR_RESYNC)
+        pair = arg & 3;
+}
+
+void TraceRecorder::request(uint32_t tUs, uint8_t method, const char *path)
+{
+    uint8_t payload[2 + TRACE_PATH_MAX];
+    size_t length = strlen(path);
+    if (length > TRACE_PATH_MAX)
+        length = TRACE_PATH_MAX;
+    payload[0] = method;
+    payload[1] = uint8_t(length);
+    memcpy(payload + 2, path, length);
+    record(TR_REQUEST, method, tUs, payload, 2 + length);
+}
+
+void TraceRecorder::model(uint32_t tUs, uint8_t source, uint32_t modelId)
+{
+    uint8_t id[4] = {uint8_t(modelId), uint8_t(modelId >> 8), uint8_t(modelId >> 16), uint8_t(modelId >> 24)};
+    record(TR_MODEL, source, tUs, id, sizeof(id));
+}
+
+void TraceRecorder::outputs(uint32_t tUs, uint8_t outputs, uint8_t prediction)
+{
+    if (outputs == lastOutputs && prediction == lastPrediction)
+        return;
+    lastOutputs = outputs;
+    lastPrediction = prediction;
+    record(TR_OUTPUT, outputs, tUs, &prediction, 1);
+}
+
+bool TraceReader::begin(const uint8_t *data, size_t size)
+{
+    *this = TraceReader();
+    if (size < sizeof(TraceHeader))
+        return false;
+    memcpy(&head, data, sizeof(head));
+    if (head.magic != TRACE_MAGIC || head.version != TRACE_VERSION || head.headerSize < sizeof(TraceHeader) ||
+        head.blockSize < sizeof(TraceBlockHeader))
+        return false;
+    this->data = data;
+    this->size = size;
+    offset = head.headerSize;
+    lastUs = head.startUs;
+    lastUnwrapped = head.startUs;
+    return true;
+}
+
+uint64_t TraceReader::unwrap(uint32_t tUs)
+{
+    lastUnwrapped += int32_t(tUs - lastUs);
+    lastUs = tUs;
+    return lastUnwrapped;
+}
+
+bool TraceReader::nextBlock(TraceBlockHeader &block)
+{
+    while (data && offset + head.blockSize <= size)
+    {
+        const uint8_t *at = data + offset;
+        offset += head.blockSize;
+        memcpy(&block, at, sizeof(block));
+        if (block.used < sizeof(TraceBlockHeader) || block.used > head.blockSize)
+        {
+            badBlocks++;
+            continue;
+        }
+        if (started && block.seq != nextSeq)
+            gapCount++;
+        started = true;
+        nextSeq = block.seq + 1;
+        blockData = at;
+        blockUsed = block.used;
+        blockAt = sizeof(TraceBlockHeader);
+        blockUs = block.baseUs;
+        unwrap(block.baseUs);
+        return true;
+    }
+    blockData = nullptr;
+    return false;
+}
+
+bool TraceReader::next(TraceRecord &record)
+{
+    if (!blockData || blockAt >= blockUsed)
+        return false;
+    const uint8_t *p = blockData + blockAt, *end = blockData + blockUsed;
+    record.type = *p >> 4;
+    record.arg = *p++ & 0xf;
+    uint32_t zigzag = 0;
+    for (int shift = 0; p < end && shift < 35; shift += 7)
+    {
+        zigzag |= uint32_t(*p & 0x7f) << shift;
+        if (!(*p++ & 0x80))
+            break;
+    }
+    int32_t delta = int32_t(zigzag >> 1) ^ -int32_t(zigzag & 1);
+    blockUs += delta;
+    record.t_us = unwrap(blockUs);
+
+    size_t need = record.type == TR_REQUEST ? 2 : record.type == TR_MODEL ? 4 : record.type == TR_OUTPUT ? 1 : 0;
+    if (record.type == TR_REQUEST && p + 2 <= end)
+        need += p[1];
+    // A path longer than the recorder writes is damage too.
+    if (record.type >= TR_TYPE_COUNT || p + need > end || (record.type == TR_REQUEST && p[1] > TRACE_PATH_MAX))
+    {
+        badBlocks++;
+        blockData = nullptr;
+        return false;
+    }
+    record.pathLength = 0;
+    record.path[0] = '\0';
+    if (record.type == TR_REQUEST)
+    {
+        record.method = p[0];
+        record.pathLength = p[1];
+        memcpy(record.path, p + 2, record.pathLength);
+        record.path[record.pathLength] = '\0';
+    }
+    else if (record.type == TR_MODEL)
+        record.modelId = p[0] | p[1] << 8 | p[2] << 16 | uint32_t(p[3]) << 24;
+    else if (record.type == TR_OUTPUT)
+        record.prediction = p[0];
+    blockAt = p + need - blockData;
+    return true;
+}
@@ -0,0 +1,176 @@
+#pragma once
+// Compact binary trace of everything loop() acts on -- sensor edges, button
+// presses, HTTP requests, model uploads -- and of what it drives: the motor
+// and buzzer pins and the prediction. host/replay feeds a trace back through
+// the firmware on the virtual clock and checks that it drives the same
+// outputs.
+//
+// A trace is a TraceHeader and then TRACE_BLOCK_SIZE-byte blocks. A block
+// starts with the sensor pair and outputs as they were when it was opened,
+// so a trace that lost its oldest blocks still replays from the first one
+// it has. Records follow, each:
+//
+//   1 byte    type << 4 | small argument (TraceType)
+//   varint    microseconds since the previous record of the block, zigzag
+//             coded (an edge popped late can predate the last output),
+//             from the block's baseUs for the first
+//   payload   TR_REQUEST: method byte, path length byte, path
+//             TR_MODEL:   model id, 4 bytes little-endian
+//             TR_OUTPUT:  prediction byte
+//
+// On the board the recorder keeps the last TRACE_BLOCKS blocks in RAM,
+// served at /trace.bin; the host build can also pass every block to a sink
+// as it fills and so record a whole run.
+#include <stddef.h>
+#include <stdint.h>
+
+#define TRACE_MAGIC 0x43525452 // "RTRC"
+#define TRACE_VERSION 1
+#define TRACE_BLOCK_SIZE 256
+#define TRACE_BLOCKS 8
+#define TRACE_PATH_MAX 32
+#define TRACE_RECORD_MAX (1 + 5 + 2 + TRACE_PATH_MAX)
+
+enum TraceType : uint8_t
+{
+    TR_SENSOR,  // an edge; arg: pair after it, bit 0 left, bit 1 right
+    TR_RESYNC,  // edges were lost; arg: the pair the pins show
+    TR_ACTION,  // button press; arg: 1 forward, 2 stop, 3 back
+    TR_REQUEST, // arg: TraceMethod
+    TR_MODEL,   // uploaded image staged; arg: ModelSource
+    TR_OUTPUT,  // arg: TRACE_OUT_* bits; payload: prediction
+    TR_TYPE_COUNT
+};
+
+enum TraceMethod : uint8_t
+{
+    TRACE_GET,
+    TRACE_HEAD,
+    TRACE_UPLOAD
+};
+
+#define TRACE_OUT_FORWARD 0x01 // MLP_PIN
+#define TRACE_OUT_BACK 0x02    // MLN_PIN
+#define TRACE_OUT_BUZZER 0x04
+
+struct TraceHeader
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t headerSize;
+    uint16_t blockSize;
+    uint16_t reserved;
+    uint32_t startUs; // micros() when recording began
+    uint32_t modelId; // of the active model then, 0 for the built-in one
+};
+
+struct TraceBlockHeader
+{
+    uint32_t seq;
+    uint32_t baseUs;
+    uint16_t used; // bytes, this header included
+    uint16_t records;
+    uint8_t pair;
+    uint8_t outputs;
+    uint8_t prediction;
+    uint8_t reserved;
+};
+
+#define TRACE_BLOCK_DATA (TRACE_BLOCK_SIZE - sizeof(TraceBlockHeader))
+
+struct TraceRecord
+{
+    uint8_t type;
+    uint8_t arg;
+    uint64_t t_us; // unwrapped; see TraceReader
+    uint8_t method;
+    uint8_t prediction;
+    uint32_t modelId;
+    uint8_t pathLength;
+    char path[TRACE_PATH_MAX + 1];
+};
+
+const char *traceTypeName(uint8_t type);
+
+class TraceRecorder
+{
+public:
+    typedef void (*BlockSink)(const uint8_t *block, size_t size);
+
+    // Starts a new trace: the state now goes in the header and the first
+    // block. Blocks of the previous trace are dropped.
+    void begin(uint32_t nowUs, uint8_t pair, uint8_t outputs, uint8_t prediction, uint32_t modelId);
+    // Every full block, and the last one on flush(), goes to sink as well.
+    void setSink(BlockSink sink) { blockSink = sink; }
+    void flush();
+
+    void sensor(uint32_t tUs, uint8_t pair) { record(TR_SENSOR, pair, tUs); }
+    void resync(uint32_t tUs, uint8_t pair) { record(TR_RESYNC, pair, tUs); }
+    void action(uint32_t tUs, uint8_t action) { record(TR_ACTION, action, tUs); }
+    void request(uint32_t tUs, uint8_t method, const char *path);
+    void model(uint32_t tUs, uint8_t source, uint32_t modelId);
+    // Records the outputs only when they differ from the last recorded.
+    void outputs(uint32_t tUs, uint8_t outputs, uint8_t prediction);
+
+    const TraceHeader &header() const { return head; }
+    // Blocks held, oldest first; the last may be partly filled.
+    uint32_t blocks() const { return held; }
+    const uint8_t *block(uint32_t i) const;
+    uint32_t records() const { return recordCount; }
+    uint32_t blocksDropped() const { return dropped; }
+
+private:
+    void record(uint8_t type, uint8_t arg, uint32_t tUs, const uint8_t *payload = nullptr, size_t length = 0);
+    void open(uint32_t tUs);
+    void close();
+    uint8_t *current() { return (uint8_t *)ring[(first + held - 1) % TRACE_BLOCKS]; }
+
+    uint32_t ring[TRACE_BLOCKS][TRACE_BLOCK_SIZE / 4];
+    TraceHeader head = {};
+    uint32_t first = 0; // ring index of the oldest block
+    uint32_t held = 0;
+    uint32_t seq = 0;
+    uint32_t lastUs = 0;
+    uint32_t recordCount = 0;
+    uint32_t dropped = 0;
+    uint8_t pair = 0;
+    uint8_t lastOutputs = 0;
+    uint8_t lastPrediction = 0;
+    bool isOpen = false;
+    BlockSink blockSink = nullptr;
+};
+
+// Walks the records of a trace held in memory. Times are unwrapped from
+// the 32-bit micros() of the board into 64 bits, starting at startUs.
+class TraceReader
+{
+public:
+    // Returns false when data does not start with a trace header.
+    bool begin(const uint8_t *data, size_t size);
+    const TraceHeader &header() const { return head; }
+
+    // The next block's snapshot; false at the end of the trace. Its records
+    // then come from next() until it returns false.
+    bool nextBlock(TraceBlockHeader &block);
+    bool next(TraceRecord &record);
+    // Blocks missing between those read (sequence gaps) or damaged.
+    uint32_t gaps() const { return gapCount; }
+    uint32_t damaged() const { return badBlocks; }
+    uint64_t unwrap(uint32_t tUs);
+
+private:
+    const uint8_t *data = nullptr;
+    size_t size = 0;
+    size_t offset = 0;
+    TraceHeader head = {};
+    const uint8_t *blockData = nullptr;
+    size_t blockUsed = 0;
+    size_t blockAt = 0;
+    uint32_t blockUs = 0; // time of the block's last record read
+    uint32_t nextSeq = 0;
+    bool started = false;
+    uint32_t gapCount = 0;
+    uint32_t badBlocks = 0;
+    uint32_t lastUs = 0;
+    uint64_t lastUnwrapped = 0;
+};
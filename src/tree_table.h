@@ -0,0 +1,183 @@
+#pragma once
+// Decision tree over binary sensors, flattened into a lookup table.
+//
+// The IR sensors are digital, so a tree over FEATURES of them is a function
+// of FEATURES bits. TreeTable evaluates the tree once for every input
+// combination (at compile time for a constexpr instance) and packs the
+// resulting classes BITS to an entry into 32-bit words. predict() is then a
+// shift and a mask with no branches and no float compares.
+//
+// Bit i of the table index means "feature i goes right". That is exact for
+// float inputs as long as every split on a feature uses the same threshold
+// (its cut), which holds for trees trained on 0/1 readings; binarizable()
+// reports it. Otherwise the float entry points walk the nodes themselves,
+// so those must outlive the table. predictBatch() classifies whole columns
+// of recorded samples.
+//
+// Size is 2^FEATURES entries: 4 bytes up to 16 entries with 4 classes, 16 KB
+// at 16 sensors. Past that, split the sensors across several tables.
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+struct TreeNode
+{
+    int16_t feature; // -1 for a leaf
+    float threshold; // go left when x[feature] <= threshold
+    int16_t left;
+    int16_t right;
+    uint8_t label; // class of a leaf
+};
+
+template <int FEATURES, int CLASSES>
+class TreeTable
+{
+public:
+    static_assert(FEATURES >= 1 && FEATURES <= 24, "table size is 2^FEATURES entries");
+    static_assert(CLASSES >= 1 && CLASSES <= 256, "classes must fit a byte");
+
+    static constexpr int BITS = CLASSES <= 2 ? 1 : CLASSES <= 4 ? 2 : CLASSES <= 16 ? 4 : 8;
+    static constexpr uint32_t ENTRIES = uint32_t(1) << FEATURES;
+    static constexpr uint32_t PER_WORD = 32 / BITS;
+    static constexpr uint32_t WORDS = (ENTRIES + PER_WORD - 1) / PER_WORD;
+
+    template <size_t NODES>
+    constexpr explicit TreeTable(const TreeNode (&nodes)[NODES]) : TreeTable(nodes, NODES) {}
+
+    constexpr TreeTable(const TreeNode *nodes, size_t count)
+        : words{}, cuts{}, singleCut(true), treeNodes(nodes), treeCount(count)
+    {
+        bool seen[FEATURES] = {};
+        for (size_t i = 0; i < count; i++)
+        {
+            int f = nodes[i].feature;
+            if (f < 0 || f >= FEATURES)
+                continue;
+            if (seen[f] && cuts[f] != nodes[i].threshold)
+                singleCut = false;
+            cuts[f] = nodes[i].threshold;
+            seen[f] = true;
+        }
+        for (uint32_t inputs = 0; inputs < ENTRIES; inputs++)
+            words[inputs / PER_WORD] |= uint32_t(walk(nodes, count, inputs)) << (inputs % PER_WORD * BITS);
+    }
+
+    constexpr bool binarizable() const { return singleCut; }
+
+    // Bit i of inputs is sensor i (HIGH = 1).
+    constexpr int predict(uint32_t inputs) const
+    {
+        inputs &= ENTRIES - 1;
+        return (words[inputs / PER_WORD] >> (inputs % PER_WORD * BITS)) & ((uint32_t(1) << BITS) - 1);
+    }
+
+    // Same result as the tree's float compares, NaN included (it goes right).
+    int predict(const float *x) const
+    {
+        if (!singleCut)
+            return walk(treeNodes, treeCount, x);
+        uint32_t inputs = 0;
+        for (int f = 0; f < FEATURES; f++)
+            inputs |= uint32_t(!(x[f] <= cuts[f])) << f;
+        return predict(inputs);
+    }
+
+    // Classifies count samples given as one array per feature. Works through
+    // fixed-size blocks into a local buffer, so the compiler can vectorize
+    // the per-sample loop without aliasing checks.
+    void predictBatch(const float *const columns[FEATURES], size_t count, uint8_t *out) const
+    {
+        uint8_t classes[BLOCK];
+        size_t base = 0;
+        for (; singleCut && base + BLOCK <= count; base += BLOCK)
+        {
+            const float *column[FEATURES];
+            for (int f = 0; f < FEATURES; f++)
+                column[f] = columns[f] + base;
+            classifyBlock(column, classes);
+            memcpy(out + base, classes, BLOCK);
+        }
+        for (; base < count; base++)
+        {
+            float x[FEATURES];
+            for (int f = 0; f < FEATURES; f++)
+                x[f] = columns[f][base];
+            out[base] = predict(x);
+        }
+    }
+
+    // Reference evaluation of the tree for one input combination. A
+    // malformed tree (child out of range, cycle) yields class 0.
+    static constexpr int walk(const TreeNode *nodes, size_t count, uint32_t inputs)
+    {
+        size_t node = 0;
+        for (size_t steps = 0; steps < count && node < count; steps++)
+        {
+            const TreeNode &n = nodes[node];
+            if (n.feature < 0)
+                return n.label < CLASSES ? n.label : 0;
+            node = size_t((inputs >> n.feature) & 1 ? n.right : n.left);
+        }
+        return 0;
+    }
+
+    // The same over float inputs, with the nodes' own thresholds
+    static constexpr int walk(const TreeNode *nodes, size_t count, const float *x)
+    {
+        size_t node = 0;
+        for (size_t steps = 0; steps < count && node < count; steps++)
+        {
+            const TreeNode &n = nodes[node];
+            if (n.feature < 0)
+                return n.label < CLASSES ? n.label : 0;
+            node = size_t(x[n.feature] <= n.threshold ? n.left : n.right);
+        }
+        return 0;
+    }
+
+private:
+    static const size_t BLOCK = 256;
+
+    // Small tables become a chain of compare-and-selects, which vectorizes
+    // without gather or per-lane shift instructions.
+    void classifyBlock(const float *const column[FEATURES], uint8_t *classes) const
+    {
+        if (ENTRIES <= 16)
+        {
+            uint32_t entry[ENTRIES <= 16 ? ENTRIES : 1];
+            for (uint32_t e = 0; e < ENTRIES && e < 16; e++)
+                entry[e] = predict(e);
+            for (size_t i = 0; i < BLOCK; i++)
+            {
+                uint32_t inputs = 0;
+#pragma GCC unroll 8
+                for (int f = 0; f < FEATURES; f++)
+                    inputs |= uint32_t(!(column[f][i] <= cuts[f])) << f;
+                uint32_t c = 0;
+#pragma GCC unroll 16
+                for (uint32_t e = 0; e < ENTRIES && e < 16; e++)
+                    c |= -uint32_t(inputs == e) & entry[e];
+                classes[i] = uint8_t(c);
+            }
+        }
+        else
+        {
+            // One vectorized pass per sensor, then plain table reads
+            uint32_t inputs[BLOCK] = {};
+            for (int f = 0; f < FEATURES; f++)
+            {
+                float cut = cuts[f];
+                for (size_t i = 0; i < BLOCK; i++)
+                    inputs[i] |= uint32_t(!(column[f][i] <= cut)) << f;
+            }
+            for (size_t i = 0; i < BLOCK; i++)
+                classes[i] = uint8_t(predict(inputs[i]));
+        }
+    }
+
+    uint32_t words[WORDS];
+    float cuts[FEATURES];
+    bool singleCut;
+    const TreeNode *treeNodes;
+    size_t treeCount;
+};
@@ -0,0 +1,791 @@
+#pragma once
+// Fleet telemetry gateway: every track unit pushes its state, and the
+// gateway keeps the latest of each and classifies its sensors again with
+// the fleet's forest (railway_fault_forest.h) as a second opinion.
+//
+// A unit sends one UDP datagram per update:
+//
+//   off size
+//    0   4    unit id, little-endian
+//    4   ..   a /data.json document, whole or a delta, or a /data.bin
+//             record (src/telemetry.h); told apart by the first byte
+//
+// A delta carries "since", the seq it was taken against, and only the
+// fields changed after it. It applies only to a slot at that seq or later
+// in the same boot epoch; one that would skip an update is refused and the
+// unit marked as waiting for a whole document or record.
+//
+// Datagrams are sharded by unit onto lock-free queues, several per worker.
+// A worker whose shards run dry steals a whole shard from another: it
+// claims it, handles a batch and lets it go, so one unit's updates are
+// still handled one at a time and in order, and a few chatty units do not
+// pin one core while the rest idle. Updates land in a table of per-unit
+// slots under a seqlock; one no newer than what the slot holds (same boot
+// epoch, lower or equal seq) is dropped as stale.
+//
+// FleetSim plays N units on generated tracks for fleet_sim and bench_fleet.
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "../railway_fault_forest.h"
+#include "../src/device_state.h"
+#include "../src/json_writer.h"
+#include "../src/telemetry.h"
+
+#define FLEET_FRAME_MAX 512
+#define FLEET_QUEUE_SIZE 1024 // per shard
+#define FLEET_SHARDS_PER_WORKER 8
+#define FLEET_SHARD_BATCH 32
+
+// Bounded multi-producer/multi-consumer queue (Vyukov): each cell carries a
+// sequence number that says whose turn it is, so push and pop are one CAS
+// on their index and never wait for each other.
+template <typename T, uint32_t N>
+class MpmcQueue
+{
+    static_assert(N && (N & (N - 1)) == 0, "queue size must be a power of two");
+
+public:
+    MpmcQueue()
+    {
+        for (uint32_t i = 0; i < N; i++)
+            cells[i].seq.store(i, std::memory_order_relaxed);
+    }
+
+    // Fill is called with the cell's item once it is ours. False when full.
+    template <typename Fill>
+    bool push(Fill fill)
+    {
+        uint32_t pos = head.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            Cell &cell = cells[pos & (N - 1)];
+            int32_t diff = int32_t(cell.seq.load(std::memory_order_acquire) - pos);
+            if (diff == 0 && head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                fill(cell.item);
+                cell.seq.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+            if (diff < 0)
+                return false;
+            if (diff > 0)
+                pos = head.load(std::memory_order_relaxed);
+        }
+    }
+
+    // Use is called with the item before its cell is handed back.
+    template <typename Use>
+    bool pop(Use use)
+    {
+        uint32_t pos = tail.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            Cell &cell = cells[pos & (N - 1)];
+            int32_t diff = int32_t(cell.seq.load(std::memory_order_acquire) - (pos + 1));
+            if (diff == 0 && tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                use(cell.item);
+                cell.seq.store(pos + N, std::memory_order_release);
+                return true;
+            }
+            if (diff < 0)
+                return false;
+            if (diff > 0)
+                pos = tail.load(std::memory_order_relaxed);
+        }
+    }
+
+    bool empty() const
+    {
+        return int32_t(head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire)) <= 0;
+    }
+
+private:
+    struct Cell
+    {
+        std::atomic<uint32_t> seq;
+        T item;
+    };
+
+    alignas(64) std::atomic<uint32_t> head{0};
+    alignas(64) std::atomic<uint32_t> tail{0};
+    alignas(64) Cell cells[N];
+};
+
+struct FleetFrame
+{
+    uint16_t size;
+    uint8_t data[FLEET_FRAME_MAX];
+};
+
+// Which fields an update carried; a /data.json delta only has the changed
+// ones.
+#define FU_LEFT 0x01
+#define FU_RIGHT 0x02
+#define FU_PREDICTION 0x04
+#define FU_SEVERITY 0x08
+#define FU_CONFIDENCE 0x10
+#define FU_FAULT_PERCENT 0x20
+#define FU_MOTOR 0x40
+#define FU_SAFETY_STOPS 0x80
+
+struct UnitUpdate
+{
+    uint32_t unit;
+    uint32_t epoch;
+    uint32_t seq;
+    uint32_t since; // a delta's base seq; 0 for a whole update
+    uint32_t fields;
+    uint8_t left, right, prediction, severity, motor;
+    uint16_t confidence;   // 0.01 %
+    uint16_t faultPercent; // 0.01 %
+    uint32_t safetyStops;
+};
+
+struct UnitState
+{
+    uint32_t epoch;
+    uint32_t seq;
+    uint32_t updates; // applied; 0 for a unit never heard from
+    uint8_t left, right;
+    uint8_t prediction; // as the unit reported it
+    uint8_t classified; // the fleet forest on the unit's sensors
+    uint8_t severity;
+    uint8_t motor; // TelemetryMotor, MOTOR_INVALID if never reported
+    uint16_t confidence;
+    uint16_t faultPercent;
+    uint32_t safetyStops;
+    uint64_t updatedNs;
+    bool needsFull; // a delta was refused; deltas resume after a whole update
+};
+
+namespace fleet_detail
+{
+inline int lookup(const char *s, size_t n, const char *const *names, int count)
+{
+    for (int i = 0; i < count; i++)
+        if (strlen(names[i]) == n && !memcmp(s, names[i], n))
+            return i;
+    return -1;
+}
+
+inline bool keyIs(const char *s, size_t n, const char *key) { return strlen(key) == n && !memcmp(s, key, n); }
+
+// The flat object writeDataJson() produces: string and number values, no
+// nesting. Strings may hold escapes; none of the fields read here do.
+inline bool parseDataJson(const char *p, const char *end, UnitUpdate &u)
+{
+    static const char *const predictions[] = {"Normal", "Crack_Left", "Crack_Right", "Break", "Unknown"};
+    static const char *const severities[] = {"Unknown", "Safe", "Moderate", "Critical"};
+    auto space = [&]() {
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n'))
+            p++;
+    };
+    space();
+    if (p == end || *p++ != '{')
+        return false;
+    bool seenEpoch = false, seenSeq = false;
+    for (;;)
+    {
+        space();
+        if (p < end && *p == '}')
+            break;
+        if (p == end || *p++ != '"')
+            return false;
+        const char *key = p;
+        while (p < end && *p != '"')
+            p++;
+        size_t keyLength = p - key;
+        p++;
+        space();
+        if (p >= end || *p++ != ':')
+            return false;
+        space();
+        const char *value = p;
+        size_t valueLength;
+        bool quoted = p < end && *p == '"';
+        if (quoted)
+        {
+            value = ++p;
+            while (p < end && *p != '"')
+                p += *p == '\\' ? 2 : 1;
+            if (p >= end)
+                return false;
+            valueLength = p++ - value;
+        }
+        else
+        {
+            while (p < end && *p != ',' && *p != '}')
+                p++;
+            valueLength = p - value;
+        }
+        int i;
+        if (keyIs(key, keyLength, "epoch"))
+            seenEpoch = true, u.epoch = strtoul(value, nullptr, 10);
+        else if (keyIs(key, keyLength, "seq"))
+            seenSeq = true, u.seq = strtoul(value, nullptr, 10);
+        else if (keyIs(key, keyLength, "since"))
+            u.since = strtoul(value, nullptr, 10);
+        else if (keyIs(key, keyLength, "left"))
+            u.fields |= FU_LEFT, u.left = *value == '1';
+        else if (keyIs(key, keyLength, "right"))
+            u.fields |= FU_RIGHT, u.right = *value == '1';
+        else if (keyIs(key, keyLength, "ai_status") && (i = lookup(value, valueLength, predictions, 5)) >= 0)
+            u.fields |= FU_PREDICTION, u.prediction = i;
+        else if (keyIs(key, keyLength, "severity") && (i = lookup(value, valueLength, severities, 4)) >= 0)
+            u.fields |= FU_SEVERITY, u.severity = i;
+        else if (keyIs(key, keyLength, "confidence"))
+            u.fields |= FU_CONFIDENCE, u.confidence = telemetryPercent(strtof(value, nullptr));
+        else if (keyIs(key, keyLength, "fault_percent"))
+            u.fields |= FU_FAULT_PERCENT, u.faultPercent = telemetryPercent(strtof(value, nullptr));
+        space();
+        if (p < end && *p == ',')
+            p++;
+        else if (p < end && *p == '}')
+            break;
+        else
+            return false;
+    }
+    return seenEpoch && seenSeq;
+}
+}
+
+// Reads a datagram. False if it is too short or neither payload kind.
+inline bool decodeFleetFrame(const uint8_t *data, size_t size, UnitUpdate &u)
+{
+    if (size < 5)
+        return false;
+    u = UnitUpdate();
+    u.unit = data[0] | data[1] << 8 | data[2] << 16 | uint32_t(data[3]) << 24;
+    if (data[4] == '{')
+        return fleet_detail::parseDataJson((const char *)data + 4, (const char *)data + size, u);
+    Telemetry t;
+    if (decodeTelemetry(data + 4, size - 4, t) != TELEMETRY_OK)
+        return false;
+    u.fields = FU_LEFT | FU_RIGHT | FU_PREDICTION | FU_SEVERITY | FU_CONFIDENCE | FU_FAULT_PERCENT | FU_MOTOR |
+               FU_SAFETY_STOPS;
+    u.epoch = t.epoch;
+    u.seq = t.seq;
+    u.left = (t.flags & TELEMETRY_LEFT) != 0;
+    u.right = (t.flags & TELEMETRY_RIGHT) != 0;
+    u.prediction = t.prediction;
+    u.severity = t.severity;
+    u.motor = t.motor;
+    u.confidence = t.confidence;
+    u.faultPercent = t.faultPercent;
+    u.safetyStops = t.safetyStops;
+    return true;
+}
+
+inline uint64_t fleetNowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+// Latest state of units 0..size-1.
+class UnitTable
+{
+public:
+    explicit UnitTable(uint32_t units) : slots(new Slot[units]), count(units) {}
+    uint32_t size() const { return count; }
+
+    enum Result
+    {
+        APPLIED,
+        STALE,
+        GAP, // a delta against an update the slot has not seen
+        UNKNOWN_UNIT
+    };
+
+    Result apply(const UnitUpdate &u, uint64_t nowNs, bool *disagrees = nullptr)
+    {
+        if (u.unit >= count)
+            return UNKNOWN_UNIT;
+        Slot &slot = slots[u.unit];
+        uint32_t v = lock(slot);
+        UnitState &s = slot.state;
+        if (s.updates && u.epoch == s.epoch && int32_t(u.seq - s.seq) <= 0)
+        {
+            slot.version.store(v, std::memory_order_release);
+            return STALE;
+        }
+        if (u.since && (!s.updates || u.epoch != s.epoch || int32_t(u.since - s.seq) > 0))
+        {
+            s.needsFull = true;
+            slot.version.store(v + 2, std::memory_order_release);
+            return GAP;
+        }
+        if (!s.updates || u.epoch != s.epoch)
+        {
+            s = UnitState();
+            s.prediction = PRED_UNKNOWN;
+            s.motor = MOTOR_INVALID;
+        }
+        s.epoch = u.epoch;
+        s.seq = u.seq;
+        s.updates++;
+        if (!u.since)
+            s.needsFull = false;
+        s.updatedNs = nowNs;
+        if (u.fields & FU_LEFT)
+            s.left = u.left;
+        if (u.fields & FU_RIGHT)
+            s.right = u.right;
+        if (u.fields & FU_PREDICTION)
+            s.prediction = u.prediction;
+        if (u.fields & FU_SEVERITY)
+            s.severity = u.severity;
+        if (u.fields & FU_MOTOR)
+            s.motor = u.motor;
+        if (u.fields & FU_CONFIDENCE)
+            s.confidence = u.confidence;
+        if (u.fields & FU_FAULT_PERCENT)
+            s.faultPercent = u.faultPercent;
+        if (u.fields & FU_SAFETY_STOPS)
+            s.safetyStops = u.safetyStops;
+        float x[RAILWAY_FOREST_FEATURES] = {float(s.left), float(s.right)}, proba[RAILWAY_FOREST_CLASSES];
+        s.classified = railwayForest.predict(x, proba);
+        if (disagrees)
+            *disagrees = s.prediction != PRED_UNKNOWN && s.prediction != s.classified;
+        slot.version.store(v + 2, std::memory_order_release);
+        return APPLIED;
+    }
+
+    // A consistent copy of the unit's slot; readers never block writers.
+    bool read(uint32_t unit, UnitState &out) const
+    {
+        if (unit >= count)
+            return false;
+        const Slot &slot = slots[unit];
+        for (;;)
+        {
+            uint32_t v = slot.version.load(std::memory_order_acquire);
+            if (v & 1)
+                continue;
+            memcpy(&out, &slot.state, sizeof(out));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.version.load(std::memory_order_relaxed) == v)
+                return out.updates != 0;
+        }
+    }
+
+private:
+    struct alignas(64) Slot
+    {
+        std::atomic<uint32_t> version{0}; // odd while written
+        UnitState state = {};
+    };
+
+    // The gateway only ever has one writer per unit, as a shard is handled
+    // by one worker at a time; apply() still takes turns for other callers.
+    static uint32_t lock(Slot &slot)
+    {
+        for (;;)
+        {
+            uint32_t v = slot.version.load(std::memory_order_relaxed);
+            if (!(v & 1) && slot.version.compare_exchange_weak(v, v + 1, std::memory_order_acquire))
+                return v;
+            std::this_thread::yield();
+        }
+    }
+
+    std::unique_ptr<Slot[]> slots;
+    uint32_t count;
+};
+
+struct FleetStats
+{
+    uint64_t submitted = 0;
+    uint64_t applied = 0;
+    uint64_t stolen = 0;  // handled by a worker other than the unit's own
+    uint64_t stale = 0;   // older than the table's state
+    uint64_t gaps = 0;    // deltas refused for a missed update
+    uint64_t invalid = 0; // undecodable or an unknown unit
+    uint64_t dropped = 0; // queues full or frame too big
+    uint64_t disagreements = 0;
+};
+
+class FleetGateway
+{
+public:
+    FleetGateway(uint32_t units, unsigned workers) : table(units), count(workers ? workers : 1)
+    {
+        // Shard i belongs to worker i % count.
+        shards.reserve(count * FLEET_SHARDS_PER_WORKER);
+        for (unsigned i = 0; i < count * FLEET_SHARDS_PER_WORKER; i++)
+            shards.emplace_back(new Shard());
+        counters.reset(new Counters[count]);
+        for (unsigned w = 0; w < count; w++)
+            threads.emplace_back(&FleetGateway::run, this, w);
+    }
+
+    ~FleetGateway()
+    {
+        stopping = true;
+        for (std::thread &t : threads)
+            t.join();
+    }
+
+    // Any thread may submit. False when the frame was dropped.
+    bool submit(const uint8_t *data, size_t size)
+    {
+        if (size < 4 || size > FLEET_FRAME_MAX)
+        {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        uint32_t unit = data[0] | data[1] << 8 | data[2] << 16 | uint32_t(data[3]) << 24;
+        bool queued = shards[unit % shards.size()]->queue.push([&](FleetFrame &f) {
+            f.size = uint16_t(size);
+            memcpy(f.data, data, size);
+        });
+        (queued ? submitted : dropped).fetch_add(1, std::memory_order_relaxed);
+        return queued;
+    }
+
+    // Waits until every frame submitted so far has been handled.
+    void drain() const
+    {
+        uint64_t target = submitted.load(std::memory_order_acquire);
+        while (handled() < target)
+            std::this_thread::yield();
+    }
+
+    FleetStats stats() const
+    {
+        FleetStats s;
+        s.submitted = submitted.load(std::memory_order_relaxed);
+        s.dropped = dropped.load(std::memory_order_relaxed);
+        for (unsigned w = 0; w < count; w++)
+        {
+            const Counters &c = counters[w];
+            s.applied += c.applied.load(std::memory_order_relaxed);
+            s.stolen += c.stolen.load(std::memory_order_relaxed);
+            s.stale += c.stale.load(std::memory_order_relaxed);
+            s.gaps += c.gaps.load(std::memory_order_relaxed);
+            s.invalid += c.invalid.load(std::memory_order_relaxed);
+            s.disagreements += c.disagreements.load(std::memory_order_relaxed);
+        }
+        return s;
+    }
+
+    const UnitTable &units() const { return table; }
+    unsigned workers() const { return count; }
+
+private:
+    struct Shard
+    {
+        std::atomic<bool> claimed{false};
+        MpmcQueue<FleetFrame, FLEET_QUEUE_SIZE> queue;
+    };
+
+    struct alignas(64) Counters
+    {
+        std::atomic<uint64_t> handled{0};
+        std::atomic<uint64_t> applied{0};
+        std::atomic<uint64_t> stolen{0};
+        std::atomic<uint64_t> stale{0};
+        std::atomic<uint64_t> gaps{0};
+        std::atomic<uint64_t> invalid{0};
+        std::atomic<uint64_t> disagreements{0};
+    };
+
+    static void bump(std::atomic<uint64_t> &counter, uint64_t n = 1)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    uint64_t handled() const
+    {
+        uint64_t n = 0;
+        for (unsigned w = 0; w < count; w++)
+            n += counters[w].handled.load(std::memory_order_acquire);
+        return n;
+    }
+
+    void handle(const FleetFrame &f, Counters &c)
+    {
+        UnitUpdate u;
+        bool disagrees = false;
+        UnitTable::Result r = decodeFleetFrame(f.data, f.size, u) ? table.apply(u, fleetNowNs(), &disagrees)
+                                                                  : UnitTable::UNKNOWN_UNIT;
+        bump(r == UnitTable::APPLIED ? c.applied : r == UnitTable::STALE ? c.stale : r == UnitTable::GAP ? c.gaps : c.invalid);
+        if (disagrees)
+            bump(c.disagreements);
+    }
+
+    // Claims shard i and handles up to a batch of its frames; 0 if it was
+    // empty or another worker holds it.
+    uint32_t take(unsigned i, Counters &c)
+    {
+        Shard &shard = *shards[i];
+        if (shard.queue.empty() || shard.claimed.exchange(true, std::memory_order_acquire))
+            return 0;
+        uint32_t n = 0;
+        while (n < FLEET_SHARD_BATCH && shard.queue.pop([&](const FleetFrame &f) { handle(f, c); }))
+            n++;
+        shard.claimed.store(false, std::memory_order_release);
+        return n;
+    }
+
+    // A batch from each of its own shards, else one stolen shard's batch,
+    // the next workers' first; a while of nothing to do turns into short
+    // sleeps.
+    void run(unsigned w)
+    {
+        Counters &c = counters[w];
+        unsigned idle = 0;
+        while (!stopping.load(std::memory_order_relaxed))
+        {
+            uint32_t took = 0;
+            for (unsigned j = 0; j < FLEET_SHARDS_PER_WORKER; j++)
+                took += take(w + j * count, c);
+            for (unsigned k = 1; !took && k < count; k++)
+                for (unsigned j = 0; !took && j < FLEET_SHARDS_PER_WORKER; j++)
+                    if ((took = take((w + k) % count + j * count, c)))
+                        bump(c.stolen, took);
+            if (took)
+            {
+                idle = 0;
+                c.handled.store(c.handled.load(std::memory_order_relaxed) + took, std::memory_order_release);
+            }
+            else if (++idle < 64)
+                std::this_thread::yield();
+            else
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+    }
+
+    UnitTable table;
+    unsigned count;
+    std::vector<std::unique_ptr<Shard>> shards;
+    std::unique_ptr<Counters[]> counters;
+    std::vector<std::thread> threads;
+    std::atomic<bool> stopping{false};
+    alignas(64) std::atomic<uint64_t> submitted{0};
+    std::atomic<uint64_t> dropped{0};
+};
+
+// Takes datagrams off a bound UDP socket into the gateway until stop is
+// set; the socket should have a receive timeout so stop is seen.
+inline void receiveFleet(int fd, FleetGateway &gateway, const std::atomic<bool> &stop)
+{
+    const unsigned BATCH = 64;
+    static thread_local uint8_t buffers[BATCH][FLEET_FRAME_MAX + 1];
+    mmsghdr messages[BATCH];
+    iovec vectors[BATCH];
+    for (unsigned i = 0; i < BATCH; i++)
+    {
+        vectors[i] = {buffers[i], sizeof(buffers[i])};
+        messages[i] = {};
+        messages[i].msg_hdr.msg_iov = &vectors[i];
+        messages[i].msg_hdr.msg_iovlen = 1;
+    }
+    while (!stop.load(std::memory_order_relaxed))
+    {
+        int n = recvmmsg(fd, messages, BATCH, MSG_WAITFORONE, nullptr);
+        for (int i = 0; i < n; i++)
+            gateway.submit(buffers[i], messages[i].msg_len); // a truncated one is too big and dropped
+    }
+}
+
+inline int openFleetSocket(uint16_t port, bool bindIt)
+{
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(bindIt ? INADDR_ANY : INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    int size = 8 << 20;
+    setsockopt(fd, SOL_SOCKET, bindIt ? SO_RCVBUF : SO_SNDBUF, &size, sizeof(size));
+    timeval timeout = {0, 100000};
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    if (fd >= 0 && (bindIt ? bind(fd, (sockaddr *)&addr, sizeof(addr)) : connect(fd, (sockaddr *)&addr, sizeof(addr))))
+    {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// N units on generated tracks. Each sends every periodUs (a tenth of that
+// for the chatty share, as a unit streaming /events through a fault
+// would), alternating /data.json documents and /data.bin records in the
+// given share. The delta share of the /data.json units sends deltas
+// against its previous update, a whole document every FLEET_SIM_FULL_EVERY.
+#define FLEET_SIM_FULL_EVERY 10
+
+class FleetSim
+{
+public:
+    FleetSim(uint32_t units, uint32_t rateHz, float binaryShare = 0.5f, float chattyShare = 0.05f, uint32_t seed = 1,
+             float deltaShare = 0.0f)
+        : rng(seed), sims(units)
+    {
+        std::uniform_real_distribution<float> share(0, 1);
+        uint64_t period = 1000000 / (rateHz ? rateHz : 1);
+        for (uint32_t u = 0; u < units; u++)
+        {
+            Unit &s = sims[u];
+            s.epoch = rng();
+            s.binary = share(rng) < binaryShare;
+            s.delta = !s.binary && share(rng) < deltaShare;
+            s.periodUs = share(rng) < chattyShare ? period / 10 + 1 : period;
+            s.nextUs = rng() % s.periodUs;
+            s.state.prediction = PRED_NORMAL;
+            s.state.severity = SEVERITY_SAFE;
+        }
+    }
+
+    uint32_t units() const { return sims.size(); }
+    // The seq of the unit's last update, and its state then.
+    uint32_t lastSeq(uint32_t unit) const { return sims[unit].seq; }
+    const DeviceState &lastState(uint32_t unit) const { return sims[unit].state; }
+
+    // With history kept, the prediction each update carried;
+    // PRED_UNKNOWN for one not sent.
+    void keepHistory(bool keep) { history = keep; }
+    uint8_t predictionAt(uint32_t unit, uint32_t seq) const
+    {
+        const std::vector<uint8_t> &h = sims[unit].predictions;
+        return seq && seq <= h.size() ? h[seq - 1] : PRED_UNKNOWN;
+    }
+
+    // Emits every update due up to nowUs: emit(data, size).
+    template <typename Emit>
+    void run(uint64_t nowUs, Emit emit)
+    {
+        uint8_t frame[FLEET_FRAME_MAX];
+        for (uint32_t u = 0; u < sims.size(); u++)
+            for (Unit &s = sims[u]; s.nextUs <= nowUs; s.nextUs += s.periodUs)
+                emit(frame, update(u, s, frame));
+    }
+
+private:
+    struct Unit
+    {
+        uint32_t epoch;
+        uint32_t seq = 0;
+        bool binary;
+        bool delta;
+        uint64_t periodUs;
+        uint64_t nextUs;
+        uint32_t faultLeft = 0; // updates until the fault clears
+        uint32_t safetyStops = 0;
+        DeviceState state;
+        DeviceState sent; // as of the previous update, for deltas
+        std::vector<uint8_t> predictions;
+    };
+
+    size_t update(uint32_t u, Unit &s, uint8_t *frame)
+    {
+        DeviceState &st = s.state;
+        if (s.faultLeft && !--s.faultLeft)
+            st.left = st.right = 0;
+        else if (!s.faultLeft && rng() % 100 == 0)
+        {
+            int kind = 1 + rng() % 3;
+            st.left = kind & 1;
+            st.right = kind >> 1;
+            s.faultLeft = 5 + rng() % 20;
+            s.safetyStops++;
+        }
+        st.prediction = Prediction(st.left | st.right << 1);
+        bool fault = st.prediction != PRED_NORMAL;
+        st.faultPercent = fault ? 60 + rng() % 4000 / 100.0f : rng() % 1000 / 100.0f;
+        st.confidence = fault ? st.faultPercent : 100 - st.faultPercent;
+        st.severity = st.faultPercent < 30 ? SEVERITY_SAFE : st.faultPercent < 70 ? SEVERITY_MODERATE : SEVERITY_CRITICAL;
+        st.messageStyle = fault ? STYLE_DANGER : STYLE_SUCCESS;
+        st.aiStyle = fault ? STYLE_DANGER : STYLE_PRIMARY;
+        s.seq++;
+        if (history)
+            s.predictions.push_back(st.prediction);
+
+        frame[0] = uint8_t(u);
+        frame[1] = uint8_t(u >> 8);
+        frame[2] = uint8_t(u >> 16);
+        frame[3] = uint8_t(u >> 24);
+        if (s.binary)
+        {
+            Telemetry t;
+            t.epoch = s.epoch;
+            t.seq = s.seq;
+            t.uptimeMs = uint32_t(s.nextUs / 1000);
+            t.flags = (st.left ? TELEMETRY_LEFT : 0) | (st.right ? TELEMETRY_RIGHT : 0) |
+                      (fault ? TELEMETRY_BUZZER | TELEMETRY_FAULT : 0);
+            t.prediction = st.prediction;
+            t.severity = st.severity;
+            t.motor = fault ? MOTOR_STOPPED : MOTOR_FORWARD;
+            t.confidence = telemetryPercent(st.confidence);
+            t.faultPercent = telemetryPercent(st.faultPercent);
+            t.safetyStops = s.safetyStops;
+            return 4 + encodeTelemetry(t, frame + 4);
+        }
+        // As writeDataJson() writes it: the whole document, or the fields
+        // changed since the previous update.
+        const DeviceState &was = s.sent;
+        bool whole = !s.delta || s.seq % FLEET_SIM_FULL_EVERY == 1;
+        char message[160], previous[160];
+        writeMessage(message, sizeof(message), st);
+        writeMessage(previous, sizeof(previous), was);
+        JsonWriter json((char *)frame + 4, FLEET_FRAME_MAX - 4);
+        json.beginObject();
+        json.field("epoch", long(s.epoch));
+        json.field("seq", long(s.seq));
+        if (!whole)
+            json.field("since", long(s.seq - 1));
+        if (whole || strcmp(message, previous))
+            json.field("message", message);
+        if (whole || st.messageStyle != was.messageStyle)
+            json.field("message_class", styleName(st.messageStyle));
+        if (whole || st.left != was.left)
+        {
+            json.field("left", st.left ? "1" : "0");
+            json.field("left_class", styleName(st.left ? STYLE_DANGER : STYLE_SUCCESS));
+        }
+        if (whole || st.right != was.right)
+        {
+            json.field("right", st.right ? "1" : "0");
+            json.field("right_class", styleName(st.right ? STYLE_DANGER : STYLE_SUCCESS));
+        }
+        if (whole)
+        {
+            json.field("btn_fwd", BTN_FWD_LABEL);
+            json.field("btn_fwd_class", styleName(st.fwdStyle));
+            json.field("btn_stop", BTN_STOP_LABEL);
+            json.field("btn_stop_class", styleName(st.stopStyle));
+            json.field("btn_back", BTN_BACK_LABEL);
+            json.field("btn_back_class", styleName(st.backStyle));
+        }
+        if (whole || st.prediction != was.prediction)
+            json.field("ai_status", predictionName(st.prediction));
+        if (whole || st.faultPercent != was.faultPercent)
+            json.fieldFixed("fault_percent", st.faultPercent);
+        if (whole || st.severity != was.severity)
+            json.field("severity", severityName(st.severity));
+        if (whole || st.aiStyle != was.aiStyle)
+            json.field("ai_class", styleName(st.aiStyle));
+        if (whole || st.confidence != was.confidence)
+            json.fieldFixed("confidence", st.confidence);
+        json.endObject();
+        s.sent = st;
+        return json.ok() ? 4 + json.length() : 0;
+    }
+
+    std::mt19937 rng;
+    std::vector<Unit> sims;
+    bool history = false;
+};
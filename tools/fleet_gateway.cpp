@@ -0,0 +1,101 @@
+// Fleet gateway: takes telemetry datagrams from any number of track units
+// (see tools/fleet.h for the format) and keeps the latest state of each.
+//
+//   fleet_gateway [--port P] [--units N] [--threads T] [--seconds S]
+//
+// Prints a line a second: frames taken, units heard from, units in fault,
+// units waiting for a whole update after a refused delta, and how often the
+// fleet forest disagrees with what a unit reports. Stops
+// after S seconds (0: on Ctrl-C) with a table of the units in fault.
+#include <signal.h>
+
+#include <cstdio>
+
+#include "fleet.h"
+
+static std::atomic<bool> stopping(false);
+
+static void onSignal(int) { stopping = true; }
+
+int main(int argc, char **argv)
+{
+    uint16_t port = 9100;
+    uint32_t units = 1024;
+    unsigned threads = std::thread::hardware_concurrency();
+    double seconds = 0;
+    for (int i = 1; i < argc; i++)
+    {
+        bool hasValue = i + 1 < argc;
+        if (!strcmp(argv[i], "--port") && hasValue)
+            port = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--units") && hasValue)
+            units = strtoul(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--threads") && hasValue)
+            threads = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--seconds") && hasValue)
+            seconds = atof(argv[++i]);
+        else
+        {
+            fprintf(stderr, "usage: fleet_gateway [--port P] [--units N] [--threads T] [--seconds S]\n");
+            return 2;
+        }
+    }
+    if (threads == 0)
+        threads = 1;
+
+    int fd = openFleetSocket(port, true);
+    if (fd < 0)
+    {
+        perror("fleet_gateway: bind");
+        return 1;
+    }
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+    printf("fleet_gateway: udp port %u, units 0..%u, %u worker threads\n", port, units - 1, threads);
+    fflush(stdout);
+
+    FleetGateway gateway(units, threads);
+    std::thread receiver(receiveFleet, fd, std::ref(gateway), std::cref(stopping));
+    uint64_t start = fleetNowNs(), last = start;
+    FleetStats before;
+    while (!stopping && (seconds <= 0 || fleetNowNs() - start < seconds * 1e9))
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        uint64_t now = fleetNowNs();
+        if (now - last < 1000000000ull)
+            continue;
+        FleetStats s = gateway.stats();
+        uint32_t heard = 0, inFault = 0, waiting = 0;
+        UnitState u;
+        for (uint32_t i = 0; i < units; i++)
+            if (gateway.units().read(i, u))
+            {
+                heard++;
+                inFault += u.prediction != PRED_NORMAL && u.prediction != PRED_UNKNOWN;
+                waiting += u.needsFull;
+            }
+        double dt = (now - last) / 1e9;
+        uint64_t taken = s.applied + s.stale + s.gaps, takenBefore = before.applied + before.stale + before.gaps;
+        printf("  %.0f frames/s, %u units heard, %u in fault, %u waiting for a whole update; %llu stale, %llu deltas "
+               "refused, %llu invalid, %llu dropped, %.1f%% stolen, %llu disagreements\n",
+               (taken - takenBefore) / dt, heard, inFault, waiting, (unsigned long long)s.stale,
+               (unsigned long long)s.gaps, (unsigned long long)s.invalid, (unsigned long long)s.dropped,
+               s.applied ? 100.0 * s.stolen / (taken + s.invalid) : 0.0, (unsigned long long)s.disagreements);
+        fflush(stdout);
+        before = s;
+        last = now;
+    }
+    stopping = true;
+    receiver.join();
+    close(fd);
+    gateway.drain();
+
+    printf("units in fault:\n");
+    UnitState u;
+    for (uint32_t i = 0; i < units; i++)
+        if (gateway.units().read(i, u) && u.prediction != PRED_NORMAL && u.prediction != PRED_UNKNOWN)
+            printf("  unit %-6u %-12s %-9s fault %.2f%%, seq %u, fleet forest says %s\n", i,
+                   predictionName(Prediction(u.prediction)), severityName(Severity(u.severity)), u.faultPercent / 100.0,
+                   u.seq, predictionName(Prediction(u.classified)));
+    return 0;
+}
@@ -0,0 +1,72 @@
+// Plays N track units against fleet_gateway: each sends its state over UDP
+// at the given rate, as a /data.json document or a /data.bin record.
+//
+//   fleet_sim [--port P] [--units N] [--rate HZ] [--binary SHARE]
+//             [--chatty SHARE] [--delta SHARE] [--seconds S] [--seed S]
+//
+// --chatty units send ten times as often; the --delta share of the
+// /data.json units sends deltas. Reports the rate it kept up.
+#include <cstdio>
+
+#include "fleet.h"
+
+int main(int argc, char **argv)
+{
+    uint16_t port = 9100;
+    uint32_t units = 256, rate = 10, seed = 1;
+    float binary = 0.5f, chatty = 0.05f, delta = 0;
+    double seconds = 10;
+    for (int i = 1; i < argc; i++)
+    {
+        bool hasValue = i + 1 < argc;
+        if (!strcmp(argv[i], "--port") && hasValue)
+            port = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--units") && hasValue)
+            units = strtoul(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--rate") && hasValue)
+            rate = strtoul(argv[++i], nullptr, 10);
+        else if (!strcmp(argv[i], "--binary") && hasValue)
+            binary = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--chatty") && hasValue)
+            chatty = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--delta") && hasValue)
+            delta = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--seconds") && hasValue)
+            seconds = atof(argv[++i]);
+        else if (!strcmp(argv[i], "--seed") && hasValue)
+            seed = strtoul(argv[++i], nullptr, 10);
+        else
+        {
+            fprintf(stderr, "usage: fleet_sim [--port P] [--units N] [--rate HZ] [--binary SHARE]\n"
+                            "                 [--chatty SHARE] [--delta SHARE] [--seconds S] [--seed S]\n");
+            return 2;
+        }
+    }
+
+    int fd = openFleetSocket(port, false);
+    if (fd < 0)
+    {
+        perror("fleet_sim: connect");
+        return 1;
+    }
+    FleetSim sim(units, rate, binary, chatty, seed, delta);
+    uint64_t sent = 0, failed = 0, bytes = 0;
+    uint64_t start = fleetNowNs(), end = start + uint64_t(seconds * 1e9);
+    // Updates go out on a 1 ms grid of wall time.
+    for (uint64_t now = start; now < end; now = fleetNowNs())
+    {
+        sim.run((now - start) / 1000, [&](const uint8_t *frame, size_t size) {
+            if (send(fd, frame, size, 0) == ssize_t(size))
+                sent++, bytes += size;
+            else
+                failed++;
+        });
+        std::this_thread::sleep_until(std::chrono::steady_clock::time_point(std::chrono::nanoseconds(now + 1000000)));
+    }
+    double elapsed = (fleetNowNs() - start) / 1e9;
+    printf("fleet_sim: %u units at %u Hz for %.1f s to port %u\n", units, rate, elapsed, port);
+    printf("  %-22s %.0f frames/s, %.1f MB/s (%llu sent, %llu failed, %.0f bytes each)\n", "sent", sent / elapsed,
+           bytes / elapsed / 1e6, (unsigned long long)sent, (unsigned long long)failed, sent ? double(bytes) / sent : 0);
+    close(fd);
+    return 0;
+}
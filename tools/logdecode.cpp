@@ -0,0 +1,36 @@
+// Turns the sketch's binary console log (src/binlog.h) back into text: a
+// capture of the serial port, or railsim --serial-log, or stdin.
+//
+//   logdecode [FILE]
+//
+// Prints one line per record with the seconds since boot. Bytes that are
+// not part of a record (the boot ROM's banner, line noise) are skipped and
+// counted on stderr.
+#include <cstdio>
+
+#include "../src/binlog.h"
+
+int main(int argc, char **argv)
+{
+    if (argc > 2)
+    {
+        fprintf(stderr, "usage: logdecode [FILE]\n");
+        return 2;
+    }
+    FILE *in = argc > 1 ? fopen(argv[1], "rb") : stdin;
+    if (!in)
+    {
+        perror(argv[1]);
+        return 1;
+    }
+    BinLogDecoder decoder;
+    uint8_t buf[4096];
+    for (size_t n; (n = fread(buf, 1, sizeof(buf), in)) > 0;)
+        decoder.feed(buf, n, [](uint32_t ms, const char *text) { printf("[%10.3f] %s\n", ms / 1e3, text); });
+    if (in != stdin)
+        fclose(in);
+    fprintf(stderr, "logdecode: %llu records, %llu bytes skipped, %llu broken records\n",
+            (unsigned long long)decoder.decoded, (unsigned long long)decoder.skipped,
+            (unsigned long long)decoder.broken);
+    return 0;
+}
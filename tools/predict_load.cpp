@@ -0,0 +1,205 @@
+// Load generator for /predict: keeps C connections busy with closed-loop
+// POSTs (each sends its next request as soon as the previous response is
+// complete) and reports QPS and latency percentiles. Works against
+// predict_server and against main.py under gunicorn or Flask; when the
+// server closes the connection after each response, the next request goes
+// out on a fresh one and the connect is counted in its latency.
+//
+//   predict_load [--port P] [--connections C] [--seconds S]
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../host/bench.h"
+
+struct Client
+{
+    int fd = -1;
+    std::string request;
+    size_t sent = 0;
+    std::string response;
+    uint64_t startNs = 0;
+};
+
+static uint16_t port = 10000;
+static int epoll;
+static std::mt19937 rng(1);
+static uint64_t errors = 0, opened = 0;
+
+static void buildRequest(Client &c)
+{
+    char body[64];
+    int len = snprintf(body, sizeof(body), "{\"left_sensor\": %u, \"right_sensor\": %u}", unsigned(rng() & 1),
+                       unsigned(rng() & 1));
+    char head[256];
+    int headLen = snprintf(head, sizeof(head),
+                           "POST /predict HTTP/1.1\r\nHost: 127.0.0.1\r\nContent-Type: application/json\r\n"
+                           "Content-Length: %d\r\n\r\n",
+                           len);
+    c.request.assign(head, headLen);
+    c.request.append(body, len);
+    c.sent = 0;
+    c.response.clear();
+}
+
+static void watch(Client &c, uint32_t events, int op)
+{
+    epoll_event ev = {};
+    ev.events = events;
+    ev.data.ptr = &c;
+    epoll_ctl(epoll, op, c.fd, &ev);
+}
+
+static void openConnection(Client &c)
+{
+    if (c.fd >= 0)
+    {
+        epoll_ctl(epoll, EPOLL_CTL_DEL, c.fd, nullptr);
+        close(c.fd);
+    }
+    opened++;
+    c.fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+    int one = 1;
+    setsockopt(c.fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(port);
+    connect(c.fd, (sockaddr *)&addr, sizeof(addr)); // EINPROGRESS; EPOLLOUT reports the outcome
+    watch(c, EPOLLOUT, EPOLL_CTL_ADD);
+}
+
+static void startRequest(Client &c)
+{
+    buildRequest(c);
+    c.startNs = bench_now_ns();
+    if (c.fd < 0)
+        openConnection(c);
+    else
+        watch(c, EPOLLOUT, EPOLL_CTL_MOD);
+}
+
+// Returns 1 when a full response is buffered, 0 if more is needed, -1 on a
+// malformed one. Sets keepAlive from the response headers.
+static int responseComplete(const std::string &r, bool &keepAlive, int &status)
+{
+    size_t end = r.find("\r\n\r\n");
+    if (end == std::string::npos)
+        return 0;
+    if (sscanf(r.c_str(), "HTTP/1.%*d %d", &status) != 1)
+        return -1;
+    std::string head = r.substr(0, end);
+    for (char &ch : head)
+        ch = tolower((unsigned char)ch);
+    size_t at = head.find("\r\ncontent-length:");
+    if (at == std::string::npos)
+        return -1;
+    size_t length = strtoul(head.c_str() + at + 17, nullptr, 10);
+    keepAlive = head.find("\r\nconnection: close") == std::string::npos &&
+                (head.compare(0, 8, "http/1.1") == 0 || head.find("\r\nconnection: keep-alive") != std::string::npos);
+    return r.size() >= end + 4 + length ? 1 : 0;
+}
+
+int main(int argc, char **argv)
+{
+    int connections = 32;
+    double seconds = 5;
+    for (int i = 1; i < argc; i++)
+    {
+        bool hasValue = i + 1 < argc;
+        if (!strcmp(argv[i], "--port") && hasValue)
+            port = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--connections") && hasValue)
+            connections = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--seconds") && hasValue)
+            seconds = atof(argv[++i]);
+        else
+        {
+            fprintf(stderr, "usage: predict_load [--port P] [--connections C] [--seconds S]\n");
+            return 2;
+        }
+    }
+
+    epoll = epoll_create1(0);
+    std::vector<Client> clients(connections);
+    LatencySamples latency;
+    latency.reserve(1 << 20);
+    std::string sample;
+
+    uint64_t start = bench_now_ns();
+    uint64_t stop = start + uint64_t(seconds * 1e9);
+    for (Client &c : clients)
+        startRequest(c);
+
+    epoll_event events[256];
+    char buf[16384];
+    while (bench_now_ns() < stop)
+    {
+        int n = epoll_wait(epoll, events, 256, 100);
+        for (int i = 0; i < n; i++)
+        {
+            Client &c = *(Client *)events[i].data.ptr;
+            if (events[i].events & EPOLLOUT)
+            {
+                ssize_t w = send(c.fd, c.request.data() + c.sent, c.request.size() - c.sent, MSG_NOSIGNAL);
+                if (w < 0 && errno != EAGAIN)
+                {
+                    errors++;
+                    openConnection(c);
+                    continue;
+                }
+                if (w > 0)
+                    c.sent += w;
+                if (c.sent == c.request.size())
+                    watch(c, EPOLLIN, EPOLL_CTL_MOD);
+                continue;
+            }
+
+            ssize_t r;
+            bool closed = false;
+            while ((r = recv(c.fd, buf, sizeof(buf), 0)) > 0)
+                c.response.append(buf, r);
+            if (r == 0 || (r < 0 && errno != EAGAIN))
+                closed = true;
+
+            bool keepAlive = false;
+            int status = 0;
+            int done = responseComplete(c.response, keepAlive, status);
+            if (done == 0 && !closed)
+                continue;
+            if (done == 1 && status == 200)
+            {
+                latency.add(bench_now_ns() - c.startNs);
+                if (sample.empty())
+                    sample = c.response.substr(c.response.find("\r\n\r\n") + 4);
+            }
+            else
+                errors++;
+            if (done != 1 || closed || !keepAlive)
+            {
+                epoll_ctl(epoll, EPOLL_CTL_DEL, c.fd, nullptr);
+                close(c.fd);
+                c.fd = -1;
+            }
+            startRequest(c);
+        }
+    }
+    double elapsed = (bench_now_ns() - start) / 1e9;
+
+    printf("predict_load: port %u, %d connections, %.1f s\n", port, connections, elapsed);
+    printf("  %-22s %.0f req/s (%zu ok, %llu errors, %llu connections opened)\n", "throughput",
+           latency.count() / elapsed, latency.count(), (unsigned long long)errors, (unsigned long long)opened);
+    latency.report("latency", "ms", 1e6);
+    if (!sample.empty())
+        printf("  %-22s %s\n", "sample response", sample.c_str());
+    return latency.count() ? 0 : 1;
+}
@@ -0,0 +1,422 @@
+// Native /predict service with the same JSON contract as main.py, answered
+// from the forest tables the firmware uses (railway_fault_forest.h).
+//
+//   predict_server [--port P] [--threads N]
+//
+// Each worker thread runs its own epoll loop on a SO_REUSEPORT listener, so
+// the kernel spreads connections across workers with no shared queue.
+// Requests are micro-batched per wakeup: every complete request read from
+// the ready connections is parsed first, the batch is classified in one
+// pass over its feature columns, then all responses are written. At low
+// load a batch is a single request and nothing waits for company; under
+// load the batch grows with concurrency and amortizes the syscalls.
+//
+// GET /stats reports request and batch counters.
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <signal.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "../railway_fault_forest.h"
+
+#define MAX_HEADER_BYTES 8192
+#define MAX_BODY_BYTES 4096
+#define MAX_EVENTS 256
+
+static const char *const STATUS_NAMES[RAILWAY_FOREST_CLASSES] = {"Normal", "Crack_Left", "Crack_Right", "Break"};
+
+static std::atomic<uint64_t> requestCount(0), batchCount(0), predictCount(0);
+static std::atomic<uint32_t> largestBatch(0);
+
+struct Connection
+{
+    int fd;
+    std::string in;
+    std::string out;
+    bool closeAfterWrite = false;
+    bool wantWrite = false;
+};
+
+// One parsed request waiting for its response.
+struct Pending
+{
+    Connection *conn;
+    bool keepAlive;
+    int status;        // 0 while a prediction is still to be made
+    std::string body;  // response body when status is set
+    float left, right; // features for a prediction
+};
+
+// Value of "key": <number or numeric string> in a flat JSON object.
+// Returns false if the key is absent or null.
+static bool jsonNumber(const std::string &doc, const char *key, float &value, bool &valid)
+{
+    std::string needle = std::string("\"") + key + "\"";
+    size_t at = doc.find(needle);
+    if (at == std::string::npos)
+        return false;
+    at = doc.find(':', at + needle.size());
+    if (at == std::string::npos)
+        return false;
+    at = doc.find_first_not_of(" \t\r\n", at + 1);
+    if (at == std::string::npos || doc.compare(at, 4, "null") == 0)
+        return false;
+    if (doc[at] == '"')
+        at++;
+    char *end;
+    value = strtof(doc.c_str() + at, &end);
+    valid = end != doc.c_str() + at;
+    return true;
+}
+
+static void parsePredict(Pending &p, const std::string &body)
+{
+    bool leftValid = false, rightValid = false;
+    bool hasLeft = jsonNumber(body, "left_sensor", p.left, leftValid);
+    bool hasRight = jsonNumber(body, "right_sensor", p.right, rightValid);
+    if (!hasLeft || !hasRight)
+    {
+        p.status = 400;
+        p.body = "{\"error\":\"Missing left_sensor or right_sensor\"}";
+    }
+    else if (!leftValid || !rightValid)
+    {
+        p.status = 500;
+        p.body = "{\"error\":\"could not convert sensor value to float\"}";
+    }
+}
+
+// Severity by predicted class, as the device's runMLPrediction() sets it.
+// main.py's random bands (Normal 1-5, cracks 50-70, Break 80-100) give the
+// same words.
+static const char *const SEVERITY_NAMES[RAILWAY_FOREST_CLASSES] = {"Minor", "Moderate", "Moderate", "Critical"};
+
+// Keys in the order Flask's jsonify() sorts them. fault_percentage is the
+// forest's probability that the track is not Normal, as the device reports
+// it, rather than main.py's randomized band around a per-class base: a
+// crack main.py puts at 50-70 reads close to 100 here.
+static void formatPrediction(Pending &p, const float *proba)
+{
+    int pred = 0;
+    for (int c = 1; c < RAILWAY_FOREST_CLASSES; c++)
+        if (proba[c] > proba[pred])
+            pred = c;
+    float confidence = std::round(proba[pred] * 100.0f) / 100.0f;
+    float faultPercent = 100.0f * (1.0f - proba[0]);
+    const char *severity = SEVERITY_NAMES[pred];
+
+    char buf[256];
+    snprintf(buf, sizeof(buf),
+             "{\"confidence\":\"%.2f%%\",\"fault_percentage\":%.2f,\"prediction\":\"%s\",\"severity\":\"%s\"}",
+             confidence * 100.0f, faultPercent, STATUS_NAMES[pred], severity);
+    p.status = 200;
+    p.body = buf;
+}
+
+static void classifyBatch(std::vector<Pending> &batch)
+{
+    // Columns of the requests that still need the model
+    std::vector<size_t> rows;
+    std::vector<float> left, right;
+    for (size_t i = 0; i < batch.size(); i++)
+    {
+        if (batch[i].status)
+            continue;
+        rows.push_back(i);
+        left.push_back(batch[i].left);
+        right.push_back(batch[i].right);
+    }
+    std::vector<float> proba(rows.size() * RAILWAY_FOREST_CLASSES);
+    const float *columns[RAILWAY_FOREST_FEATURES] = {left.data(), right.data()};
+    railwayForest.predictProbaBatch(columns, rows.size(), proba.data());
+    for (size_t r = 0; r < rows.size(); r++)
+        formatPrediction(batch[rows[r]], &proba[r * RAILWAY_FOREST_CLASSES]);
+    predictCount += rows.size();
+}
+
+static void appendResponse(Pending &p)
+{
+    const char *reason = p.status == 200 ? "OK" : p.status == 400 ? "BAD REQUEST" : p.status == 404 ? "NOT FOUND"
+                       : p.status == 405 ? "METHOD NOT ALLOWED" : p.status == 413 ? "REQUEST ENTITY TOO LARGE"
+                       : "INTERNAL SERVER ERROR";
+    char head[192];
+    int len = snprintf(head, sizeof(head),
+                       "HTTP/1.1 %d %s\r\nContent-Type: application/json\r\nContent-Length: %zu\r\nConnection: %s\r\n\r\n",
+                       p.status, reason, p.body.size(), p.keepAlive ? "keep-alive" : "close");
+    p.conn->out.append(head, len);
+    p.conn->out += p.body;
+    if (!p.keepAlive)
+        p.conn->closeAfterWrite = true;
+}
+
+static std::string statsJson()
+{
+    char buf[256];
+    uint64_t batches = batchCount.load();
+    snprintf(buf, sizeof(buf),
+             "{\"requests\":%llu,\"predictions\":%llu,\"batches\":%llu,\"mean_batch\":%.2f,\"largest_batch\":%u}",
+             (unsigned long long)requestCount.load(), (unsigned long long)predictCount.load(),
+             (unsigned long long)batches, batches ? double(requestCount.load()) / batches : 0.0, largestBatch.load());
+    return buf;
+}
+
+// Parses every complete request in conn->in onto the batch. Returns false
+// if the connection sent something unusable and should be answered and
+// closed.
+static bool parseRequests(Connection *conn, std::vector<Pending> &batch)
+{
+    while (!conn->closeAfterWrite)
+    {
+        size_t headerEnd = conn->in.find("\r\n\r\n");
+        if (headerEnd == std::string::npos)
+            return conn->in.size() <= MAX_HEADER_BYTES;
+
+        // Request line as sent, header names and values lowercased
+        std::string head = conn->in.substr(0, headerEnd);
+        size_t lineEnd = head.find("\r\n");
+        std::string line = head.substr(0, lineEnd);
+        for (size_t i = line.size(); i < head.size(); i++)
+            head[i] = tolower((unsigned char)head[i]);
+        size_t contentLength = 0;
+        size_t at = head.find("\r\ncontent-length:");
+        if (at != std::string::npos)
+            contentLength = strtoul(head.c_str() + at + 17, nullptr, 10);
+        if (contentLength > MAX_BODY_BYTES)
+            return false;
+        if (conn->in.size() < headerEnd + 4 + contentLength)
+            return true;
+
+        Pending p = {conn, true, 0, std::string(), 0, 0};
+        bool http10 = line.size() >= 8 && line.compare(line.size() - 8, 8, "HTTP/1.0") == 0;
+        if (head.find("\r\nconnection: close") != std::string::npos)
+            p.keepAlive = false;
+        else if (http10)
+            p.keepAlive = head.find("\r\nconnection: keep-alive") != std::string::npos;
+
+        std::string method = line.substr(0, line.find(' '));
+        size_t pathStart = method.size() + 1;
+        std::string path = pathStart < line.size() ? line.substr(pathStart, line.find_first_of(" ?", pathStart) - pathStart) : "";
+        std::string body = conn->in.substr(headerEnd + 4, contentLength);
+        conn->in.erase(0, headerEnd + 4 + contentLength);
+
+        if (path == "/predict")
+        {
+            if (method != "POST")
+            {
+                p.status = 405;
+                p.body = "{\"error\":\"Method not allowed\"}";
+            }
+            else
+                parsePredict(p, body);
+        }
+        else if (path == "/" && method == "GET")
+        {
+            p.status = 200;
+            p.body = "{\"message\":\"\\ud83d\\ude86 Railway Fault Detection AI API is Live!\","
+                     "\"usage\":\"Send POST request to /predict with JSON { 'left_sensor': 0, 'right_sensor': 1 }\"}";
+        }
+        else if (path == "/stats" && method == "GET")
+        {
+            p.status = 200;
+            p.body = statsJson();
+        }
+        else
+        {
+            p.status = 404;
+            p.body = "{\"error\":\"Not found\"}";
+        }
+        batch.push_back(p);
+        if (!p.keepAlive)
+            conn->closeAfterWrite = true;
+    }
+    return true;
+}
+
+static void watch(int epoll, Connection *conn, bool wantWrite)
+{
+    if (conn->wantWrite == wantWrite)
+        return;
+    epoll_event ev = {};
+    ev.events = EPOLLIN | (wantWrite ? EPOLLOUT : 0);
+    ev.data.ptr = conn;
+    epoll_ctl(epoll, EPOLL_CTL_MOD, conn->fd, &ev);
+    conn->wantWrite = wantWrite;
+}
+
+static void closeConnection(int epoll, Connection *conn, std::unordered_map<int, Connection *> &conns)
+{
+    epoll_ctl(epoll, EPOLL_CTL_DEL, conn->fd, nullptr);
+    close(conn->fd);
+    conns.erase(conn->fd);
+    delete conn;
+}
+
+// Writes what the socket takes; returns false once the connection is done.
+static bool flush(int epoll, Connection *conn)
+{
+    while (!conn->out.empty())
+    {
+        ssize_t n = send(conn->fd, conn->out.data(), conn->out.size(), MSG_NOSIGNAL);
+        if (n < 0)
+        {
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+                watch(epoll, conn, true);
+                return true;
+            }
+            return false;
+        }
+        conn->out.erase(0, n);
+    }
+    watch(epoll, conn, false);
+    return !conn->closeAfterWrite;
+}
+
+static int listenOn(uint16_t port)
+{
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one));
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(port);
+    if (bind(fd, (sockaddr *)&addr, sizeof(addr)) < 0 || listen(fd, 1024) < 0)
+    {
+        perror("predict_server: listen");
+        exit(1);
+    }
+    return fd;
+}
+
+static void worker(uint16_t port)
+{
+    int listener = listenOn(port);
+    int epoll = epoll_create1(0);
+    epoll_event ev = {};
+    ev.events = EPOLLIN;
+    ev.data.ptr = nullptr;
+    epoll_ctl(epoll, EPOLL_CTL_ADD, listener, &ev);
+
+    std::unordered_map<int, Connection *> conns;
+    std::vector<Pending> batch;
+    std::vector<Connection *> touched;
+    epoll_event events[MAX_EVENTS];
+    char buf[16384];
+
+    for (;;)
+    {
+        int n = epoll_wait(epoll, events, MAX_EVENTS, -1);
+        batch.clear();
+        touched.clear();
+        for (int i = 0; i < n; i++)
+        {
+            Connection *conn = (Connection *)events[i].data.ptr;
+            if (!conn)
+            {
+                int fd;
+                while ((fd = accept4(listener, nullptr, nullptr, SOCK_NONBLOCK)) >= 0)
+                {
+                    int one = 1;
+                    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+                    Connection *c = new Connection();
+                    c->fd = fd;
+                    conns[fd] = c;
+                    epoll_event cev = {};
+                    cev.events = EPOLLIN;
+                    cev.data.ptr = c;
+                    epoll_ctl(epoll, EPOLL_CTL_ADD, fd, &cev);
+                }
+                continue;
+            }
+
+            bool open = true;
+            if (events[i].events & EPOLLIN)
+            {
+                ssize_t got;
+                while ((got = recv(conn->fd, buf, sizeof(buf), 0)) > 0)
+                    conn->in.append(buf, got);
+                if (got == 0 || (got < 0 && errno != EAGAIN && errno != EWOULDBLOCK))
+                    open = false;
+            }
+            if (events[i].events & (EPOLLERR | EPOLLHUP))
+                open = false;
+
+            size_t before = batch.size();
+            if (!parseRequests(conn, batch))
+            {
+                Pending p = {conn, false, 413, "{\"error\":\"Request too large\"}", 0, 0};
+                batch.push_back(p);
+                conn->closeAfterWrite = true;
+            }
+            if (!open && batch.size() == before && conn->out.empty())
+            {
+                closeConnection(epoll, conn, conns);
+                continue;
+            }
+            touched.push_back(conn);
+        }
+
+        if (!batch.empty())
+        {
+            classifyBatch(batch);
+            requestCount += batch.size();
+            batchCount++;
+            uint32_t size = batch.size();
+            uint32_t largest = largestBatch.load();
+            while (size > largest && !largestBatch.compare_exchange_weak(largest, size))
+                ;
+            for (Pending &p : batch)
+                appendResponse(p);
+        }
+        for (Connection *conn : touched)
+            if (!flush(epoll, conn))
+                closeConnection(epoll, conn, conns);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    uint16_t port = 10000;
+    unsigned threads = std::thread::hardware_concurrency();
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "--port") && i + 1 < argc)
+            port = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "--threads") && i + 1 < argc)
+            threads = atoi(argv[++i]);
+        else
+        {
+            fprintf(stderr, "usage: predict_server [--port P] [--threads N]\n");
+            return 2;
+        }
+    }
+    if (threads == 0)
+        threads = 1;
+    signal(SIGPIPE, SIG_IGN);
+
+    printf("predict_server: http://0.0.0.0:%u/predict, %u worker threads\n", port, threads);
+    fflush(stdout);
+    std::vector<std::thread> workers;
+    for (unsigned i = 0; i < threads; i++)
+        workers.emplace_back(worker, port);
+    for (std::thread &t : workers)
+        t.join();
+    return 0;
+}
@@ -0,0 +1,730 @@
+#pragma once
+// Decision-tree trainer for train_tree and bench_train: the same gini tree
+// wow.py fits with scikit-learn, grown from a CSV of any size.
+//
+// The CSV is memory-mapped and every thread works on its own stretch of
+// lines, in three passes: count the lines, parse a stride sample of them
+// for the cut points, then parse every line and write its bins, at most 256
+// a feature, straight into place at the thread's offset. The cut points
+// are the midpoints between neighbouring distinct values, so a two-valued
+// sensor column keeps the exact 0.5 threshold sklearn picks; a column with
+// more values than bins is cut at quantiles of the sample.
+//
+// No float column is ever held: a row costs a byte per feature, one for its
+// label and two for the node it is in, about 5 GB for 10^9 rows of the two
+// sensors.
+//
+// The tree grows a level at a time. One pass over the rows builds a class
+// histogram per (node, feature, bin) in each thread, the threads' histograms
+// are summed, and each open node's best split is read off its histogram by
+// a running sum over the bins. Rows carry the id of the node they are in and
+// are never sorted or copied into per-node lists. The open nodes can double
+// every level and each thread holds a histogram for all of them, so depth
+// stops at TRAIN_MAX_DEPTH.
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define TRAIN_MAX_BINS 256
+#define TRAIN_MAX_DEPTH 12
+#define TRAIN_SAMPLE_ROWS 262144
+#define TRAIN_NO_NODE 0xffffu
+static_assert((2 << TRAIN_MAX_DEPTH) - 1 < TRAIN_NO_NODE, "node ids are 16 bits");
+
+// Runs fn(thread, begin, end) over [0, count) cut into one range a thread;
+// the last range runs on the calling thread.
+template <typename Fn>
+inline void parallelRanges(unsigned threads, size_t count, Fn fn)
+{
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t + 1 < threads; t++)
+        pool.emplace_back([&fn, t, threads, count]() { fn(t, count * t / threads, count * (t + 1) / threads); });
+    fn(threads - 1, count * (threads - 1) / threads, count);
+    for (std::thread &thread : pool)
+        thread.join();
+}
+
+// One feature's cut points. bin(v) counts the cuts below v: an even grid
+// over the cuts gives a first guess, good to within the cuts in its cell,
+// so a column costs a couple of compares a row instead of a binary search.
+struct FeatureBins
+{
+    std::vector<double> cuts;
+
+    void index()
+    {
+        guess.assign(cuts.empty() ? 1 : 4096, 0);
+        lo = cuts.empty() ? 0 : cuts.front();
+        double span = cuts.empty() ? 0 : cuts.back() - lo;
+        scale = span > 0 ? (guess.size() - 1) / span : 0;
+        for (size_t k = 0; k < guess.size() && scale > 0; k++)
+            guess[k] = std::lower_bound(cuts.begin(), cuts.end(), lo + k / scale) - cuts.begin();
+    }
+
+    uint8_t bin(double v) const
+    {
+        double at = (v - lo) * scale;
+        size_t b = at <= 0 ? 0 : at >= guess.size() - 1 ? guess.back() : guess[size_t(at)];
+        while (b < cuts.size() && cuts[b] < v)
+            b++;
+        while (b > 0 && cuts[b - 1] >= v)
+            b--;
+        return b;
+    }
+
+private:
+    std::vector<uint8_t> guess;
+    double lo = 0, scale = 0;
+};
+
+struct TrainData
+{
+    std::vector<std::string> features;
+    std::vector<std::string> classes;
+    std::vector<FeatureBins> edges;           // edges[feature]
+    std::vector<std::vector<uint8_t>> binned; // binned[feature][row]
+    std::vector<uint8_t> labels;
+    uint64_t skipped = 0; // lines with the wrong field count, a bad number or an unknown label
+    size_t bytes = 0;
+
+    size_t rows() const { return labels.size(); }
+};
+
+// Plain decimal numbers, all the datasets hold; anything else goes through
+// strtod.
+inline bool parseNumber(const char *p, const char *end, float &out)
+{
+    static const double scale[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9,
+                                   1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18};
+    const char *start = p;
+    bool negative = p < end && *p == '-';
+    if (negative || (p < end && *p == '+'))
+        p++;
+    uint64_t mantissa = 0;
+    int digits = 0, fraction = -1;
+    for (; p < end; p++)
+    {
+        if (*p >= '0' && *p <= '9')
+        {
+            mantissa = mantissa * 10 + (*p - '0');
+            digits++;
+            if (fraction >= 0)
+                fraction++;
+        }
+        else if (*p == '.' && fraction < 0)
+            fraction = 0;
+        else
+            break;
+    }
+    if (p == end && digits > 0 && digits <= 18)
+    {
+        double v = double(mantissa) / scale[fraction > 0 ? fraction : 0];
+        out = float(negative ? -v : v);
+        return true;
+    }
+    char buf[64];
+    size_t n = end - start;
+    if (n == 0 || n >= sizeof(buf))
+        return false;
+    memcpy(buf, start, n);
+    buf[n] = '\0';
+    char *stop;
+    out = strtof(buf, &stop);
+    return stop == buf + n;
+}
+
+// Cut points for one feature from a sample of its values; sorts sample.
+inline std::vector<double> cutPoints(std::vector<float> &sample, int maxBins)
+{
+    sample.erase(std::remove_if(sample.begin(), sample.end(), [](float v) { return std::isnan(v); }), sample.end());
+    std::sort(sample.begin(), sample.end());
+    std::vector<float> distinct(sample);
+    distinct.erase(std::unique(distinct.begin(), distinct.end()), distinct.end());
+    std::vector<double> cuts;
+    if (distinct.size() <= size_t(maxBins))
+    {
+        for (size_t i = 1; i < distinct.size(); i++)
+            cuts.push_back(distinct[i - 1] / 2.0 + distinct[i] / 2.0);
+        return cuts;
+    }
+    for (int k = 1; k < maxBins; k++)
+    {
+        float at = sample[sample.size() * k / maxBins];
+        auto above = std::upper_bound(distinct.begin(), distinct.end(), at);
+        if (above == distinct.end())
+            break;
+        double cut = at / 2.0 + *above / 2.0;
+        if (cuts.empty() || cut > cuts.back())
+            cuts.push_back(cut);
+    }
+    return cuts;
+}
+
+// Loads the CSV at path. features names the feature columns, in order;
+// empty takes every column but the label. Labels are matched against
+// data.classes, which the caller fills in, or taken as a class index.
+// Features are binned into at most maxBins bins as they are read.
+inline bool loadCsv(const char *path, const char *label, const std::vector<std::string> &features, unsigned threads,
+                    TrainData &data, std::string &error, int maxBins = TRAIN_MAX_BINS)
+{
+    int fd = open(path, O_RDONLY);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) < 0)
+    {
+        error = std::string(path) + ": " + strerror(errno);
+        if (fd >= 0)
+            close(fd);
+        return false;
+    }
+    size_t size = st.st_size;
+    const char *text = size ? (const char *)mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0) : nullptr;
+    close(fd);
+    if (size && text == MAP_FAILED)
+    {
+        error = std::string(path) + ": mmap failed";
+        return false;
+    }
+    if (size)
+        madvise((void *)text, size, MADV_SEQUENTIAL);
+    const char *end = text + size;
+
+    // Header: which column is the label and which slot each feature takes.
+    const char *body = text ? (const char *)memchr(text, '\n', size) : nullptr;
+    body = body ? body + 1 : end;
+    std::vector<std::string> header;
+    for (const char *p = text; p < body;)
+    {
+        const char *q = p;
+        while (q < body && *q != ',' && *q != '\n' && *q != '\r')
+            q++;
+        header.emplace_back(p, q);
+        p = q < body && *q == ',' ? q + 1 : body;
+    }
+    int labelColumn = -1;
+    std::vector<int> slot(header.size(), -1);
+    data.features.clear();
+    for (size_t c = 0; c < header.size(); c++)
+        if (header[c] == label)
+            labelColumn = c;
+    if (features.empty())
+    {
+        for (size_t c = 0; c < header.size(); c++)
+            if (int(c) != labelColumn)
+            {
+                slot[c] = data.features.size();
+                data.features.push_back(header[c]);
+            }
+    }
+    else
+        for (const std::string &name : features)
+        {
+            size_t c = std::find(header.begin(), header.end(), name) - header.begin();
+            if (c == header.size())
+            {
+                error = "no column " + name;
+                break;
+            }
+            slot[c] = data.features.size();
+            data.features.push_back(name);
+        }
+    if (data.features.empty() && error.empty())
+        error = "no feature columns";
+    if (labelColumn < 0 && error.empty())
+        error = std::string("no label column ") + label;
+    if (data.classes.empty() || data.classes.size() > 256)
+        error = "between 1 and 256 classes";
+    if (!error.empty())
+    {
+        if (size)
+            munmap((void *)text, size);
+        return false;
+    }
+
+    // Each thread takes the lines that start in its stretch of the body.
+    size_t featureCount = data.features.size(), fieldCount = header.size();
+    std::vector<const char *> stretch(threads + 1, end);
+    for (unsigned t = 0; t < threads; t++)
+    {
+        const char *p = body + (end - body) * t / threads;
+        if (p > body && p[-1] != '\n')
+        {
+            const char *nl = (const char *)memchr(p, '\n', end - p);
+            p = nl ? nl + 1 : end;
+        }
+        stretch[t] = p;
+    }
+    // Calls fn(line, lineEnd, index) for every line of stretch t, index
+    // counting up from the one given.
+    auto eachLine = [&](unsigned t, size_t index, auto fn) {
+        for (const char *p = stretch[t], *stop = stretch[t + 1]; p < stop; index++)
+        {
+            const char *line = p, *eol = (const char *)memchr(p, '\n', end - p);
+            eol = eol ? eol : end;
+            p = eol + 1;
+            fn(line, eol > line && eol[-1] == '\r' ? eol - 1 : eol, index);
+        }
+    };
+    auto parseLine = [&](const char *line, const char *lineEnd, float *values, int &cls) {
+        if (lineEnd == line)
+            return false;
+        size_t field = 0;
+        cls = -1;
+        bool ok = true;
+        for (const char *f = line; ok && f <= lineEnd; field++)
+        {
+            const char *fe = (const char *)memchr(f, ',', lineEnd - f);
+            fe = fe ? fe : lineEnd;
+            if (field >= fieldCount)
+                ok = false;
+            else if (int(field) == labelColumn)
+            {
+                for (size_t k = 0; k < data.classes.size() && cls < 0; k++)
+                    if (data.classes[k].size() == size_t(fe - f) && !memcmp(data.classes[k].data(), f, fe - f))
+                        cls = k;
+                float index;
+                if (cls < 0 && parseNumber(f, fe, index) && index >= 0 && index < data.classes.size() &&
+                    index == int(index))
+                    cls = int(index);
+                ok = cls >= 0;
+            }
+            else if (slot[field] >= 0)
+                ok = parseNumber(f, fe, values[slot[field]]);
+            f = fe + 1;
+        }
+        return ok && field == fieldCount;
+    };
+
+    // Lines before each stretch, so rows can be written straight into place.
+    std::vector<size_t> first(threads + 1, 0);
+    parallelRanges(threads, threads, [&](unsigned, size_t from, size_t to) {
+        for (size_t t = from; t < to; t++)
+            eachLine(t, 0, [&](const char *, const char *, size_t) { first[t + 1]++; });
+    });
+    for (unsigned t = 0; t < threads; t++)
+        first[t + 1] += first[t];
+    size_t lines = first[threads], stride = std::max<size_t>(1, lines / TRAIN_SAMPLE_ROWS);
+
+    // Cut points from every stride-th line.
+    std::vector<std::vector<std::vector<float>>> samples(threads, std::vector<std::vector<float>>(featureCount));
+    parallelRanges(threads, threads, [&](unsigned, size_t from, size_t to) {
+        std::vector<float> values(featureCount);
+        int cls;
+        for (size_t t = from; t < to; t++)
+            eachLine(t, first[t], [&](const char *line, const char *lineEnd, size_t i) {
+                if (i % stride == 0 && parseLine(line, lineEnd, values.data(), cls))
+                    for (size_t k = 0; k < featureCount; k++)
+                        samples[t][k].push_back(values[k]);
+            });
+    });
+    data.edges.assign(featureCount, FeatureBins());
+    for (size_t k = 0; k < featureCount; k++)
+    {
+        std::vector<float> sample;
+        for (unsigned t = 0; t < threads; t++)
+        {
+            sample.insert(sample.end(), samples[t][k].begin(), samples[t][k].end());
+            std::vector<float>().swap(samples[t][k]);
+        }
+        data.edges[k].cuts = cutPoints(sample, maxBins);
+        data.edges[k].index();
+    }
+
+    // Every line, binned into its stretch's place; skipped lines leave
+    // room that is closed up after.
+    data.binned.assign(featureCount, std::vector<uint8_t>(lines));
+    data.labels.resize(lines);
+    std::vector<size_t> kept(threads, 0);
+    std::vector<uint64_t> skipped(threads, 0);
+    parallelRanges(threads, threads, [&](unsigned, size_t from, size_t to) {
+        std::vector<float> values(featureCount);
+        int cls;
+        for (size_t t = from; t < to; t++)
+            eachLine(t, 0, [&](const char *line, const char *lineEnd, size_t) {
+                if (!parseLine(line, lineEnd, values.data(), cls))
+                {
+                    skipped[t] += lineEnd != line;
+                    return;
+                }
+                size_t row = first[t] + kept[t]++;
+                for (size_t k = 0; k < featureCount; k++)
+                    data.binned[k][row] = data.edges[k].bin(values[k]);
+                data.labels[row] = cls;
+            });
+    });
+    size_t rows = 0;
+    data.skipped = 0;
+    for (unsigned t = 0; t < threads; t++)
+    {
+        if (rows != first[t])
+        {
+            for (size_t k = 0; k < featureCount; k++)
+                std::copy(data.binned[k].begin() + first[t], data.binned[k].begin() + first[t] + kept[t],
+                          data.binned[k].begin() + rows);
+            std::copy(data.labels.begin() + first[t], data.labels.begin() + first[t] + kept[t],
+                      data.labels.begin() + rows);
+        }
+        rows += kept[t];
+        data.skipped += skipped[t];
+    }
+    for (size_t k = 0; k < featureCount; k++)
+        data.binned[k].resize(rows);
+    data.labels.resize(rows);
+    data.bytes = size;
+    if (size)
+        munmap((void *)text, size);
+    return true;
+}
+
+struct TrainOptions
+{
+    int maxDepth = 3; // at most TRAIN_MAX_DEPTH
+    int maxBins = TRAIN_MAX_BINS; // loadCsv() bins the features
+    uint64_t minSamplesSplit = 2;
+    uint64_t minSamplesLeaf = 1;
+    double holdout = 0; // share of rows kept out of training for the confusion matrix
+    unsigned threads = 1;
+};
+
+struct TrainNode
+{
+    int feature = -1; // -1: leaf
+    uint8_t bin = 0;  // rows in this bin or lower go left
+    double threshold = 0;
+    int left = -1, right = -1;
+    int label = 0;
+    std::vector<uint64_t> counts; // training rows by class
+};
+
+class TreeTrainer
+{
+public:
+    TreeTrainer(const TrainData &data, const TrainOptions &options) : data(data), options(options) {}
+
+    void grow()
+    {
+        size_t rows = data.rows(), features = data.features.size(), classes = data.classes.size();
+        size_t bins = 1;
+        for (const FeatureBins &e : data.edges)
+            bins = std::max(bins, e.cuts.size() + 1);
+        nodes.assign(1, TrainNode());
+        nodeOf.resize(rows);
+        for (size_t r = 0; r < rows; r++)
+            nodeOf[r] = heldOut(r) ? TRAIN_NO_NODE : 0;
+
+        std::vector<int> open(1, 0);
+        for (int depth = 0; !open.empty(); depth++)
+        {
+            // Histograms of the open nodes: [slot][feature][bin][class].
+            std::vector<int> slotOf(nodes.size(), -1);
+            for (size_t s = 0; s < open.size(); s++)
+                slotOf[open[s]] = s;
+            size_t cells = open.size() * features * bins * classes;
+            std::vector<std::vector<uint64_t>> local(options.threads);
+            parallelRanges(options.threads, rows, [&](unsigned t, size_t from, size_t to) {
+                std::vector<uint64_t> &h = local[t];
+                h.assign(cells, 0);
+                for (size_t r = from; r < to; r++)
+                {
+                    uint32_t n = nodeOf[r];
+                    if (n == TRAIN_NO_NODE || slotOf[n] < 0)
+                        continue;
+                    size_t base = size_t(slotOf[n]) * features;
+                    for (size_t f = 0; f < features; f++)
+                        h[((base + f) * bins + data.binned[f][r]) * classes + data.labels[r]]++;
+                }
+            });
+            std::vector<uint64_t> &hist = local[0];
+            parallelRanges(options.threads, hist.size(), [&](unsigned, size_t from, size_t to) {
+                for (unsigned t = 1; t < options.threads; t++)
+                    for (size_t i = from; i < to; i++)
+                        hist[i] += local[t][i];
+            });
+
+            // Every open node's best split, one task per node and feature.
+            std::vector<BinSplit> best(open.size() * features);
+            std::atomic<size_t> next(0);
+            parallelRanges(options.threads, options.threads, [&](unsigned, size_t, size_t) {
+                std::vector<uint64_t> left(classes);
+                for (size_t task; (task = next++) < best.size();)
+                    best[task] = bestSplit(&hist[task * bins * classes],
+                                           data.edges[task % features].cuts.size() + 1, bins, classes, left);
+            });
+
+            std::vector<int> nextOpen;
+            std::vector<int> splitOf(nodes.size(), -1);
+            for (size_t s = 0; s < open.size(); s++)
+            {
+                int id = open[s];
+                TrainNode &node = nodes[id];
+                node.counts.assign(classes, 0);
+                for (size_t b = 0; b < bins; b++)
+                    for (size_t c = 0; c < classes; c++)
+                        node.counts[c] += hist[(s * features * bins + b) * classes + c];
+                node.label = std::max_element(node.counts.begin(), node.counts.end()) - node.counts.begin();
+                uint64_t total = 0;
+                for (uint64_t c : node.counts)
+                    total += c;
+                int feature = -1;
+                for (size_t f = 0; f < features; f++)
+                    if (best[s * features + f].bin >= 0 &&
+                        (feature < 0 || best[s * features + f].score > best[s * features + feature].score))
+                        feature = f;
+                bool pure = node.counts[node.label] == total;
+                if (depth >= std::min(options.maxDepth, TRAIN_MAX_DEPTH) || pure || total < options.minSamplesSplit ||
+                    feature < 0 || best[s * features + feature].score <= impurityScore(node.counts, total) * (1 + 1e-12))
+                    continue;
+                node.feature = feature;
+                node.bin = best[s * features + feature].bin;
+                node.threshold = data.edges[feature].cuts[node.bin];
+                node.left = nodes.size();
+                node.right = nodes.size() + 1;
+                splitOf[id] = feature;
+                nextOpen.push_back(node.left);
+                nextOpen.push_back(node.right);
+                nodes.emplace_back();
+                nodes.emplace_back();
+            }
+            open.swap(nextOpen);
+            if (open.empty())
+                break;
+            parallelRanges(options.threads, rows, [&](unsigned, size_t from, size_t to) {
+                for (size_t r = from; r < to; r++)
+                {
+                    uint32_t n = nodeOf[r];
+                    if (n == TRAIN_NO_NODE || n >= splitOf.size() || splitOf[n] < 0)
+                        continue;
+                    const TrainNode &node = nodes[n];
+                    nodeOf[r] = data.binned[node.feature][r] <= node.bin ? node.left : node.right;
+                }
+            });
+        }
+    }
+
+    // Confusion matrix over the held-out rows, or the training rows when
+    // nothing is held out: [actual * classes + predicted].
+    std::vector<uint64_t> evaluate() const
+    {
+        size_t classes = data.classes.size();
+        std::vector<std::vector<uint64_t>> local(options.threads, std::vector<uint64_t>(classes * classes));
+        parallelRanges(options.threads, data.rows(), [&](unsigned t, size_t from, size_t to) {
+            for (size_t r = from; r < to; r++)
+            {
+                if (options.holdout > 0 && !heldOut(r))
+                    continue;
+                int n = 0;
+                while (nodes[n].feature >= 0)
+                    n = data.binned[nodes[n].feature][r] <= nodes[n].bin ? nodes[n].left : nodes[n].right;
+                local[t][data.labels[r] * classes + nodes[n].label]++;
+            }
+        });
+        for (unsigned t = 1; t < options.threads; t++)
+            for (size_t i = 0; i < classes * classes; i++)
+                local[0][i] += local[t][i];
+        return local[0];
+    }
+
+    const std::vector<TrainNode> &tree() const { return nodes; }
+    size_t bins(int feature) const { return data.edges[feature].cuts.size() + 1; }
+
+private:
+    struct BinSplit
+    {
+        double score = -1;
+        int bin = -1; // -1: no cut keeps both sides big enough
+    };
+
+    bool heldOut(size_t row) const
+    {
+        return options.holdout > 0 && (uint64_t(row) * 0x9e3779b97f4a7c15ull >> 40) < options.holdout * (1 << 24);
+    }
+
+    // Gini impurity, up to a constant: the split maximizing the sum of
+    // sum(count^2) / n over its two sides is the one sklearn picks.
+    static double impurityScore(const std::vector<uint64_t> &counts, uint64_t total)
+    {
+        double s = 0;
+        for (uint64_t c : counts)
+            s += double(c) * c;
+        return total ? s / total : 0;
+    }
+
+    // The best cut of one node on one feature from its histogram h, which
+    // has used bins in use.
+    BinSplit bestSplit(const uint64_t *h, size_t used, size_t bins, size_t classes, std::vector<uint64_t> &left) const
+    {
+        BinSplit best;
+        std::vector<uint64_t> total(classes, 0);
+        uint64_t n = 0;
+        for (size_t b = 0; b < bins; b++)
+            for (size_t c = 0; c < classes; c++)
+                total[c] += h[b * classes + c];
+        for (uint64_t c : total)
+            n += c;
+        std::fill(left.begin(), left.end(), 0);
+        uint64_t nl = 0;
+        for (size_t b = 0; b + 1 < used; b++)
+        {
+            double sl = 0, sr = 0;
+            for (size_t c = 0; c < classes; c++)
+            {
+                left[c] += h[b * classes + c];
+                nl += h[b * classes + c];
+            }
+            uint64_t nr = n - nl;
+            if (nl < options.minSamplesLeaf || nr < options.minSamplesLeaf || nl == 0 || nr == 0)
+                continue;
+            for (size_t c = 0; c < classes; c++)
+            {
+                sl += double(left[c]) * left[c];
+                sr += double(total[c] - left[c]) * (total[c] - left[c]);
+            }
+            double score = sl / nl + sr / nr;
+            if (score > best.score)
+            {
+                best.score = score;
+                best.bin = b;
+            }
+        }
+        return best;
+    }
+
+    const TrainData &data;
+    TrainOptions options;
+    std::vector<uint16_t> nodeOf;
+    std::vector<TrainNode> nodes;
+};
+
+// Shortest text that reads back as v, the way Python prints a float.
+inline void formatThreshold(char *out, size_t size, double v)
+{
+    for (int precision = 1; precision <= 17; precision++)
+    {
+        snprintf(out, size, "%.*g", precision, v);
+        if (strtod(out, nullptr) == v)
+            break;
+    }
+    if (!strpbrk(out, ".eni"))
+        strncat(out, ".0", size - strlen(out) - 1);
+}
+
+inline void writeEloquentNode(FILE *f, const std::vector<TrainNode> &nodes, int n, int indent)
+{
+    const TrainNode &node = nodes[n];
+    if (node.feature < 0)
+    {
+        fprintf(f, "%*sreturn %d;\n", indent, "", node.label);
+        return;
+    }
+    char threshold[32];
+    formatThreshold(threshold, sizeof(threshold), node.threshold);
+    fprintf(f, "%*sif (x[%d] <= %s) {\n", indent, "", node.feature, threshold);
+    writeEloquentNode(f, nodes, node.left, indent + 4);
+    fprintf(f, "%*s}\n\n%*selse {\n", indent, "", indent, "");
+    writeEloquentNode(f, nodes, node.right, indent + 4);
+    fprintf(f, "%*s}\n", indent, "");
+}
+
+// railway_fault_model.h as micromlgen writes it for wow.py, so the sketch
+// and anything else built on Eloquent::ML::Port::DecisionTree take it as is.
+inline void writeEloquentTree(FILE *f, const std::vector<TrainNode> &nodes)
+{
+    fputs("#pragma once\n"
+          "#include <cstdarg>\n"
+          "namespace Eloquent {\n"
+          "    namespace ML {\n"
+          "        namespace Port {\n"
+          "            class DecisionTree {\n"
+          "                public:\n"
+          "                    /**\n"
+          "                    * Predict class for features vector\n"
+          "                    */\n"
+          "                    int predict(float *x) {\n",
+          f);
+    writeEloquentNode(f, nodes, 0, 24);
+    fputs("                    }\n"
+          "\n"
+          "                protected:\n"
+          "                };\n"
+          "            }\n"
+          "        }\n"
+          "    }",
+          f);
+}
+
+// railway_fault_tree.h: the node arrays src/tree_table.h compiles into a
+// lookup table, numbered depth-first like sklearn's.
+inline void writeTreeTable(FILE *f, const std::vector<TrainNode> &nodes, size_t features, size_t classes)
+{
+    std::vector<int> order, number(nodes.size());
+    std::vector<int> stack(1, 0);
+    while (!stack.empty())
+    {
+        int n = stack.back();
+        stack.pop_back();
+        number[n] = order.size();
+        order.push_back(n);
+        if (nodes[n].feature >= 0)
+        {
+            stack.push_back(nodes[n].right);
+            stack.push_back(nodes[n].left);
+        }
+    }
+    fprintf(f, "#pragma once\n"
+               "// Generated by train_tree from the same tree as railway_fault_model.h.\n"
+               "#include \"src/tree_table.h\"\n\n"
+               "#define RAILWAY_FAULT_FEATURES %zu\n"
+               "#define RAILWAY_FAULT_CLASSES %zu\n\n"
+               "// {feature, threshold, left, right, label}; feature -1 marks a leaf\n"
+               "static constexpr TreeNode RAILWAY_FAULT_TREE[] = {\n",
+            features, classes);
+    for (int n : order)
+    {
+        const TrainNode &node = nodes[n];
+        char threshold[32];
+        formatThreshold(threshold, sizeof(threshold), node.feature < 0 ? 0.0 : node.threshold);
+        if (node.feature < 0)
+            fprintf(f, "    {-1, %sf, -1, -1, %d},\n", threshold, node.label);
+        else
+            fprintf(f, "    {%d, %sf, %d, %d, 0},\n", node.feature, threshold, number[node.left], number[node.right]);
+    }
+    fputs("};\n", f);
+}
+
+// Rows are the actual class, columns the predicted one.
+inline void printConfusion(FILE *f, const std::vector<std::string> &classes, const std::vector<uint64_t> &confusion)
+{
+    size_t n = classes.size();
+    uint64_t total = 0, right = 0;
+    fprintf(f, "  %-14s", "actual \\ pred");
+    for (const std::string &c : classes)
+        fprintf(f, " %12.12s", c.c_str());
+    fprintf(f, " %9s\n", "recall");
+    for (size_t a = 0; a < n; a++)
+    {
+        uint64_t row = 0;
+        fprintf(f, "  %-14.14s", classes[a].c_str());
+        for (size_t p = 0; p < n; p++)
+        {
+            fprintf(f, " %12llu", (unsigned long long)confusion[a * n + p]);
+            row += confusion[a * n + p];
+        }
+        fprintf(f, " %8.2f%%\n", row ? 100.0 * confusion[a * n + a] / row : 0.0);
+        total += row;
+        right += confusion[a * n + a];
+    }
+    fprintf(f, "  accuracy %.4f%% of %llu rows\n", total ? 100.0 * right / total : 0.0, (unsigned long long)total);
+}
@@ -0,0 +1,76 @@
+import pickle
+import sys
+
+import numpy as np
+from sklearn.ensemble import RandomForestClassifier
+
+import features
+
+# Train the forest the firmware classifies with, on the windowed sensor
+# features of labeled traces (features.py, the same as src/features.h):
+#
+#   python gen_traces.py railway_fault_traces.csv 20 1
+#   python train_window.py [model.pkl] [trace.csv ...]
+#   python export_forest.py railway_fault_window.pkl railway_fault_window.h railway_fault_window.bin
+#
+# The held-out trace, host/tracks/glitchy.csv (gen_traces.py ... 2 2), is
+# scored per sample, and for the two things the window is for: glitches
+# that would have stopped the train, and how soon a real fault is called.
+# Some of its samples are kept in the model as check inputs; bench_features
+# replays that trace through the firmware's extractor and must get the
+# same feature values at those samples.
+
+model_path = sys.argv[1] if len(sys.argv) > 1 else "railway_fault_window.pkl"
+train_paths = sys.argv[2:] or ["railway_fault_traces.csv"]
+check_path = "host/tracks/glitchy.csv"
+EVERY = 2  # training takes every other sample; neighbours are near copies
+
+X, y = [], []
+for path in train_paths:
+    Xp, yp, _ = features.trace_features(path, EVERY)
+    X.append(Xp)
+    y.append(yp)
+X, y = np.concatenate(X), np.concatenate(y)
+assert (y >= 0).all(), "training traces need a status column"
+
+# Small enough to hot-swap: the image must fit MODEL_IMAGE_MAX (src/model_store.h)
+model = RandomForestClassifier(n_estimators=6, max_depth=5, min_samples_leaf=50, random_state=42)
+model.fit(X, y)
+
+X_test, y_test, index = features.trace_features(check_path)
+pred = model.predict(X_test)
+print("✅ Trained on %d samples from %d trace(s)" % (len(y), len(train_paths)))
+print("   held-out per-sample accuracy %.2f%%" % (100.0 * (pred == y_test).mean()))
+
+# Glitches: clear-track samples whose instantaneous pair is a fault
+glitch = (y_test == 0) & ((X_test[:, 0] > 0) | (X_test[:, 1] > 0))
+print("   glitch samples called Normal %.2f%% (%d samples; the bare pair calls none)" % (
+    100.0 * (pred[glitch] == 0).mean(), glitch.sum()))
+
+# Detection delay: from each fault's first sample to its first correct call
+delays, missed = [], 0
+onsets = np.flatnonzero((y_test[1:] != 0) & (y_test[:-1] == 0)) + 1
+for start in onsets:
+    stop = start
+    while stop < len(y_test) and y_test[stop] == y_test[start]:
+        stop += 1
+    hit = np.flatnonzero(pred[start:stop] == y_test[start])
+    if len(hit):
+        delays.append(hit[0] * features.SAMPLE_US / 1000.0)
+    else:
+        missed += 1
+print("   faults called %d/%d, delay median %.0f ms, max %.0f ms" % (
+    len(delays), len(onsets), np.median(delays), max(delays)))
+
+# Check samples for the exporter and bench_features: spread over the trace,
+# and around every fault onset where the features move fastest
+picks = sorted(set(list(range(0, len(index), len(index) // 32)) +
+                   [min(o + d, len(index) - 1) for o in onsets[:8] for d in (0, 2, 5, 20)]))
+model.check_inputs_ = X_test[picks]
+model.check_trace_ = check_path
+model.check_samples_ = index[picks]
+model.feature_names_ = features.NAMES
+
+with open(model_path, "wb") as f:
+    pickle.dump(model, f)
+print("✅ Model saved to %s" % model_path)
@@ -1,3 +1,5 @@
+# build/train_tree (tools/train_tree.cpp) fits the same tree natively and
+# writes both headers below; this script stays as the reference.
 from micromlgen import port
 from sklearn.tree import DecisionTreeClassifier
 import pandas as pd
@@ -15,7 +17,30 @@ model.fit(X, y)
 
 # Export model as Arduino C code
 c_code = port(model)
-with open("railway_fault_model.c", "w") as f:
+with open("railway_fault_model.h", "w") as f:
     f.write(c_code)
 
-print("✅ Model exported to railway_fault_model.c successfully!")
+print("✅ Model exported to railway_fault_model.h successfully!")
+
+# Export the same tree as plain node arrays; the firmware turns them into a
+# lookup table at compile time (src/tree_table.h)
+tree = model.tree_
+with open("railway_fault_tree.h", "w") as f:
+    f.write("#pragma once\n")
+    f.write("// Generated by wow.py from the same tree as railway_fault_model.h.\n")
+    f.write('#include "src/tree_table.h"\n\n')
+    f.write("#define RAILWAY_FAULT_FEATURES %d\n" % tree.n_features)
+    f.write("#define RAILWAY_FAULT_CLASSES %d\n\n" % len(model.classes_))
+    f.write("// {feature, threshold, left, right, label}; feature -1 marks a leaf\n")
+    f.write("static constexpr TreeNode RAILWAY_FAULT_TREE[] = {\n")
+    for i in range(tree.node_count):
+        leaf = tree.children_left[i] == -1
+        # repr() is the shortest text that reads back as the same double
+        f.write("    {%d, %sf, %d, %d, %d},\n" % (
+            -1 if leaf else tree.feature[i],
+            repr(0.0 if leaf else float(tree.threshold[i])),
+            tree.children_left[i], tree.children_right[i],
+            model.classes_[tree.value[i].argmax()] if leaf else 0))
+    f.write("};\n")
+
+print("✅ Tree table exported to railway_fault_tree.h")
@@ -1,44 +1,41 @@
-#include <Arduino.h>
-#include <EEPROM.h>
-#include <ESP8266WiFi.h>
-#include <ESP8266WebServer.h>
-#include "railway_fault_model.h"
+#include "src/hal.h"
+#include "src/binlog.h"
+#include "src/dashboard_gz.h"
+#include "src/device_state.h"
+#include "src/event_log.h"
+#include "src/event_stream.h"
+#include "src/features.h"
+#include "src/http_server.h"
+#include "src/json_writer.h"
+#include "src/metrics.h"
+#include "src/model_store.h"
+#include "src/scheduler.h"
+#include "src/sensors.h"
+#include "src/state_version.h"
+#include "src/stations.h"
+#include "src/telemetry.h"
+#include "src/trace.h"
+#include "railway_fault_tree.h"
+#include "railway_fault_window.h"
 
-using namespace Eloquent::ML::Port;
-DecisionTree model;
+// The exported tree, evaluated for every sensor pair at compile time
+constexpr TreeTable<RAILWAY_FAULT_FEATURES, RAILWAY_FAULT_CLASSES> model(RAILWAY_FAULT_TREE);
+static_assert(model.binarizable(), "classifyPair and the stop ISR read the sensors as bits");
 
-#define LOLIN_LED D4
 #define PRODUCTION 1
-String HOME = "/";
+const char *HOME = "/";
 
 unsigned long timestamp = 0;
 
 IPAddress local_ip(192, 168, 1, 1);
 IPAddress gateway(192, 168, 1, 1);
 IPAddress subnet(255, 255, 255, 0);
-ESP8266WebServer server(80);
+HttpServer server(80);
 
 const char *hotspot_name = "iota1107-rail";
 const char *hotspot_password = "iota1107";
 
-struct
-{
-    String message;
-    String message_class = "hide";
-    String left;
-    String left_class = "success";
-    String right;
-    String right_class = "success";
-    String btn_fwd = "FORWARD";
-    String btn_fwd_cmd;
-    String btn_fwd_class = "success";
-    String btn_stop = "STOP";
-    String btn_stop_cmd;
-    String btn_stop_class = "success";
-    String btn_back = "BACK";
-    String btn_back_cmd;
-    String btn_back_class = "success";
-} dataPacket;
+DeviceState state;
 
 struct
 {
@@ -49,65 +46,669 @@ struct
 } btnAction;
 int userBtnAction = btnAction.BTN_NONE;
 
+// What loop() is given and what it drives, for replaying an incident; the
+// last few seconds are served at /trace.bin.
+TraceRecorder traceRecorder;
+
+// Everything loop() does besides serving HTTP runs as a task here.
+#define MAX_TASKS 8
+Scheduler<MAX_TASKS> scheduler;
+int userActionTask = -1;
+
 #ifdef PRODUCTION
-String ai_status = "Unknown";
-String ai_class = "primary";
-float fault_percent = 0.0;
-String severity = "Unknown";
-
-String getDataJson()
-{
-    return "{\"message\":\"" + dataPacket.message + "\",\"message_class\":\"" + dataPacket.message_class + "\", "
-                                                                                                           "\"left\":\"" +
-           dataPacket.left + "\",\"left_class\":\"" + dataPacket.left_class + "\", "
-                                                                              "\"right\":\"" +
-           dataPacket.right + "\",\"right_class\":\"" + dataPacket.right_class + "\", "
-                                                                                 "\"btn_fwd\":\"" +
-           dataPacket.btn_fwd + "\",\"btn_fwd_class\":\"" + dataPacket.btn_fwd_class + "\", "
-                                                                                       "\"btn_stop\":\"" +
-           dataPacket.btn_stop + "\",\"btn_stop_class\":\"" + dataPacket.btn_stop_class + "\", "
-                                                                                          "\"btn_back\":\"" +
-           dataPacket.btn_back + "\",\"btn_back_class\":\"" + dataPacket.btn_back_class + "\", "
-                                                                                          "\"ai_status\":\"" +
-           ai_status + "\",\"fault_percent\":\"" + String(fault_percent) + "\",\"severity\":\"" + severity + "\",\"ai_class\":\"" + ai_class + "\"}";
+enum StateField
+{
+    F_MESSAGE,
+    F_MESSAGE_CLASS,
+    F_LEFT,
+    F_LEFT_CLASS,
+    F_RIGHT,
+    F_RIGHT_CLASS,
+    F_BTN_FWD,
+    F_BTN_FWD_CLASS,
+    F_BTN_STOP,
+    F_BTN_STOP_CLASS,
+    F_BTN_BACK,
+    F_BTN_BACK_CLASS,
+    F_AI_STATUS,
+    F_FAULT_PERCENT,
+    F_SEVERITY,
+    F_AI_CLASS,
+    F_CONFIDENCE,
+    F_STATIONS,
+    FIELD_COUNT
+};
+StateVersion<FIELD_COUNT> stateVersion;
+
+#if STATION_COUNT
+// The other stations' sensor pairs, scanned every STATION_SCAN_MS. A class
+// counts once it has held for STATION_HOLD_SCANS scans.
+#define STATION_SCAN_MS 10
+#define STATION_HOLD_SCANS 5
+StationArray<STATION_COUNT, STATION_HOLD_SCANS> stations;
+char stationMap[STATION_COUNT + 1];
+#endif
+
+char jsonBuffer[768 + STATION_COUNT];
+char messageBuffer[128];
+
+// Serializes the dashboard state into out without heap allocations. With
+// since > 0 only fields changed after that sequence number are written,
+// with since itself so a receiver can tell the delta's base.
+// Returns the length written, or 0 if out was too small.
+size_t writeDataJson(char *out, size_t size, uint32_t since = 0)
+{
+    StageTimer timer(S_DATA_JSON);
+    auto changed = [since](int field) { return since == 0 || stateVersion.changedSince(field, since); };
+
+    JsonWriter json(out, size);
+    json.beginObject();
+    json.field("epoch", long(stateVersion.epoch()));
+    json.field("seq", long(stateVersion.seq()));
+    if (since)
+        json.field("since", long(since));
+    if (changed(F_MESSAGE))
+    {
+        writeMessage(messageBuffer, sizeof(messageBuffer), state);
+        json.field("message", messageBuffer);
+    }
+    if (changed(F_MESSAGE_CLASS))
+        json.field("message_class", styleName(state.messageStyle));
+    if (changed(F_LEFT))
+        json.field("left", state.left ? "1" : "0");
+    if (changed(F_LEFT_CLASS))
+        json.field("left_class", styleName(state.leftStyle));
+    if (changed(F_RIGHT))
+        json.field("right", state.right ? "1" : "0");
+    if (changed(F_RIGHT_CLASS))
+        json.field("right_class", styleName(state.rightStyle));
+    if (changed(F_BTN_FWD))
+        json.field("btn_fwd", BTN_FWD_LABEL);
+    if (changed(F_BTN_FWD_CLASS))
+        json.field("btn_fwd_class", styleName(state.fwdStyle));
+    if (changed(F_BTN_STOP))
+        json.field("btn_stop", BTN_STOP_LABEL);
+    if (changed(F_BTN_STOP_CLASS))
+        json.field("btn_stop_class", styleName(state.stopStyle));
+    if (changed(F_BTN_BACK))
+        json.field("btn_back", BTN_BACK_LABEL);
+    if (changed(F_BTN_BACK_CLASS))
+        json.field("btn_back_class", styleName(state.backStyle));
+    if (changed(F_AI_STATUS))
+        json.field("ai_status", predictionName(state.prediction));
+    if (changed(F_FAULT_PERCENT))
+        json.fieldFixed("fault_percent", state.faultPercent);
+    if (changed(F_SEVERITY))
+        json.field("severity", severityName(state.severity));
+    if (changed(F_AI_CLASS))
+        json.field("ai_class", styleName(state.aiStyle));
+    if (changed(F_CONFIDENCE))
+        json.fieldFixed("confidence", state.confidence);
+#if STATION_COUNT
+    if (changed(F_STATIONS))
+    {
+        stations.writeMap(stationMap);
+        json.field("stations_in_fault", long(stations.inFault()));
+        json.field("station_map", stationMap);
+    }
+#endif
+    json.endObject();
+    return json.ok() ? json.length() : 0;
+}
+
+void sendDataJson(uint32_t since = 0)
+{
+    size_t len = writeDataJson(jsonBuffer, sizeof(jsonBuffer), since);
+    if (len)
+        server.send(200, "text/json", jsonBuffer, len);
+    else
+        server.send(500, "text/plain", "state too large");
+}
+
+#define MAX_EVENT_CLIENTS 4
+EventStream<MAX_EVENT_CLIENTS> events;
+char eventBuffer[800 + STATION_COUNT];
+
+// Pushes whatever loop() just changed to the /events subscribers.
+void pushState()
+{
+    StageTimer timer(S_PUSH_STATE);
+    events.publish(stateVersion.seq(), millis(), eventBuffer, sizeof(eventBuffer),
+                   [](uint32_t since, char *out, size_t size) { return writeDataJson(out, size, since); });
+}
+
+void setButtonClasses(Style fwd, Style stop, Style back)
+{
+    stateVersion.update(F_BTN_FWD_CLASS, state.fwdStyle, fwd);
+    stateVersion.update(F_BTN_STOP_CLASS, state.stopStyle, stop);
+    stateVersion.update(F_BTN_BACK_CLASS, state.backStyle, back);
 }
 
 #endif
 
+// A press of button 1 (forward), 2 (stop) or 3 (back), from /act or a
+// replayed trace; applyUserAction() carries it out.
+void pressButton(uint8_t button)
+{
+    userBtnAction = btnAction.BTN_FWD + button - 1;
+    traceRecorder.action(micros(), button);
+    scheduler.arm(userActionTask);
+}
+
 void handel_UserAction()
 {
+    uint8_t button = 0;
     for (uint8_t i = 0; i < server.args(); i++)
     {
-        if (server.argName(i) == "btn_fwd")
-        {
-            userBtnAction = btnAction.BTN_FWD;
-            dataPacket.btn_fwd_cmd = server.arg(i);
-        }
-        else if (server.argName(i) == "btn_stop")
-        {
-            userBtnAction = btnAction.BTN_STOP;
-            dataPacket.btn_stop_cmd = server.arg(i);
-        }
-        else if (server.argName(i) == "btn_back")
+        if (!strcmp(server.argName(i), "btn_fwd"))
+            button = 1;
+        else if (!strcmp(server.argName(i), "btn_stop"))
+            button = 2;
+        else if (!strcmp(server.argName(i), "btn_back"))
+            button = 3;
+    }
+    if (button)
+        pressButton(button);
+    sendDataJson();
+}
+
+void forwardTo(const char *location)
+{
+    server.sendHeader("Location", location);
+    server.send(302);
+}
+
+// The page lives gzip-compressed in flash (see gen_dashboard.py) and is
+// streamed from there as the socket drains, so serving it needs no heap copy.
+void handle_Home()
+{
+    StageTimer timer(S_HOME_PAGE);
+    server.sendHeader("ETag", DASHBOARD_ETAG);
+    server.sendHeader("Cache-Control", "no-cache");
+    if (!strcmp(server.header("If-None-Match"), DASHBOARD_ETAG))
+    {
+        server.send(304);
+        return;
+    }
+
+    server.sendHeader("Content-Encoding", "gzip");
+    server.send_P(200, "text/html", (PGM_P)DASHBOARD_GZ, DASHBOARD_GZ_LEN);
+}
+
+// Conditional polling: the ETag is "<epoch>-<seq>". A client that passes
+// ?epoch=E&since=N gets 304 when nothing changed, otherwise only the fields
+// that changed after N. A stale epoch (device rebooted) gets the full state.
+void handle_DataRequest()
+{
+    char etag[24];
+    snprintf(etag, sizeof(etag), "\"%lu-%lu\"", (unsigned long)stateVersion.epoch(), (unsigned long)stateVersion.seq());
+    server.sendHeader("ETag", etag);
+    server.sendHeader("Cache-Control", "no-cache");
+
+    uint32_t since = 0;
+    if (server.hasArg("since") && strtoul(server.arg("epoch"), nullptr, 10) == stateVersion.epoch())
+        since = strtoul(server.arg("since"), nullptr, 10);
+    if (since > stateVersion.seq())
+        since = 0;
+
+    if (!strcmp(server.header("If-None-Match"), etag) || (since && since == stateVersion.seq()))
+    {
+        server.send(304);
+        return;
+    }
+    sendDataJson(since);
+}
+
+bool aiFaultDetected = false;
+
+// Faults, stops and overrides, kept in the flash filesystem region across
+// reboots: 7 x 255 records.
+#define EVENT_LOG_SECTORS 8
+EventLog eventLog(FS_PHYS_ADDR, EVENT_LOG_SECTORS);
+
+// Forest images uploaded at /model, saved in the two sectors after the log.
+// They classify the windowed sensor features, as the compiled-in one does.
+static_assert(RAILWAY_WINDOW_FEATURES == FEATURE_COUNT, "railway_fault_window.h is out of date; see train_window.py");
+typedef Forest<RAILWAY_WINDOW_FEATURES, RAILWAY_WINDOW_CLASSES> RailwayForest;
+ModelStore modelStore(FS_PHYS_ADDR + EVENT_LOG_SECTORS * FLASH_SECTOR_SIZE, RAILWAY_WINDOW_FEATURES,
+                      RAILWAY_WINDOW_CLASSES);
+bool modelFlash = false;
+// What runMLPrediction() evaluates: the compiled-in forest until an image
+// is swapped in.
+RailwayForest forest = railwayWindow;
+
+// The sensor pair sampled every millisecond from its edges, and the
+// features of the last FEATURE_WINDOW samples.
+SensorWindow<FEATURE_WINDOW> sensorWindow;
+
+// Between inferences only, so each one runs on a single model.
+bool swapModel()
+{
+    if (!modelStore.swap())
+        return false;
+    forest = forestFromImage<RAILWAY_WINDOW_FEATURES, RAILWAY_WINDOW_CLASSES>(modelStore.active());
+    eventLog.append(EV_MODEL, modelStore.source());
+    return true;
+}
+
+#define HISTORY_RECORD_MAX 100 // longest record as JSON, with its comma
+
+// The event log as a JSON array, oldest first, read from flash a response
+// buffer at a time, so the size of the log does not matter. The cursor is
+// the last sequence number sent; count is how many have been.
+size_t writeHistory(char *out, size_t size, HttpStream &stream)
+{
+    if (stream.cursor == UINT32_MAX)
+        return 0;
+    size_t len = 0;
+    if (!stream.count && !stream.cursor)
+    {
+        out[len++] = '[';
+        stream.cursor = stream.arg;
+    }
+    bool full = false;
+    eventLog.forEach(stream.cursor, [&](const LogRecord &r) {
+        if (full || len + HISTORY_RECORD_MAX > size)
         {
-            userBtnAction = btnAction.BTN_BACK;
-            dataPacket.btn_back_cmd = server.arg(i);
+            full = true;
+            return;
         }
+        len += snprintf(out + len, size - len, "%s{\"seq\":%lu,\"boot\":%u,\"t_ms\":%lu,\"event\":\"%s\",\"arg\":%u}",
+                        stream.count ? "," : "", (unsigned long)r.seq, r.boot, (unsigned long)r.uptimeMs,
+                        logEventName(r.type), r.arg);
+        stream.cursor = r.seq;
+        stream.count++;
+    });
+    if (!full)
+    {
+        out[len++] = ']';
+        stream.cursor = UINT32_MAX;
     }
-    server.send(200, "text/json", getDataJson());
+    return len;
 }
 
-void forwardTo(String location)
+// ?since=N returns only records after sequence number N.
+void handle_History()
 {
-    server.sendHeader("Location", location, true);
-    server.send(302, "text/plain", "");
+    uint32_t since = strtoul(server.arg("since"), nullptr, 10);
+    server.sendStream(200, "text/json", writeHistory, since < UINT32_MAX ? since : 0);
 }
 
-void handle_Home() { server.send(200, "text/html", getTemplate()); }
-void handle_DataRequest() { server.send(200, "text/json", getDataJson()); }
+// The same state as /data.json in a 28-byte record for collectors; see
+// src/telemetry.h for the layout. out must hold TELEMETRY_V1_SIZE bytes.
+size_t writeTelemetry(uint8_t *out)
+{
+    Telemetry t;
+    t.epoch = stateVersion.epoch();
+    t.seq = stateVersion.seq();
+    t.uptimeMs = millis();
+    t.flags = (state.left ? TELEMETRY_LEFT : 0) | (state.right ? TELEMETRY_RIGHT : 0) |
+              (digitalRead(BUZZER_PIN) ? TELEMETRY_BUZZER : 0) | (aiFaultDetected ? TELEMETRY_FAULT : 0);
+    t.prediction = state.prediction;
+    t.severity = state.severity;
+    t.motor = (digitalRead(MLP_PIN) ? MOTOR_FORWARD : 0) | (digitalRead(MLN_PIN) ? MOTOR_BACK : 0);
+    t.confidence = telemetryPercent(state.confidence);
+    t.faultPercent = telemetryPercent(state.faultPercent);
+    t.safetyStops = safetyStops.load();
+    return encodeTelemetry(t, out);
+}
+
+void handle_BinaryData()
+{
+    uint8_t record[TELEMETRY_V1_SIZE];
+    size_t len = writeTelemetry(record);
+    server.sendHeader("Cache-Control", "no-cache");
+    server.send(200, "application/octet-stream", (const char *)record, len);
+}
+
+#if STATION_COUNT
+#define STATION_RECORD_MAX 112
+
+// Every station on the chain; the cursor is the next one to write.
+size_t writeStations(char *out, size_t size, HttpStream &stream)
+{
+    if (stream.cursor > STATION_COUNT)
+        return 0;
+    size_t len = 0;
+    if (!stream.count++)
+        len = snprintf(out, size, "{\"count\":%d,\"in_fault\":%lu,\"stations\":[", STATION_COUNT,
+                       (unsigned long)stations.inFault());
+    for (; stream.cursor < STATION_COUNT && len + STATION_RECORD_MAX <= size; stream.cursor++)
+    {
+        int s = stream.cursor;
+        len += snprintf(out + len, size - len,
+                        "%s{\"id\":%d,\"left\":%d,\"right\":%d,\"status\":\"%s\",\"faults\":%lu,\"since_ms\":%lu}",
+                        s ? "," : "", s, stations.leftOf(s), stations.rightOf(s),
+                        predictionName(Prediction(stations.classOf(s))), (unsigned long)stations.faults(s),
+                        stations.fault(s) ? (unsigned long)stations.faultSince(s) : 0ul);
+    }
+    if (stream.cursor == STATION_COUNT && len + 2 < size)
+    {
+        out[len++] = ']';
+        out[len++] = '}';
+        stream.cursor++;
+    }
+    return len;
+}
+
+void handle_Stations() { server.sendStream(200, "text/json", writeStations); }
+#endif
+
+// Server-sent events: the connection stays open and pushState() writes to it.
+void handle_Events()
+{
+    if (events.subscribe(server.client()))
+        server.detach();
+    else
+        server.send(503, "text/plain", "too many event clients");
+}
+
+size_t writeModelInfo(char *out, size_t size)
+{
+    const ModelHeader *h = modelStore.header();
+    JsonWriter json(out, size);
+    json.beginObject();
+    json.field("source", modelSourceName(modelStore.source()));
+    json.field("generation", long(modelStore.generation()));
+    json.field("model_id", long(h ? h->modelId : 0));
+    json.field("trees", long(h ? h->weightSum : RAILWAY_WINDOW_TREES));
+    json.field("nodes", long(h ? h->nodes : RAILWAY_WINDOW_NODES));
+    json.field("size", long(h ? h->size : 0));
+    json.field("swaps", long(modelStore.swaps()));
+    json.field("pending", modelStore.busy() ? "1" : "0");
+    json.field("last_error", modelErrorName(modelStore.lastError()));
+    json.endObject();
+    return json.ok() ? json.length() : 0;
+}
+
+void handle_Model()
+{
+    char info[256];
+    size_t len = writeModelInfo(info, sizeof(info));
+    server.sendHeader("Cache-Control", "no-cache");
+    server.send(200, "text/json", info, len);
+}
+
+// POST /model with a forest image from export_forest.py. It is checked once
+// all of it is in, then swapped in by the sensors task and saved to flash.
+int receiveModel(const uint8_t *data, size_t length, uint32_t offset, uint32_t total)
+{
+    if (!modelFlash)
+        return 503;
+    ModelError e = data ? modelStore.writeUpload(data, length, offset) : modelStore.beginUpload(total);
+    if (e == MODEL_OK)
+        return 0;
+    return e == MODEL_BUSY ? 503 : e == MODEL_TOO_LARGE ? 413 : 400;
+}
+
+void handle_ModelUploaded()
+{
+    ModelError e = modelStore.endUpload();
+    if (e != MODEL_OK)
+    {
+        server.send(e == MODEL_BUSY ? 503 : 400, "text/plain", modelErrorName(e));
+        return;
+    }
+    traceRecorder.model(micros(), MODEL_UPLOAD, modelStore.stagedHeader()->modelId);
+    handle_Model();
+}
+
+// The trace recorder's header, then its blocks oldest first. A block still
+// being filled goes as it is; one dropped while the response is under way
+// leaves a sequence gap that the reader reports. The cursor is the next
+// block sequence number to send.
+size_t writeTrace(char *out, size_t size, HttpStream &stream)
+{
+    size_t len = 0;
+    if (!stream.count++)
+    {
+        memcpy(out, &traceRecorder.header(), sizeof(TraceHeader));
+        len = sizeof(TraceHeader);
+        stream.cursor = ((const TraceBlockHeader *)traceRecorder.block(0))->seq;
+    }
+    for (uint32_t i = 0; i < traceRecorder.blocks() && len + TRACE_BLOCK_SIZE <= size; i++)
+    {
+        const TraceBlockHeader *b = (const TraceBlockHeader *)traceRecorder.block(i);
+        if (int32_t(b->seq - stream.cursor) < 0)
+            continue;
+        memcpy(out + len, b, TRACE_BLOCK_SIZE);
+        len += TRACE_BLOCK_SIZE;
+        stream.cursor = b->seq + 1;
+    }
+    return len;
+}
+
+void handle_Trace()
+{
+    server.sendHeader("Cache-Control", "no-cache");
+    server.sendStream(200, "application/octet-stream", writeTrace);
+}
+
+void traceRequest()
+{
+    uint8_t method = server.isUpload() ? TRACE_UPLOAD : server.isHead() ? TRACE_HEAD : TRACE_GET;
+    traceRecorder.request(micros(), method, server.uri());
+}
 
 void handle_NotFound() { forwardTo(HOME); }
 
+uint32_t faultCount = 0;
+
+// How long an interrupt stop waits for the window classifier to call a
+// fault before it counts as a glitch (and, with SENSOR_GLITCH_RESUME, the
+// train moves on); longer than any misread it must ride out, short enough
+// that nobody notices the hitch.
+#define FEATURE_CONFIRM_MS 20
+uint32_t glitchDeadline = 0; // 0: no interrupt stop waiting to be confirmed
+uint32_t glitchFaults = 0;   // faultCount when it stopped
+uint32_t sensorGlitches = 0;
+
+// With nothing to do loop() waits in esp_delay(); see idleUntilNeeded().
+#define IDLE_POLL_MS 1 // how often a wait looks for a client
+bool idleSleep = true;
+uint32_t idleWaits = 0;
+uint32_t idleEarlyWakes = 0; // ended by a sensor edge or a client
+uint64_t idleUs = 0;
+
+#define TASK_FAMILIES 5
+
+// One metric family of per-task scheduler statistics. Returns 0 if it does
+// not fit in out.
+size_t writeTaskMetrics(char *out, size_t size, int family)
+{
+    static const char *const headers[TASK_FAMILIES] = {
+        "# TYPE rail_task_runs_total counter\n",
+        "# HELP rail_task_lateness_seconds How long after its due time a task started.\n"
+        "# TYPE rail_task_lateness_seconds summary\n",
+        "# TYPE rail_task_lateness_seconds_max gauge\n",
+        "# HELP rail_task_overruns_total Runs that finished past the task's deadline.\n"
+        "# TYPE rail_task_overruns_total counter\n",
+        "# HELP rail_task_skipped_total Periods dropped because the task ran too late.\n"
+        "# TYPE rail_task_skipped_total counter\n",
+    };
+    size_t len = snprintf(out, size, "%s", headers[family]);
+    for (int id = 0; id < scheduler.count() && len < size; id++)
+    {
+        const TaskStats &s = scheduler.stats(id);
+        const char *name = scheduler.name(id);
+        if (family == 0)
+            len += snprintf(out + len, size - len, "rail_task_runs_total{task=\"%s\"} %lu\n", name,
+                            (unsigned long)s.runs);
+        else if (family == 1)
+            len += snprintf(out + len, size - len,
+                            "rail_task_lateness_seconds_sum{task=\"%s\"} %.9g\n"
+                            "rail_task_lateness_seconds_count{task=\"%s\"} %lu\n",
+                            name, s.totalLateUs * 1e-6, name, (unsigned long)s.runs);
+        else if (family == 2)
+            len += snprintf(out + len, size - len, "rail_task_lateness_seconds_max{task=\"%s\"} %.9g\n", name,
+                            s.maxLateUs * 1e-6);
+        else if (family == 3)
+            len += snprintf(out + len, size - len, "rail_task_overruns_total{task=\"%s\"} %lu\n", name,
+                            (unsigned long)s.overruns);
+        else
+            len += snprintf(out + len, size - len, "rail_task_skipped_total{task=\"%s\"} %lu\n", name,
+                            (unsigned long)s.skipped);
+    }
+    return len < size ? len : 0;
+}
+
+// The counters at the end of /metrics. Returns 0 if they do not fit.
+size_t writeCounterMetrics(char *out, size_t size)
+{
+    const HttpServerStats &http = server.stats();
+    int len = snprintf(out, size,
+                       "# TYPE rail_http_requests_total counter\n"
+                       "rail_http_requests_total %lu\n"
+                       "# TYPE rail_http_connections gauge\n"
+                       "rail_http_connections %d\n"
+                       "# TYPE rail_http_connections_total counter\n"
+                       "rail_http_connections_total %lu\n"
+                       "# HELP rail_http_evictions_total Idle keep-alive connections closed for a waiting client.\n"
+                       "# TYPE rail_http_evictions_total counter\n"
+                       "rail_http_evictions_total %lu\n"
+                       "# TYPE rail_http_timeouts_total counter\n"
+                       "rail_http_timeouts_total %lu\n"
+                       "# HELP rail_http_rejected_total Malformed or oversized requests.\n"
+                       "# TYPE rail_http_rejected_total counter\n"
+                       "rail_http_rejected_total %lu\n"
+                       "# TYPE rail_faults_total counter\n"
+                       "rail_faults_total %lu\n",
+                       (unsigned long)http.requests, server.openConnections(), (unsigned long)http.accepted,
+                       (unsigned long)http.evicted, (unsigned long)http.timedOut, (unsigned long)http.rejected,
+                       (unsigned long)faultCount);
+    return len > 0 && size_t(len) < size ? len : 0;
+}
+
+// The sensor and model counters, after the others.
+size_t writeSensorMetrics(char *out, size_t size)
+{
+    int len = snprintf(out, size,
+                       "# HELP rail_safety_stops_total Motor stops made by the sensor interrupt.\n"
+                       "# TYPE rail_safety_stops_total counter\n"
+                       "rail_safety_stops_total %lu\n"
+                       "# TYPE rail_sensor_edges_total counter\n"
+                       "rail_sensor_edges_total %lu\n"
+                       "# TYPE rail_sensor_edges_dropped_total counter\n"
+                       "rail_sensor_edges_dropped_total %lu\n"
+                       "# HELP rail_sensor_glitches_total Interrupt stops the window classifier did not confirm.\n"
+                       "# TYPE rail_sensor_glitches_total counter\n"
+                       "rail_sensor_glitches_total %lu\n"
+                       "# TYPE rail_model_swaps_total counter\n"
+                       "rail_model_swaps_total %lu\n"
+                       "# HELP rail_model_rejected_total Model images that failed their checks.\n"
+                       "# TYPE rail_model_rejected_total counter\n"
+                       "rail_model_rejected_total %lu\n"
+                       "# TYPE rail_model_generation gauge\n"
+                       "rail_model_generation %lu\n"
+                       "# TYPE rail_free_heap_bytes gauge\n"
+                       "rail_free_heap_bytes %lu\n",
+                       (unsigned long)safetyStops.load(), (unsigned long)sensorEvents.pushed(),
+                       (unsigned long)sensorEvents.dropped(), (unsigned long)sensorGlitches,
+                       (unsigned long)modelStore.swaps(), (unsigned long)modelStore.rejected(),
+                       (unsigned long)modelStore.generation(), (unsigned long)ESP.getFreeHeap());
+#if STATION_COUNT
+    if (len > 0 && size_t(len) < size)
+        len += snprintf(out + len, size - len,
+                        "# HELP rail_stations_in_fault Stations on the chain whose pair classifies as a fault.\n"
+                        "# TYPE rail_stations_in_fault gauge\n"
+                        "rail_stations_in_fault %lu\n",
+                        (unsigned long)stations.inFault());
+#endif
+    return len > 0 && size_t(len) < size ? len : 0;
+}
+
+// The console log's counters.
+size_t writeLogMetrics(char *out, size_t size)
+{
+    int len = snprintf(out, size,
+                       "# TYPE rail_log_records_total counter\n"
+                       "rail_log_records_total %lu\n"
+                       "# HELP rail_log_dropped_total Console records dropped because the ring was full.\n"
+                       "# TYPE rail_log_dropped_total counter\n"
+                       "rail_log_dropped_total %lu\n"
+                       "# TYPE rail_log_bytes_total counter\n"
+                       "rail_log_bytes_total %llu\n"
+                       "# TYPE rail_log_pending_bytes gauge\n"
+                       "rail_log_pending_bytes %lu\n",
+                       (unsigned long)binLog.records(), (unsigned long)binLog.dropped(),
+                       (unsigned long long)binLog.bytesSent(), (unsigned long)binLog.pending());
+    return len > 0 && size_t(len) < size ? len : 0;
+}
+
+// The idle waits, last.
+size_t writeIdleMetrics(char *out, size_t size)
+{
+    int len = snprintf(out, size,
+                       "# HELP rail_idle_seconds_total Time loop() waited in esp_delay() for work.\n"
+                       "# TYPE rail_idle_seconds_total counter\n"
+                       "rail_idle_seconds_total %.9g\n"
+                       "# TYPE rail_idle_waits_total counter\n"
+                       "rail_idle_waits_total %lu\n"
+                       "# HELP rail_idle_early_wakes_total Waits ended by a sensor edge or a client.\n"
+                       "# TYPE rail_idle_early_wakes_total counter\n"
+                       "rail_idle_early_wakes_total %lu\n",
+                       idleUs / 1e6, (unsigned long)idleWaits, (unsigned long)idleEarlyWakes);
+    return len > 0 && size_t(len) < size ? len : 0;
+}
+
+// Prometheus text format, produced a response buffer at a time: the stage
+// histograms, the task families, then the counters. The cursor is the
+// section in the high bits and the line within a stage in the low byte.
+size_t writeMetrics(char *out, size_t size, HttpStream &stream)
+{
+    size_t len = 0;
+    for (;;)
+    {
+        uint32_t section = stream.cursor >> 8;
+        size_t n;
+        if (section < STAGE_COUNT)
+        {
+            int line = stream.cursor & 0xff;
+            len += writeStageMetrics(out + len, size - len, section, line);
+            if (line < STAGE_METRIC_LINES)
+            {
+                stream.cursor = section << 8 | line;
+                return len;
+            }
+        }
+        else if (section < STAGE_COUNT + TASK_FAMILIES)
+        {
+            if (!(n = writeTaskMetrics(out + len, size - len, section - STAGE_COUNT)))
+                return len;
+            len += n;
+        }
+        else if (section == STAGE_COUNT + TASK_FAMILIES)
+        {
+            if (!(n = writeCounterMetrics(out + len, size - len)))
+                return len;
+            len += n;
+        }
+        else if (section == STAGE_COUNT + TASK_FAMILIES + 1)
+        {
+            if (!(n = writeSensorMetrics(out + len, size - len)))
+                return len;
+            len += n;
+        }
+        else if (section == STAGE_COUNT + TASK_FAMILIES + 2)
+        {
+            if (!(n = writeLogMetrics(out + len, size - len)))
+                return len;
+            len += n;
+        }
+        else if (section == STAGE_COUNT + TASK_FAMILIES + 3)
+        {
+            if (!(n = writeIdleMetrics(out + len, size - len)))
+                return len;
+            len += n;
+        }
+        else
+            return len;
+        stream.cursor = (section + 1) << 8;
+    }
+}
+
+void handle_Metrics() { server.sendStream(200, "text/plain; version=0.0.4", writeMetrics); }
+
 void setUpServer()
 {
     delay(500);
@@ -115,571 +716,381 @@ void setUpServer()
     WiFi.softAPConfig(local_ip, gateway, subnet);
     delay(100);
 
+    const char *headerKeys[] = {"If-None-Match"};
+    server.collectHeaders(headerKeys, 1);
     server.on("/", handle_Home);
     server.on("/act", handel_UserAction);
     server.on("/data.json", handle_DataRequest);
+    server.on("/data.bin", handle_BinaryData);
+    server.on("/events", handle_Events);
+    server.on("/history", handle_History);
+    server.on("/metrics", handle_Metrics);
+    server.on("/model", handle_Model);
+    server.onUpload("/model", receiveModel, handle_ModelUploaded);
+    server.on("/trace.bin", handle_Trace);
+#if STATION_COUNT
+    server.on("/stations.json", handle_Stations);
+#endif
     server.onNotFound(handle_NotFound);
+    server.onRequest(traceRequest);
     server.begin();
     delay(300);
-    Serial.println("server started.");
+    binLog.log(LOG_SERVER_STARTED);
 }
 
-#define IRL_PIN D1
-#define IRR_PIN D2
-#define MLP_PIN D5
-#define MLN_PIN D6
-#define BUZZER_PIN D7
-
 void setUpGPIO()
 {
     pinMode(LOLIN_LED, OUTPUT);
     pinMode(BUZZER_PIN, OUTPUT);
-    pinMode(IRL_PIN, INPUT);
-    pinMode(IRR_PIN, INPUT);
     pinMode(MLP_PIN, OUTPUT);
     pinMode(MLN_PIN, OUTPUT);
+#if STATION_COUNT
+    stations.begin(model, STATION_LOAD_PIN, STATION_CLOCK_PIN, STATION_DATA_PIN);
+#endif
 }
 
-uint32_t led_time_stamp = 0;
-void blinkLed(int mil)
+void blinkLed() { digitalWrite(LOLIN_LED, !digitalRead(LOLIN_LED)); }
+
+uint32_t sensorDropsSeen = 0;
+uint32_t safetyStopsLogged = 0;
+
+void runMLPrediction();
+void setUpTasks();
+
+uint8_t traceOutputs()
 {
-    if (led_time_stamp + mil < millis())
-    {
-        led_time_stamp = millis();
-        digitalWrite(LOLIN_LED, !digitalRead(LOLIN_LED));
-    }
+    return (digitalRead(MLP_PIN) ? TRACE_OUT_FORWARD : 0) | (digitalRead(MLN_PIN) ? TRACE_OUT_BACK : 0) |
+           (digitalRead(BUZZER_PIN) ? TRACE_OUT_BUZZER : 0);
 }
 
-uint32_t lcd_update_time = 0;
-bool aiFaultDetected = false;
+int classifyPair(int left, int right)
+{
+    return model.predict((left ? 1 : 0) | (right ? 2 : 0));
+}
 
 void setup()
 {
     delay(500);
     Serial.begin(115200);
-    Serial.println("\n\nstarting...");
+    binLog.log(LOG_BOOT);
+    stateVersion.begin(ESP.random());
+    if (FS_PHYS_SIZE < EVENT_LOG_SECTORS * FLASH_SECTOR_SIZE || !eventLog.begin())
+        binLog.log(LOG_NO_EVENT_LOG);
+    modelFlash = FS_PHYS_SIZE >= (EVENT_LOG_SECTORS + MODEL_SLOTS) * FLASH_SECTOR_SIZE;
+    if (modelFlash && modelStore.begin() && swapModel())
+        binLog.log(LOG_MODEL_LOADED);
     setUpServer();
     setUpGPIO();
+    setUpSensors(classifyPair);
+    sensorWindow.begin(micros(), digitalRead(IRL_PIN), digitalRead(IRR_PIN));
+    setUpTasks();
     timestamp = millis();
+    runMLPrediction();
+    const ModelHeader *h = modelStore.header();
+    traceRecorder.begin(micros(), (sensorWindow.left() ? 1 : 0) | (sensorWindow.right() ? 2 : 0), traceOutputs(),
+                        state.prediction, h ? h->modelId : 0);
 }
 
 void runMLPrediction()
 {
-    int left = digitalRead(IRL_PIN);
-    int right = digitalRead(IRR_PIN);
-    float x[2] = {float(left), float(right)};
-    int pred = model.predict(x);
-
-    String result;
-    if (pred == 0)
-        result = "Normal";
-    else if (pred == 1)
-        result = "Crack_Left";
-    else if (pred == 2)
-        result = "Crack_Right";
-    else
-        result = "Break";
+    StageTimer timer(S_PREDICTION);
+    // The forest decides what the dashboard reports, from the newest
+    // sample's window; the table behind classifyPair() only drives the
+    // interrupt stop.
+    float x[RAILWAY_WINDOW_FEATURES];
+    float proba[RAILWAY_WINDOW_CLASSES];
+    sensorWindow.extract(x);
+    Prediction pred = Prediction(forest.predict(x, proba));
+    int left = sensorWindow.left(), right = sensorWindow.right();
 
-    // static flag to keep last state
-    static bool faultDetected = false;
-
-    // 🔹 AI severity and percentage logic
-    if (pred == 0)
+    // 🔹 AI severity and percentage logic: fault % is the forest's
+    // probability that the track is not Normal
+    bool messageChanged = stateVersion.update(F_FAULT_PERCENT, state.faultPercent, 100.0f * (1.0f - proba[0]));
+    stateVersion.update(F_CONFIDENCE, state.confidence, 100.0f * proba[pred]);
+    if (pred == PRED_NORMAL)
     {
-        faultDetected = false; // reset when normal
-        fault_percent = random(1, 10);
-        severity = "Safe";
-        ai_class = "success";
+        messageChanged |= stateVersion.update(F_SEVERITY, state.severity, SEVERITY_SAFE);
+        stateVersion.update(F_AI_CLASS, state.aiStyle, STYLE_SUCCESS);
     }
     else
     {
-        // generate random only once when fault first appears
-        if (!faultDetected)
+        if (pred == PRED_CRACK_LEFT || pred == PRED_CRACK_RIGHT)
         {
-            if (pred == 1 || pred == 2)
-                fault_percent = random(45, 75);
-            else
-                fault_percent = random(85, 100);
-        }
-
-        faultDetected = true;
-
-        if (pred == 1 || pred == 2)
-        {
-            severity = "Moderate";
-            ai_class = "warning";
+            messageChanged |= stateVersion.update(F_SEVERITY, state.severity, SEVERITY_MODERATE);
+            stateVersion.update(F_AI_CLASS, state.aiStyle, STYLE_WARNING);
         }
         else
         {
-            severity = "Critical";
-            ai_class = "danger";
+            messageChanged |= stateVersion.update(F_SEVERITY, state.severity, SEVERITY_CRITICAL);
+            stateVersion.update(F_AI_CLASS, state.aiStyle, STYLE_DANGER);
         }
     }
 
-    ai_status = result;
-
-    // 🔹 For the top message banner
-    dataPacket.message = "AI Status: " + result +
-                         " | Fault: " + String(fault_percent) +
-                         "% | Severity: " + severity;
+    messageChanged |= stateVersion.update(F_AI_STATUS, state.prediction, pred);
 
-    if (pred == 0)
+    // 🔹 For the top message banner, which is rendered from the fields above
+    if (pred == PRED_NORMAL)
     {
+        if (aiFaultDetected)
+            eventLog.append(EV_CLEAR);
         aiFaultDetected = false; // fault cleared
-        dataPacket.message_class = "success";
+        stateVersion.update(F_MESSAGE_CLASS, state.messageStyle, STYLE_SUCCESS);
         digitalWrite(BUZZER_PIN, LOW);
     }
     else
     {
+        if (!aiFaultDetected)
+        {
+            faultCount++;
+            eventLog.append(EV_FAULT, pred);
+        }
         aiFaultDetected = true; // fault active
-        dataPacket.message_class = "danger";
+        stateVersion.update(F_MESSAGE_CLASS, state.messageStyle, STYLE_DANGER);
         digitalWrite(BUZZER_PIN, HIGH);
 
-        // Auto stop train only once per fault detection
+        // Auto stop train only once per fault detection. The sensor interrupt
+        // has normally done this already; this covers a dropped edge.
         digitalWrite(MLP_PIN, LOW);
         digitalWrite(MLN_PIN, LOW);
 
         // Update dashboard
-        dataPacket.btn_fwd_class = "success";
-        dataPacket.btn_stop_class = "danger";
-        dataPacket.btn_back_class = "success";
+        setButtonClasses(STYLE_SUCCESS, STYLE_DANGER, STYLE_SUCCESS);
+    }
+    if (messageChanged)
+        stateVersion.touch(F_MESSAGE);
+
+    stateVersion.update(F_LEFT, state.left, uint8_t(left ? 1 : 0));
+    stateVersion.update(F_RIGHT, state.right, uint8_t(right ? 1 : 0));
+
+    // Predictions run every millisecond; the console only gets news, as a
+    // record loop() sends when it has time.
+    if (!messageChanged)
+        return;
+    binLog.log(pred == PRED_NORMAL ? LOG_STATUS : LOG_FAULT, state.prediction,
+               uint32_t(state.faultPercent * 100 + 0.5f), state.severity);
+}
+
+// Runs a button press from /act. Queued as a task so the handler only
+// records it and answers.
+void applyUserAction()
+{
+    // The driver has the train now; no interrupt stop is to be undone.
+    glitchDeadline = 0;
+    stoppedDrive.store(0);
 
-        dataPacket.message = "⚠ " + result + " detected! Train Stopped 🚨 | Fault: " +
-                             String(fault_percent) + "% | Severity: " + severity;
+    if (userBtnAction == btnAction.BTN_FWD)
+    {
+        setButtonClasses(STYLE_DANGER, STYLE_SUCCESS, STYLE_SUCCESS);
+        digitalWrite(MLP_PIN, HIGH);
+        digitalWrite(MLN_PIN, LOW);
+        aiFaultDetected = false; // override: user manually resumes
+        eventLog.append(EV_MANUAL, 1);
     }
 
-    dataPacket.left = String(left);
-    dataPacket.right = String(right);
+    if (userBtnAction == btnAction.BTN_STOP)
+    {
+        setButtonClasses(STYLE_SUCCESS, STYLE_DANGER, STYLE_SUCCESS);
+        digitalWrite(MLP_PIN, LOW);
+        digitalWrite(MLN_PIN, LOW);
+        eventLog.append(EV_MANUAL, 2);
+    }
 
-    Serial.println(dataPacket.message);
+    if (userBtnAction == btnAction.BTN_BACK)
+    {
+        setButtonClasses(STYLE_SUCCESS, STYLE_SUCCESS, STYLE_DANGER);
+        digitalWrite(MLP_PIN, LOW);
+        digitalWrite(MLN_PIN, HIGH);
+        aiFaultDetected = false; // override: user manually resumes
+        eventLog.append(EV_MANUAL, 3);
+    }
+
+    userBtnAction = btnAction.BTN_NONE;
+    traceRecorder.outputs(micros(), traceOutputs(), state.prediction);
 }
 
-void loop()
+void serviceSensors()
 {
-    server.handleClient();
-    blinkLed(500);
+    // A new model is classified against the track right away.
+    if (swapModel())
+        runMLPrediction();
 
-    if (userBtnAction != btnAction.BTN_NONE)
+    // 🔹 Each edge fills the window up to its own time, so the samples do
+    // not depend on when this runs
+    SensorEvent ev;
+    while (sensorEvents.pop(ev))
     {
-        if (userBtnAction == btnAction.BTN_FWD)
-        {
-            dataPacket.btn_fwd_class = "danger";
-            dataPacket.btn_stop_class = "success";
-            dataPacket.btn_back_class = "success";
-            digitalWrite(MLP_PIN, HIGH);
-            digitalWrite(MLN_PIN, LOW);
-            aiFaultDetected = false; // override: user manually resumes
-        }
+        traceRecorder.sensor(ev.t_us, (ev.left ? 1 : 0) | (ev.right ? 2 : 0));
+        // The last sample before the edge is classified too, however late
+        // this runs after it.
+        if (sensorWindow.advanceTo(ev.t_us))
+            runMLPrediction();
+        sensorWindow.set(ev.left, ev.right);
+    }
+
+    // If the queue overflowed the last edge may be lost; carry on from what
+    // the pins show now so the state cannot stay stale.
+    if (sensorEvents.dropped() != sensorDropsSeen)
+    {
+        sensorDropsSeen = sensorEvents.dropped();
+        eventLog.append(EV_EDGES_LOST);
+        int left = digitalRead(IRL_PIN), right = digitalRead(IRR_PIN);
+        traceRecorder.resync(micros(), (left ? 1 : 0) | (right ? 2 : 0));
+        sensorWindow.set(left, right);
+    }
 
-        if (userBtnAction == btnAction.BTN_STOP)
+    // 🔹 AI model runs on every new sample
+    if (sensorWindow.advanceTo(micros()))
+        runMLPrediction();
+
+    // Interrupt stops are counted in the handler and logged from here.
+    uint32_t stops = safetyStops.load();
+    if (stops != safetyStopsLogged)
+    {
+        eventLog.append(EV_AUTO_STOP, stops - safetyStopsLogged > 255 ? 255 : stops - safetyStopsLogged);
+        safetyStopsLogged = stops;
+        if (stoppedDrive.load())
         {
-            dataPacket.btn_fwd_class = "success";
-            dataPacket.btn_stop_class = "danger";
-            dataPacket.btn_back_class = "success";
-            digitalWrite(MLP_PIN, LOW);
-            digitalWrite(MLN_PIN, LOW);
+            glitchDeadline = millis() + FEATURE_CONFIRM_MS;
+            glitchFaults = faultCount;
         }
+    }
 
-        if (userBtnAction == btnAction.BTN_BACK)
+    // An interrupt stop the window does not back up was a glitch. The stop
+    // stays unless the build opted into putting the drive back.
+    if (glitchDeadline && int32_t(millis() - glitchDeadline) >= 0)
+    {
+        uint8_t drive = stoppedDrive.exchange(0);
+        glitchDeadline = 0;
+        if (drive && !aiFaultDetected && faultCount == glitchFaults)
         {
-            dataPacket.btn_fwd_class = "success";
-            dataPacket.btn_stop_class = "success";
-            dataPacket.btn_back_class = "danger";
-            digitalWrite(MLP_PIN, LOW);
-            digitalWrite(MLN_PIN, HIGH);
-            aiFaultDetected = false; // override: user manually resumes
+#if SENSOR_GLITCH_RESUME
+            digitalWrite(MLP_PIN, drive & 1 ? HIGH : LOW);
+            digitalWrite(MLN_PIN, drive & 2 ? HIGH : LOW);
+#endif
+            sensorGlitches++;
+            eventLog.append(EV_GLITCH, SENSOR_GLITCH_RESUME);
         }
+    }
+
+    traceRecorder.outputs(micros(), traceOutputs(), state.prediction);
+}
+
+void serviceEventLog() { eventLog.service(); }
+void serviceModelStore() { modelStore.service(); }
 
-        userBtnAction = btnAction.BTN_NONE;
+#if STATION_COUNT
+// Station fault onsets go to the event log as one count at most every
+// STATION_LOG_MS, so a flapping chain can neither crowd EV_FAULT and
+// EV_AUTO_STOP out of its queue nor wear out the flash.
+#define STATION_LOG_MS 1000
+uint32_t stationOnsets = 0;
+uint32_t stationLoggedMs = 0;
+
+void serviceStations()
+{
+    stations.scan();
+    uint32_t now = millis();
+    bool changed = stations.classify(now, [](int, int) { stationOnsets++; });
+    if (changed)
+        stateVersion.touch(F_STATIONS);
+    if (stationOnsets && now - stationLoggedMs >= STATION_LOG_MS)
+    {
+        eventLog.append(EV_STATION, stationOnsets > 255 ? 255 : stationOnsets);
+        stationOnsets = 0;
+        stationLoggedMs = now;
     }
+}
+#endif
 
-    if (lcd_update_time + 1000 < millis())
+// Samples until a steady window's prediction can change. Only the runs and
+// since_edge_ms still grow, a millisecond a sample, and the forest notices
+// one only when it passes the next split threshold on it.
+uint32_t samplesUntilChange()
+{
+    static_assert(FEATURE_SAMPLE_US == 1000, "run features count whole samples");
+    static const int growing[] = {FEAT_LEFT_RUN_MS, FEAT_RIGHT_RUN_MS, FEAT_SINCE_EDGE_MS};
+    float x[RAILWAY_WINDOW_FEATURES];
+    sensorWindow.extract(x);
+    uint32_t samples = FEATURE_RUN_CAP;
+    for (int f : growing)
     {
-        lcd_update_time = millis();
-        runMLPrediction(); // 🔹 AI model runs every second
+        float threshold = forest.nextThreshold(f, x[f]);
+        if (threshold < FEATURE_RUN_CAP && uint32_t(threshold) + 1 - uint32_t(x[f]) < samples)
+            samples = uint32_t(threshold) + 1 - uint32_t(x[f]);
     }
+    return samples;
+}
+
+// How long serviceSensors() has nothing to do. It looks at each sample
+// before the next is taken, as when it ran every millisecond, but in a
+// steady window only at those where the prediction can change.
+uint32_t sensorsIdleUs()
+{
+    if (sensorEvents.size() || sensorEvents.dropped() != sensorDropsSeen || safetyStops.load() != safetyStopsLogged ||
+        glitchDeadline || modelStore.busy())
+        return 0;
+    uint32_t samples = sensorWindow.steady() ? samplesUntilChange() : 1;
+    int32_t left = int32_t(sensorWindow.nextSampleUs() - micros()) + int32_t((samples - 1) * FEATURE_SAMPLE_US);
+    return left > 0 ? left : 0;
+}
+
+bool sensorsBusy() { return !sensorsIdleUs(); }
+bool pushBusy() { return events.pending(stateVersion.seq(), millis()); }
+bool eventLogBusy() { return !eventLog.idle(); }
+bool modelStoreBusy() { return modelStore.busy(); }
+
+void setUpTasks()
+{
+    userActionTask = scheduler.oneShot("user_action", 0, applyUserAction);
+    scheduler.setPoll(scheduler.every("sensors", 1, 1, serviceSensors), sensorsBusy);
+    scheduler.setPoll(scheduler.every("push", 1, 2, pushState), pushBusy);
+    scheduler.setPoll(scheduler.every("event_log", 1, 3, serviceEventLog), eventLogBusy);
+    scheduler.every("led", 500, 4, blinkLed);
+    scheduler.setPoll(scheduler.every("model_store", 1, 5, serviceModelStore), modelStoreBusy);
+#if STATION_COUNT
+    scheduler.every("stations", STATION_SCAN_MS, 6, serviceStations);
+#endif
+}
+
+// Waits in esp_delay() until the next task with work is due, a sensor edge
+// (the interrupt calls esp_schedule()) or a client, instead of spinning.
+// The soft AP keeps the radio up, so the SDK idles the CPU rather than
+// light-sleeping; what it saves is loop() and its polling tasks. The
+// interrupt stop does not depend on any of it.
+void idleUntilNeeded()
+{
+    if (!idleSleep || binLog.pending() || !server.idle())
+        return;
+    // esp_delay() counts milliseconds. Rounding up makes a task up to a
+    // millisecond late, never a sample: the wait ends before the next one.
+    uint32_t waitUs = scheduler.idleUs(sensorsIdleUs());
+    if (!waitUs)
+        return;
+    uint32_t ms = (waitUs + 999) / 1000;
+    uint32_t start = micros();
+    esp_delay(ms, []() { return !sensorEvents.size() && server.idle(); }, IDLE_POLL_MS);
+    uint32_t slept = micros() - start;
+    if (!slept)
+        return; // the host build with idling off
+    idleWaits++;
+    idleUs += slept;
+    if (slept < ms * 1000)
+        idleEarlyWakes++;
+    scheduler.afterIdle();
 }
 
-String getTemplate()
-{
-    return "<!DOCTYPE html>\n"
-           "<html>\n"
-           "<head>\n"
-           "<style>"
-           "body{\n"
-           "background-color: #F1FCFF;\n"
-           "padding:0px;\n"
-           "margin:0px;\n"
-           "text-align: center;\n"
-           "}\n"
-           "header{\n"
-           "height:35px;\n"
-           "padding:10px;\n"
-           "text-align:left;\n"
-           "display: flex;\n"
-           "background-color: #0093E9;\n"
-           "position:fixed;\n"
-           "width:100%;\n"
-           "z-index:100;\n"
-           "top:0;\n"
-           "}\n"
-           "footer{\n"
-           "padding:20px;\n"
-           "}\n"
-           "\n"
-           "form{\n"
-           "margin:15px auto 0px auto;\n"
-           "max-width:90%;\n"
-           "background-color: #AAAAAA;\n"
-           "padding: 15px 0 15px 0;\n"
-           "border-radius: 5px;\n"
-           "}\n"
-           "\n"
-           "button{\n"
-           "margin:8px auto 0px auto;\n"
-           "width:90%;\n"
-           "background-color: #AAAAAA;\n"
-           "padding: 10px 0 10px 0;\n"
-           "border-radius: 5px;\n"
-           "font-size: 24px;\n"
-           "font-weight: bold;\n"
-           "color:white;\n"
-           "border: none;\n"
-           "}\n"
-           "button:active {\n"
-           "width:89%;\n"
-           "padding: 10px 0 10px 0;\n"
-           "color:black;\n"
-           "}\n"
-           "input{\n"
-           "margin:8px auto 0px auto;\n"
-           "width:90%;\n"
-           "padding: 10px 0 10px 0;\n"
-           "border-radius: 5px;\n"
-           "font-size: 22px;\n"
-           "color:black;\n"
-           "border: none;\n"
-           "}\n"
-           "\n"
-           "label{\n"
-           "margin:15px auto 0px auto;\n"
-           "width:90%;\n"
-           "padding: 0px 0 0px 0;\n"
-           "font-size: 22px;\n"
-           "display:block;\n"
-           "}\n"
-           "\n"
-           ".radio-group{\n"
-           "margin:15px auto 15px auto;\n"
-           "font-size: 24px;\n"
-           "width:100%;\n"
-           "display:flex;\n"
-           "flex-direction: row;\n"
-           "text-align:left;\n"
-           "}\n"
-           ".radio-label{\n"
-           "margin:0px;\n"
-           "padding:0px;\n"
-           "}\n"
-           ".radio{\n"
-           "width:32px;\n"
-           "margin:0px 10px 0px 15px;\n"
-           "}\n"
-           "\n"
-           ".content{\n"
-           "margin-top:70px;\n"
-           "}\n"
-           ".connection{\n"
-           "margin-left:20px;\n"
-           "color: white;\n"
-           "}\n"
-           ".online{\n"
-           "margin: 8px 0 0 -8px;\n"
-           "font-size: 16px;\n"
-           "color:white;\n"
-           "}\n"
-           ".card{\n"
-           "margin:15px auto 0px auto;\n"
-           "max-width:90%;\n"
-           "padding: 15px 0 15px 0;\n"
-           "border-radius: 5px;\n"
-           "}\n"
-           ".primary{\n"
-           "background-color: #8BC6EC;\n"
-           "visibility: visible;\n"
-           "}\n"
-           ".secondary{\n"
-           "background-color: #AAAAAA;\n"
-           "visibility: visible;\n"
-           "}\n"
-           ".success{\n"
-           "background-color: #82c063;\n"
-           "visibility: visible;\n"
-           "}\n"
-           ".danger{\n"
-           "background-color: #F76666;\n"
-           "visibility: visible;\n"
-           "}\n"
-           ".warning{\n"
-           "background-color: #E3D377;\n"
-           "visibility: visible;\n"
-           "}\n"
-           ".hide{\n"
-           "visibility: hidden;\n"
-           "}\n"
-           "@media only screen and (min-width: 500px) {\n"
-           ".card {\n"
-           "max-width:400px;\n"
-           "}\n"
-           "button{\n"
-           "max-width:400px;\n"
-           "}\n"
-           "form{\n"
-           "max-width:400px;\n"
-           "}\n"
-           "label{\n"
-           "max-width:400px;\n"
-           "}\n"
-           "}\n"
-           "\n"
-           "h1 {\n"
-           "margin: 2px;\n"
-           "color: white;\n"
-           "}\n"
-           "h2 {\n"
-           "margin: 2px;\n"
-           "color: black;\n"
-           "}\n"
-           "</style>\n"
-           "<meta charset='utf-8'>\n"
-           "<meta http-equiv='X-UA-Compatible' content='IE=edge'>\n"
-           "<title>Iot</title>\n"
-           "<meta name='viewport' content='width=device-width, initial-scale=1'>\n"
-           "<link rel='stylesheet' type='text/css' media='screen' href='main.css'>\n"
-           "\n"
-           "</head>\n"
-           "<body onload=\"liveDataAjax()\">\n"
-           "<header>\n"
-           "<span class=\"connection\" id=\"connected\">\n"
-           "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"32\" height=\"32\" fill=\"currentColor\" class=\"connected\" viewBox=\"0 0 16 16\">\n"
-           "<path d=\"M15.384 6.115a.485.485 0 0 0-.047-.736A12.444 12.444 0 0 0 8 3C5.259 3 2.723 3.882.663 5.379a.485.485 0 0 0-.048.736.518.518 0 0 0 .668.05A11.448 11.448 0 0 1 8 4c2.507 0 4.827.802 6.716 2.164.205.148.49.13.668-.049z\"/>\n"
-           "<path d=\"M13.229 8.271a.482.482 0 0 0-.063-.745A9.455 9.455 0 0 0 8 6c-1.905 0-3.68.56-5.166 1.526a.48.48 0 0 0-.063.745.525.525 0 0 0 .652.065A8.46 8.46 0 0 1 8 7a8.46 8.46 0 0 1 4.576 1.336c.206.132.48.108.653-.065zm-2.183 2.183c.226-.226.185-.605-.1-.75A6.473 6.473 0 0 0 8 9c-1.06 0-2.062.254-2.946.704-.285.145-.326.524-.1.75l.015.015c.16.16.407.19.611.09A5.478 5.478 0 0 1 8 10c.868 0 1.69.201 2.42.56.203.1.45.07.61-.091l.016-.015zM9.06 12.44c.196-.196.198-.52-.04-.66A1.99 1.99 0 0 0 8 11.5a1.99 1.99 0 0 0-1.02.28c-.238.14-.236.464-.04.66l.706.706a.5.5 0 0 0 .707 0l.707-.707z\"/>\n"
-           "</svg>\n"
-           "</span>\n"
-           "<span class=\"connection\" id=\"disconnected\">\n"
-           "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"32\" height=\"32\" fill=\"currentColor\" class=\"connected\" viewBox=\"0 0 16 16\">\n"
-           "<path d=\"M10.706 3.294A12.545 12.545 0 0 0 8 3C5.259 3 2.723 3.882.663 5.379a.485.485 0 0 0-.048.736.518.518 0 0 0 .668.05A11.448 11.448 0 0 1 8 4c.63 0 1.249.05 1.852.148l.854-.854zM8 6c-1.905 0-3.68.56-5.166 1.526a.48.48 0 0 0-.063.745.525.525 0 0 0 .652.065 8.448 8.448 0 0 1 3.51-1.27L8 6zm2.596 1.404.785-.785c.63.24 1.227.545 1.785.907a.482.482 0 0 1 .063.745.525.525 0 0 1-.652.065 8.462 8.462 0 0 0-1.98-.932zM8 10l.933-.933a6.455 6.455 0 0 1 2.013.637c.285.145.326.524.1.75l-.015.015a.532.532 0 0 1-.611.09A5.478 5.478 0 0 0 8 10zm4.905-4.905.747-.747c.59.3 1.153.645 1.685 1.03a.485.485 0 0 1 .047.737.518.518 0 0 1-.668.05 11.493 11.493 0 0 0-1.811-1.07zM9.02 11.78c.238.14.236.464.04.66l-.707.706a.5.5 0 0 1-.707 0l-.707-.707c-.195-.195-.197-.518.04-.66A1.99 1.99 0 0 1 8 11.5c.374 0 .723.102 1.021.28zm4.355-9.905a.53.53 0 0 1 .75.75l-10.75 10.75a.53.53 0 0 1-.75-.75l10.75-10.75z\"/>\n"
-           "</svg>\n"
-           "</span>\n"
-           "<span class=\"connection\">\n"
-           "<p class=\"online\" id=\"online\" >Online</p>\n"
-           "</span>\n"
-           "</header>\n"
-           "\n"
-           "<div class=\"content\">\n"
-           "<div class=\"card hide\" id=\"message\">\n"
-           "<span></span>\n"
-           "<h1></h1>\n"
-           "</div>\n"
-           "<div class=\"card primary\" id=\"left\">\n"
-           "<span>\n"
-           "<h3>Left</h3>\n"
-           "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"48\" height=\"48\" fill=\"red\" class=\"bi bi-water\" viewBox=\"0 0 16 16\">\n"
-           "<path fill-rule=\"evenodd\" d=\"M15 8a.5.5 0 0 0-.5-.5H2.707l3.147-3.146a.5.5 0 1 0-.708-.708l-4 4a.5.5 0 0 0 0 .708l4 4a.5.5 0 0 0 .708-.708L2.707 8.5H14.5A.5.5 0 0 0 15 8\"/>\n"
-           "</svg>\n"
-           "</span>\n"
-           "<h1>Not Detected</h1>\n"
-           "</div>\n"
-           "<div class=\"card primary\" id=\"right\">\n"
-           "<span>\n"
-           "<h3>Right</h3>\n"
-           "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"48\" height=\"48\" fill=\"white\" class=\"bi bi-thermometer-half\" viewBox=\"0 0 16 16\">\n"
-           "<path fill-rule=\"evenodd\" d=\"M1 8a.5.5 0 0 1 .5-.5h11.793l-3.147-3.146a.5.5 0 0 1 .708-.708l4 4a.5.5 0 0 1 0 .708l-4 4a.5.5 0 0 1-.708-.708L13.293 8.5H1.5A.5.5 0 0 1 1 8\"/>\n"
-           "</svg>\n"
-           "</span>\n"
-           "<h1>30 &deg; C</h1>\n"
-           "</div>\n"
-           "\n"
-           "<div>\n"
-           "<button onclick=\"onClickBtn('btn_fwd')\" id=\"btn_fwd\">FORWARD</button>\n"
-           "</div>\n"
-           "<div>\n"
-           "<button onclick=\"onClickBtn('btn_stop')\" id=\"btn_stop\">STOP</button>\n"
-           "</div>\n"
-           "<div>\n"
-           "<button onclick=\"onClickBtn('btn_back')\" id=\"btn_back\">BACK</button>\n"
-           "</div>\n"
-           "\n"
-           "<div class=\"card primary\" id=\"ai_card\">"
-           "<h2>AI Fault Detection</h2>"
-           "<h3 id=\"ai_status_text\">Status: -</h3>"
-           "<h3 id=\"ai_fault_text\">Fault: - %</h3>"
-           "<h3 id=\"ai_severity_text\">Severity: -</h3>"
-           "</div>"
-
-           "\n"
-           "\n"
-           "<div class=\"card primary\" id=\"location\">\n"
-           "<a href=\"https://maps.app.goo.gl/Wmyqr1H4hy8awwjN7\">\n"
-           "<span>\n"
-           "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"48\" height=\"48\" fill=\"white\" class=\"bi bi-thermometer-half\" viewBox=\"0 0 16 16\">\n"
-           "<path fill-rule=\"evenodd\" d=\"M1 8a.5.5 0 0 1 .5-.5h11.793l-3.147-3.146a.5.5 0 0 1 .708-.708l4 4a.5.5 0 0 1 0 .708l-4 4a.5.5 0 0 1-.708-.708L13.293 8.5H1.5A.5.5 0 0 1 1 8\"/>\n"
-           "</svg>\n"
-           "</span>\n"
-           "<h1>Location</h1>\n"
-           "</a>\n"
-           "</div>\n"
-           "\n"
-           "\n"
-           "\n"
-           "\n"
-           "\n"
-           "</div>\n"
-           "<footer>\n"
-           "\n"
-           "</footer>\n"
-           "\n"
-           "<script>"
-           "var DRT = 500;\n"
-           "function updateCSSClass(element, css){\n"
-           "    if(css != 'primary')\n"
-           "        element.classList.remove('primary');\n"
-           "    if(css != 'secondary')\n"
-           "        element.classList.remove('secondary');\n"
-           "    if(css != 'success')\n"
-           "        element.classList.remove('success');\n"
-           "    if(css != 'danger')\n"
-           "        element.classList.remove('danger');\n"
-           "    if(css != 'warning')\n"
-           "        element.classList.remove('warning');\n"
-           "    if(css != 'hide')\n"
-           "        element.classList.remove('hide');\n"
-           "    element.classList.add(css);\n"
-           "}\n"
-           "\n"
-           "function updateData(data){\n"
-           "\tdocument.getElementById(\"message\").children[1].innerHTML = \"\"+data.message+\"\";\n"
-           "\tupdateCSSClass(document.getElementById(\"message\"), data.message_class);\n"
-           "\tdocument.getElementById(\"left\").children[1].innerHTML = \"\"+data.left+\"\";\n"
-           "\tupdateCSSClass(document.getElementById(\"left\"), data.left_class);\n"
-           "\tdocument.getElementById(\"right\").children[1].innerHTML = \"\"+data.right+\"\";\n"
-           "\tupdateCSSClass(document.getElementById(\"right\"), data.right_class);\n"
-           "\tdocument.getElementById(\"btn_fwd\").innerHTML = \"\"+data.btn_fwd+\"\";\n"
-           "\tupdateCSSClass(document.getElementById(\"btn_fwd\"), data.btn_fwd_class);\n"
-           "\tdocument.getElementById(\"btn_stop\").innerHTML = \"\"+data.btn_stop+\"\";\n"
-           "\tupdateCSSClass(document.getElementById(\"btn_stop\"), data.btn_stop_class);\n"
-           "\tdocument.getElementById(\"btn_back\").innerHTML = \"\"+data.btn_back+\"\";\n"
-           "\tupdateCSSClass(document.getElementById(\"btn_back\"), data.btn_back_class);\n"
-           "document.getElementById(\"ai_status_text\").innerHTML = \"Status: \" + data.ai_status;"
-           "document.getElementById(\"ai_fault_text\").innerHTML = \"Fault: \" + data.fault_percent + \" %\";"
-           "document.getElementById(\"ai_severity_text\").innerHTML = \"Severity: \" + data.severity;"
-           "updateCSSClass(document.getElementById(\"ai_card\"), data.ai_class);"
-
-           "}\n"
-           "\n"
-           "function getCommand(btn_id, value){\n"
-           "\tif(btn_id == \"btn_fwd\"){\n"
-           "\t\tif(value == 'ON'){\n"
-           "\t\t\treturn 'OFF';\n"
-           "\t\t}else{\n"
-           "\t\t\treturn 'FORWARD';\n"
-           "\t\t}\n"
-           "\t}\tif(btn_id == \"btn_stop\"){\n"
-           "\t\tif(value == 'ON'){\n"
-           "\t\t\treturn 'OFF';\n"
-           "\t\t}else{\n"
-           "\t\t\treturn 'STOP';\n"
-           "\t\t}\n"
-           "\t}\tif(btn_id == \"btn_back\"){\n"
-           "\t\tif(value == 'ON'){\n"
-           "\t\t\treturn 'OFF';\n"
-           "\t\t}else{\n"
-           "\t\t\treturn 'BACK';\n"
-           "\t\t}\n"
-           "\t}    \n"
-           "}\n"
-           "\n"
-           "function onClickBtn(btn_id){\n"
-           "\tvar val = document.getElementById(btn_id).innerHTML;\n"
-           "\tvar cmd = getCommand(btn_id,val);\n"
-           "    console.log(cmd)\n"
-           "\tsendButtonClick('/act?'+btn_id+'='+cmd)\n"
-           "}\n"
-           "\n"
-           "\n"
-           "\n"
-           "function updateNetwork(connected){\n"
-           "    if(connected){\n"
-           "        document.getElementById('disconnected').style.display = 'none';\n"
-           "        document.getElementById('connected').style.display = 'block';\n"
-           "        document.getElementById('online').innerHTML = 'Online';\n"
-           "    }\n"
-           "    else{\n"
-           "        document.getElementById('connected').style.display = 'none';\n"
-           "        document.getElementById('disconnected').style.display = 'block';\n"
-           "        document.getElementById('online').innerHTML = 'Offline';\n"
-           "    }\n"
-           "}\n"
-           "\n"
-           "\n"
-           "function sendButtonClick(url){\n"
-           "\t\n"
-           "    const xhr = new XMLHttpRequest();\n"
-           "    xhr.open('GET', url, true);\n"
-           "    xhr.onload = () => {\n"
-           "        if(xhr.readyState === XMLHttpRequest.DONE && xhr.status === 200) {\n"
-           "            var data= JSON.parse(xhr.responseText);\n"
-           "            updateData(data);\n"
-           "            updateNetwork(true);\n"
-           "        }\n"
-           "    }\n"
-           "    xhr.onerror = function() {\n"
-           "        updateNetwork(false);\n"
-           "    };\n"
-           "    xhr.send();\n"
-           "}\n"
-           "\n"
-           "\n"
-           "\n"
-           "\n"
-           "var netcount = 0;\n"
-           "function reconnect(){\n"
-           "    if(netcount == 0){\n"
-           "        console.log(\"Retrying\");\n"
-           "        document.getElementById('online').innerHTML = 'Retrying..';\n"
-           "        setTimeout(liveDataAjax,1000);\n"
-           "        return\n"
-           "    }\n"
-           "    netcount -= 1;\n"
-           "    console.log(\"count\",netcount);\n"
-           "    document.getElementById('online').innerHTML = 'Offline ('+netcount+')';\n"
-           "    setTimeout(reconnect, 1000);\n"
-           "}\n"
-           "function liveDataAjax(){\n"
-           "    const xhr = new XMLHttpRequest();\n"
-           "    xhr.open('GET', '/data.json', true);\n"
-           "    xhr.onload = () => {\n"
-           "        if(xhr.readyState === XMLHttpRequest.DONE && xhr.status === 200) {\n"
-           "            var data= JSON.parse(xhr.responseText);\n"
-           "            updateData(data);\n"
-           "            updateNetwork(true);\n"
-           "            setTimeout(liveDataAjax, DRT);\n"
-           "        }\n"
-           "        else if (xhr.readyState === XMLHttpRequest.DONE){\n"
-           "            updateNetwork(false);\n"
-           "            netcount = 5;\n"
-           "            reconnect();\n"
-           "        }\n"
-           "    };\n"
-           "    xhr.onerror = function() {\n"
-           "        updateNetwork(false);\n"
-           "        netcount = 5;\n"
-           "        reconnect();\n"
-           "    };\n"
-           "    xhr.send();\t\n"
-           "}\n"
-           "\n"
-           "</script>\n"
-           "</body>\n"
-           "</html>";
-}
\ No newline at end of file
+void loop()
+{
+    idleUntilNeeded();
+    StageTimer timer(S_LOOP);
+    {
+        StageTimer serverTimer(S_HANDLE_CLIENT);
+        server.handleClient();
+    }
+    scheduler.run();
+    if (binLog.pending())
+    {
+        StageTimer serialTimer(S_SERIAL);
+        binLog.drain();
+    }
+}